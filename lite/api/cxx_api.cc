@@ -73,6 +73,7 @@ bool IsQuantizedMode(const std::shared_ptr<cpp::ProgramDesc> &program_desc) {
 void Predictor::SaveModel(const std::string &dir,
                           lite_api::LiteModelType model_type,
                           bool record_info) {
+  StopWarmUp();
   if (!program_) {
     GenRuntimeProgram();
   }
@@ -173,16 +174,18 @@ void Predictor::SaveOpKernelInfo(const std::string &model_dir) {
 
 #if !defined(LITE_WITH_FPGA) && !defined(LITE_WITH_METAL)
 lite::Tensor *Predictor::GetInput(size_t offset) {
-  CHECK(input_names_.size() > offset)
-      << "The network has " << input_names_.size() << " inputs"
+  StopWarmUp();
+  CHECK(input_vars_.size() > offset)
+      << "The network has " << input_vars_.size() << " inputs"
       << ", the offset should be less than this.";
-  auto *in_var = exec_scope_->FindVar(input_names_[offset]);
+  auto *in_var = input_vars_[offset];
   CHECK(in_var) << "no fatch variable " << input_names_[offset]
                 << " in exec_scope";
   return in_var->GetMutable<lite::Tensor>();
 }
 #else
 lite::Tensor *Predictor::GetInput(size_t offset) {
+  StopWarmUp();
   auto *_feed_list = exec_scope_->FindVar("feed");
   CHECK(_feed_list) << "no feed variable in exec_scope";
   auto *feed_list = _feed_list->GetMutable<std::vector<lite::Tensor>>();
@@ -238,6 +241,20 @@ void Predictor::PrepareFeedFetch() {
     output_names_[fetchs[i]->GetAttr<int>("col")] =
         fetchs[i]->Input("X").front();
   }
+  // Resolve the feed/fetch variables once, so that the per-request accessors
+  // do not have to search the scopes by name.
+  input_vars_.resize(input_names_.size());
+  input_ids_.clear();
+  for (size_t i = 0; i < input_names_.size(); i++) {
+    input_vars_[i] = exec_scope_->FindVar(input_names_[i]);
+    input_ids_[input_names_[i]] = i;
+  }
+  output_vars_.resize(output_names_.size());
+  output_ids_.clear();
+  for (size_t i = 0; i < output_names_.size(); i++) {
+    output_vars_[i] = exec_scope_->FindVar(output_names_[i]);
+    output_ids_[output_names_[i]] = i;
+  }
   for (size_t i = 0; i < feeds.size(); i++) {
     input_precisions_[i] = GetInput(i)->precision();
   }
@@ -245,26 +262,27 @@ void Predictor::PrepareFeedFetch() {
 
 #if !defined(LITE_WITH_FPGA) && !defined(LITE_WITH_METAL)
 const lite::Tensor *Predictor::GetOutput(size_t offset) const {
-  CHECK(output_names_.size() > offset)
-      << "The network has " << output_names_.size() << " outputs"
+  StopWarmUp();
+  CHECK(output_vars_.size() > offset)
+      << "The network has " << output_vars_.size() << " outputs"
       << ", the offset should be less than this.";
-  const std::string name = output_names_.at(offset);
-  auto *out_var = exec_scope_->FindVar(name);
-  CHECK(out_var) << "no fatch variable " << name << " in exec_scope";
+  auto *out_var = output_vars_[offset];
+  CHECK(out_var) << "no fatch variable " << output_names_[offset]
+                 << " in exec_scope";
   return out_var->GetMutable<lite::Tensor>();
 }
 
 std::vector<const lite::Tensor *> Predictor::GetOutputs() const {
   std::vector<const lite::Tensor *> outputs;
-  size_t out_size = output_names_.size();
+  size_t out_size = output_vars_.size();
   for (size_t i = 0; i < out_size; i++) {
-    const std::string name = output_names_.at(i);
-    outputs.push_back(GetTensor(name));
+    outputs.push_back(GetOutput(i));
   }
   return outputs;
 }
 #else
 const lite::Tensor *Predictor::GetOutput(size_t offset) const {
+  StopWarmUp();
   auto *_fetch_list = exec_scope_->FindVar("fetch");
   CHECK(_fetch_list) << "no fatch variable in exec_scope";
   auto &fetch_list = *_fetch_list->GetMutable<std::vector<lite::Tensor>>();
@@ -273,6 +291,7 @@ const lite::Tensor *Predictor::GetOutput(size_t offset) const {
 }
 
 std::vector<const lite::Tensor *> Predictor::GetOutputs() const {
+  StopWarmUp();
   auto *_fetch_list = exec_scope_->FindVar("fetch");
   CHECK(_fetch_list) << "no fatch variable in exec_scope";
   auto &fetch_list = *_fetch_list->GetMutable<std::vector<lite::Tensor>>();
@@ -286,6 +305,32 @@ std::vector<const lite::Tensor *> Predictor::GetOutputs() const {
 
 #endif
 
+void Predictor::BindOutput(size_t offset,
+                           void *data,
+                           size_t memory_size,
+                           TargetType target) {
+  StopWarmUp();
+  if (!program_generated_) {
+    GenRuntimeProgram();
+  }
+  CHECK_LT(offset, output_names_.size()) << "offset " << offset << " overflow";
+  program_->BindExternalOutput(
+      output_names_[offset], data, memory_size, target);
+}
+
+void Predictor::UnbindOutput(size_t offset) {
+  StopWarmUp();
+  CHECK_LT(offset, output_names_.size()) << "offset " << offset << " overflow";
+  if (program_) program_->UnbindExternalOutput(output_names_[offset]);
+}
+
+void Predictor::EnableDepthFirstTiling(size_t band_bytes) {
+  if (!program_generated_) {
+    GenRuntimeProgram();
+  }
+  program_->EnableDepthFirstTiling(band_bytes);
+}
+
 const cpp::ProgramDesc &Predictor::program_desc() const {
   return *program_desc_.get();
 }
@@ -404,12 +449,14 @@ void Predictor::GenRuntimeProgram() {
 }
 
 const lite::Tensor *Predictor::GetTensor(const std::string &name) const {
+  StopWarmUp();
   auto *var = exec_scope_->FindVar(name);
   CHECK(var) << "no variable named with " << name << " in exec_scope";
   return &var->Get<lite::Tensor>();
 }
 
 lite::Tensor *Predictor::GetMutableTensor(const std::string &name) {
+  StopWarmUp();
   auto *var = exec_scope_->FindVar(name);
   CHECK(var) << "no variable named with " << name << " in exec_scope";
   return var->GetMutable<lite::Tensor>();
@@ -417,8 +464,8 @@ lite::Tensor *Predictor::GetMutableTensor(const std::string &name) {
 
 // get input by name
 lite::Tensor *Predictor::GetInputByName(const std::string &name) {
-  auto element = std::find(input_names_.begin(), input_names_.end(), name);
-  if (element == input_names_.end()) {
+  auto element = input_ids_.find(name);
+  if (element == input_ids_.end()) {
     LOG(ERROR) << "Model do not have input named with: [" << name
                << "], model's inputs include:";
     for (size_t i = 0; i < input_names_.size(); i++) {
@@ -426,15 +473,14 @@ lite::Tensor *Predictor::GetInputByName(const std::string &name) {
     }
     return nullptr;
   } else {
-    int position = std::distance(input_names_.begin(), element);
-    return GetInput(position);
+    return GetInput(element->second);
   }
 }
 
 // get output by name
 const lite::Tensor *Predictor::GetOutputByName(const std::string &name) {
-  auto element = std::find(output_names_.begin(), output_names_.end(), name);
-  if (element == output_names_.end()) {
+  auto element = output_ids_.find(name);
+  if (element == output_ids_.end()) {
     LOG(ERROR) << "Model do not have output named with: [" << name
                << "], model's outputs include:";
     for (size_t i = 0; i < output_names_.size(); i++) {
@@ -442,8 +488,7 @@ const lite::Tensor *Predictor::GetOutputByName(const std::string &name) {
     }
     return nullptr;
   } else {
-    int position = std::distance(output_names_.begin(), element);
-    return GetOutput(position);
+    return GetOutput(element->second);
   }
 }
 
@@ -500,6 +545,7 @@ void Predictor::CheckPaddleOpVersions(
 }
 
 bool Predictor::TryShrinkMemory() {
+  StopWarmUp();
 #ifdef LITE_WITH_ARM
   // Clear ArmL3Cache
   lite::DeviceInfo::Global().ClearArmL3Cache();
@@ -530,6 +576,20 @@ bool Predictor::TryShrinkMemory() {
   return true;
 }
 
+void Predictor::WarmUp(const std::function<void()> &thread_init) {
+  if (!program_generated_) {
+    GenRuntimeProgram();
+  }
+  // An op failing on a missing input would abort the background thread,
+  // check the inputs here instead.
+  for (size_t i = 0; i < input_names_.size(); i++) {
+    CHECK(GetInput(i)->IsInitialized())
+        << "The input " << input_names_[i] << " must be set before WarmUp.";
+  }
+  program_->StartWarmUp(thread_init);
+  warming_up_ = true;
+}
+
 void Predictor::CheckInputValid() {
   for (size_t idx = 0; idx < input_precisions_.size(); ++idx) {
     if (GetInput(idx)->precision() != input_precisions_[idx]) {
@@ -544,7 +604,7 @@ void Predictor::CheckInputValid() {
 }
 
 void Predictor::ClearTensorArray(
-    const std::shared_ptr<const cpp::ProgramDesc> &program_desc) {
+    const std::shared_ptr<const cpp::ProgramDesc> &program_desc) const {
   for (size_t blk_idx = 0; blk_idx < program_desc->BlocksSize(); blk_idx++) {
     const cpp::BlockDesc *block =
         program_desc->GetBlock<cpp::BlockDesc>(blk_idx);
@@ -13,13 +13,16 @@
 // limitations under the License.
 
 #pragma once
+#include <functional>
 #include <map>
 #include <memory>
 #include <mutex>  //NOLINT
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include "lite/api/paddle_api.h"
+#include "lite/api/request_trace.h"
 #include "lite/core/op_lite.h"
 #include "lite/core/optimizer/optimizer.h"
 #include "lite/core/program.h"
@@ -108,6 +111,7 @@ class LITE_API Predictor {
   // in scope_ with the original predictor.
   //////////////////////////////////////////////////////////
   std::shared_ptr<Predictor> Clone() {
+    StopWarmUp();
     // step 1. Generate runtime_program, update op_info and var_info in
     // program_desc_
     if (!program_generated_) {
@@ -133,6 +137,7 @@ class LITE_API Predictor {
                             "should be not be nullptr in Clone mode.";
     CHECK(scope_) << "Both program and scope of current predicotr should be "
                      "not be nullptr in Clone mode.";
+    StopWarmUp();
     // step 1. Generate runtime_program, update op_info and var_info in
     // program_desc_
     if (!program_generated_) {
@@ -160,6 +165,7 @@ class LITE_API Predictor {
 
   // Run the predictor for a single batch of data.
   void Run() {
+    StopWarmUp();
     if (!program_generated_) {
       GenRuntimeProgram();
     }
@@ -199,6 +205,10 @@ class LITE_API Predictor {
   /// \return a boolean variable.
   bool TryShrinkMemory();
 
+  // Run the ops on a background thread to prepare their kernels, see
+  // RuntimeProgram::StartWarmUp. All the inputs must be set.
+  void WarmUp(const std::function<void()>& thread_init = nullptr);
+
   // Get offset-th col of feed inputs.
   lite::Tensor* GetInput(size_t offset);
   // get input by name.
@@ -216,6 +226,15 @@ class LITE_API Predictor {
 
   // Get offset-th col of fetch results.
   const lite::Tensor* GetOutput(size_t offset) const;
+  // Let the op producing the offset-th output write it into `data`, see
+  // RuntimeProgram::BindExternalOutput.
+  void BindOutput(size_t offset,
+                  void* data,
+                  size_t memory_size,
+                  TargetType target);
+  void UnbindOutput(size_t offset);
+  // See RuntimeProgram::EnableDepthFirstTiling.
+  void EnableDepthFirstTiling(size_t band_bytes);
   std::vector<const lite::Tensor*> GetOutputs() const;
 
   const cpp::ProgramDesc& program_desc() const;
@@ -255,7 +274,15 @@ class LITE_API Predictor {
   void CheckInputValid();
 
   void ClearTensorArray(
-      const std::shared_ptr<const cpp::ProgramDesc>& program_desc);
+      const std::shared_ptr<const cpp::ProgramDesc>& program_desc) const;
+
+  // Waits for the warm-up before the inputs or the outputs are touched.
+  void StopWarmUp() const {
+    if (!warming_up_) return;
+    program_->StopWarmUp();
+    warming_up_ = false;
+    ClearTensorArray(program_desc_);
+  }
 
  private:
   std::shared_ptr<cpp::ProgramDesc> program_desc_;
@@ -265,8 +292,14 @@ class LITE_API Predictor {
   bool program_generated_{false};
   std::vector<std::string> input_names_;
   std::vector<std::string> output_names_;
+  // Feed/fetch variables resolved in PrepareFeedFetch, indexed by column.
+  std::vector<Variable*> input_vars_;
+  std::vector<Variable*> output_vars_;
+  std::unordered_map<std::string, size_t> input_ids_;
+  std::unordered_map<std::string, size_t> output_ids_;
   std::vector<Place> valid_places_;
   std::vector<PrecisionType> input_precisions_;
+  mutable bool warming_up_{false};
 };
 
 class CxxPaddleApiImpl : public lite_api::PaddlePredictor {
@@ -293,6 +326,8 @@ class CxxPaddleApiImpl : public lite_api::PaddlePredictor {
 
   void Run() override;
 
+  void WarmUp() override;
+
   /// \brief Release all tmp tensor to compress the size of the memory pool.
   /// The memory pool is considered to be composed of a list of chunks, if
   /// the chunk is not occupied, it can be released.
@@ -305,6 +340,15 @@ class CxxPaddleApiImpl : public lite_api::PaddlePredictor {
   std::shared_ptr<lite_api::PaddlePredictor> Clone(
       const std::vector<std::string>& var_names) override;
 
+  std::shared_ptr<lite_api::PaddlePredictor> CloneOnNumaNode(
+      int node) override;
+
+  void BindOutput(int i,
+                  void* data,
+                  size_t memory_size,
+                  TargetType target = TargetType::kHost) override;
+  void UnbindOutput(int i) override;
+
   std::string GetVersion() const override;
 
   // get inputs names and get outputs names
@@ -330,6 +374,7 @@ class CxxPaddleApiImpl : public lite_api::PaddlePredictor {
   lite_api::CxxConfig config_;
   std::mutex mutex_;
   bool status_is_cloned_;
+  std::shared_ptr<lite_api::RequestTraceWriter> request_trace_;
 };
 
 /*
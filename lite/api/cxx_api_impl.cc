@@ -17,11 +17,13 @@
 #include <mutex>  //NOLINT
 #include <string>
 #include "lite/api/paddle_api.h"
+#include "lite/backends/host/allocator.h"
 #include "lite/core/device_info.h"
 #include "lite/core/optimizer/mir/pass_manager.h"
 #include "lite/core/optimizer/mir/post_quant_dynamic_pass.h"
 #include "lite/core/optimizer/mir/sparse_conv_detect_pass.h"
 #include "lite/core/version.h"
+#include "lite/core/weight_registry.h"
 #ifdef LITE_USE_THREAD_POOL
 #include "lite/core/parallel_defines.h"
 #include "lite/core/thread_pool.h"
@@ -37,11 +39,23 @@
 #endif
 #include "lite/backends/x86/mklml.h"
 #endif
+#if (defined LITE_WITH_X86) && !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
+#include "lite/backends/x86/cpu_info.h"
+#endif
 namespace paddle {
 namespace lite {
 
 void CxxPaddleApiImpl::Init(const lite_api::CxxConfig &config) {
   config_ = config;
+  lite::host::AllocatorGuard allocator_guard(
+      static_cast<lite::host::AllocatorKind>(config.host_allocator()));
+#if (defined LITE_WITH_X86) && !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
+  // Build on the node of the predictor, so the weights are placed there.
+  std::unique_ptr<x86::NumaNodeScope> numa_scope;
+  if (config.x86_numa_node() >= 0) {
+    numa_scope.reset(new x86::NumaNodeScope(config.x86_numa_node()));
+  }
+#endif
   mode_ = config.power_mode();
   threads_ = config.threads();
 #ifdef LITE_USE_THREAD_POOL
@@ -140,10 +154,23 @@ void CxxPaddleApiImpl::Init(const lite_api::CxxConfig &config) {
     }
 
     raw_predictor_->Build(config, places, passes);
+    if (config.share_weights()) {
+      WeightRegistry::Global().Enable();
+      WeightRegistry::Global().ShareScope(raw_predictor_->scope());
+    }
   } else {
     raw_predictor_->PrepareFeedFetch();
     CHECK(raw_predictor_) << "The Predictor can not be nullptr in Clone mode.";
   }
+  if (config.depth_first_tiling()) {
+    raw_predictor_->EnableDepthFirstTiling(config.depth_first_band_bytes());
+  }
+  if (!config.request_trace_path().empty()) {
+    request_trace_ =
+        lite_api::RequestTraceWriter::Open(config.request_trace_path(),
+                                           config.request_trace_sample_rate(),
+                                           config.request_trace_max_requests());
+  }
 
 #ifdef LITE_WITH_METAL
   raw_predictor_->ConfigMetalContext(config);
@@ -263,12 +290,48 @@ std::vector<std::string> CxxPaddleApiImpl::GetOutputNames() {
 }
 
 void CxxPaddleApiImpl::Run() {
+  lite::host::AllocatorGuard allocator_guard(
+      static_cast<lite::host::AllocatorKind>(config_.host_allocator()));
+#if (defined LITE_WITH_X86) && !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
+  // The calling thread is pinned for the run only, its affinity is
+  // restored after it.
+  std::unique_ptr<x86::NumaNodeScope> numa_scope;
+  if (config_.x86_numa_node() >= 0) {
+    numa_scope.reset(new x86::NumaNodeScope(config_.x86_numa_node()));
+    x86::BindWorkerThreadsToNumaNode(config_.x86_numa_node(),
+                                     config_.x86_math_num_threads());
+  }
+#endif
 #ifdef LITE_WITH_ARM
   lite::DeviceInfo::Global().SetRunMode(mode_, threads_);
 #endif
+  if (request_trace_) request_trace_->Record(this);
   raw_predictor_->Run();
 }
 
+void CxxPaddleApiImpl::WarmUp() {
+  // The warm-up thread gets the allocator and the NUMA node Run uses, the
+  // run mode and the allocator are kept per thread.
+  auto allocator =
+      static_cast<lite::host::AllocatorKind>(config_.host_allocator());
+  int numa_node = config_.x86_numa_node();
+  int math_threads = config_.x86_math_num_threads();
+  auto mode = mode_;
+  int threads = threads_;
+  raw_predictor_->WarmUp([=]() {
+#ifdef LITE_WITH_ARM
+    lite::DeviceInfo::Global().SetRunMode(mode, threads);
+#endif
+    lite::host::SetCurrentAllocator(allocator);
+#if (defined LITE_WITH_X86) && !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
+    if (numa_node >= 0) {
+      x86::BindThreadToNumaNode(numa_node);
+      x86::BindWorkerThreadsToNumaNode(numa_node, math_threads);
+    }
+#endif
+  });
+}
+
 std::shared_ptr<lite_api::PaddlePredictor> CxxPaddleApiImpl::Clone() {
   std::lock_guard<std::mutex> lock(mutex_);
   auto predictor =
@@ -286,6 +349,38 @@ std::shared_ptr<lite_api::PaddlePredictor> CxxPaddleApiImpl::Clone(
   return predictor;
 }
 
+std::shared_ptr<lite_api::PaddlePredictor> CxxPaddleApiImpl::CloneOnNumaNode(
+    int node) {
+#if (defined LITE_WITH_X86) && !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
+  std::lock_guard<std::mutex> lock(mutex_);
+  // The private copies of the weights are first touched, so placed, on the
+  // node while the thread is pinned to it.
+  x86::NumaNodeScope numa_scope(node);
+  std::vector<std::string> weights;
+  for (auto &name : raw_predictor_->GetParamNames()) {
+    auto *var = raw_predictor_->scope()->FindVar(name);
+    if (var && var->IsType<lite::Tensor>()) weights.push_back(name);
+  }
+  auto predictor = std::make_shared<lite::CxxPaddleApiImpl>(
+      raw_predictor_->Clone(weights));
+  auto config = config_;
+  config.set_x86_numa_node(node);
+  predictor->Init(config);
+  return predictor;
+#else
+  return lite_api::PaddlePredictor::CloneOnNumaNode(node);
+#endif
+}
+
+void CxxPaddleApiImpl::BindOutput(int i,
+                                  void *data,
+                                  size_t memory_size,
+                                  TargetType target) {
+  raw_predictor_->BindOutput(i, data, memory_size, target);
+}
+
+void CxxPaddleApiImpl::UnbindOutput(int i) { raw_predictor_->UnbindOutput(i); }
+
 std::string CxxPaddleApiImpl::GetVersion() const { return version(); }
 
 std::unique_ptr<const lite_api::Tensor> CxxPaddleApiImpl::GetTensor(
@@ -15,6 +15,9 @@
 #include "lite/api/light_api.h"
 #include <algorithm>
 #include <map>
+#include <set>
+#include "lite/backends/host/math/half_weight.h"
+#include "lite/core/weight_registry.h"
 #ifdef ENABLE_ARM_FP16
 #include "lite/backends/arm/math/fp16/funcs_fp16.h"
 #endif
@@ -23,21 +26,21 @@ namespace paddle {
 namespace lite {
 
 void LightPredictor::Build(const std::string& lite_model_file,
-                           bool model_from_memory) {
+                           bool model_from_memory,
+                           bool weight_streaming) {
   if (model_from_memory) {
     LoadModelNaiveFromMemory(
         lite_model_file, scope_.get(), program_desc_.get());
+  } else if (weight_streaming) {
+    weight_stream_ = LoadModelNaiveFromFileStreaming(
+        lite_model_file, scope_.get(), program_desc_.get());
   } else {
     LoadModelNaiveFromFile(lite_model_file, scope_.get(), program_desc_.get());
   }
 
-  // For weight quantization of post training, load the int8/16 weights
-  // for optimized model, and dequant it to fp32.
-  DequantizeWeight();
-#ifdef ENABLE_ARM_FP16
-  // fp16 Weight convert
-  WeightFP32ToFP16();
-#endif
+  // The streamed weights are prepared by the first run of the ops reading
+  // them, see RuntimeProgram.
+  if (!weight_stream_) PrepareAllWeights();
   BuildRuntimeProgram(program_desc_);
   PrepareFeedFetch();
 }
@@ -66,28 +69,25 @@ void LightPredictor::Build(const std::string& model_dir,
       LOG(FATAL) << "Unknown model type";
   }
 
-  DequantizeWeight();
-
-#ifdef ENABLE_ARM_FP16
-  // fp16 Weight convert
-  WeightFP32ToFP16();
-#endif
+  PrepareAllWeights();
   BuildRuntimeProgram(program_desc_);
   PrepareFeedFetch();
 }
 
 #if !defined(LITE_WITH_FPGA) && !defined(LITE_WITH_METAL)
 Tensor* LightPredictor::GetInput(size_t offset) {
-  CHECK(input_names_.size() > offset)
-      << "The network has " << input_names_.size() << " inputs"
+  StopWarmUp();
+  CHECK(input_vars_.size() > offset)
+      << "The network has " << input_vars_.size() << " inputs"
       << ", the offset should be less than this.";
-  auto* in_var = program_->exec_scope()->FindVar(input_names_[offset]);
+  auto* in_var = input_vars_[offset];
   CHECK(in_var) << "no fatch variable " << input_names_[offset]
                 << " in exec_scope";
   return in_var->GetMutable<lite::Tensor>();
 }
 #else
 Tensor* LightPredictor::GetInput(size_t offset) {
+  StopWarmUp();
   auto* _feed_list = program_->exec_scope()->FindVar("feed");
   CHECK(_feed_list) << "no feed variable in exec_scope";
   auto* feed_list = _feed_list->GetMutable<std::vector<lite::Tensor>>();
@@ -100,8 +100,8 @@ Tensor* LightPredictor::GetInput(size_t offset) {
 
 // get input by name
 Tensor* LightPredictor::GetInputByName(const std::string& name) {
-  auto element = std::find(input_names_.begin(), input_names_.end(), name);
-  if (element == input_names_.end()) {
+  auto element = input_ids_.find(name);
+  if (element == input_ids_.end()) {
     LOG(ERROR) << "Model do not have input named with: [" << name
                << "], model's inputs include:";
     for (size_t i = 0; i < input_names_.size(); i++) {
@@ -109,15 +109,14 @@ Tensor* LightPredictor::GetInputByName(const std::string& name) {
     }
     return nullptr;
   } else {
-    int position = std::distance(input_names_.begin(), element);
-    return GetInput(position);
+    return GetInput(element->second);
   }
 }
 
 // get output by name
 const lite::Tensor* LightPredictor::GetOutputByName(const std::string& name) {
-  auto element = std::find(output_names_.begin(), output_names_.end(), name);
-  if (element == output_names_.end()) {
+  auto element = output_ids_.find(name);
+  if (element == output_ids_.end()) {
     LOG(ERROR) << "Model do not have output named with: [" << name
                << "], model's outputs include:";
     for (size_t i = 0; i < output_names_.size(); i++) {
@@ -125,23 +124,24 @@ const lite::Tensor* LightPredictor::GetOutputByName(const std::string& name) {
     }
     return nullptr;
   } else {
-    int position = std::distance(output_names_.begin(), element);
-    return GetOutput(position);
+    return GetOutput(element->second);
   }
 }
 
 #if !defined(LITE_WITH_METAL)
 const Tensor* LightPredictor::GetOutput(size_t offset) {
-  CHECK(output_names_.size() > offset)
-      << "The network has " << output_names_.size() << " outputs"
+  StopWarmUp();
+  CHECK(output_vars_.size() > offset)
+      << "The network has " << output_vars_.size() << " outputs"
       << ", the offset should be less than this.";
-  auto* out_var = program_->exec_scope()->FindVar(output_names_.at(offset));
+  auto* out_var = output_vars_[offset];
   CHECK(out_var) << "no fatch variable " << output_names_.at(offset)
                  << " in exec_scope";
   return out_var->GetMutable<lite::Tensor>();
 }
 #else
 const lite::Tensor* LightPredictor::GetOutput(size_t offset) {
+  StopWarmUp();
   auto* _fetch_list = program_->exec_scope()->FindVar("fetch");
   CHECK(_fetch_list) << "no fetch variable in exec_scope";
   auto& fetch_list = *_fetch_list->GetMutable<std::vector<lite::Tensor>>();
@@ -150,6 +150,35 @@ const lite::Tensor* LightPredictor::GetOutput(size_t offset) {
 }
 #endif
 
+void LightPredictor::ShareWeights() {
+  // The streamed weights must all be in place and prepared before they are
+  // hashed.
+  if (weight_stream_) PrepareAllWeights();
+  WeightRegistry::Global().Enable();
+  WeightRegistry::Global().ShareScope(scope_.get());
+}
+
+void LightPredictor::BindOutput(size_t offset,
+                                void* data,
+                                size_t memory_size,
+                                TargetType target) {
+  StopWarmUp();
+  CHECK_LT(offset, output_names_.size()) << "offset " << offset << " overflow";
+  program_->BindExternalOutput(
+      output_names_[offset], data, memory_size, target);
+}
+
+void LightPredictor::UnbindOutput(size_t offset) {
+  StopWarmUp();
+  CHECK_LT(offset, output_names_.size()) << "offset " << offset << " overflow";
+  program_->UnbindExternalOutput(output_names_[offset]);
+}
+
+void LightPredictor::EnableDepthFirstTiling(size_t band_bytes) {
+  StopWarmUp();
+  program_->EnableDepthFirstTiling(band_bytes);
+}
+
 // get inputs names
 std::vector<std::string> LightPredictor::GetInputNames() {
   return input_names_;
@@ -188,6 +217,21 @@ void LightPredictor::PrepareFeedFetch() {
     output_names_[fetchs[i]->GetAttr<int>("col")] =
         fetchs[i]->Input("X").front();
   }
+  // Resolve the feed/fetch variables once, so that the per-request accessors
+  // do not have to search the scopes by name.
+  auto* exec_scope = program_->exec_scope();
+  input_vars_.resize(input_names_.size());
+  input_ids_.clear();
+  for (size_t i = 0; i < input_names_.size(); i++) {
+    input_vars_[i] = exec_scope->FindVar(input_names_[i]);
+    input_ids_[input_names_[i]] = i;
+  }
+  output_vars_.resize(output_names_.size());
+  output_ids_.clear();
+  for (size_t i = 0; i < output_names_.size(); i++) {
+    output_vars_[i] = exec_scope->FindVar(output_names_[i]);
+    output_ids_[output_names_[i]] = i;
+  }
   for (size_t i = 0; i < feeds.size(); i++) {
     input_precisions_[i] = GetInput(i)->precision();
   }
@@ -228,12 +272,46 @@ void LightPredictor::BuildRuntimeProgram(
   }
   // Only extracting the ops and generate the runtime program from the main
   // block desc
-  program_.reset(new RuntimeProgram(program_desc, exe_scope, kRootBlockIdx));
+  std::function<void(int, size_t)> prepare_weights;
+  if (weight_stream_) {
+    prepare_weights = [this](int block_idx, size_t op_idx) {
+      PrepareWeights(block_idx, op_idx);
+    };
+  }
+  program_.reset(new RuntimeProgram(program_desc,
+                                    exe_scope,
+                                    kRootBlockIdx,
+                                    weight_stream_,
+                                    prepare_weights));
 }
 
-void LightPredictor::DequantizeWeight() {
-  std::shared_ptr<const cpp::ProgramDesc> program_desc = program_desc_;
-  CHECK(program_desc != nullptr);
+void LightPredictor::PrepareWeights(int block_idx, size_t op_idx) {
+  auto* block = program_desc_->GetBlock<cpp::BlockDesc>(block_idx);
+  CHECK(block != nullptr);
+  auto* op_desc = block->GetOp<cpp::OpDesc>(op_idx);
+  CHECK(op_desc != nullptr);
+  // For weight quantization of post training, load the int8/16 weights
+  // for optimized model, and dequant it to fp32.
+  DequantizeWeight(*op_desc);
+  ExpandHalfWeight(op_desc);
+#ifdef ENABLE_ARM_FP16
+  // fp16 Weight convert
+  WeightFP32ToFP16(*op_desc);
+#endif
+}
+
+void LightPredictor::PrepareAllWeights() {
+  if (weight_stream_) weight_stream_->WaitAll();
+  for (size_t i = 0; i < program_desc_->BlocksSize(); i++) {
+    auto* block = program_desc_->GetBlock<cpp::BlockDesc>(i);
+    CHECK(block != nullptr);
+    for (size_t k = 0; k < block->OpsSize(); ++k) {
+      PrepareWeights(i, k);
+    }
+  }
+}
+
+void LightPredictor::DequantizeWeight(const cpp::OpDesc& op_desc) {
 #define PROCESS_CONV2D_DATA()                                             \
   for (int64_t i = 0; i < ch; ++i) {                                      \
     for (int64_t j = 0; j < offset; ++j) {                                \
@@ -248,86 +326,78 @@ void LightPredictor::DequantizeWeight() {
     }                                                                   \
   }
 
-  auto is_weight_quantized_op = [](const cpp::OpDesc* op_desc) {
-    CHECK(op_desc != nullptr);
+  auto is_weight_quantized_op = [](const cpp::OpDesc& op_desc) {
     bool result = false;
-    if (op_desc->HasAttr("quantization_type")) {
-      std::string type = op_desc->GetAttr<std::string>("quantization_type");
+    if (op_desc.HasAttr("quantization_type")) {
+      std::string type = op_desc.GetAttr<std::string>("quantization_type");
       result = (type == "post_weight_abs_max") ||
                (type == "post_weight_channel_wise_abs_max");
     } else {
-      result = op_desc->HasAttr("quantize_weight_bits");
+      result = op_desc.HasAttr("quantize_weight_bits");
     }
     return result;
   };
+  if (!is_weight_quantized_op(op_desc)) return;
   Tensor tmp_tensor;
-  for (size_t i = 0; i < program_desc->BlocksSize(); i++) {
-    auto* block = program_desc->GetBlock<cpp::BlockDesc>(i);
-    CHECK(block != nullptr);
-    for (size_t k = 0; k < block->OpsSize(); ++k) {
-      auto* op_desc = block->GetOp<cpp::OpDesc>(k);
-      CHECK(op_desc != nullptr);
-      if (is_weight_quantized_op(op_desc)) {
-        auto input_names = op_desc->input_vars();
-        for (auto& input_name : input_names) {
-          std::string input_scale_name = input_name + "_quant_scale";
-          size_t found = input_name.find("/target_trans");
-          std::string input_scale_name_alias = "";
-          if (found != std::string::npos) {
-            input_scale_name_alias =
-                input_name.substr(0, found) + "_quant_scale";
-          }
-          if (op_desc->HasAttr(input_scale_name) ||
-              (!input_scale_name_alias.empty() &&
-               op_desc->HasAttr(
-                   input_scale_name_alias))) {  // the input is quantized
-            if (!input_scale_name_alias.empty()) {
-              input_scale_name = input_scale_name_alias;
-              input_name = input_name.substr(0, found);
-            }
-            auto input_tensor =
-                scope_->FindVar(input_name)->GetMutable<lite::Tensor>();
-            CHECK(input_tensor != nullptr);
-            tmp_tensor.CopyDataFrom(*input_tensor);
-            auto scale_list =
-                op_desc->GetAttr<std::vector<float>>(input_scale_name);
-
-            int quantize_weight_bits =
-                op_desc->GetAttr<int>("quantize_weight_bits");
-            CHECK(quantize_weight_bits == 8 || quantize_weight_bits == 16);
-            float* fp_data = input_tensor->mutable_data<float>();
-            CHECK(fp_data != nullptr);
-
-            std::string op_type = op_desc->Type();
-            if (op_type == "conv2d" || op_type == "depthwise_conv2d") {
-              int64_t ch = input_tensor->dims()[0];
-              int64_t offset = input_tensor->numel() / ch;
-              CHECK_EQ(scale_list.size(), ch);
-              if (quantize_weight_bits == 8) {
-                const int8_t* int_data = tmp_tensor.data<int8_t>();
-                CHECK(int_data != nullptr);
-                PROCESS_CONV2D_DATA()
-              } else {
-                const int16_t* int_data = tmp_tensor.data<int16_t>();
-                CHECK(int_data != nullptr);
-                PROCESS_CONV2D_DATA()
-              }
-            } else if (op_type == "fc" || op_type == "mul" ||
-                       op_type == "lookup_table") {
-              int64_t chin = input_tensor->dims()[0];
-              int64_t chout = input_tensor->dims()[1];
-              CHECK_EQ(scale_list.size(), chout);
-              if (quantize_weight_bits == 8) {
-                const int8_t* int_data = tmp_tensor.data<int8_t>();
-                CHECK(int_data != nullptr);
-                PROCESS_FC_DATA()
-              } else {
-                const int16_t* int_data = tmp_tensor.data<int16_t>();
-                CHECK(int_data != nullptr);
-                PROCESS_FC_DATA()
-              }
-            }
-          }
+  auto input_names = op_desc.input_vars();
+  for (auto& input_name : input_names) {
+    std::string input_scale_name = input_name + "_quant_scale";
+    size_t found = input_name.find("/target_trans");
+    std::string input_scale_name_alias = "";
+    if (found != std::string::npos) {
+      input_scale_name_alias = input_name.substr(0, found) + "_quant_scale";
+    }
+    if (op_desc.HasAttr(input_scale_name) ||
+        (!input_scale_name_alias.empty() &&
+         op_desc.HasAttr(input_scale_name_alias))) {  // the input is quantized
+      if (!input_scale_name_alias.empty()) {
+        input_scale_name = input_scale_name_alias;
+        input_name = input_name.substr(0, found);
+      }
+      auto input_tensor =
+          scope_->FindVar(input_name)->GetMutable<lite::Tensor>();
+      CHECK(input_tensor != nullptr);
+      // Already dequantized for another op reading the same weight.
+      if (input_tensor->precision() != PRECISION(kInt8) &&
+          input_tensor->precision() != PRECISION(kInt16)) {
+        continue;
+      }
+      tmp_tensor.CopyDataFrom(*input_tensor);
+      auto scale_list = op_desc.GetAttr<std::vector<float>>(input_scale_name);
+
+      int quantize_weight_bits = op_desc.GetAttr<int>("quantize_weight_bits");
+      CHECK(quantize_weight_bits == 8 || quantize_weight_bits == 16);
+      float* fp_data = input_tensor->mutable_data<float>();
+      CHECK(fp_data != nullptr);
+
+      std::string op_type = op_desc.Type();
+      if (op_type == "conv2d" || op_type == "depthwise_conv2d") {
+        int64_t ch = input_tensor->dims()[0];
+        int64_t offset = input_tensor->numel() / ch;
+        CHECK_EQ(scale_list.size(), ch);
+        if (quantize_weight_bits == 8) {
+          const int8_t* int_data = tmp_tensor.data<int8_t>();
+          CHECK(int_data != nullptr);
+          PROCESS_CONV2D_DATA()
+        } else {
+          const int16_t* int_data = tmp_tensor.data<int16_t>();
+          CHECK(int_data != nullptr);
+          PROCESS_CONV2D_DATA()
+        }
+      } else if (op_type == "fc" || op_type == "mul" ||
+                 op_type == "lookup_table" || op_type == "matmul" ||
+                 op_type == "matmul_v2") {
+        int64_t chin = input_tensor->dims()[0];
+        int64_t chout = input_tensor->dims()[1];
+        CHECK_EQ(scale_list.size(), chout);
+        if (quantize_weight_bits == 8) {
+          const int8_t* int_data = tmp_tensor.data<int8_t>();
+          CHECK(int_data != nullptr);
+          PROCESS_FC_DATA()
+        } else {
+          const int16_t* int_data = tmp_tensor.data<int16_t>();
+          CHECK(int_data != nullptr);
+          PROCESS_FC_DATA()
         }
       }
     }
@@ -337,49 +407,88 @@ void LightPredictor::DequantizeWeight() {
 #undef PROCESS_FC_DATA
 }
 
+// Whether the kernel picked for `op_desc` by opt reads fp16/bf16 weights.
+static bool KernelReadsHalfWeight(const cpp::OpDesc& op_desc) {
+  static const std::set<std::string> kHalfWeightX86Ops{"fc",
+                                                       "mul",
+                                                       "matmul",
+                                                       "lookup_table",
+                                                       "lookup_table_v2",
+                                                       "embedding_bag"};
+  if (!op_desc.HasAttr(kKernelTypeAttr)) return false;
+  std::string op_type, alias;
+  Place place;
+  KernelBase::ParseKernelType(
+      op_desc.GetAttr<std::string>(kKernelTypeAttr), &op_type, &alias, &place);
+  return place.target == TARGET(kX86) &&
+         place.precision == PRECISION(kFloat) &&
+         kHalfWeightX86Ops.count(op_type);
+}
+
+void LightPredictor::ExpandHalfWeight(cpp::OpDesc* op_desc) {
+  if (!op_desc->HasAttr("half_weight_type") ||
+      KernelReadsHalfWeight(*op_desc)) {
+    return;
+  }
+  const std::vector<std::string> weight_args{"W", "Y"};
+  bool bf16 = op_desc->GetAttr<std::string>("half_weight_type") ==
+              host::math::kHalfWeightBF16;
+  for (auto& arg : weight_args) {
+    if (!op_desc->HasInput(arg) || op_desc->Input(arg).empty()) continue;
+    auto input_tensor = scope_->FindVar(op_desc->Input(arg).front())
+                            ->GetMutable<lite::Tensor>();
+    if (input_tensor->precision() != PRECISION(kInt16)) continue;
+
+    Tensor tmp_tensor;
+    tmp_tensor.CopyDataFrom(*input_tensor);
+    input_tensor->clear();
+    input_tensor->set_precision(PRECISION(kFloat));
+    const uint16_t* in_data =
+        reinterpret_cast<const uint16_t*>(tmp_tensor.data<int16_t>());
+    float* fp_data = input_tensor->mutable_data<float>();
+    for (int64_t j = 0; j < input_tensor->numel(); j++) {
+      fp_data[j] = bf16 ? host::math::bf16_to_float(in_data[j])
+                        : host::math::fp16_to_float(in_data[j]);
+    }
+  }
+  op_desc->DeleteAttr("half_weight_type");
+}
+
 #ifdef ENABLE_ARM_FP16
 typedef __fp16 float16_t;
-void LightPredictor::WeightFP32ToFP16() {
-  std::shared_ptr<const cpp::ProgramDesc> program_desc = program_desc_;
-  std::vector<std::string> fp16_ops{"conv2d",
-                                    "depthwise_conv2d",
-                                    "conv2d_transpose",
-                                    "fc",
-                                    "gru",
-                                    "sequence_conv",
-                                    "elementwise_add",
-                                    "elementwise_sub",
-                                    "elementwise_div",
-                                    "elementwise_mul",
-                                    "prelu"};
-  for (size_t i = 0; i < program_desc->BlocksSize(); i++) {
-    auto* block = program_desc->GetBlock<cpp::BlockDesc>(i);
-    for (size_t k = 0; k < block->OpsSize(); ++k) {
-      auto* op_desc = block->GetOp<cpp::OpDesc>(k);
-      std::string op_type = op_desc->Type();
-      auto iter = std::find(fp16_ops.begin(), fp16_ops.end(), op_type);
-      if (iter != fp16_ops.end()) {
-        auto input_names = op_desc->input_vars();
-        for (auto& input_name : input_names) {
-          std::string input_weight_name = input_name + "_fp16";
-          if (op_desc->HasAttr(input_weight_name)) {  // the input is fp16
-            Tensor tmp_tensor;
-            auto input_tensor =
-                scope_->FindVar(input_name)->GetMutable<lite::Tensor>();
-
-            if (input_tensor->precision() != PRECISION(kFloat)) continue;
-
-            tmp_tensor.CopyDataFrom(*input_tensor);
-            input_tensor->clear();
-            input_tensor->set_precision(PRECISION(kFP16));
-
-            float16_t* fp_data = input_tensor->mutable_data<float16_t>();
-            const float* in_data = tmp_tensor.data<float>();
-            lite::arm::math::fp16::fp32_to_fp16(
-                in_data, fp_data, input_tensor->numel());
-          }
-        }
-      }
+void LightPredictor::WeightFP32ToFP16(const cpp::OpDesc& op_desc) {
+  static const std::vector<std::string> fp16_ops{"conv2d",
+                                                 "depthwise_conv2d",
+                                                 "conv2d_transpose",
+                                                 "fc",
+                                                 "gru",
+                                                 "sequence_conv",
+                                                 "elementwise_add",
+                                                 "elementwise_sub",
+                                                 "elementwise_div",
+                                                 "elementwise_mul",
+                                                 "prelu"};
+  std::string op_type = op_desc.Type();
+  auto iter = std::find(fp16_ops.begin(), fp16_ops.end(), op_type);
+  if (iter == fp16_ops.end()) return;
+  auto input_names = op_desc.input_vars();
+  for (auto& input_name : input_names) {
+    std::string input_weight_name = input_name + "_fp16";
+    if (op_desc.HasAttr(input_weight_name)) {  // the input is fp16
+      Tensor tmp_tensor;
+      auto input_tensor =
+          scope_->FindVar(input_name)->GetMutable<lite::Tensor>();
+
+      if (input_tensor->precision() != PRECISION(kFloat)) continue;
+
+      tmp_tensor.CopyDataFrom(*input_tensor);
+      input_tensor->clear();
+      input_tensor->set_precision(PRECISION(kFP16));
+
+      float16_t* fp_data = input_tensor->mutable_data<float16_t>();
+      const float* in_data = tmp_tensor.data<float>();
+      lite::arm::math::fp16::fp32_to_fp16(
+          in_data, fp_data, input_tensor->numel());
     }
   }
 }
@@ -398,7 +507,19 @@ void LightPredictor::CheckInputValid() {
   }
 }
 
+void LightPredictor::WarmUp(const std::function<void()>& thread_init) {
+  // An op failing on a missing input would abort the background thread,
+  // check the inputs here instead.
+  for (size_t i = 0; i < input_names_.size(); i++) {
+    CHECK(GetInput(i)->IsInitialized())
+        << "The input " << input_names_[i] << " must be set before WarmUp.";
+  }
+  program_->StartWarmUp(thread_init);
+  warming_up_ = true;
+}
+
 bool LightPredictor::TryShrinkMemory() {
+  StopWarmUp();
 #ifdef LITE_WITH_ARM
   // Clear ArmL3Cache
   lite::DeviceInfo::Global().ClearArmL3Cache();
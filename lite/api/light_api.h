@@ -19,12 +19,16 @@
 #pragma once
 
 #include <algorithm>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include "lite/api/paddle_api.h"
+#include "lite/api/request_trace.h"
+#include "lite/backends/host/allocator.h"
 #include "lite/core/context.h"
 #include "lite/core/program.h"
 #include "lite/core/tensor.h"
@@ -42,12 +46,14 @@ class LITE_API LightPredictor {
  public:
   // constructor function of LightPredictor, `lite_model_file` refers to data in
   // model file or buffer,`model_from_memory` refers to whther to load model
-  // from memory.
+  // from memory. With `weight_streaming` the weights of a model file are
+  // filled in the background, see MobileConfig::set_weight_streaming.
   LightPredictor(const std::string& lite_model_file,
-                 bool model_from_memory = false) {
+                 bool model_from_memory = false,
+                 bool weight_streaming = false) {
     scope_ = std::make_shared<Scope>();
     program_desc_ = std::make_shared<cpp::ProgramDesc>();
-    Build(lite_model_file, model_from_memory);
+    Build(lite_model_file, model_from_memory, weight_streaming);
   }
 
   // NOTE: This is a deprecated API and will be removed in latter release.
@@ -63,11 +69,16 @@ class LITE_API LightPredictor {
   }
 
   void Run() {
+    StopWarmUp();
     CheckInputValid();
     program_->Run();
     if (bool_clear_tensor_) ClearTensorArray(program_desc_);
   }
 
+  // Run the program once on the inputs on a background thread, see
+  // RuntimeProgram::StartWarmUp. All the inputs must be set.
+  void WarmUp(const std::function<void()>& thread_init = nullptr);
+
   /// \brief Release all tmp tensor to compress the size of the memory pool.
   /// The memory pool is considered to be composed of a list of chunks, if
   /// the chunk is not occupied, it can be released.
@@ -83,8 +94,23 @@ class LITE_API LightPredictor {
   const Tensor* GetOutputByName(const std::string& name);
   // Get offset-th col of fetch outputs.
   const Tensor* GetOutput(size_t offset);
+  // Let the op producing the offset-th output write it into `data`, see
+  // RuntimeProgram::BindExternalOutput.
+  void BindOutput(size_t offset,
+                  void* data,
+                  size_t memory_size,
+                  TargetType target);
+  void UnbindOutput(size_t offset);
+  // See RuntimeProgram::EnableDepthFirstTiling.
+  void EnableDepthFirstTiling(size_t band_bytes);
+
+  // Keep one copy of the weights identical to those of the other models of
+  // the process, see WeightRegistry.
+  void ShareWeights();
 
   const lite::Tensor* GetTensor(const std::string& name) const {
+    if (weight_stream_) weight_stream_->WaitAll();
+    program_->StopWarmUp();
     auto* var = program_->exec_scope()->FindVar(name);
     CHECK(var) << "no fatch variable " << name << " in exec_scope";
     return &var->Get<lite::Tensor>();
@@ -114,7 +140,8 @@ class LITE_API LightPredictor {
   void CheckInputValid();
 
   void Build(const std::string& lite_model_file,
-             bool model_from_memory = false);
+             bool model_from_memory = false,
+             bool weight_streaming = false);
 
   // NOTE: This is a deprecated API and will be removed in latter release.
   void Build(
@@ -127,23 +154,52 @@ class LITE_API LightPredictor {
   void BuildRuntimeProgram(
       const std::shared_ptr<const cpp::ProgramDesc>& program_desc);
 
-  void DequantizeWeight();
+  // Converts the weights read by op `op_idx` of block `block_idx` to what
+  // its kernel reads. Runs at Build, or on the first run of the op when the
+  // weights are streamed, and converts each weight once.
+  void PrepareWeights(int block_idx, size_t op_idx);
+  // Waits for the streamed weights and prepares those of every op.
+  void PrepareAllWeights();
+
+  void DequantizeWeight(const cpp::OpDesc& op_desc);
+
+  // The weights stored as fp16/bf16 for QUANT_FP16/QUANT_BF16 are only read
+  // by the x86 float kernels, expand them to fp32 for the ops whose picked
+  // kernel runs on another target.
+  void ExpandHalfWeight(cpp::OpDesc* op_desc);
 
 #ifdef ENABLE_ARM_FP16
-  void WeightFP32ToFP16();
+  void WeightFP32ToFP16(const cpp::OpDesc& op_desc);
 #endif
 
   void ClearTensorArray(
       const std::shared_ptr<const cpp::ProgramDesc>& program_desc);
 
+  // Waits for the warm-up before the inputs or the outputs are touched.
+  void StopWarmUp() {
+    if (!warming_up_) return;
+    program_->StopWarmUp();
+    warming_up_ = false;
+    if (bool_clear_tensor_) ClearTensorArray(program_desc_);
+  }
+
  private:
   std::shared_ptr<Scope> scope_;
   std::unique_ptr<RuntimeProgram> program_;
   std::shared_ptr<cpp::ProgramDesc> program_desc_;
   std::vector<std::string> input_names_;
   std::vector<std::string> output_names_;
+  // Feed/fetch variables resolved in PrepareFeedFetch, indexed by column.
+  std::vector<Variable*> input_vars_;
+  std::vector<Variable*> output_vars_;
+  std::unordered_map<std::string, size_t> input_ids_;
+  std::unordered_map<std::string, size_t> output_ids_;
   std::vector<PrecisionType> input_precisions_;
   bool bool_clear_tensor_ = false;
+  bool warming_up_{false};
+  // Set while the weights are being filled in the background. Declared
+  // after `scope_` so that the loader is joined before the scope goes.
+  std::shared_ptr<WeightStream> weight_stream_;
 };
 
 class LightPredictorImpl : public lite_api::PaddlePredictor {
@@ -156,6 +212,12 @@ class LightPredictorImpl : public lite_api::PaddlePredictor {
   std::unique_ptr<const lite_api::Tensor> GetOutputByName(
       const std::string& name) const;
   void Run() override;
+  void WarmUp() override;
+  void BindOutput(int i,
+                  void* data,
+                  size_t memory_size,
+                  TargetType target = TargetType::kHost) override;
+  void UnbindOutput(int i) override;
 
   std::shared_ptr<lite_api::PaddlePredictor> Clone() override;
   std::shared_ptr<lite_api::PaddlePredictor> Clone(
@@ -178,6 +240,10 @@ class LightPredictorImpl : public lite_api::PaddlePredictor {
 
  private:
   std::unique_ptr<lite::LightPredictor> raw_predictor_;
+  lite::host::AllocatorKind host_allocator_{lite::host::AllocatorKind::kSystem};
+  int x86_numa_node_{-1};
+  int x86_math_num_threads_{1};
+  std::shared_ptr<lite_api::RequestTraceWriter> request_trace_;
 };
 
 }  // namespace lite
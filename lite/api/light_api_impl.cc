@@ -15,6 +15,7 @@
 #include "lite/api/light_api.h"
 #include <string>
 #include "lite/api/paddle_api.h"
+#include "lite/backends/host/allocator.h"
 #include "lite/core/version.h"
 #include "lite/model_parser/model_parser.h"
 #ifndef LITE_ON_TINY_PUBLISH
@@ -28,11 +29,26 @@
     !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
 #include "lite/backends/x86/mklml.h"
 #endif
+#if (defined LITE_WITH_X86) && !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
+#include "lite/backends/x86/cpu_info.h"
+#endif
 
 namespace paddle {
 namespace lite {
 
 void LightPredictorImpl::Init(const lite_api::MobileConfig& config) {
+  host_allocator_ =
+      static_cast<lite::host::AllocatorKind>(config.host_allocator());
+  lite::host::AllocatorGuard allocator_guard(host_allocator_);
+#if (defined LITE_WITH_X86) && !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
+  x86_numa_node_ = config.x86_numa_node();
+  x86_math_num_threads_ = config.x86_math_num_threads();
+  // Load on the node of the predictor, so the weights are placed there.
+  std::unique_ptr<x86::NumaNodeScope> numa_scope;
+  if (x86_numa_node_ >= 0) {
+    numa_scope.reset(new x86::NumaNodeScope(x86_numa_node_));
+  }
+#endif
   // LightPredictor Only support NaiveBuffer backend in publish lib
   if (config.lite_model_file().empty()) {
     raw_predictor_.reset(
@@ -43,7 +59,18 @@ void LightPredictorImpl::Init(const lite_api::MobileConfig& config) {
                            lite_api::LiteModelType::kNaiveBuffer));
   } else {
     raw_predictor_.reset(new LightPredictor(config.lite_model_file(),
-                                            config.is_model_from_memory()));
+                                            config.is_model_from_memory(),
+                                            config.weight_streaming()));
+  }
+  if (config.share_weights()) raw_predictor_->ShareWeights();
+  if (config.depth_first_tiling()) {
+    raw_predictor_->EnableDepthFirstTiling(config.depth_first_band_bytes());
+  }
+  if (!config.request_trace_path().empty()) {
+    request_trace_ =
+        lite_api::RequestTraceWriter::Open(config.request_trace_path(),
+                                           config.request_trace_sample_rate(),
+                                           config.request_trace_max_requests());
   }
   mode_ = config.power_mode();
   threads_ = config.threads();
@@ -122,12 +149,51 @@ std::unique_ptr<const lite_api::Tensor> LightPredictorImpl::GetOutput(
 }
 
 void LightPredictorImpl::Run() {
+  lite::host::AllocatorGuard allocator_guard(host_allocator_);
+#if (defined LITE_WITH_X86) && !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
+  // The calling thread is pinned for the run only, its affinity is
+  // restored after it.
+  std::unique_ptr<x86::NumaNodeScope> numa_scope;
+  if (x86_numa_node_ >= 0) {
+    numa_scope.reset(new x86::NumaNodeScope(x86_numa_node_));
+    x86::BindWorkerThreadsToNumaNode(x86_numa_node_, x86_math_num_threads_);
+  }
+#endif
 #ifdef LITE_WITH_ARM
   lite::DeviceInfo::Global().SetRunMode(mode_, threads_);
 #endif
+  if (request_trace_) request_trace_->Record(this);
   raw_predictor_->Run();
 }
 
+void LightPredictorImpl::WarmUp() {
+  // The run mode and the allocator are kept per thread, the warm-up is
+  // stopped before the predictor goes.
+  raw_predictor_->WarmUp([this]() {
+#ifdef LITE_WITH_ARM
+    lite::DeviceInfo::Global().SetRunMode(mode_, threads_);
+#endif
+    lite::host::SetCurrentAllocator(host_allocator_);
+#if (defined LITE_WITH_X86) && !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
+    if (x86_numa_node_ >= 0) {
+      x86::BindThreadToNumaNode(x86_numa_node_);
+      x86::BindWorkerThreadsToNumaNode(x86_numa_node_, x86_math_num_threads_);
+    }
+#endif
+  });
+}
+
+void LightPredictorImpl::BindOutput(int i,
+                                    void* data,
+                                    size_t memory_size,
+                                    TargetType target) {
+  raw_predictor_->BindOutput(i, data, memory_size, target);
+}
+
+void LightPredictorImpl::UnbindOutput(int i) {
+  raw_predictor_->UnbindOutput(i);
+}
+
 std::shared_ptr<lite_api::PaddlePredictor> LightPredictorImpl::Clone() {
   LOG(FATAL) << "The Clone API is not supported in LigthPredictor";
   return nullptr;
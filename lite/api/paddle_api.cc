@@ -16,6 +16,7 @@
 
 #include <utility>
 
+#include "lite/backends/host/allocator.h"
 #include "lite/core/context.h"
 #include "lite/core/device_info.h"
 #include "lite/core/target_wrapper.h"
@@ -113,6 +114,32 @@ void Tensor::ShareExternalMemory(void *data,
   tensor(raw_tensor_)->ResetBuffer(buf, memory_size);
 }
 
+// Leaves `x` with an empty buffer of its own, keeping the shape, LoD and
+// precision.
+static void DetachBuffer(lite::Tensor *x) {
+  lite::Tensor own;
+  own.Resize(x->dims());
+  own.set_lod(x->lod());
+  own.set_precision(x->precision());
+  x->ShareDataWith(own);
+}
+
+void Tensor::ReleaseExternalMemory() { DetachBuffer(tensor(raw_tensor_)); }
+
+void Tensor::MoveDataFrom(const Tensor &other) {
+  auto *x = tensor(raw_tensor_);
+  auto *src = tensor(other.raw_tensor_);
+  if (x == src) return;
+  if (src->buffer_shared() || src->offset() != 0) {
+    // The buffer is written again by the tensors which share it.
+    DetachBuffer(x);
+    x->CopyDataFrom(*src);
+    return;
+  }
+  x->ShareDataWith(*src);
+  DetachBuffer(src);
+}
+
 template <typename T>
 T *Tensor::mutable_data(TargetType type) const {
   return tensor(raw_tensor_)->mutable_data<T>(type);
@@ -284,6 +311,59 @@ std::unique_ptr<Tensor> PaddlePredictor::GetMutableTensor(
   return nullptr;
 }
 
+void SetHostAllocatorHook(void *(*malloc_fn)(size_t size, void *user_data),
+                          void (*free_fn)(void *ptr,
+                                          size_t size,
+                                          void *user_data),
+                          void *user_data) {
+  lite::host::SetAllocatorHook(malloc_fn, free_fn, user_data);
+}
+
+HostMemoryStats GetHostMemoryStats(HostAllocatorType type) {
+  auto stats =
+      lite::host::GetAllocator(static_cast<lite::host::AllocatorKind>(type))
+          ->stats();
+  HostMemoryStats res;
+  res.live_bytes = stats.live_bytes;
+  res.peak_bytes = stats.peak_bytes;
+  res.cached_bytes = stats.cached_bytes;
+  res.alloc_count = stats.alloc_count;
+  res.free_count = stats.free_count;
+  res.cache_hits = stats.cache_hits;
+  return res;
+}
+
+void ReleaseHostMemoryCache(HostAllocatorType type) {
+  lite::host::GetAllocator(static_cast<lite::host::AllocatorKind>(type))
+      ->Release();
+}
+
+void PaddlePredictor::WarmUp() {
+  LOG(WARNING) << "The WarmUp API is only supported by MobileConfig and "
+                  "CxxConfig predictors, the kernels are prepared by the "
+                  "first Run.";
+}
+
+std::shared_ptr<PaddlePredictor> PaddlePredictor::CloneOnNumaNode(int node) {
+  LOG(WARNING) << "The CloneOnNumaNode API is only supported by CxxConfig "
+                  "predictor on x86, the predictor is cloned without NUMA "
+                  "placement.";
+  return Clone();
+}
+
+void PaddlePredictor::BindOutput(int i,
+                                 void *data,
+                                 size_t memory_size,
+                                 TargetType target) {
+  LOG(FATAL) << "The BindOutput API is only supported by CxxConfig and "
+                "MobileConfig predictor.";
+}
+
+void PaddlePredictor::UnbindOutput(int i) {
+  LOG(FATAL) << "The UnbindOutput API is only supported by CxxConfig and "
+                "MobileConfig predictor.";
+}
+
 std::vector<std::string> PaddlePredictor::GetParamNames() {
   std::vector<std::string> null_result = {};
   LOG(FATAL)
@@ -422,6 +502,8 @@ void ConfigBase::set_x86_math_num_threads(int threads) {
   x86_math_num_threads_ = threads;
 }
 int ConfigBase::x86_math_num_threads() const { return x86_math_num_threads_; }
+void ConfigBase::set_x86_numa_node(int node) { x86_numa_node_ = node; }
+int ConfigBase::x86_numa_node() const { return x86_numa_node_; }
 #endif
 
 void ConfigBase::set_subgraph_model_cache_buffers(
@@ -42,6 +42,45 @@ enum class L3CacheSetMethod {
   // kAutoGrow = 3,   // Not supported yet, least memory consumption.
 };
 
+// Allocators of the host memory. There is one allocator of each type in the
+// process, shared by all the predictors which select it.
+enum class HostAllocatorType {
+  kSystem = 0,   // malloc and free for every buffer.
+  kCaching = 1,  // The freed blocks are kept in size classes and reused.
+  kCachingHugePages = 2,  // kCaching, the blocks from 2MB on are 2MB aligned
+                          // and advised as transparent huge pages.
+  kCustom = 3,            // The functions set by SetHostAllocatorHook.
+};
+
+// Counters of one HostAllocatorType over the whole process.
+struct LITE_API HostMemoryStats {
+  int64_t live_bytes{0};
+  int64_t peak_bytes{0};
+  // Freed blocks kept by the caching allocators.
+  int64_t cached_bytes{0};
+  int64_t alloc_count{0};
+  int64_t free_count{0};
+  // Allocations served from the cache.
+  int64_t cache_hits{0};
+};
+
+// Set the functions of HostAllocatorType::kCustom. `free_fn` gets the size
+// passed to `malloc_fn`, the blocks are returned to the functions which made
+// them even if other ones are set later.
+LITE_API void SetHostAllocatorHook(void* (*malloc_fn)(size_t size,
+                                                      void* user_data),
+                                   void (*free_fn)(void* ptr,
+                                                   size_t size,
+                                                   void* user_data),
+                                   void* user_data);
+
+// Counters of a host allocator, summed over all the predictors and threads
+// using it, not the memory of a single predictor.
+LITE_API HostMemoryStats GetHostMemoryStats(HostAllocatorType type);
+
+// Return the blocks cached by a caching host allocator to the system.
+LITE_API void ReleaseHostMemoryCache(HostAllocatorType type);
+
 // return true if current device supports OpenCL model
 LITE_API bool IsOpenCLBackendValid(bool check_fp16_valid = false);
 
@@ -69,6 +108,14 @@ struct LITE_API Tensor {
   // state
   // during the prediction process.
   void ShareExternalMemory(void* data, size_t memory_size, TargetType target);
+  // Stop using the memory given to ShareExternalMemory, the tensor gets
+  // memory of its own the next time it is written.
+  void ReleaseExternalMemory();
+  // Take over the memory of `other` with its shape, LoD and precision, and
+  // leave `other` to get memory of its own the next time it is written. It
+  // hands the output of a predictor on to another one without a copy, the
+  // memory is copied instead when other tensors of the predictor share it.
+  void MoveDataFrom(const Tensor& other);
 
   template <typename T, TargetType type = TargetType::kHost>
   void CopyFromCpu(const T* data);
@@ -121,6 +168,32 @@ class LITE_API PaddlePredictor {
   /// Release all tmp tensor to compress the size of the memory pool.
   virtual bool TryShrinkMemory() = 0;
 
+  /// Prepare the kernels in the background by running the model once on the
+  /// inputs, so that the first Run does not pay for it. All the inputs must
+  /// be set before. The next access to the inputs or the outputs, or Run,
+  /// stops the warm-up after the current op and waits for it. Supported by
+  /// the MobileConfig and CxxConfig predictors, it is a no-op otherwise.
+  virtual void WarmUp();
+
+  /// Clone the predictor for a NUMA node: the clone runs pinned to the node
+  /// and gets private copies of the weights placed on it, so that clones on
+  /// different sockets do not read weights over the interconnect. `node` is
+  /// a dense index over the nodes which have cpus, not the sysfs node id.
+  /// Only supported by CxxConfig predictor on x86, it falls back to Clone().
+  virtual std::shared_ptr<PaddlePredictor> CloneOnNumaNode(int node);
+
+  /// Let the op producing the i-th output write it directly into `data`,
+  /// which saves copying large outputs out after every Run. When the output
+  /// can not be written in place, because it does not fit or shares the
+  /// memory of another tensor, it is copied into `data` after Run instead.
+  /// `data` must stay valid until UnbindOutput. The counterpart of
+  /// Tensor::ShareExternalMemory for the inputs.
+  virtual void BindOutput(int i,
+                          void* data,
+                          size_t memory_size,
+                          TargetType target = TargetType::kHost);
+  virtual void UnbindOutput(int i);
+
   // Get Input by name
   virtual std::unique_ptr<Tensor> GetInputByName(const std::string& name) = 0;
 
@@ -174,6 +247,13 @@ class LITE_API ConfigBase {
   std::map<std::string, std::vector<char>> nnadapter_model_cache_buffers_{};
   int device_id_{0};
   int x86_math_num_threads_ = 1;
+  int x86_numa_node_ = -1;
+  bool share_weights_{false};
+  bool depth_first_tiling_{false};
+  size_t depth_first_band_bytes_{0};
+  std::string request_trace_path_;
+  double request_trace_sample_rate_{1.};
+  int64_t request_trace_max_requests_{0};
 
   std::string metal_path_;
   bool metal_use_mps_{false};
@@ -183,6 +263,8 @@ class LITE_API ConfigBase {
 
   std::vector<std::string> discarded_passes_{};
 
+  HostAllocatorType host_allocator_{HostAllocatorType::kSystem};
+
  public:
   explicit ConfigBase(PowerMode mode = LITE_POWER_NO_BIND, int threads = 1);
   // set Model_dir
@@ -306,6 +388,51 @@ class LITE_API ConfigBase {
   // set x86_math_num_threads
   void set_x86_math_num_threads(int threads);
   int x86_math_num_threads() const;
+  // Pin the threads running the predictor to a NUMA node, the weights are
+  // then first touched on that node. The node is a dense index over the
+  // nodes which have cpus, not the sysfs node id. The calling thread is
+  // pinned during Run only. -1 leaves the threads unpinned.
+  void set_x86_numa_node(int node);
+  int x86_numa_node() const;
+
+  // Keep a single copy of the weights which are identical in several models
+  // of the process, such as the fine-tuned variants of one backbone. The
+  // kernels then share their prepacked weights as well.
+  void set_share_weights(bool share) { share_weights_ = share; }
+  bool share_weights() const { return share_weights_; }
+
+  // Run the chains of consecutive convs of x86 models band by band of output
+  // rows, so the feature maps between them only exist for one band, which
+  // stays in the cache for large inputs. Only the convs of the direct and
+  // depthwise kernels are chained, so the results are bit-identical to the
+  // untiled run. `band_bytes` of 0 sizes the bands from the last level
+  // cache.
+  void set_depth_first_tiling(bool enable, size_t band_bytes = 0) {
+    depth_first_tiling_ = enable;
+    depth_first_band_bytes_ = band_bytes;
+  }
+  bool depth_first_tiling() const { return depth_first_tiling_; }
+  size_t depth_first_band_bytes() const { return depth_first_band_bytes_; }
+
+  // Record the inputs of about `sample_rate` of the requests to the trace
+  // `path`, which the benchmark tool replays with `--replay_trace_path`.
+  // `max_requests` of 0 records until the process exits. Inputs on a device
+  // are recorded with a copy on the host. Predictors which share a trace
+  // must use the same options.
+  void set_request_trace(const std::string& path,
+                         double sample_rate = 1.,
+                         int64_t max_requests = 0) {
+    request_trace_path_ = path;
+    request_trace_sample_rate_ = sample_rate;
+    request_trace_max_requests_ = max_requests;
+  }
+  const std::string& request_trace_path() const { return request_trace_path_; }
+  double request_trace_sample_rate() const {
+    return request_trace_sample_rate_;
+  }
+  int64_t request_trace_max_requests() const {
+    return request_trace_max_requests_;
+  }
 
   void set_metal_lib_path(const std::string& path);
   void set_metal_use_mps(bool flag);
@@ -323,6 +450,12 @@ class LITE_API ConfigBase {
   const std::vector<std::string> get_discarded_passes() const {
     return discarded_passes_;
   }
+
+  // The allocator of the host buffers made while the predictor is built and
+  // run, the buffers of the other threads use the system allocator. The
+  // allocator of each type is shared by the predictors of the process.
+  void set_host_allocator(HostAllocatorType type) { host_allocator_ = type; }
+  HostAllocatorType host_allocator() const { return host_allocator_; }
 };
 
 class LITE_API CxxModelBuffer {
@@ -541,6 +674,8 @@ class LITE_API MobileConfig : public ConfigBase {
   std::string model_buffer_;
   std::string param_buffer_;
 
+  bool weight_streaming_{false};
+
  public:
   // set model data in combined format, `set_model_from_file` refers to loading
   // model from file, set_model_from_buffer refers to loading model from memory
@@ -570,6 +705,14 @@ class LITE_API MobileConfig : public ConfigBase {
   // NOTE: This is a deprecated API and will be removed in latter release.
   const std::string& param_buffer() const { return param_buffer_; }
 
+  // Fill the weights of a model file on a background thread, in the order
+  // the program first reads them. The predictor is created before the
+  // weights are read, and each op waits for its own weights on its first
+  // run only. It shortens the cold start of large models, the models from
+  // memory and the old model formats are loaded at once.
+  void set_weight_streaming(bool x) { weight_streaming_ = x; }
+  bool weight_streaming() const { return weight_streaming_; }
+
   // This is the method for allocating workspace_size according to L3Cache size
   void SetArmL3CacheSize(
       L3CacheSetMethod method = L3CacheSetMethod::kDeviceL3Cache,
@@ -0,0 +1,243 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "lite/api/paddle_pipeline.h"
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <map>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <utility>
+#include "lite/core/tensor.h"
+#include "lite/utils/log/cp_logging.h"
+
+namespace paddle {
+namespace lite_api {
+
+struct PipelineRequest::Impl {
+  // The nodes of a map stay in place, so the tensors handed out stay valid
+  // when others are added.
+  std::map<std::string, lite::Tensor> tensors;
+  std::shared_ptr<void> user_data;
+};
+
+PipelineRequest::PipelineRequest() : impl_(new Impl) {}
+
+PipelineRequest::~PipelineRequest() = default;
+
+std::unique_ptr<Tensor> PipelineRequest::GetMutableTensor(
+    const std::string& name) {
+  return std::unique_ptr<Tensor>(new Tensor(&impl_->tensors[name]));
+}
+
+std::unique_ptr<const Tensor> PipelineRequest::GetTensor(
+    const std::string& name) const {
+  auto it = impl_->tensors.find(name);
+  if (it == impl_->tensors.end()) return nullptr;
+  return std::unique_ptr<const Tensor>(
+      new Tensor(static_cast<const void*>(&it->second)));
+}
+
+void PipelineRequest::RemoveTensor(const std::string& name) {
+  impl_->tensors.erase(name);
+}
+
+std::vector<std::string> PipelineRequest::GetTensorNames() const {
+  std::vector<std::string> names;
+  for (auto& item : impl_->tensors) {
+    names.push_back(item.first);
+  }
+  return names;
+}
+
+void PipelineRequest::set_user_data(std::shared_ptr<void> data) {
+  impl_->user_data = data;
+}
+
+std::shared_ptr<void> PipelineRequest::user_data() const {
+  return impl_->user_data;
+}
+
+// The requests between two stages, first in first out.
+class RequestQueue {
+ public:
+  explicit RequestQueue(size_t capacity) : capacity_(capacity) {}
+
+  // Block while the queue is full, return false once it is cancelled.
+  bool Push(std::unique_ptr<PipelineRequest> request) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    CHECK(!closed_) << "A request is pushed to a closed pipeline.";
+    not_full_.wait(
+        lock, [this]() { return cancelled_ || requests_.size() < capacity_; });
+    if (cancelled_) return false;
+    requests_.push_back(std::move(request));
+    not_empty_.notify_one();
+    return true;
+  }
+
+  // Block while the queue is empty, return null once it is closed and
+  // drained, or cancelled.
+  std::unique_ptr<PipelineRequest> Pop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(
+        lock, [this]() { return cancelled_ || closed_ || !requests_.empty(); });
+    if (cancelled_ || requests_.empty()) return nullptr;
+    auto request = std::move(requests_.front());
+    requests_.pop_front();
+    not_full_.notify_one();
+    return request;
+  }
+
+  void Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    not_empty_.notify_all();
+  }
+
+  void Cancel() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cancelled_ = true;
+    requests_.clear();
+    not_empty_.notify_all();
+    not_full_.notify_all();
+  }
+
+ private:
+  const size_t capacity_;
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::deque<std::unique_ptr<PipelineRequest>> requests_;
+  bool closed_{false};
+  bool cancelled_{false};
+};
+
+struct PaddlePipeline::Impl {
+  size_t queue_capacity{2};
+  std::vector<PipelineStage> stages;
+  // queues[i] feeds stages[i], the last one holds the finished requests.
+  std::vector<std::unique_ptr<RequestQueue>> queues;
+  std::vector<std::thread> threads;
+};
+
+PaddlePipeline::PaddlePipeline(int queue_capacity) : impl_(new Impl) {
+  CHECK_GT(queue_capacity, 0) << "The queue capacity must be positive.";
+  impl_->queue_capacity = queue_capacity;
+}
+
+PaddlePipeline::~PaddlePipeline() {
+  for (auto& queue : impl_->queues) {
+    queue->Cancel();
+  }
+  for (auto& thread : impl_->threads) {
+    thread.join();
+  }
+}
+
+void PaddlePipeline::AddPredictor(std::shared_ptr<PaddlePredictor> predictor,
+                                  const std::vector<std::string>& inputs,
+                                  const std::vector<std::string>& outputs) {
+  CHECK(predictor) << "The predictor of a pipeline stage is null.";
+  auto input_names = inputs.empty() ? predictor->GetInputNames() : inputs;
+  auto output_names = outputs.empty() ? predictor->GetOutputNames() : outputs;
+  CHECK_EQ(input_names.size(), predictor->GetInputNames().size())
+      << "The model has " << predictor->GetInputNames().size()
+      << " inputs, but " << input_names.size() << " tensors are given.";
+  CHECK_EQ(output_names.size(), predictor->GetOutputNames().size())
+      << "The model has " << predictor->GetOutputNames().size()
+      << " outputs, but " << output_names.size() << " tensors are given.";
+  AddStage([=](PipelineRequest* request) {
+    RunPredictor(predictor.get(), input_names, output_names, request);
+  });
+}
+
+void PaddlePipeline::AddStage(const PipelineStage& stage) {
+  CHECK(impl_->queues.empty()) << "The pipeline is started, no stage can be "
+                                  "added.";
+  CHECK(stage) << "The pipeline stage is empty.";
+  impl_->stages.push_back(stage);
+}
+
+void PaddlePipeline::Start() {
+  CHECK(impl_->queues.empty()) << "The pipeline is started already.";
+  CHECK(!impl_->stages.empty()) << "The pipeline has no stage.";
+  for (size_t i = 0; i <= impl_->stages.size(); ++i) {
+    impl_->queues.emplace_back(new RequestQueue(impl_->queue_capacity));
+  }
+  for (size_t i = 0; i < impl_->stages.size(); ++i) {
+    auto* in = impl_->queues[i].get();
+    auto* out = impl_->queues[i + 1].get();
+    auto* stage = &impl_->stages[i];
+    impl_->threads.emplace_back([in, out, stage]() {
+      while (auto request = in->Pop()) {
+        (*stage)(request.get());
+        if (!out->Push(std::move(request))) break;
+      }
+      out->Close();
+    });
+  }
+}
+
+void PaddlePipeline::Push(std::unique_ptr<PipelineRequest> request) {
+  CHECK(!impl_->queues.empty()) << "The pipeline is not started.";
+  CHECK(request) << "The pushed request is null.";
+  impl_->queues.front()->Push(std::move(request));
+}
+
+std::unique_ptr<PipelineRequest> PaddlePipeline::Pop() {
+  CHECK(!impl_->queues.empty()) << "The pipeline is not started.";
+  return impl_->queues.back()->Pop();
+}
+
+void PaddlePipeline::Close() {
+  CHECK(!impl_->queues.empty()) << "The pipeline is not started.";
+  impl_->queues.front()->Close();
+}
+
+void PaddlePipeline::Run(PipelineRequest* request) {
+  for (auto& stage : impl_->stages) {
+    stage(request);
+  }
+}
+
+void PaddlePipeline::RunPredictor(PaddlePredictor* predictor,
+                                  const std::vector<std::string>& inputs,
+                                  const std::vector<std::string>& outputs,
+                                  PipelineRequest* request) {
+  auto& tensors = request->impl_->tensors;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    auto it = tensors.find(inputs[i]);
+    CHECK(it != tensors.end() && it->second.IsInitialized())
+        << "The request has no tensor " << inputs[i] << " for the input " << i
+        << " of the predictor.";
+    auto& src = it->second;
+    auto input = predictor->GetInput(i);
+    // The memory of the last request may be larger, sharing a smaller one
+    // is only accepted by a tensor which does not hold memory.
+    input->ReleaseExternalMemory();
+    input->ShareExternalMemory(
+        src.raw_data(), src.memory_size(), src.target());
+    input->Resize(src.dims().Vectorize());
+    input->SetLoD(src.lod());
+    input->SetPrecision(src.precision());
+  }
+  predictor->Run();
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    Tensor(&tensors[outputs[i]]).MoveDataFrom(*predictor->GetOutput(i));
+  }
+}
+
+}  // namespace lite_api
+}  // namespace paddle
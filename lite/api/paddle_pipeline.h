@@ -0,0 +1,122 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+/*
+ * This file defines PaddlePipeline, which chains predictors and stages of
+ * application code into a streaming pipeline, such as the detector, the
+ * crops and the recognizer of OCR.
+ */
+
+#ifndef PADDLE_LITE_PIPELINE_H_  // NOLINT
+#define PADDLE_LITE_PIPELINE_H_
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "paddle_api.h"  // NOLINT
+
+namespace paddle {
+namespace lite_api {
+
+/// The tensors of one request on its way through a pipeline, by name. The
+/// outputs of a predictor are moved in without a copy, and the next
+/// predictor reads its inputs from them in place.
+class LITE_API PipelineRequest {
+ public:
+  PipelineRequest();
+  ~PipelineRequest();
+  PipelineRequest(const PipelineRequest&) = delete;
+  PipelineRequest& operator=(const PipelineRequest&) = delete;
+
+  /// Get the tensor `name`, an empty one is added if it does not exist.
+  std::unique_ptr<Tensor> GetMutableTensor(const std::string& name);
+  /// Get a readonly tensor, return null if no one called `name` exists.
+  std::unique_ptr<const Tensor> GetTensor(const std::string& name) const;
+  void RemoveTensor(const std::string& name);
+  std::vector<std::string> GetTensorNames() const;
+
+  /// State of the application carried along with the request, such as the
+  /// source image of the crops or the id of the client.
+  void set_user_data(std::shared_ptr<void> data);
+  std::shared_ptr<void> user_data() const;
+
+ private:
+  friend class PaddlePipeline;
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+/// A stage of application code, which reads and writes the tensors of the
+/// request in place.
+using PipelineStage = std::function<void(PipelineRequest* request)>;
+
+/// The stages run on a thread each, a request goes to the next stage through
+/// a bounded queue as soon as one is done with it. The stages work on
+/// different requests at the same time, so the throughput is set by the
+/// slowest stage rather than the sum of them. The requests leave the
+/// pipeline in the order they enter it.
+///
+/// Push blocks while the first queue is full and the last stage blocks
+/// while the requests are not popped, so pushing and popping are usually
+/// done from two threads. The threads of the predictors add up, so set them
+/// to share the cores between the stages.
+class LITE_API PaddlePipeline {
+ public:
+  /// At most `queue_capacity` requests wait between two stages.
+  explicit PaddlePipeline(int queue_capacity = 2);
+  /// Cancels the requests which are still in the pipeline, call Close and
+  /// pop all of them first to finish them.
+  ~PaddlePipeline();
+  PaddlePipeline(const PaddlePipeline&) = delete;
+  PaddlePipeline& operator=(const PaddlePipeline&) = delete;
+
+  /// Add a stage running `predictor`. Its i-th input shares the memory of
+  /// the tensor `inputs[i]` of the request and its i-th output is moved to
+  /// the tensor `outputs[i]`, empty lists use the names of the model. The
+  /// predictor is only run by the pipeline from then on.
+  void AddPredictor(std::shared_ptr<PaddlePredictor> predictor,
+                    const std::vector<std::string>& inputs = {},
+                    const std::vector<std::string>& outputs = {});
+  /// Add a stage of application code, e.g. cropping the detected boxes.
+  void AddStage(const PipelineStage& stage);
+
+  /// Start the threads of the stages, no stage can be added after it.
+  void Start();
+  /// Queue a request, block while the first queue is full.
+  void Push(std::unique_ptr<PipelineRequest> request);
+  /// Get the next finished request, block until there is one. Return null
+  /// once the pipeline is closed and the last request is out.
+  std::unique_ptr<PipelineRequest> Pop();
+  /// No more requests are pushed, the ones in the pipeline go on.
+  void Close();
+
+  /// Run `request` through all the stages on the calling thread. It does
+  /// not need Start, and must not be mixed with Push.
+  void Run(PipelineRequest* request);
+
+ private:
+  static void RunPredictor(PaddlePredictor* predictor,
+                           const std::vector<std::string>& inputs,
+                           const std::vector<std::string>& outputs,
+                           PipelineRequest* request);
+
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace lite_api
+}  // namespace paddle
+
+#endif  // NOLINT
@@ -168,6 +168,13 @@ static size_t PrecisionTypeLength(PrecisionType type) {
 enum class QuantType : int {
   QUANT_INT8,
   QUANT_INT16,
+  // int8 weights as QUANT_INT8, and the fc/matmul kernels that support it
+  // quantize their activations per row at runtime to compute in int8.
+  QUANT_INT8_DYNAMIC,
+  // fc/mul/matmul/lookup_table weights stored as fp16 or bf16 bits, widened
+  // to fp32 inside the x86 kernels and expanded at load elsewhere.
+  QUANT_FP16,
+  QUANT_BF16,
 };
 
 template <typename T>
@@ -54,7 +54,10 @@ USE_MIR_PASS(lite_match_matrix_activation_fuse_pass);
 USE_MIR_PASS(lite_scales_fuse_pass);
 USE_MIR_PASS(lite_scaleacts_fuse_pass);
 USE_MIR_PASS(lite_sequence_reverse_embedding_fuse_pass);
+USE_MIR_PASS(lite_embedding_bag_fuse_pass);
 USE_MIR_PASS(lite_elementwise_activation_fuse_pass);
+USE_MIR_PASS(lite_conv_block_fuse_pass);
+USE_MIR_PASS(lite_fused_elementwise_fuse_pass);
 USE_MIR_PASS(lite_elementwise_scale_fuse_pass);
 USE_MIR_PASS(lite_conv_scale_fuse_pass);
 USE_MIR_PASS(lite_conv_elementwise_tree_fuse_pass);
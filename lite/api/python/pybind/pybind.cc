@@ -55,6 +55,74 @@ using lite_api::CLPrecisionType;
 using lite_api::Tensor;
 using lite_api::CxxModelBuffer;
 
+// The numpy arrays shared with the inputs of a predictor, at most one per
+// input. Sharing another array with an input drops the previous one.
+class SharedInputArrays {
+ public:
+  // Shares `array` with `input`, or copies it when it can not be shared.
+  // Returns whether the array was shared.
+  bool Share(Tensor *input,
+             const std::string &name,
+             const py::array &array,
+             TargetType place) {
+    // A copy must not be written into the array shared before.
+    if (arrays_.count(name)) Release(input, name);
+    if (!ShareTensorWithPyArray(input, array, place)) {
+      SetTensorFromPyArray(input, array, place);
+      return false;
+    }
+    arrays_[name] = array;
+    return true;
+  }
+
+  void Release(Tensor *input, const std::string &name) {
+    input->ReleaseExternalMemory();
+    arrays_.erase(name);
+  }
+
+ private:
+  std::map<std::string, py::object> arrays_;
+};
+
+// An input of a predictor, which shares numpy arrays through the
+// SharedInputArrays of the predictor.
+class InputTensor : public Tensor {
+ public:
+  InputTensor(const Tensor &tensor,
+              const std::string &name,
+              SharedInputArrays *arrays)
+      : Tensor(tensor), name_(name), arrays_(arrays) {}
+
+  bool ShareNumpy(const py::array &array, TargetType place) {
+    return arrays_->Share(this, name_, array, place);
+  }
+  void ReleaseNumpy() { arrays_->Release(this, name_); }
+
+ private:
+  std::string name_;
+  SharedInputArrays *arrays_;
+};
+
+// A predictor which holds the numpy arrays shared with its inputs, so they
+// live as long as the inputs use them and no longer.
+template <typename PredictorT>
+class PyPredictor : public PredictorT {
+ public:
+  std::unique_ptr<InputTensor> GetSharedInput(int i) {
+    auto input = this->GetInput(i);
+    return std::unique_ptr<InputTensor>(
+        new InputTensor(*input, this->GetInputNames().at(i), &arrays_));
+  }
+  std::unique_ptr<InputTensor> GetSharedInputByName(const std::string &name) {
+    auto input = this->GetInputByName(name);
+    return std::unique_ptr<InputTensor>(
+        new InputTensor(*input, name, &arrays_));
+  }
+
+ private:
+  SharedInputArrays arrays_;
+};
+
 #ifndef LITE_ON_TINY_PUBLISH
 using lite::CxxPaddleApiImpl;
 static void BindLiteCxxPredictor(py::module *m);
@@ -115,16 +183,19 @@ void BindLiteApi(py::module *m) {
 // Global helper methods
 #ifndef LITE_ON_TINY_PUBLISH
   m->def("create_paddle_predictor",
-         [](const CxxConfig &config) -> std::unique_ptr<CxxPaddleApiImpl> {
-           auto x = std::unique_ptr<CxxPaddleApiImpl>(new CxxPaddleApiImpl());
+         [](const CxxConfig &config)
+             -> std::unique_ptr<PyPredictor<CxxPaddleApiImpl>> {
+           auto x = std::unique_ptr<PyPredictor<CxxPaddleApiImpl>>(
+               new PyPredictor<CxxPaddleApiImpl>());
            x->Init(config);
            return std::move(x);
          });
 #endif
   m->def("create_paddle_predictor",
-         [](const MobileConfig &config) -> std::unique_ptr<LightPredictorImpl> {
-           auto x =
-               std::unique_ptr<LightPredictorImpl>(new LightPredictorImpl());
+         [](const MobileConfig &config)
+             -> std::unique_ptr<PyPredictor<LightPredictorImpl>> {
+           auto x = std::unique_ptr<PyPredictor<LightPredictorImpl>>(
+               new PyPredictor<LightPredictorImpl>());
            x->Init(config);
            return std::move(x);
          });
@@ -330,7 +401,9 @@ void BindLiteTensor(py::module *m) {
   py::class_<Tensor> tensor(*m, "Tensor");
 
   tensor.def("resize", &Tensor::Resize)
-      .def("numpy", [](Tensor &self) { return TensorToPyArray(self); })
+      .def("numpy",
+           [](Tensor &self, bool copy) { return TensorToPyArray(self, copy); },
+           py::arg("copy") = false)
       .def("shape", &Tensor::shape)
       .def("target", &Tensor::target)
       .def("precision", &Tensor::precision)
@@ -341,6 +414,15 @@ void BindLiteTensor(py::module *m) {
            py::arg("array"),
            py::arg("place") = TargetType::kHost);
 
+  // The predictor holds the shared array until the input shares another one
+  // or releases it.
+  py::class_<InputTensor, Tensor>(*m, "InputTensor")
+      .def("share_numpy",
+           &InputTensor::ShareNumpy,
+           py::arg("array"),
+           py::arg("place") = TargetType::kHost)
+      .def("release_numpy", &InputTensor::ReleaseNumpy);
+
 #define DO_GETTER_ONCE(data_type__, name__)                           \
   tensor.def(#name__, [=](Tensor &self) -> std::vector<data_type__> { \
     std::vector<data_type__> data;                                    \
@@ -379,25 +461,62 @@ void BindLiteTensor(py::module *m) {
 #undef DATA_GETTER_SETTER_ONCE
 }
 
+// Runs the predictor once per dict of `batch`, which maps input names to
+// arrays. The arrays are shared with the inputs for the run, the outputs of
+// every run are copied, as the next run overwrites them.
+template <typename PredictorT>
+std::vector<std::map<std::string, py::array>> RunBatch(
+    PredictorT *self,
+    const std::vector<std::map<std::string, py::array>> &batch) {
+  auto output_names = self->GetOutputNames();
+  std::vector<std::map<std::string, py::array>> results;
+  results.reserve(batch.size());
+  for (auto &inputs : batch) {
+    std::vector<std::unique_ptr<InputTensor>> shared;
+    for (auto &item : inputs) {
+      auto input = self->GetSharedInputByName(item.first);
+      if (input->ShareNumpy(item.second, TargetType::kHost)) {
+        shared.push_back(std::move(input));
+      }
+    }
+    {
+      py::gil_scoped_release release;
+      self->Run();
+    }
+    for (auto &input : shared) input->ReleaseNumpy();
+    std::map<std::string, py::array> outputs;
+    for (size_t i = 0; i < output_names.size(); i++) {
+      auto output = self->GetOutput(static_cast<int>(i));
+      outputs[output_names[i]] = TensorToPyArray(*output, true);
+    }
+    results.push_back(std::move(outputs));
+  }
+  return results;
+}
+
 #ifndef LITE_ON_TINY_PUBLISH
 void BindLiteCxxPredictor(py::module *m) {
-  py::class_<CxxPaddleApiImpl>(*m, "CxxPredictor")
+  using Predictor = PyPredictor<CxxPaddleApiImpl>;
+  py::class_<Predictor>(*m, "CxxPredictor")
       .def(py::init<>())
-      .def("get_input", &CxxPaddleApiImpl::GetInput)
+      .def("get_input", &Predictor::GetSharedInput, py::keep_alive<0, 1>())
       .def("get_output", &CxxPaddleApiImpl::GetOutput)
       .def("get_output_names", &CxxPaddleApiImpl::GetOutputNames)
       .def("get_input_names", &CxxPaddleApiImpl::GetInputNames)
-      .def("get_input_by_name", &CxxPaddleApiImpl::GetInputByName)
+      .def("get_input_by_name",
+           &Predictor::GetSharedInputByName,
+           py::keep_alive<0, 1>())
       .def("get_output_by_name", &CxxPaddleApiImpl::GetOutputByName)
       .def("run", &CxxPaddleApiImpl::Run)
+      .def("run_batch", &RunBatch<Predictor>, py::arg("batch"))
       .def("get_version", &CxxPaddleApiImpl::GetVersion)
       .def("save_optimized_pb_model",
-           [](CxxPaddleApiImpl &self, const std::string &output_dir) {
+           [](Predictor &self, const std::string &output_dir) {
              self.SaveOptimizedModel(output_dir,
                                      lite_api::LiteModelType::kProtobuf);
            })
       .def("save_optimized_model",
-           [](CxxPaddleApiImpl &self, const std::string &output_dir) {
+           [](Predictor &self, const std::string &output_dir) {
              self.SaveOptimizedModel(output_dir,
                                      lite_api::LiteModelType::kNaiveBuffer);
            });
@@ -405,15 +524,19 @@ void BindLiteCxxPredictor(py::module *m) {
 #endif
 
 void BindLiteLightPredictor(py::module *m) {
-  py::class_<LightPredictorImpl>(*m, "LightPredictor")
+  using Predictor = PyPredictor<LightPredictorImpl>;
+  py::class_<Predictor>(*m, "LightPredictor")
       .def(py::init<>())
-      .def("get_input", &LightPredictorImpl::GetInput)
+      .def("get_input", &Predictor::GetSharedInput, py::keep_alive<0, 1>())
       .def("get_output", &LightPredictorImpl::GetOutput)
       .def("get_input_names", &LightPredictorImpl::GetInputNames)
       .def("get_output_names", &LightPredictorImpl::GetOutputNames)
-      .def("get_input_by_name", &LightPredictorImpl::GetInputByName)
+      .def("get_input_by_name",
+           &Predictor::GetSharedInputByName,
+           py::keep_alive<0, 1>())
       .def("get_output_by_name", &LightPredictorImpl::GetOutputByName)
       .def("run", &LightPredictorImpl::Run)
+      .def("run_batch", &RunBatch<Predictor>, py::arg("batch"))
       .def("get_version", &LightPredictorImpl::GetVersion);
 }
 
@@ -69,9 +69,36 @@ inline std::string TensorDTypeToPyDTypeStr(PrecisionType type) {
   return "";
 }
 
+////////////////////////////////////////////////////////////////
+// Function Name: PyArrayToTensorDType
+// Usage: Get the Lite PrecisionType of a numpy array, kUnk if
+//        the dtype is not supported.
+////////////////////////////////////////////////////////////////
+inline PrecisionType PyArrayToTensorDType(const py::array &array) {
+#define PY_DTYPE_TO_TENSOR_DTYPE(T, proto_type) \
+  if (py::isinstance<py::array_t<T>>(array)) {  \
+    return proto_type;                          \
+  }
+
+  PY_DTYPE_TO_TENSOR_DTYPE(float, PrecisionType::kFloat)
+  PY_DTYPE_TO_TENSOR_DTYPE(double, PrecisionType::kFP64)
+  PY_DTYPE_TO_TENSOR_DTYPE(bool, PrecisionType::kBool)
+  PY_DTYPE_TO_TENSOR_DTYPE(uint8_t, PrecisionType::kUInt8)
+  PY_DTYPE_TO_TENSOR_DTYPE(int8_t, PrecisionType::kInt8)
+  PY_DTYPE_TO_TENSOR_DTYPE(int32_t, PrecisionType::kInt32)
+  PY_DTYPE_TO_TENSOR_DTYPE(int64_t, PrecisionType::kInt64)
+  PY_DTYPE_TO_TENSOR_DTYPE(int16_t, PrecisionType::kInt16)
+
+#undef PY_DTYPE_TO_TENSOR_DTYPE
+  return PrecisionType::kUnk;
+}
+
 ////////////////////////////////////////////////////////////////
 // Function Name: TensorToPyArray
-// Usage: Transform tensor's data into numpy array
+// Usage: Transform tensor's data into numpy array. Without
+//        `need_deep_copy` the array is a read-only view of
+//        the tensor, which is only valid until the next run
+//        of the predictor owning the tensor.
 ////////////////////////////////////////////////////////////////
 inline py::array TensorToPyArray(const Tensor &tensor,
                                  bool need_deep_copy = false) {
@@ -94,12 +121,20 @@ inline py::array TensorToPyArray(const Tensor &tensor,
   }
 
   const void *tensor_buf_ptr = static_cast<const void *>(tensor.data<int8_t>());
+  if (need_deep_copy) {
+    py::array copy(py::dtype(py_dtype_str.c_str()), py_dims);
+    std::memcpy(copy.mutable_data(), tensor_buf_ptr, numel * sizeof_dtype);
+    return copy;
+  }
   auto base = py::cast(std::move(tensor));
-  return py::array(py::dtype(py_dtype_str.c_str()),
-                   py_dims,
-                   py_strides,
-                   const_cast<void *>(tensor_buf_ptr),
-                   base);
+  py::array view(py::dtype(py_dtype_str.c_str()),
+                 py_dims,
+                 py_strides,
+                 const_cast<void *>(tensor_buf_ptr),
+                 base);
+  py::detail::array_proxy(view.ptr())->flags &=
+      ~py::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+  return view;
 }
 
 ////////////////////////////////////////////////////////////////
@@ -160,6 +195,40 @@ void SetTensorFromPyArray(Tensor *self,
   }
 }
 
+////////////////////////////////////////////////////////////////
+// Function Name: ShareTensorWithPyArray
+// Usage: Let the tensor use the memory of a C contiguous numpy
+//        array instead of a copy. The array must stay alive and
+//        unchanged while the predictor runs, the tensor uses it
+//        until ReleaseExternalMemory or the next share. Returns
+//        false, leaving the tensor as is, when the array can not
+//        be shared.
+////////////////////////////////////////////////////////////////
+inline bool ShareTensorWithPyArray(Tensor *self,
+                                   const py::array &array,
+                                   const TargetType &place) {
+  auto precision = PyArrayToTensorDType(array);
+  if (precision == PrecisionType::kUnk ||
+      !(array.flags() & py::array::c_style) ||
+      (place != TargetType::kHost && place != TargetType::kX86 &&
+       place != TargetType::kARM)) {
+    return false;
+  }
+  std::vector<int64_t> dims;
+  dims.reserve(array.ndim());
+  for (decltype(array.ndim()) i = 0; i < array.ndim(); ++i) {
+    dims.push_back(static_cast<int64_t>(array.shape()[i]));
+  }
+  // A tensor which still holds an earlier, larger array would refuse the
+  // smaller buffer.
+  self->ReleaseExternalMemory();
+  self->Resize(dims);
+  self->SetPrecision(precision);
+  self->ShareExternalMemory(
+      const_cast<void *>(array.data()), array.nbytes(), place);
+  return true;
+}
+
 }  // namespace pybind
 }  // namespace lite
 }  // namespace paddle
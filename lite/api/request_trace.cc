@@ -0,0 +1,226 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "lite/api/request_trace.h"
+#include <cmath>
+#include <cstring>
+#include <map>
+#include "lite/utils/log/cp_logging.h"
+
+namespace paddle {
+namespace lite_api {
+
+static const char kTraceMagic[4] = {'P', 'L', 'R', 'T'};
+static const uint32_t kTraceVersion = 1;
+
+static size_t ElementSize(PrecisionType precision) {
+  if (precision == PrecisionType::kBool) return sizeof(bool);
+  return PrecisionTypeLength(precision);
+}
+
+static bool IsHostTarget(TargetType target) {
+  return target == TargetType::kHost || target == TargetType::kX86 ||
+         target == TargetType::kARM;
+}
+
+// Copies the data of an input on a device to the host.
+static std::vector<char> CopyToHost(const Tensor& tensor, size_t size) {
+  std::vector<char> data(size);
+  switch (tensor.precision()) {
+    case PrecisionType::kFloat:
+      tensor.CopyToCpu(reinterpret_cast<float*>(data.data()));
+      break;
+    case PrecisionType::kInt32:
+      tensor.CopyToCpu(reinterpret_cast<int*>(data.data()));
+      break;
+    case PrecisionType::kInt64:
+      tensor.CopyToCpu(reinterpret_cast<int64_t*>(data.data()));
+      break;
+    case PrecisionType::kInt8:
+      tensor.CopyToCpu(reinterpret_cast<int8_t*>(data.data()));
+      break;
+    case PrecisionType::kUInt8:
+      tensor.CopyToCpu(reinterpret_cast<uint8_t*>(data.data()));
+      break;
+    default:
+      LOG(FATAL) << "Can not trace an input of "
+                 << PrecisionToStr(tensor.precision()) << " on "
+                 << TargetToStr(tensor.target());
+  }
+  return data;
+}
+
+template <typename T>
+static void WriteValue(std::ofstream* file, T value) {
+  file->write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static bool ReadValue(std::ifstream* file, T* value) {
+  return static_cast<bool>(
+      file->read(reinterpret_cast<char*>(value), sizeof(T)));
+}
+
+std::shared_ptr<RequestTraceWriter> RequestTraceWriter::Open(
+    const std::string& path, double sample_rate, int64_t max_requests) {
+  static std::mutex mutex;
+  static std::map<std::string, std::weak_ptr<RequestTraceWriter>> writers;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto writer = writers[path].lock();
+  if (!writer) {
+    writer = std::make_shared<RequestTraceWriter>(
+        path, sample_rate, max_requests);
+    writers[path] = writer;
+  }
+  CHECK(writer->sample_rate_ == sample_rate &&
+        writer->max_requests_ == max_requests)
+      << "The request trace " << path << " is already open with the sample "
+      << "rate " << writer->sample_rate_ << " and at most "
+      << writer->max_requests_ << " requests, but got " << sample_rate
+      << " and " << max_requests;
+  return writer;
+}
+
+RequestTraceWriter::RequestTraceWriter(const std::string& path,
+                                       double sample_rate,
+                                       int64_t max_requests)
+    : file_(path, std::ios::out | std::ios::binary | std::ios::trunc),
+      sample_rate_(sample_rate),
+      max_requests_(max_requests) {
+  CHECK(file_.is_open()) << "Failed to open the request trace " << path;
+  CHECK(sample_rate_ > 0. && sample_rate_ <= 1.)
+      << "The sample rate of the request trace must be in (0, 1], but got "
+      << sample_rate_;
+  file_.write(kTraceMagic, sizeof(kTraceMagic));
+  WriteValue<uint32_t>(&file_, kTraceVersion);
+  file_.flush();
+}
+
+void RequestTraceWriter::Record(PaddlePredictor* predictor) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (max_requests_ > 0 && recorded_ >= max_requests_) return;
+  // Request n is recorded when it takes the sampled count to the next
+  // integer, so the same requests are recorded in every run of the process.
+  const int64_t n = requests_++;
+  if (std::floor((n + 1) * sample_rate_) <= std::floor(n * sample_rate_)) {
+    return;
+  }
+  auto names = predictor->GetInputNames();
+  WriteValue<uint32_t>(&file_, static_cast<uint32_t>(names.size()));
+  for (auto& name : names) {
+    WriteTensor(name, *predictor->GetInputByName(name));
+  }
+  file_.flush();
+  recorded_++;
+}
+
+void RequestTraceWriter::WriteTensor(const std::string& name,
+                                     const Tensor& tensor) {
+  WriteValue<uint32_t>(&file_, static_cast<uint32_t>(name.size()));
+  file_.write(name.data(), name.size());
+  WriteValue<int32_t>(&file_, static_cast<int32_t>(tensor.precision()));
+  auto shape = tensor.shape();
+  WriteValue<uint32_t>(&file_, static_cast<uint32_t>(shape.size()));
+  int64_t numel = 1;
+  for (auto dim : shape) {
+    WriteValue<int64_t>(&file_, dim);
+    numel *= dim;
+  }
+  auto lod = tensor.lod();
+  WriteValue<uint32_t>(&file_, static_cast<uint32_t>(lod.size()));
+  for (auto& level : lod) {
+    WriteValue<uint32_t>(&file_, static_cast<uint32_t>(level.size()));
+    for (auto offset : level) WriteValue<uint64_t>(&file_, offset);
+  }
+  // Inputs which are not set are traced without data, inputs on a device
+  // with a copy of it on the host.
+  uint64_t size = 0;
+  const char* data = nullptr;
+  std::vector<char> host_data;
+  if (tensor.IsInitialized()) {
+    size = numel * ElementSize(tensor.precision());
+    if (IsHostTarget(tensor.target())) {
+      data = reinterpret_cast<const char*>(tensor.data<int8_t>());
+    } else {
+      host_data = CopyToHost(tensor, size);
+      data = host_data.data();
+    }
+  }
+  WriteValue<uint64_t>(&file_, size);
+  if (size > 0) file_.write(data, size);
+}
+
+RequestTraceReader::RequestTraceReader(const std::string& path)
+    : file_(path, std::ios::in | std::ios::binary) {
+  CHECK(file_.is_open()) << "Failed to open the request trace " << path;
+  char magic[sizeof(kTraceMagic)];
+  uint32_t version = 0;
+  CHECK(file_.read(magic, sizeof(magic)) && ReadValue(&file_, &version) &&
+        std::memcmp(magic, kTraceMagic, sizeof(magic)) == 0)
+      << path << " is not a request trace";
+  CHECK_EQ(version, kTraceVersion) << "Unsupported request trace version";
+}
+
+bool RequestTraceReader::Next(std::vector<TracedTensor>* request) {
+  uint32_t count = 0;
+  if (!ReadValue(&file_, &count)) return false;
+  request->resize(count);
+  for (auto& tensor : *request) {
+    uint32_t name_size = 0, rank = 0, levels = 0;
+    int32_t precision = 0;
+    uint64_t size = 0;
+    bool ok = ReadValue(&file_, &name_size);
+    tensor.name.resize(name_size);
+    ok = ok && file_.read(&tensor.name[0], name_size) &&
+         ReadValue(&file_, &precision) && ReadValue(&file_, &rank);
+    tensor.precision = static_cast<PrecisionType>(precision);
+    tensor.shape.resize(rank);
+    for (auto& dim : tensor.shape) ok = ok && ReadValue(&file_, &dim);
+    ok = ok && ReadValue(&file_, &levels);
+    tensor.lod.resize(levels);
+    for (auto& level : tensor.lod) {
+      uint32_t level_size = 0;
+      ok = ok && ReadValue(&file_, &level_size);
+      level.resize(level_size);
+      for (auto& offset : level) ok = ok && ReadValue(&file_, &offset);
+    }
+    ok = ok && ReadValue(&file_, &size);
+    tensor.data.resize(size);
+    ok = ok && (size == 0 || file_.read(tensor.data.data(), size));
+    // A request cut by a crash of the recording process ends the trace.
+    if (!ok) return false;
+  }
+  return true;
+}
+
+void SetTracedInputs(PaddlePredictor* predictor,
+                     std::vector<TracedTensor>* request) {
+  for (auto& traced : *request) {
+    auto input = predictor->GetInputByName(traced.name);
+    input->Resize(traced.shape);
+    input->SetLoD(traced.lod);
+    input->SetPrecision(traced.precision);
+    // The memory of the last request may be larger, sharing a smaller one
+    // is only accepted by a tensor which does not hold memory.
+    input->ReleaseExternalMemory();
+    if (!traced.data.empty()) {
+      input->ShareExternalMemory(
+          traced.data.data(), traced.data.size(), TargetType::kHost);
+    }
+  }
+}
+
+}  // namespace lite_api
+}  // namespace paddle
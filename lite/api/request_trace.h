@@ -0,0 +1,100 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>  //NOLINT
+#include <string>
+#include <vector>
+#include "lite/api/paddle_api.h"
+
+namespace paddle {
+namespace lite_api {
+
+// A request trace keeps the inputs of sampled predictor requests, so that
+// the benchmark can replay the shapes, LoDs and data seen in production.
+//
+// The file starts with the magic "PLRT" and a uint32 version, followed by
+// the requests. The numbers and the data are in the byte order of the
+// recording host, a trace is replayed on hosts of the same byte order:
+//   uint32 input count, then for every input:
+//     uint32 name size, name,
+//     int32 precision,
+//     uint32 rank, int64 dims[rank],
+//     uint32 lod levels, for every level: uint32 size, uint64 offsets[size],
+//     uint64 data size, data.
+struct TracedTensor {
+  std::string name;
+  shape_t shape;
+  lod_t lod;
+  PrecisionType precision{PrecisionType::kUnk};
+  std::vector<char> data;
+};
+
+class LITE_API RequestTraceWriter {
+ public:
+  // The writer of `path` shared by all the predictors of the process, so
+  // that clones append to the same trace. It records about `sample_rate`
+  // of the requests, evenly spread, and stops after `max_requests` of them
+  // unless that is 0. A trace which is open already must be opened with
+  // the same options.
+  static std::shared_ptr<RequestTraceWriter> Open(const std::string& path,
+                                                  double sample_rate = 1.,
+                                                  int64_t max_requests = 0);
+
+  RequestTraceWriter(const std::string& path,
+                     double sample_rate,
+                     int64_t max_requests);
+
+  // Appends the current inputs of `predictor` if this request is sampled.
+  // Every request is flushed, so a crash keeps the requests before it.
+  void Record(PaddlePredictor* predictor);
+
+  int64_t recorded() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return recorded_;
+  }
+
+ private:
+  void WriteTensor(const std::string& name, const Tensor& tensor);
+
+  mutable std::mutex mutex_;
+  std::ofstream file_;
+  double sample_rate_{1.};
+  int64_t max_requests_{0};
+  int64_t requests_{0};
+  int64_t recorded_{0};
+};
+
+class LITE_API RequestTraceReader {
+ public:
+  explicit RequestTraceReader(const std::string& path);
+
+  // Reads the inputs of the next request, false at the end of the trace.
+  bool Next(std::vector<TracedTensor>* request);
+
+ private:
+  std::ifstream file_;
+};
+
+// Sets the inputs of `predictor` to the tensors of a traced request. The
+// inputs share the memory of `request`, which must outlive the run.
+LITE_API void SetTracedInputs(PaddlePredictor* predictor,
+                              std::vector<TracedTensor>* request);
+
+}  // namespace lite_api
+}  // namespace paddle
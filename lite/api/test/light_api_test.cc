@@ -15,6 +15,14 @@
 #include "lite/api/light_api.h"
 #include <gflags/gflags.h>
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+#include "lite/core/program.h"
+#include "lite/model_parser/model_parser.h"
 
 DEFINE_string(optimized_model, "", "");
 
@@ -99,5 +107,214 @@ TEST(LightAPI, loadNaiveBuffer) {
   }
 }
 
+#ifndef LITE_ON_TINY_PUBLISH
+// feed -> fc x kFcNum -> fetch 0, fill_constant(ValueTensor) -> fetch 1 and
+// the weight ValueTensor -> fetch 2. The weights are large enough for the
+// loader to still be filling them while the program is built.
+static void SaveFcChainModel(const std::string& model_file) {
+  const int kFcNum = 6;
+  const int64_t kSize = 384;
+  cpp::ProgramDesc program_desc;
+  auto* block = program_desc.AddBlock<cpp::BlockDesc>();
+  Scope scope;
+  auto add_var = [&](const std::string& name,
+                     VarDescAPI::Type type,
+                     bool persistable) {
+    auto* var = block->AddVar<cpp::VarDesc>();
+    var->SetName(name);
+    var->SetType(type);
+    var->SetPersistable(persistable);
+    if (type == VarDescAPI::Type::LOD_TENSOR) {
+      var->SetDataType(VarDescAPI::VarDataType::FP32);
+    }
+  };
+  auto add_op = [&](const std::string& type, const std::string& alias,
+                    const Place& place) {
+    auto* op = block->AddOp<cpp::OpDesc>();
+    op->SetType(type);
+    op->SetAttr<std::string>(
+        kKernelTypeAttr, KernelBase::SerializeKernelType(type, alias, place));
+    return op;
+  };
+  auto add_weight = [&](const std::string& name,
+                        const std::vector<int64_t>& dims) {
+    add_var(name, VarDescAPI::Type::LOD_TENSOR, true);
+    auto* tensor = scope.Var(name)->GetMutable<Tensor>();
+    tensor->Resize(dims);
+    auto* data = tensor->mutable_data<float>();
+    for (int64_t i = 0; i < tensor->numel(); i++) {
+      data[i] = static_cast<float>((i * 37 + name.size()) % 101) / 101.f - 0.5f;
+    }
+  };
+  const Place host{TARGET(kHost), PRECISION(kAny), DATALAYOUT(kAny)};
+  const Place x86{TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHW)};
+
+  add_var("feed", VarDescAPI::Type::FEED_MINIBATCH, true);
+  add_var("fetch", VarDescAPI::Type::FETCH_LIST, true);
+  add_var("x", VarDescAPI::Type::LOD_TENSOR, false);
+  auto* feed = add_op("feed", "def", host);
+  feed->SetInput("X", {"feed"});
+  feed->SetOutput("Out", {"x"});
+  feed->SetAttr<int>("col", 0);
+
+  std::string in = "x";
+  for (int i = 0; i < kFcNum; i++) {
+    const std::string id = std::to_string(i);
+    add_weight("w" + id, {kSize, kSize});
+    add_weight("b" + id, {kSize});
+    add_var("h" + id, VarDescAPI::Type::LOD_TENSOR, false);
+    auto* fc = add_op("fc", "def", x86);
+    fc->SetInput("Input", {in});
+    fc->SetInput("W", {"w" + id});
+    fc->SetInput("Bias", {"b" + id});
+    fc->SetOutput("Out", {"h" + id});
+    fc->SetAttr<int>("in_num_col_dims", 1);
+    in = "h" + id;
+  }
+
+  add_weight("value", {1});
+  add_var("c", VarDescAPI::Type::LOD_TENSOR, false);
+  auto* fill = add_op("fill_constant",
+                      "def",
+                      Place{TARGET(kHost), PRECISION(kAny), DATALAYOUT(kNCHW)});
+  fill->SetInput("ValueTensor", {"value"});
+  fill->SetOutput("Out", {"c"});
+  fill->SetAttr<std::vector<int64_t>>("shape", {2, 3});
+  fill->SetAttr<int>("dtype", static_cast<int>(core::FluidType::FP32));
+  fill->SetAttr<float>("value", 0.f);
+  fill->SetAttr<bool>("force_cpu", false);
+
+  int col = 0;
+  for (auto name : {in, std::string("c"), std::string("value")}) {
+    auto* fetch = add_op("fetch", "def", host);
+    fetch->SetInput("X", {name});
+    fetch->SetOutput("Out", {"fetch"});
+    fetch->SetAttr<int>("col", col++);
+  }
+  SaveModelNaive(model_file, scope, program_desc);
+}
+
+static void SetFcChainInput(LightPredictor* predictor) {
+  auto* input = predictor->GetInput(0);
+  input->Resize(DDim(std::vector<int64_t>({4, 384})));
+  auto* data = input->mutable_data<float>();
+  for (int64_t i = 0; i < input->numel(); i++) {
+    data[i] = static_cast<float>(i % 13) / 13.f;
+  }
+}
+
+static std::vector<float> GetOutputValues(LightPredictor* predictor, int i) {
+  const auto* output = predictor->GetOutput(i);
+  return std::vector<float>(output->data<float>(),
+                            output->data<float>() + output->numel());
+}
+
+TEST(LightAPI, weight_streaming) {
+  const std::string model_file = "light_api_weight_streaming";
+  SaveFcChainModel(model_file);
+
+  std::vector<std::vector<float>> outputs[2];
+  for (bool streaming : {false, true}) {
+    // Build several times, the loader races with a different op each time.
+    for (int repeat = 0; repeat < 4; repeat++) {
+      LightPredictor predictor(model_file + ".nb", false, streaming);
+      SetFcChainInput(&predictor);
+      predictor.Run();
+      auto& result = outputs[streaming];
+      for (int i = 0; i < 2; i++) {
+        auto values = GetOutputValues(&predictor, i);
+        if (result.size() < 2) {
+          result.push_back(values);
+        } else {
+          EXPECT_EQ(result[i], values);
+        }
+      }
+    }
+  }
+  ASSERT_EQ(outputs[1].size(), 2u);
+  EXPECT_EQ(outputs[0][0], outputs[1][0]);
+  EXPECT_EQ(outputs[0][1], outputs[1][1]);
+  EXPECT_EQ(outputs[1][1].size(), 6u);
+  EXPECT_EQ(outputs[1][1][0], -0.5f + static_cast<float>(5 % 101) / 101.f);
+  std::remove((model_file + ".nb").c_str());
+}
+
+TEST(LightAPI, warm_up) {
+  const std::string model_file = "light_api_warm_up";
+  SaveFcChainModel(model_file);
+  LightPredictor reference(model_file + ".nb", false);
+  SetFcChainInput(&reference);
+  reference.Run();
+  auto expected = GetOutputValues(&reference, 0);
+
+  {
+    LightPredictor predictor(model_file + ".nb", false);
+    ASSERT_DEATH(predictor.WarmUp(), "must be set before WarmUp");
+  }
+
+  // Run right after WarmUp stops the warm-up in the middle of the program,
+  // the later runs wait for a warm-up which is done.
+  for (int sleep_ms : {0, 0, 20}) {
+    LightPredictor predictor(model_file + ".nb", false);
+    SetFcChainInput(&predictor);
+    predictor.WarmUp();
+    if (sleep_ms) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(sleep_ms));
+    }
+    predictor.Run();
+    EXPECT_EQ(GetOutputValues(&predictor, 0), expected);
+    // A second warm-up on the prepared kernels, stopped by the input access.
+    predictor.WarmUp();
+    SetFcChainInput(&predictor);
+    predictor.Run();
+    EXPECT_EQ(GetOutputValues(&predictor, 0), expected);
+  }
+  std::remove((model_file + ".nb").c_str());
+}
+
+TEST(LightAPI, bind_output) {
+  const std::string model_file = "light_api_bind_output";
+  SaveFcChainModel(model_file);
+  LightPredictor reference(model_file + ".nb", false);
+  SetFcChainInput(&reference);
+  reference.Run();
+  auto expected = GetOutputValues(&reference, 0);
+  auto expected_value = GetOutputValues(&reference, 2);
+  ASSERT_EQ(expected_value.size(), 1u);
+
+  LightPredictor predictor(model_file + ".nb", false);
+  std::vector<float> out(expected.size(), -1.f);
+  std::vector<float> value(4, -1.f);
+  predictor.BindOutput(
+      0, out.data(), out.size() * sizeof(float), TARGET(kHost));
+  predictor.BindOutput(
+      2, value.data(), value.size() * sizeof(float), TARGET(kHost));
+  for (int run = 0; run < 2; run++) {
+    SetFcChainInput(&predictor);
+    predictor.Run();
+    // The fc writes straight into the bound memory.
+    EXPECT_EQ(predictor.GetOutput(0)->data<float>(), out.data());
+    EXPECT_EQ(out, expected);
+    // The weight has no producer, it is copied after the run.
+    EXPECT_NE(predictor.GetOutput(2)->data<float>(), value.data());
+    EXPECT_EQ(value, std::vector<float>({expected_value[0], -1.f, -1.f, -1.f}));
+  }
+
+  // Unbound outputs get memory of their own and leave the caller's alone.
+  predictor.UnbindOutput(0);
+  predictor.UnbindOutput(2);
+  std::fill(out.begin(), out.end(), -1.f);
+  std::fill(value.begin(), value.end(), -1.f);
+  SetFcChainInput(&predictor);
+  predictor.Run();
+  EXPECT_NE(predictor.GetOutput(0)->data<float>(), out.data());
+  EXPECT_EQ(GetOutputValues(&predictor, 0), expected);
+  EXPECT_EQ(GetOutputValues(&predictor, 2), expected_value);
+  EXPECT_EQ(out, std::vector<float>(expected.size(), -1.f));
+  EXPECT_EQ(value, std::vector<float>(4, -1.f));
+  std::remove((model_file + ".nb").c_str());
+}
+#endif  // LITE_ON_TINY_PUBLISH
+
 }  // namespace lite
 }  // namespace paddle
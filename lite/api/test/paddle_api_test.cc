@@ -110,6 +110,73 @@ TEST(CxxApi, share_external_data) {
   EXPECT_NEAR(out[1], -28.8729, 1e-3);
 }
 
+// Shares a larger array and then a smaller one with the same input, as
+// Tensor.share_numpy does in python.
+TEST(CxxApi, share_smaller_external_data) {
+  lite_api::CxxConfig config;
+  config.set_model_dir(FLAGS_model_dir);
+  config.set_valid_places({
+      Place{TARGET(kX86), PRECISION(kFloat)},
+      Place{TARGET(kARM), PRECISION(kFloat)},
+  });
+
+  auto predictor = lite_api::CreatePaddlePredictor(config);
+  auto input_tensor = predictor->GetInput(0);
+  auto outputs = predictor->GetOutputNames();
+  const TargetType target = config.valid_places()[0].target;
+
+  for (int64_t rows : {200, 100}) {
+    std::vector<float> external_data(rows * 100);
+    for (int64_t i = 0; i < rows * 100; i++) {
+      external_data[i] = i;
+    }
+    // The tensor would refuse a buffer smaller than the one it holds.
+    input_tensor->ReleaseExternalMemory();
+    input_tensor->Resize(std::vector<int64_t>({rows, 100}));
+    input_tensor->ShareExternalMemory(static_cast<void*>(external_data.data()),
+                                      external_data.size() * sizeof(float),
+                                      target);
+
+    predictor->Run();
+
+    auto output = predictor->GetTensor(outputs[0]);
+    EXPECT_EQ(output->shape()[0], rows);
+    auto* out = output->data<float>();
+    EXPECT_NEAR(out[0], 50.2132, 1e-3);
+    EXPECT_NEAR(out[1], -28.8729, 1e-3);
+  }
+  input_tensor->ReleaseExternalMemory();
+}
+
+// WarmUp runs the model in the background, Run right after it stops the
+// warm-up in the middle and gets the same results.
+TEST(CxxApi, warm_up) {
+  lite_api::CxxConfig config;
+  config.set_model_dir(FLAGS_model_dir);
+  config.set_valid_places({
+      Place{TARGET(kX86), PRECISION(kFloat)},
+      Place{TARGET(kARM), PRECISION(kFloat)},
+  });
+
+  auto predictor = lite_api::CreatePaddlePredictor(config);
+  auto outputs = predictor->GetOutputNames();
+  for (int repeat = 0; repeat < 2; repeat++) {
+    auto input_tensor = predictor->GetInput(0);
+    input_tensor->Resize(std::vector<int64_t>({100, 100}));
+    auto* data = input_tensor->mutable_data<float>();
+    for (int i = 0; i < 100 * 100; i++) {
+      data[i] = i;
+    }
+    predictor->WarmUp();
+    predictor->Run();
+
+    auto output = predictor->GetTensor(outputs[0]);
+    auto* out = output->data<float>();
+    EXPECT_NEAR(out[0], 50.2132, 1e-3);
+    EXPECT_NEAR(out[1], -28.8729, 1e-3);
+  }
+}
+
 // Demo1 for Mobile Devices :Load model from file and run
 #ifdef LITE_WITH_ARM
 TEST(LightApi, run) {
@@ -0,0 +1,171 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "lite/api/paddle_pipeline.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite_api {
+
+// Writes twice its input to a new output buffer on every run, like the
+// last op of a model does after the output is moved out.
+class DoublePredictor : public PaddlePredictor {
+ public:
+  std::unique_ptr<Tensor> GetInput(int i) override {
+    return std::unique_ptr<Tensor>(new Tensor(&input_));
+  }
+  std::unique_ptr<const Tensor> GetOutput(int i) const override {
+    return std::unique_ptr<const Tensor>(
+        new Tensor(static_cast<const void*>(&output_)));
+  }
+  void Run() override {
+    output_.Resize(input_.dims());
+    auto* out = output_.mutable_data<float>();
+    for (int64_t i = 0; i < input_.numel(); ++i) {
+      out[i] = 2.f * input_.data<float>()[i];
+    }
+    outputs_.push_back(out);
+  }
+  std::shared_ptr<PaddlePredictor> Clone() override { return nullptr; }
+  std::shared_ptr<PaddlePredictor> Clone(
+      const std::vector<std::string>& var_names) override {
+    return nullptr;
+  }
+  std::string GetVersion() const override { return ""; }
+  std::vector<std::string> GetInputNames() override { return {"x"}; }
+  std::vector<std::string> GetOutputNames() override { return {"y"}; }
+  bool TryShrinkMemory() override { return true; }
+  std::unique_ptr<Tensor> GetInputByName(const std::string& name) override {
+    return GetInput(0);
+  }
+  std::unique_ptr<const Tensor> GetTensor(
+      const std::string& name) const override {
+    return GetOutput(0);
+  }
+
+  // The memory written by every run.
+  std::vector<const float*> outputs_;
+
+ private:
+  lite::Tensor input_;
+  lite::Tensor output_;
+};
+
+static std::unique_ptr<PipelineRequest> MakeRequest(float value) {
+  std::unique_ptr<PipelineRequest> request(new PipelineRequest);
+  auto x = request->GetMutableTensor("x");
+  x->Resize({2, 3});
+  auto* data = x->mutable_data<float>();
+  for (int i = 0; i < 6; ++i) data[i] = value;
+  return request;
+}
+
+TEST(PipelineRequest, tensors) {
+  PipelineRequest request;
+  EXPECT_EQ(request.GetTensor("x"), nullptr);
+  request.GetMutableTensor("x")->Resize({4});
+  ASSERT_NE(request.GetTensor("x"), nullptr);
+  EXPECT_EQ(request.GetTensor("x")->shape(), shape_t({4}));
+  EXPECT_EQ(request.GetTensorNames(), std::vector<std::string>({"x"}));
+  request.RemoveTensor("x");
+  EXPECT_TRUE(request.GetTensorNames().empty());
+}
+
+TEST(Tensor, move_data_from) {
+  lite::Tensor src, dst, shared;
+  src.Resize({8});
+  auto* data = src.mutable_data<float>();
+  data[7] = 7.f;
+  Tensor(&dst).MoveDataFrom(Tensor(&src));
+  EXPECT_EQ(dst.data<float>(), data);
+  EXPECT_EQ(dst.dims(), src.dims());
+  EXPECT_FALSE(src.IsInitialized());
+
+  // The memory is copied when another tensor writes it as well.
+  shared.ShareDataWith(dst);
+  Tensor(&src).MoveDataFrom(Tensor(&dst));
+  EXPECT_NE(src.data<float>(), data);
+  EXPECT_EQ(src.data<float>()[7], 7.f);
+  EXPECT_EQ(dst.data<float>(), data);
+}
+
+TEST(PaddlePipeline, run) {
+  auto predictor = std::make_shared<DoublePredictor>();
+  PaddlePipeline pipeline;
+  pipeline.AddPredictor(predictor);
+  pipeline.AddStage([](PipelineRequest* request) {
+    request->GetMutableTensor("x")->MoveDataFrom(*request->GetTensor("y"));
+  });
+  pipeline.AddPredictor(predictor, {"x"}, {"z"});
+  auto request = MakeRequest(1.f);
+  pipeline.Run(request.get());
+  EXPECT_EQ(request->GetTensor("z")->data<float>()[5], 4.f);
+  EXPECT_EQ(request->GetTensor("z")->data<float>(), predictor->outputs_[1]);
+}
+
+TEST(PaddlePipeline, streaming) {
+  const size_t kRequests = 32;
+  auto first = std::make_shared<DoublePredictor>();
+  auto second = std::make_shared<DoublePredictor>();
+  PaddlePipeline pipeline(1);
+  pipeline.AddPredictor(first, {"x"}, {"y"});
+  pipeline.AddStage([](PipelineRequest* request) {
+    auto y = request->GetMutableTensor("y");
+    auto* data = y->mutable_data<float>();
+    data[0] += 1.f;
+  });
+  pipeline.AddPredictor(second, {"y"}, {"z"});
+  pipeline.Start();
+
+  std::thread client([&]() {
+    for (size_t i = 0; i < kRequests; ++i) {
+      pipeline.Push(MakeRequest(i));
+    }
+    pipeline.Close();
+  });
+  std::vector<std::unique_ptr<PipelineRequest>> done;
+  while (auto request = pipeline.Pop()) {
+    done.push_back(std::move(request));
+  }
+  client.join();
+  // The stages are all done once the last request is out.
+  ASSERT_EQ(done.size(), kRequests);
+  for (size_t i = 0; i < kRequests; ++i) {
+    auto z = done[i]->GetTensor("z");
+    EXPECT_EQ(z->data<float>()[0], 4.f * i + 2.f);
+    EXPECT_EQ(z->data<float>()[5], 4.f * i);
+    // The outputs are moved along, not copied.
+    EXPECT_EQ(done[i]->GetTensor("y")->data<float>(), first->outputs_[i]);
+    EXPECT_EQ(z->data<float>(), second->outputs_[i]);
+  }
+}
+
+TEST(PaddlePipeline, cancel) {
+  PaddlePipeline pipeline(1);
+  pipeline.AddPredictor(std::make_shared<DoublePredictor>());
+  pipeline.Start();
+  // Nobody pops, the pipeline fills up and is cancelled when it goes.
+  pipeline.Push(MakeRequest(1.f));
+  pipeline.Push(MakeRequest(2.f));
+}
+
+}  // namespace lite_api
+}  // namespace paddle
@@ -0,0 +1,157 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "lite/api/request_trace.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite_api {
+
+// Holds its inputs by name and does nothing on Run.
+class InputPredictor : public PaddlePredictor {
+ public:
+  std::unique_ptr<Tensor> GetInput(int i) override {
+    return GetInputByName(GetInputNames()[i]);
+  }
+  std::unique_ptr<const Tensor> GetOutput(int i) const override {
+    return nullptr;
+  }
+  void Run() override {}
+  std::shared_ptr<PaddlePredictor> Clone() override { return nullptr; }
+  std::shared_ptr<PaddlePredictor> Clone(
+      const std::vector<std::string>& var_names) override {
+    return nullptr;
+  }
+  std::string GetVersion() const override { return ""; }
+  std::vector<std::string> GetInputNames() override { return {"x", "ids"}; }
+  std::vector<std::string> GetOutputNames() override { return {}; }
+  bool TryShrinkMemory() override { return true; }
+  std::unique_ptr<Tensor> GetInputByName(const std::string& name) override {
+    return std::unique_ptr<Tensor>(new Tensor(&inputs_[name]));
+  }
+  std::unique_ptr<const Tensor> GetTensor(
+      const std::string& name) const override {
+    return nullptr;
+  }
+
+  // Sets the inputs of the request with the given id, which has `id` rows.
+  void SetRequest(int id) {
+    auto& x = inputs_["x"];
+    x.Resize({id, 3});
+    auto* x_data = x.mutable_data<float>();
+    for (int i = 0; i < id * 3; ++i) x_data[i] = id + i * 0.5f;
+    auto& ids = inputs_["ids"];
+    ids.Resize({id, 1});
+    ids.set_lod({{0, 1, static_cast<uint64_t>(id)}});
+    auto* ids_data = ids.mutable_data<int64_t>();
+    for (int i = 0; i < id; ++i) ids_data[i] = id * 100 + i;
+  }
+
+  const lite::Tensor& input(const std::string& name) { return inputs_[name]; }
+
+ private:
+  std::map<std::string, lite::Tensor> inputs_;
+};
+
+static void ExpectRequest(const std::vector<TracedTensor>& request, int id) {
+  ASSERT_EQ(request.size(), 2u);
+  auto& x = request[0];
+  EXPECT_EQ(x.name, "x");
+  EXPECT_EQ(x.precision, PrecisionType::kFloat);
+  EXPECT_EQ(x.shape, shape_t({id, 3}));
+  EXPECT_TRUE(x.lod.empty());
+  ASSERT_EQ(x.data.size(), id * 3 * sizeof(float));
+  auto* x_data = reinterpret_cast<const float*>(x.data.data());
+  for (int i = 0; i < id * 3; ++i) EXPECT_EQ(x_data[i], id + i * 0.5f);
+  auto& ids = request[1];
+  EXPECT_EQ(ids.name, "ids");
+  EXPECT_EQ(ids.precision, PrecisionType::kInt64);
+  EXPECT_EQ(ids.shape, shape_t({id, 1}));
+  EXPECT_EQ(ids.lod, lod_t({{0, 1, static_cast<uint64_t>(id)}}));
+  ASSERT_EQ(ids.data.size(), id * sizeof(int64_t));
+  auto* ids_data = reinterpret_cast<const int64_t*>(ids.data.data());
+  for (int i = 0; i < id; ++i) EXPECT_EQ(ids_data[i], id * 100 + i);
+}
+
+TEST(RequestTrace, round_trip) {
+  const std::string path = "request_trace_round_trip.trace";
+  InputPredictor predictor;
+  {
+    auto writer = RequestTraceWriter::Open(path);
+    for (int id : {2, 5, 3}) {
+      predictor.SetRequest(id);
+      writer->Record(&predictor);
+    }
+    EXPECT_EQ(writer->recorded(), 3);
+  }
+
+  RequestTraceReader reader(path);
+  std::vector<TracedTensor> request;
+  InputPredictor replay;
+  for (int id : {2, 5, 3}) {
+    ASSERT_TRUE(reader.Next(&request));
+    ExpectRequest(request, id);
+    // The inputs of the replay share the memory of the request.
+    SetTracedInputs(&replay, &request);
+    auto& x = replay.input("x");
+    EXPECT_EQ(x.dims(), lite::DDim({id, 3}));
+    EXPECT_EQ(x.data<float>(),
+              reinterpret_cast<const float*>(request[0].data.data()));
+    EXPECT_EQ(replay.input("ids").lod(), request[1].lod);
+  }
+  EXPECT_FALSE(reader.Next(&request));
+  std::remove(path.c_str());
+}
+
+TEST(RequestTrace, sample_rate) {
+  const std::string path = "request_trace_sample_rate.trace";
+  InputPredictor predictor;
+  {
+    // Every fourth request is recorded, up to two of them.
+    auto writer = RequestTraceWriter::Open(path, 0.25, 2);
+    for (int id = 1; id <= 12; ++id) {
+      predictor.SetRequest(id);
+      writer->Record(&predictor);
+    }
+    EXPECT_EQ(writer->recorded(), 2);
+  }
+
+  RequestTraceReader reader(path);
+  std::vector<TracedTensor> request;
+  for (int id : {4, 8}) {
+    ASSERT_TRUE(reader.Next(&request));
+    ExpectRequest(request, id);
+  }
+  EXPECT_FALSE(reader.Next(&request));
+  std::remove(path.c_str());
+}
+
+TEST(RequestTrace, open_shared) {
+  const std::string path = "request_trace_open_shared.trace";
+  auto writer = RequestTraceWriter::Open(path, 0.5);
+  EXPECT_EQ(RequestTraceWriter::Open(path, 0.5), writer);
+  ASSERT_DEATH(RequestTraceWriter::Open(path, 0.25), "already open");
+  writer.reset();
+  std::remove(path.c_str());
+}
+
+}  // namespace lite_api
+}  // namespace paddle
@@ -26,6 +26,8 @@
 #ifdef __ANDROID__
 #include "lite/api/tools/benchmark/precision_evaluation/imagenet_image_classification/prepost_process.h"
 #endif
+#include "lite/api/tools/benchmark/replay.h"
+#include "lite/api/tools/benchmark/serving.h"
 #include "lite/core/version.h"
 #include "lite/utils/timer.h"
 
@@ -54,7 +56,13 @@ int Benchmark(int argc, char** argv) {
   auto input_shapes = lite::GetShapes(FLAGS_input_shape);
 
   // Run
-  Run(model_file, input_shapes);
+  if (!FLAGS_replay_trace_path.empty()) {
+    RunReplayBenchmark(model_file);
+  } else if (FLAGS_concurrency > 0) {
+    RunServingBenchmark(model_file, input_shapes);
+  } else {
+    Run(model_file, input_shapes);
+  }
 
   return 0;
 }
@@ -73,6 +81,32 @@ std::shared_ptr<PaddlePredictor> CreatePredictor(
   return predictor;
 }
 
+void SetInputs(std::shared_ptr<PaddlePredictor> predictor,
+               const std::vector<std::vector<int64_t>>& input_shapes) {
+  for (size_t i = 0; i < input_shapes.size(); i++) {
+    auto input_tensor = predictor->GetInput(i);
+    input_tensor->Resize(input_shapes[i]);
+    // NOTE: Change input data type to other type as you need.
+    auto input_data = input_tensor->mutable_data<float>();
+    auto input_num = lite::ShapeProduction(input_shapes[i]);
+    if (FLAGS_input_data_path.empty()) {
+      for (auto j = 0; j < input_num; j++) {
+        input_data[j] = 1.f;
+      }
+    } else {
+      auto paths = lite::Split(FLAGS_input_data_path, ":");
+      std::ifstream fs(paths[i]);
+      if (!fs.is_open()) {
+        std::cerr << "Open input image " << paths[i] << " error." << std::endl;
+      }
+      for (int k = 0; k < input_num; k++) {
+        fs >> input_data[k];
+      }
+      fs.close();
+    }
+  }
+}
+
 void RunImpl(std::shared_ptr<PaddlePredictor> predictor, PerfData* perf_data) {
   lite::Timer timer;
   timer.Start();
@@ -124,29 +158,7 @@ void Run(const std::string& model_file,
 
   // Set inputs
   if (FLAGS_validation_set.empty()) {
-    for (size_t i = 0; i < input_shapes.size(); i++) {
-      auto input_tensor = predictor->GetInput(i);
-      input_tensor->Resize(input_shapes[i]);
-      // NOTE: Change input data type to other type as you need.
-      auto input_data = input_tensor->mutable_data<float>();
-      auto input_num = lite::ShapeProduction(input_shapes[i]);
-      if (FLAGS_input_data_path.empty()) {
-        for (auto j = 0; j < input_num; j++) {
-          input_data[j] = 1.f;
-        }
-      } else {
-        auto paths = lite::Split(FLAGS_input_data_path, ":");
-        std::ifstream fs(paths[i]);
-        if (!fs.is_open()) {
-          std::cerr << "Open input image " << paths[i] << " error."
-                    << std::endl;
-        }
-        for (int k = 0; k < input_num; k++) {
-          fs >> input_data[k];
-        }
-        fs.close();
-      }
-    }
+    SetInputs(predictor, input_shapes);
   } else {
 #ifdef __ANDROID__
     config = LoadConfigTxt(FLAGS_config_path);
@@ -309,5 +321,102 @@ void Run(const std::string& model_file,
   StoreBenchmarkResult(ss.str());
 }
 
+void RunServingBenchmark(
+    const std::string& model_file,
+    const std::vector<std::vector<int64_t>>& input_shapes) {
+  ServingOptions options;
+  options.concurrency = FLAGS_concurrency;
+  options.target_qps = FLAGS_target_qps;
+  options.duration_s = FLAGS_duration;
+  options.warmup = FLAGS_warmup;
+  options.memory_profile = FLAGS_enable_memory_profile;
+  options.memory_check_interval_ms = FLAGS_memory_check_interval_ms;
+
+  // MobileConfig predictors can not be cloned, every client loads its own
+  // one from the optimized model.
+  auto result = RunServing(
+      [&]() {
+        auto predictor = CreatePredictor(model_file);
+        SetInputs(predictor, input_shapes);
+        return predictor;
+      },
+      options);
+
+  std::stringstream ss;
+#ifdef __ANDROID__
+  ss << "\n======= Device Info =======\n";
+  ss << GetDeviceInfo();
+#endif
+  ss << "\n======= Model Info =======\n";
+  ss << "optimized_model_file: " << model_file << std::endl;
+  ss << "input_data_path: "
+     << (FLAGS_input_data_path.empty() ? "All 1.f" : FLAGS_input_data_path)
+     << std::endl;
+  ss << "input_shape: " << FLAGS_input_shape << std::endl;
+  ss << "\n======= Runtime Info =======\n";
+  ss << "benchmark_bin version: " << lite::version() << std::endl;
+  ss << "threads: " << FLAGS_threads << std::endl;
+  ss << "power_mode: " << FLAGS_power_mode << std::endl;
+  ss << "backend: " << FLAGS_backend << std::endl;
+  ss << "result_path: " << FLAGS_result_path << std::endl;
+  ss << ServingReport(result, options);
+  std::cout << ss.str() << std::endl;
+  StoreBenchmarkResult(ss.str());
+
+  if (!FLAGS_json_result_path.empty()) {
+    std::ofstream fs(FLAGS_json_result_path, std::ios::out);
+    if (!fs.is_open()) {
+      std::cerr << "Fail to open result file: " << FLAGS_json_result_path
+                << std::endl;
+      return;
+    }
+    fs << ServingJson(result, options, model_file);
+    fs.close();
+  }
+}
+
+void RunReplayBenchmark(const std::string& model_file) {
+  ReplayOptions options;
+  options.warmup = FLAGS_warmup;
+  options.repeats = FLAGS_repeats;
+
+  lite::Timer timer;
+  timer.Start();
+  auto predictor = CreatePredictor(model_file);
+  float init_time = timer.Stop();
+  auto requests = LoadTrace(FLAGS_replay_trace_path);
+  auto result = RunReplay(predictor.get(), &requests, options);
+
+  std::stringstream ss;
+#ifdef __ANDROID__
+  ss << "\n======= Device Info =======\n";
+  ss << GetDeviceInfo();
+#endif
+  ss << "\n======= Model Info =======\n";
+  ss << "optimized_model_file: " << model_file << std::endl;
+  ss << "replay_trace_path: " << FLAGS_replay_trace_path << std::endl;
+  ss << "\n======= Runtime Info =======\n";
+  ss << "benchmark_bin version: " << lite::version() << std::endl;
+  ss << "threads: " << FLAGS_threads << std::endl;
+  ss << "power_mode: " << FLAGS_power_mode << std::endl;
+  ss << "backend: " << FLAGS_backend << std::endl;
+  ss << "result_path: " << FLAGS_result_path << std::endl;
+  ss << "init(ms): " << init_time << std::endl;
+  ss << ReplayReport(result, options);
+  std::cout << ss.str() << std::endl;
+  StoreBenchmarkResult(ss.str());
+
+  if (!FLAGS_json_result_path.empty()) {
+    std::ofstream fs(FLAGS_json_result_path, std::ios::out);
+    if (!fs.is_open()) {
+      std::cerr << "Fail to open result file: " << FLAGS_json_result_path
+                << std::endl;
+      return;
+    }
+    fs << ReplayJson(result, options, model_file);
+    fs.close();
+  }
+}
+
 }  // namespace lite_api
 }  // namespace paddle
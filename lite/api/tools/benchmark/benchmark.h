@@ -95,6 +95,9 @@ class PerfData {
 int Benchmark(int argc, char** argv);
 void Run(const std::string& model_file,
          const std::vector<std::vector<int64_t>>& input_shape);
+void RunServingBenchmark(const std::string& model_file,
+                         const std::vector<std::vector<int64_t>>& input_shape);
+void RunReplayBenchmark(const std::string& model_file);
 
 #ifdef __ANDROID__
 std::string GetDeviceInfo() {
@@ -161,7 +164,7 @@ bool CheckFlagsValid() {
     std::cerr << "Must set --backend option!" << std::endl;
     ret = false;
   }
-  if (FLAGS_input_shape.empty()) {
+  if (FLAGS_input_shape.empty() && FLAGS_replay_trace_path.empty()) {
     std::cerr << "Must set --input_shape option!" << std::endl;
     ret = false;
   }
@@ -186,6 +189,25 @@ bool CheckFlagsValid() {
       ret = false;
     }
   }
+  if (FLAGS_concurrency > 0) {
+    if (!FLAGS_validation_set.empty()) {
+      std::cerr << "--validation_set is not supported with --concurrency!"
+                << std::endl;
+      ret = false;
+    }
+    if (FLAGS_duration <= 0.) {
+      std::cerr << "--duration should be positive!" << std::endl;
+      ret = false;
+    }
+  }
+  if (!FLAGS_replay_trace_path.empty()) {
+    if (FLAGS_concurrency > 0 || !FLAGS_validation_set.empty()) {
+      std::cerr << "--replay_trace_path is not supported with --concurrency "
+                   "or --validation_set!"
+                << std::endl;
+      ret = false;
+    }
+  }
 
   return ret;
 }
@@ -225,6 +247,11 @@ const std::string PrintUsage() {
         "--model_file=/path/to/mobilenetv1/model "
         "--param_file=/path/to/mobilenetv1/params "
         "--input_shape=1,3,224,224 --backend=x86 \n\n"
+        "  For serving benchmark: ./benchmark_bin "
+        "--optimized_model_file=/path/to/mbilenetv1_opt.nb "
+        "--input_shape=1,3,224,224 --backend=x86 --concurrency=4 "
+        "--target_qps=200 --duration=30 "
+        "--json_result_path=/path/to/result.json \n\n"
         "For detailed usage info: ./benchmark_bin --help \n\n";
 
   return ss.str();
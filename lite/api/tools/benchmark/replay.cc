@@ -0,0 +1,209 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/api/tools/benchmark/replay.h"
+#include <algorithm>
+#include <chrono>  // NOLINT(build/c++11)
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <utility>
+
+namespace paddle {
+namespace lite_api {
+
+typedef std::chrono::steady_clock Clock;
+
+struct LatencyStats {
+  int64_t count{0};
+  float min{0.f};
+  float max{0.f};
+  double sum{0.};
+
+  void Add(float ms) {
+    min = count ? std::min(min, ms) : ms;
+    max = count ? std::max(max, ms) : ms;
+    sum += ms;
+    ++count;
+  }
+  float avg() const { return count ? static_cast<float>(sum / count) : 0.f; }
+};
+
+static std::string Signature(const std::vector<TracedTensor>& request) {
+  std::stringstream ss;
+  for (size_t i = 0; i < request.size(); ++i) {
+    ss << (i ? "," : "");
+    for (size_t j = 0; j < request[i].shape.size(); ++j) {
+      ss << (j ? "x" : "") << request[i].shape[j];
+    }
+  }
+  return ss.str();
+}
+
+std::vector<std::vector<TracedTensor>> LoadTrace(const std::string& path) {
+  RequestTraceReader reader(path);
+  std::vector<std::vector<TracedTensor>> requests;
+  std::vector<TracedTensor> request;
+  while (reader.Next(&request)) {
+    requests.push_back(std::move(request));
+  }
+  return requests;
+}
+
+ReplayResult RunReplay(PaddlePredictor* predictor,
+                       std::vector<std::vector<TracedTensor>>* requests,
+                       const ReplayOptions& options) {
+  ReplayResult result;
+  result.latencies.resize(requests->size());
+  for (auto& request : *requests) {
+    result.signatures.push_back(Signature(request));
+  }
+  for (int pass = 0; pass < options.warmup + options.repeats; ++pass) {
+    for (size_t i = 0; i < requests->size(); ++i) {
+      // Setting the inputs only shares the traced buffers, so it is left in
+      // the measurement as the application has to do the same.
+      auto begin = Clock::now();
+      SetTracedInputs(predictor, &(*requests)[i]);
+      predictor->Run();
+      auto end = Clock::now();
+      if (pass < options.warmup) continue;
+      result.latencies[i].push_back(
+          std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
+              .count() /
+          1000.f);
+    }
+  }
+  return result;
+}
+
+static const size_t kSlowestRequests = 10;
+
+static std::map<std::string, LatencyStats> StatsBySignature(
+    const ReplayResult& result) {
+  std::map<std::string, LatencyStats> stats;
+  for (size_t i = 0; i < result.latencies.size(); ++i) {
+    for (float ms : result.latencies[i]) {
+      stats[result.signatures[i]].Add(ms);
+    }
+  }
+  return stats;
+}
+
+static LatencyStats TotalStats(const ReplayResult& result) {
+  LatencyStats total;
+  for (auto& request : result.latencies) {
+    for (float ms : request) total.Add(ms);
+  }
+  return total;
+}
+
+std::string ReplayReport(const ReplayResult& result,
+                         const ReplayOptions& options) {
+  std::stringstream ss;
+  ss << "\n======= Replay Info =======\n";
+  ss << "requests: " << result.latencies.size() << std::endl;
+  ss << "warmup passes: " << options.warmup << std::endl;
+  ss << "repeat passes: " << options.repeats << std::endl;
+
+  auto total = TotalStats(result);
+  ss << "\n======= Replay Perf Info =======\n";
+  ss << std::fixed << std::setprecision(3) << std::left;
+  ss << "Time per request(unit: ms):\n";
+  ss << "min   = " << std::setw(12) << total.min << std::endl;
+  ss << "max   = " << std::setw(12) << total.max << std::endl;
+  ss << "avg   = " << std::setw(12) << total.avg() << std::endl;
+  ss << "Time per pass(unit: ms):\n";
+  ss << "avg   = " << std::setw(12)
+     << (options.repeats > 0 ? total.sum / options.repeats : 0.) << std::endl;
+
+  ss << "\nTime per input shape(unit: ms):\n";
+  ss << std::setw(32) << "shape" << std::setw(10) << "runs" << std::setw(12)
+     << "min" << std::setw(12) << "max" << std::setw(12) << "avg"
+     << std::endl;
+  for (auto& entry : StatsBySignature(result)) {
+    ss << std::setw(32) << entry.first << std::setw(10) << entry.second.count
+       << std::setw(12) << entry.second.min << std::setw(12)
+       << entry.second.max << std::setw(12) << entry.second.avg() << std::endl;
+  }
+
+  // The requests whose average is the highest, by their index in the trace.
+  std::vector<std::pair<float, size_t>> requests;
+  for (size_t i = 0; i < result.latencies.size(); ++i) {
+    LatencyStats stats;
+    for (float ms : result.latencies[i]) stats.Add(ms);
+    requests.emplace_back(stats.avg(), i);
+  }
+  const size_t slowest = std::min(kSlowestRequests, requests.size());
+  std::partial_sort(requests.begin(),
+                    requests.begin() + slowest,
+                    requests.end(),
+                    std::greater<std::pair<float, size_t>>());
+  ss << "\nSlowest requests(unit: ms):\n";
+  ss << std::setw(10) << "request" << std::setw(32) << "shape"
+     << std::setw(12) << "avg" << std::endl;
+  for (size_t i = 0; i < slowest; ++i) {
+    ss << std::setw(10) << requests[i].second << std::setw(32)
+       << result.signatures[requests[i].second] << std::setw(12)
+       << requests[i].first << std::endl;
+  }
+  return ss.str();
+}
+
+static std::string JsonEscape(const std::string& s) {
+  std::string out;
+  for (char ch : s) {
+    if (ch == '"' || ch == '\\') out += '\\';
+    out += ch;
+  }
+  return out;
+}
+
+std::string ReplayJson(const ReplayResult& result,
+                       const ReplayOptions& options,
+                       const std::string& model_file) {
+  auto total = TotalStats(result);
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(3);
+  ss << "{\n";
+  ss << "  \"model_file\": \"" << JsonEscape(model_file) << "\",\n";
+  ss << "  \"requests\": " << result.latencies.size() << ",\n";
+  ss << "  \"warmup\": " << options.warmup << ",\n";
+  ss << "  \"repeats\": " << options.repeats << ",\n";
+  ss << "  \"latency_ms\": {\"min\": " << total.min
+     << ", \"max\": " << total.max << ", \"avg\": " << total.avg() << "},\n";
+  ss << "  \"shapes\": [";
+  bool first = true;
+  for (auto& entry : StatsBySignature(result)) {
+    ss << (first ? "" : ", ") << "{\"shape\": \"" << entry.first
+       << "\", \"runs\": " << entry.second.count
+       << ", \"min\": " << entry.second.min
+       << ", \"max\": " << entry.second.max
+       << ", \"avg\": " << entry.second.avg() << "}";
+    first = false;
+  }
+  ss << "],\n";
+  ss << "  \"request_avg_ms\": [";
+  for (size_t i = 0; i < result.latencies.size(); ++i) {
+    LatencyStats stats;
+    for (float ms : result.latencies[i]) stats.Add(ms);
+    ss << (i ? ", " : "") << stats.avg();
+  }
+  ss << "]\n";
+  ss << "}\n";
+  return ss.str();
+}
+
+}  // namespace lite_api
+}  // namespace paddle
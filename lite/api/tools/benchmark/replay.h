@@ -0,0 +1,61 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef LITE_API_TOOLS_BENCHMARK_REPLAY_H_
+#define LITE_API_TOOLS_BENCHMARK_REPLAY_H_
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/api/paddle_api.h"
+#include "lite/api/request_trace.h"
+
+namespace paddle {
+namespace lite_api {
+
+struct ReplayOptions {
+  // Passes over the whole trace before and during the measurement.
+  int warmup{0};
+  int repeats{1};
+};
+
+struct ReplayResult {
+  // Shapes of the inputs of every request, e.g. "1x3x224x224,1x2".
+  std::vector<std::string> signatures;
+  // Latencies in ms of every request, one per measured pass.
+  std::vector<std::vector<float>> latencies;
+};
+
+// Loads all the requests of the trace recorded by
+// `ConfigBase::set_request_trace`.
+std::vector<std::vector<TracedTensor>> LoadTrace(const std::string& path);
+
+// Runs the requests in their recorded order on `predictor`, pass by pass.
+ReplayResult RunReplay(PaddlePredictor* predictor,
+                       std::vector<std::vector<TracedTensor>>* requests,
+                       const ReplayOptions& options);
+
+// Latency of the whole trace, of every input shape and of the slowest
+// requests.
+std::string ReplayReport(const ReplayResult& result,
+                         const ReplayOptions& options);
+
+// The same information as a JSON object for regression tracking.
+std::string ReplayJson(const ReplayResult& result,
+                       const ReplayOptions& options,
+                       const std::string& model_file);
+
+}  // namespace lite_api
+}  // namespace paddle
+
+#endif  // LITE_API_TOOLS_BENCHMARK_REPLAY_H_
@@ -0,0 +1,294 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/api/tools/benchmark/serving.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>              // NOLINT(build/c++11)
+#include <cmath>
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <fstream>
+#include <iomanip>
+#include <mutex>  // NOLINT(build/c++11)
+#include <sstream>
+#include <thread>  // NOLINT(build/c++11)
+
+namespace paddle {
+namespace lite_api {
+
+typedef std::chrono::steady_clock Clock;
+
+static float ElapsedMs(Clock::time_point from, Clock::time_point to) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(to - from)
+             .count() /
+         1000.f;
+}
+
+// VmRSS of /proc/self/status in kB, -1 where it is not available.
+static int64_t CurrentRssKb() {
+  std::ifstream fs("/proc/self/status");
+  std::string line;
+  while (std::getline(fs, line)) {
+    if (line.compare(0, 6, "VmRSS:") == 0) {
+      return std::stoll(line.substr(6));
+    }
+  }
+  return -1;
+}
+
+// Four buckets per octave from the power of two below the fastest request
+// to the slowest one.
+static std::vector<std::pair<float, int64_t>> LatencyHistogram(
+    const std::vector<float>& sorted) {
+  std::vector<std::pair<float, int64_t>> histogram;
+  if (sorted.empty()) return histogram;
+  const float lo = std::pow(
+      2.f, std::floor(std::log2(std::max(sorted.front(), 1e-3f))));
+  size_t i = 0;
+  for (int b = 1; i < sorted.size(); ++b) {
+    const float bound = lo * std::pow(2.f, b / 4.f);
+    int64_t count = 0;
+    while (i < sorted.size() && sorted[i] <= bound) {
+      ++count;
+      ++i;
+    }
+    histogram.emplace_back(bound, count);
+  }
+  return histogram;
+}
+
+float ServingResult::percentile(double p) const {
+  if (latencies.empty()) return 0.f;
+  const double rank = std::ceil(p / 100. * latencies.size());
+  const size_t index = static_cast<size_t>(std::max(rank, 1.)) - 1;
+  return latencies[std::min(index, latencies.size() - 1)];
+}
+
+ServingResult RunServing(
+    const std::function<std::shared_ptr<PaddlePredictor>()>& create,
+    const ServingOptions& options) {
+  const int clients = std::max(options.concurrency, 1);
+  std::vector<std::shared_ptr<PaddlePredictor>> predictors;
+  for (int i = 0; i < clients; ++i) {
+    predictors.push_back(create());
+  }
+
+  // The clients warm up on their own threads since part of the runtime
+  // state (e.g. the cpu workspace) is per thread, then wait for the start.
+  std::mutex mutex;
+  std::condition_variable cv;
+  int warmed = 0;
+  bool started = false;
+  Clock::time_point start;
+  Clock::time_point deadline;
+  std::atomic<int64_t> next_request{0};
+  const bool open_loop = options.target_qps > 0.;
+  const auto interval = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(open_loop ? 1. / options.target_qps : 0.));
+
+  std::vector<std::vector<float>> latencies(clients);
+  std::vector<Clock::time_point> last_done(clients);
+  std::vector<std::thread> threads;
+  for (int c = 0; c < clients; ++c) {
+    threads.emplace_back([&, c]() {
+      auto& predictor = predictors[c];
+      for (int i = 0; i < options.warmup; ++i) {
+        predictor->Run();
+      }
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        ++warmed;
+        cv.notify_all();
+        cv.wait(lock, [&]() { return started; });
+      }
+      last_done[c] = start;
+      while (true) {
+        Clock::time_point issue;
+        if (open_loop) {
+          issue = start + interval * next_request.fetch_add(1);
+          if (issue >= deadline) break;
+          std::this_thread::sleep_until(issue);
+        } else {
+          issue = Clock::now();
+          if (issue >= deadline) break;
+        }
+        predictor->Run();
+        last_done[c] = Clock::now();
+        latencies[c].push_back(ElapsedMs(issue, last_done[c]));
+      }
+    });
+  }
+
+  ServingResult result;
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&]() { return warmed == clients; });
+    start = Clock::now();
+    deadline = start + std::chrono::duration_cast<Clock::duration>(
+                           std::chrono::duration<double>(options.duration_s));
+    started = true;
+    cv.notify_all();
+  }
+
+  std::atomic<bool> finished{false};
+  std::thread sampler;
+  if (options.memory_profile) {
+    sampler = std::thread([&]() {
+      const auto period = std::chrono::milliseconds(
+          std::max(options.memory_check_interval_ms, 1));
+      for (auto t = start; !finished.load(); t += period) {
+        int64_t rss = CurrentRssKb();
+        if (rss < 0) break;
+        result.rss.emplace_back(ElapsedMs(start, Clock::now()), rss);
+        std::this_thread::sleep_until(t + period);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  finished = true;
+  if (sampler.joinable()) sampler.join();
+
+  const auto end = *std::max_element(last_done.begin(), last_done.end());
+  result.elapsed_s = ElapsedMs(start, end) / 1000.;
+  for (auto& client : latencies) {
+    result.latencies.insert(
+        result.latencies.end(), client.begin(), client.end());
+  }
+  std::sort(result.latencies.begin(), result.latencies.end());
+  result.histogram = LatencyHistogram(result.latencies);
+  return result;
+}
+
+static const double kPercentiles[] = {50., 90., 99., 99.9};
+
+// "p50", "p99.9", ...
+static std::string PercentileName(double p) {
+  std::stringstream ss;
+  ss << "p" << p;
+  return ss.str();
+}
+
+std::string ServingReport(const ServingResult& result,
+                          const ServingOptions& options) {
+  std::stringstream ss;
+  ss << "\n======= Serving Info =======\n";
+  ss << "concurrency: " << options.concurrency << std::endl;
+  if (options.target_qps > 0.) {
+    ss << "mode: open loop, target_qps: " << options.target_qps << std::endl;
+  } else {
+    ss << "mode: closed loop" << std::endl;
+  }
+  ss << "duration(sec): " << options.duration_s << std::endl;
+  ss << "warmup per client: " << options.warmup << std::endl;
+
+  ss << "\n======= Serving Perf Info =======\n";
+  ss << std::fixed << std::setprecision(3) << std::left;
+  ss << "requests   = " << result.latencies.size() << std::endl;
+  ss << "throughput = " << std::setw(12) << result.throughput() << "qps"
+     << std::endl;
+  if (result.latencies.empty()) return ss.str();
+  ss << "Latency(unit: ms):\n";
+  ss << "min   = " << std::setw(12) << result.latencies.front() << std::endl;
+  for (double p : kPercentiles) {
+    ss << std::setw(6) << PercentileName(p) << "= " << std::setw(12)
+       << result.percentile(p) << std::endl;
+  }
+  ss << "max   = " << std::setw(12) << result.latencies.back() << std::endl;
+
+  ss << "\nLatency histogram(unit: ms):\n";
+  const int64_t peak =
+      std::max_element(result.histogram.begin(),
+                       result.histogram.end(),
+                       [](const std::pair<float, int64_t>& a,
+                          const std::pair<float, int64_t>& b) {
+                         return a.second < b.second;
+                       })
+          ->second;
+  for (auto& bucket : result.histogram) {
+    ss << "<= " << std::setw(12) << bucket.first << std::setw(10)
+       << bucket.second
+       << std::string(static_cast<size_t>(40 * bucket.second / peak), '#')
+       << std::endl;
+  }
+
+  if (!result.rss.empty()) {
+    int64_t peak_rss = 0;
+    double sum_rss = 0.;
+    for (auto& sample : result.rss) {
+      peak_rss = std::max(peak_rss, sample.second);
+      sum_rss += sample.second;
+    }
+    ss << "\nMemory Usage(unit: kB):\n";
+    ss << "start = " << std::setw(12) << result.rss.front().second
+       << std::endl;
+    ss << "avg   = " << std::setw(12) << sum_rss / result.rss.size()
+       << std::endl;
+    ss << "peak  = " << std::setw(12) << peak_rss << std::endl;
+    ss << "end   = " << std::setw(12) << result.rss.back().second << std::endl;
+  }
+  return ss.str();
+}
+
+static std::string JsonEscape(const std::string& s) {
+  std::string out;
+  for (char ch : s) {
+    if (ch == '"' || ch == '\\') out += '\\';
+    out += ch;
+  }
+  return out;
+}
+
+std::string ServingJson(const ServingResult& result,
+                        const ServingOptions& options,
+                        const std::string& model_file) {
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(3);
+  ss << "{\n";
+  ss << "  \"model_file\": \"" << JsonEscape(model_file) << "\",\n";
+  ss << "  \"concurrency\": " << options.concurrency << ",\n";
+  ss << "  \"target_qps\": " << std::max(options.target_qps, 0.) << ",\n";
+  ss << "  \"duration_s\": " << options.duration_s << ",\n";
+  ss << "  \"warmup\": " << options.warmup << ",\n";
+  ss << "  \"requests\": " << result.latencies.size() << ",\n";
+  ss << "  \"elapsed_s\": " << result.elapsed_s << ",\n";
+  ss << "  \"throughput_qps\": " << result.throughput() << ",\n";
+  ss << "  \"latency_ms\": {";
+  if (!result.latencies.empty()) {
+    ss << "\"min\": " << result.latencies.front() << ", ";
+    for (double p : kPercentiles) {
+      ss << "\"" << PercentileName(p) << "\": " << result.percentile(p) << ", ";
+    }
+    ss << "\"max\": " << result.latencies.back();
+  }
+  ss << "},\n";
+  ss << "  \"histogram\": [";
+  for (size_t i = 0; i < result.histogram.size(); ++i) {
+    ss << (i ? ", " : "") << "[" << result.histogram[i].first << ", "
+       << result.histogram[i].second << "]";
+  }
+  ss << "],\n";
+  ss << "  \"rss_kb\": [";
+  for (size_t i = 0; i < result.rss.size(); ++i) {
+    ss << (i ? ", " : "") << "[" << result.rss[i].first << ", "
+       << result.rss[i].second << "]";
+  }
+  ss << "]\n";
+  ss << "}\n";
+  return ss.str();
+}
+
+}  // namespace lite_api
+}  // namespace paddle
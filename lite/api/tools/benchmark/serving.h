@@ -0,0 +1,79 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef LITE_API_TOOLS_BENCHMARK_SERVING_H_
+#define LITE_API_TOOLS_BENCHMARK_SERVING_H_
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "lite/api/paddle_api.h"
+
+namespace paddle {
+namespace lite_api {
+
+struct ServingOptions {
+  // Number of client threads, each one owns a predictor.
+  int concurrency{1};
+  // Requests per second issued on a fixed schedule shared by all the
+  // clients (open loop). Non-positive values mean every client sends its
+  // next request as soon as the previous one returns (closed loop).
+  double target_qps{0.};
+  // Length of the measurement, the warmup runs are not part of it.
+  double duration_s{10.};
+  // Runs of every client before the measurement starts.
+  int warmup{0};
+  // Sample the resident set size every `memory_check_interval_ms`.
+  bool memory_profile{false};
+  int memory_check_interval_ms{5};
+};
+
+struct ServingResult {
+  double elapsed_s{0.};
+  // Latencies in ms of the measured requests, sorted ascending. In the open
+  // loop a latency counts from the scheduled start of the request, so the
+  // time spent queued behind a busy client is included.
+  std::vector<float> latencies;
+  // (upper bound in ms, count) of log spaced latency buckets.
+  std::vector<std::pair<float, int64_t>> histogram;
+  // (ms since the start of the measurement, RSS in kB).
+  std::vector<std::pair<float, int64_t>> rss;
+
+  double throughput() const {
+    return elapsed_s > 0. ? latencies.size() / elapsed_s : 0.;
+  }
+  // Nearest rank percentile, p in [0, 100].
+  float percentile(double p) const;
+};
+
+// Creates `options.concurrency` predictors with `create` (inputs already
+// set) and drives them from one thread each for `options.duration_s`.
+ServingResult RunServing(
+    const std::function<std::shared_ptr<PaddlePredictor>()>& create,
+    const ServingOptions& options);
+
+// Human readable summary: throughput, percentiles, histogram and RSS.
+std::string ServingReport(const ServingResult& result,
+                          const ServingOptions& options);
+
+// The same information as a JSON object for regression tracking.
+std::string ServingJson(const ServingResult& result,
+                        const ServingOptions& options,
+                        const std::string& model_file);
+
+}  // namespace lite_api
+}  // namespace paddle
+
+#endif  // LITE_API_TOOLS_BENCHMARK_SERVING_H_
@@ -101,11 +101,37 @@ static const char enable_memory_profile_msg[] =
     "Whether to report the memory usage by periodically "
     "checking the memory footprint. Internally, a separate thread "
     " will be spawned for this periodic check. Therefore, "
-    "the performance benchmark result could be affected. Not supported yet.";
+    "the performance benchmark result could be affected. Only supported by "
+    "the serving benchmark (--concurrency) on Linux and Android yet.";
 static const char memory_check_interval_ms_msg[] =
     "The interval in millisecond between two consecutive memory "
     "footprint checks. This is only used when "
-    "--enable_memory_profile is set to true. Not supported yet.";
+    "--enable_memory_profile is set to true.";
+
+// Serving options
+static const char concurrency_msg[] =
+    "Run the serving benchmark with this number of client threads, each one "
+    "with its own predictor. Non-positive values run the default "
+    "warmup/repeats benchmark on a single predictor.";
+static const char target_qps_msg[] =
+    "Issue requests at this total rate on a fixed schedule (open loop), "
+    "latency is measured from the scheduled time. Non-positive values mean "
+    "each client sends the next request when the previous one returns "
+    "(closed loop). Only used when --concurrency is set.";
+static const char duration_msg[] =
+    "The measurement length in seconds of the serving benchmark, excluding "
+    "the warmup runs of each client. Only used when --concurrency is set.";
+static const char json_result_path_msg[] =
+    "Save the serving or replay benchmark result to the file as JSON. "
+    "Only used when --concurrency or --replay_trace_path is set.";
+
+// Replay options
+static const char replay_trace_path_msg[] =
+    "Replay the requests of the trace recorded by "
+    "ConfigBase::set_request_trace instead of the --input_shape inputs, "
+    "--warmup and --repeats are the passes over the whole trace. The report "
+    "has the latency of every input shape and of the slowest requests, "
+    "--json_result_path saves it as JSON.";
 
 // Configuration options
 static const char config_path_msg[] = "Configuration options.";
@@ -146,6 +172,15 @@ DECLARE_bool(enable_op_time_profile);
 DECLARE_bool(enable_memory_profile);
 DECLARE_int32(memory_check_interval_ms);
 
+// Serving options
+DECLARE_int32(concurrency);
+DECLARE_double(target_qps);
+DECLARE_double(duration);
+DECLARE_string(json_result_path);
+
+// Replay options
+DECLARE_string(replay_trace_path);
+
 // Configuration options
 DECLARE_string(config_path);
 
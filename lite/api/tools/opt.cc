@@ -46,7 +46,8 @@ DEFINE_bool(quant_model,
 DEFINE_string(quant_type,
               "QUANT_INT16",
               "Set the quant_type for post_quant_dynamic, "
-              "and it should be QUANT_INT8 or QUANT_INT16 for now.");
+              "and it should be QUANT_INT8, QUANT_INT16, QUANT_INT8_DYNAMIC, "
+              "QUANT_FP16 or QUANT_BF16 for now.");
 DEFINE_bool(enable_fp16, false, "Set kernel_type run in FP16.");
 DEFINE_bool(record_tailoring_info,
             false,
@@ -0,0 +1,223 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/arm/math/fused_elementwise.h"
+#include <arm_neon.h>
+#include <string.h>
+#include <algorithm>
+#include "lite/backends/arm/math/funcs.h"
+
+namespace paddle {
+namespace lite {
+namespace arm {
+namespace math {
+
+using host::math::FusedElementwiseApply;
+using host::math::FusedElementwiseInstr;
+using host::math::FusedElementwiseOpcode;
+
+template <typename VecOp>
+static void unary_loop(const FusedElementwiseInstr& instr,
+                       int len,
+                       float* acc,
+                       VecOp op) {
+  int i = 0;
+  for (; i + 4 <= len; i += 4) {
+    vst1q_f32(acc + i, op(vld1q_f32(acc + i)));
+  }
+  for (; i < len; ++i) {
+    acc[i] = FusedElementwiseApply(instr, acc[i], 0.f);
+  }
+}
+
+template <typename VecOp>
+static void binary_loop(const FusedElementwiseInstr& instr,
+                        const float* b,
+                        bool b_scalar,
+                        int len,
+                        float* acc,
+                        VecOp op) {
+  int i = 0;
+  if (b_scalar) {
+    const float32x4_t vb = vdupq_n_f32(b[0]);
+    for (; i + 4 <= len; i += 4) {
+      vst1q_f32(acc + i, op(vld1q_f32(acc + i), vb));
+    }
+    for (; i < len; ++i) {
+      acc[i] = FusedElementwiseApply(instr, acc[i], b[0]);
+    }
+    return;
+  }
+  for (; i + 4 <= len; i += 4) {
+    vst1q_f32(acc + i, op(vld1q_f32(acc + i), vld1q_f32(b + i)));
+  }
+  for (; i < len; ++i) {
+    acc[i] = FusedElementwiseApply(instr, acc[i], b[i]);
+  }
+}
+
+static inline float32x4_t sigmoid_f32x4(float32x4_t x) {
+  const float32x4_t one = vdupq_n_f32(1.f);
+  return div_ps(one, vaddq_f32(one, exp_ps(vnegq_f32(x))));
+}
+
+// Returns false for the opcodes without a vector implementation.
+static bool eval_neon(const FusedElementwiseInstr& instr,
+                      const float* b,
+                      bool b_scalar,
+                      int len,
+                      float* acc) {
+  const float32x4_t zero = vdupq_n_f32(0.f);
+  const float32x4_t one = vdupq_n_f32(1.f);
+  const float32x4_t p0 = vdupq_n_f32(instr.p0);
+  const float32x4_t p1 = vdupq_n_f32(instr.p1);
+  const float32x4_t p2 = vdupq_n_f32(instr.p2);
+  switch (instr.opcode) {
+    case FusedElementwiseOpcode::kAdd:
+      binary_loop(instr, b, b_scalar, len, acc, [](float32x4_t a,
+                                                   float32x4_t v) {
+        return vaddq_f32(a, v);
+      });
+      return true;
+    case FusedElementwiseOpcode::kSub:
+      binary_loop(instr, b, b_scalar, len, acc, [](float32x4_t a,
+                                                   float32x4_t v) {
+        return vsubq_f32(a, v);
+      });
+      return true;
+    case FusedElementwiseOpcode::kRsub:
+      binary_loop(instr, b, b_scalar, len, acc, [](float32x4_t a,
+                                                   float32x4_t v) {
+        return vsubq_f32(v, a);
+      });
+      return true;
+    case FusedElementwiseOpcode::kMul:
+      binary_loop(instr, b, b_scalar, len, acc, [](float32x4_t a,
+                                                   float32x4_t v) {
+        return vmulq_f32(a, v);
+      });
+      return true;
+#ifdef __aarch64__
+    case FusedElementwiseOpcode::kDiv:
+      binary_loop(instr, b, b_scalar, len, acc, [](float32x4_t a,
+                                                   float32x4_t v) {
+        return vdivq_f32(a, v);
+      });
+      return true;
+    case FusedElementwiseOpcode::kRdiv:
+      binary_loop(instr, b, b_scalar, len, acc, [](float32x4_t a,
+                                                   float32x4_t v) {
+        return vdivq_f32(v, a);
+      });
+      return true;
+#endif
+    case FusedElementwiseOpcode::kMax:
+      binary_loop(instr, b, b_scalar, len, acc, [](float32x4_t a,
+                                                   float32x4_t v) {
+        return vmaxq_f32(a, v);
+      });
+      return true;
+    case FusedElementwiseOpcode::kMin:
+      binary_loop(instr, b, b_scalar, len, acc, [](float32x4_t a,
+                                                   float32x4_t v) {
+        return vminq_f32(a, v);
+      });
+      return true;
+    case FusedElementwiseOpcode::kScale:
+      unary_loop(instr, len, acc, [&](float32x4_t a) {
+        return vmlaq_f32(p1, a, p0);
+      });
+      return true;
+    case FusedElementwiseOpcode::kRelu:
+      unary_loop(
+          instr, len, acc, [&](float32x4_t a) { return vmaxq_f32(a, zero); });
+      return true;
+    case FusedElementwiseOpcode::kRelu6:
+      unary_loop(instr, len, acc, [&](float32x4_t a) {
+        return vminq_f32(vmaxq_f32(a, zero), p0);
+      });
+      return true;
+    case FusedElementwiseOpcode::kLeakyRelu:
+      unary_loop(instr, len, acc, [&](float32x4_t a) {
+        uint32x4_t mask = vcgtq_f32(a, zero);
+        return vbslq_f32(mask, a, vmulq_f32(a, p0));
+      });
+      return true;
+    case FusedElementwiseOpcode::kSigmoid:
+      unary_loop(
+          instr, len, acc, [&](float32x4_t a) { return sigmoid_f32x4(a); });
+      return true;
+    case FusedElementwiseOpcode::kTanh:
+      // tanh(x) = 2 * sigmoid(2x) - 1
+      unary_loop(instr, len, acc, [&](float32x4_t a) {
+        float32x4_t s = sigmoid_f32x4(vmulq_n_f32(a, 2.f));
+        return vsubq_f32(vmulq_n_f32(s, 2.f), one);
+      });
+      return true;
+    case FusedElementwiseOpcode::kSwish:
+      unary_loop(instr, len, acc, [&](float32x4_t a) {
+        return vmulq_f32(a, sigmoid_f32x4(vmulq_f32(a, p0)));
+      });
+      return true;
+    case FusedElementwiseOpcode::kHardSigmoid:
+      unary_loop(instr, len, acc, [&](float32x4_t a) {
+        float32x4_t v = vmlaq_f32(p1, a, p0);
+        return vminq_f32(vmaxq_f32(v, zero), one);
+      });
+      return true;
+    case FusedElementwiseOpcode::kHardSwish: {
+      const float32x4_t inv_scale = vdupq_n_f32(1.f / instr.p1);
+      unary_loop(instr, len, acc, [&](float32x4_t a) {
+        float32x4_t v = vminq_f32(vmaxq_f32(vaddq_f32(a, p2), zero), p0);
+        return vmulq_f32(vmulq_f32(a, v), inv_scale);
+      });
+      return true;
+    }
+    case FusedElementwiseOpcode::kExp:
+      unary_loop(instr, len, acc, [&](float32x4_t a) { return exp_ps(a); });
+      return true;
+    case FusedElementwiseOpcode::kAbs:
+      unary_loop(instr, len, acc, [&](float32x4_t a) { return vabsq_f32(a); });
+      return true;
+    default:
+      // armv7 has no vector division, div and rdiv stay scalar there.
+      return false;
+  }
+}
+
+void fused_elementwise_eval(const std::vector<FusedElementwiseInstr>& program,
+                            const float* const* x,
+                            const bool* x_scalar,
+                            int len,
+                            float* acc) {
+  if (x_scalar[0]) {
+    std::fill(acc, acc + len, x[0][0]);
+  } else {
+    memcpy(acc, x[0], len * sizeof(float));
+  }
+  for (const auto& instr : program) {
+    const float* b = instr.input >= 0 ? x[instr.input] : nullptr;
+    const bool b_scalar = instr.input >= 0 ? x_scalar[instr.input] : true;
+    if (eval_neon(instr, b, b_scalar, len, acc)) continue;
+    for (int i = 0; i < len; ++i) {
+      float v = b == nullptr ? 0.f : (b_scalar ? b[0] : b[i]);
+      acc[i] = FusedElementwiseApply(instr, acc[i], v);
+    }
+  }
+}
+
+}  // namespace math
+}  // namespace arm
+}  // namespace lite
+}  // namespace paddle
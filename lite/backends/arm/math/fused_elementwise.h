@@ -0,0 +1,38 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vector>
+#include "lite/backends/host/math/fused_elementwise.h"
+
+namespace paddle {
+namespace lite {
+namespace arm {
+namespace math {
+
+// Evaluates the whole program over `len` outputs: acc = X[0], then every
+// instruction is applied in place. x and x_scalar follow
+// host::math::FusedElementwiseRun.
+void fused_elementwise_eval(
+    const std::vector<host::math::FusedElementwiseInstr>& program,
+    const float* const* x,
+    const bool* x_scalar,
+    int len,
+    float* acc);
+
+}  // namespace math
+}  // namespace arm
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,210 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/host/allocator.h"
+#include <stdlib.h>
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+#include "lite/utils/log/logging.h"
+#include "lite/utils/macros.h"
+
+namespace paddle {
+namespace lite {
+namespace host {
+
+static std::atomic<int64_t> total_live_bytes{0};
+static std::atomic<int64_t> total_peak_bytes{0};
+static std::atomic<int64_t> total_alloc_count{0};
+static std::atomic<int64_t> total_free_count{0};
+
+static void RaisePeak(std::atomic<int64_t>* peak_bytes, int64_t live) {
+  int64_t peak = peak_bytes->load();
+  while (live > peak && !peak_bytes->compare_exchange_weak(peak, live)) {
+  }
+}
+
+void* HostAllocator::Malloc(size_t size) {
+  void* ptr = Alloc(size);
+  if (!ptr) return nullptr;
+  alloc_count_++;
+  total_alloc_count++;
+  RaisePeak(&peak_bytes_, live_bytes_ += static_cast<int64_t>(size));
+  RaisePeak(&total_peak_bytes,
+            total_live_bytes += static_cast<int64_t>(size));
+  return ptr;
+}
+
+void HostAllocator::Free(void* ptr, size_t size) {
+  free_count_++;
+  total_free_count++;
+  live_bytes_ -= static_cast<int64_t>(size);
+  total_live_bytes -= static_cast<int64_t>(size);
+  Dealloc(ptr, size);
+}
+
+AllocatorStats HostAllocator::stats() const {
+  AllocatorStats stats;
+  stats.live_bytes = live_bytes_;
+  stats.peak_bytes = peak_bytes_;
+  stats.cached_bytes = cached_bytes_;
+  stats.alloc_count = alloc_count_;
+  stats.free_count = free_count_;
+  stats.cache_hits = cache_hits_;
+  return stats;
+}
+
+AllocatorStats TotalStats() {
+  AllocatorStats stats;
+  stats.live_bytes = total_live_bytes;
+  stats.peak_bytes = total_peak_bytes;
+  stats.alloc_count = total_alloc_count;
+  stats.free_count = total_free_count;
+  return stats;
+}
+
+void ResetTotalPeak() { total_peak_bytes = total_live_bytes.load(); }
+
+void* SystemAllocator::Alloc(size_t size) { return malloc(size); }
+
+void SystemAllocator::Dealloc(void* ptr, size_t size) { free(ptr); }
+
+size_t CachingAllocator::ClassSize(size_t size) {
+  if (size <= 64) return 64;
+  // A quarter of the largest power of two below `size`.
+  size_t step = 1;
+  while ((step << 3) < size) step <<= 1;
+  return (size + step - 1) & ~(step - 1);
+}
+
+void* CachingAllocator::SystemAlloc(size_t size) {
+#if defined(__linux__)
+  if (huge_pages_ && size >= kHugePageSize) {
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, kHugePageSize, size) != 0) return nullptr;
+#ifdef MADV_HUGEPAGE
+    madvise(ptr, size, MADV_HUGEPAGE);
+#endif
+    return ptr;
+  }
+#endif
+  return malloc(size);
+}
+
+void* CachingAllocator::Alloc(size_t size) {
+  const size_t class_size = ClassSize(size);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = free_blocks_.find(class_size);
+    if (it != free_blocks_.end() && !it->second.empty()) {
+      void* ptr = it->second.back();
+      it->second.pop_back();
+      cached_bytes_ -= static_cast<int64_t>(class_size);
+      cache_hits_++;
+      return ptr;
+    }
+  }
+  void* ptr = SystemAlloc(class_size);
+  if (!ptr) {
+    // Give the cached blocks back and retry once.
+    Release();
+    ptr = SystemAlloc(class_size);
+  }
+  return ptr;
+}
+
+void CachingAllocator::Dealloc(void* ptr, size_t size) {
+  const size_t class_size = ClassSize(size);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (cached_bytes_ + static_cast<int64_t>(class_size) <=
+        max_cached_bytes_) {
+      free_blocks_[class_size].push_back(ptr);
+      cached_bytes_ += static_cast<int64_t>(class_size);
+      return;
+    }
+  }
+  free(ptr);
+}
+
+void CachingAllocator::Release() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& blocks : free_blocks_) {
+    for (void* ptr : blocks.second) free(ptr);
+  }
+  free_blocks_.clear();
+  cached_bytes_ = 0;
+}
+
+void* HookAllocator::Alloc(size_t size) {
+  return malloc_fn_(size, user_data_);
+}
+
+void HookAllocator::Dealloc(void* ptr, size_t size) {
+  free_fn_(ptr, size, user_data_);
+}
+
+// The allocators are never destroyed, a static buffer may still hold one of
+// their blocks at exit.
+static HostAllocator* SystemAllocatorInstance() {
+  static HostAllocator* system = new SystemAllocator;
+  return system;
+}
+
+static std::atomic<HostAllocator*> hook_allocator{nullptr};
+
+HostAllocator* GetAllocator(AllocatorKind kind) {
+  switch (kind) {
+    case AllocatorKind::kCaching: {
+      static HostAllocator* caching = new CachingAllocator(false);
+      return caching;
+    }
+    case AllocatorKind::kCachingHugePages: {
+      static HostAllocator* caching = new CachingAllocator(true);
+      return caching;
+    }
+    case AllocatorKind::kHook: {
+      HostAllocator* hook = hook_allocator;
+      CHECK(hook) << "No host allocator hook is set.";
+      return hook;
+    }
+    default:
+      return SystemAllocatorInstance();
+  }
+}
+
+void SetAllocatorHook(MallocHook malloc_fn, FreeHook free_fn, void* user_data) {
+  CHECK(malloc_fn && free_fn) << "Both allocator hooks must be set.";
+  hook_allocator = new HookAllocator(malloc_fn, free_fn, user_data);
+}
+
+static LITE_THREAD_LOCAL HostAllocator* current_allocator = nullptr;
+
+HostAllocator* CurrentAllocator() {
+  return current_allocator ? current_allocator : SystemAllocatorInstance();
+}
+
+void SetCurrentAllocator(AllocatorKind kind) {
+  current_allocator = GetAllocator(kind);
+}
+
+AllocatorGuard::AllocatorGuard(AllocatorKind kind) : prev_(current_allocator) {
+  current_allocator = GetAllocator(kind);
+}
+
+AllocatorGuard::~AllocatorGuard() { current_allocator = prev_; }
+
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
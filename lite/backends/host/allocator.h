@@ -0,0 +1,158 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <mutex>  //NOLINT
+#include <unordered_map>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace host {
+
+// Counters of one allocator, over all of its users in the process.
+struct AllocatorStats {
+  int64_t live_bytes{0};
+  int64_t peak_bytes{0};
+  int64_t cached_bytes{0};
+  int64_t alloc_count{0};
+  int64_t free_count{0};
+  int64_t cache_hits{0};
+};
+
+// Source of the raw host blocks behind TargetWrapper<kHost>::Malloc. Every
+// block carries the allocator that made it, so a block is always returned
+// to its own allocator whichever one is current when it is freed. The
+// allocators live as long as the process.
+class HostAllocator {
+ public:
+  virtual ~HostAllocator() = default;
+
+  void* Malloc(size_t size);
+  void Free(void* ptr, size_t size);
+
+  // Returns the cached blocks to the system.
+  virtual void Release() {}
+
+  AllocatorStats stats() const;
+
+ protected:
+  virtual void* Alloc(size_t size) = 0;
+  virtual void Dealloc(void* ptr, size_t size) = 0;
+
+  std::atomic<int64_t> cached_bytes_{0};
+  std::atomic<int64_t> cache_hits_{0};
+
+ private:
+  std::atomic<int64_t> live_bytes_{0};
+  std::atomic<int64_t> peak_bytes_{0};
+  std::atomic<int64_t> alloc_count_{0};
+  std::atomic<int64_t> free_count_{0};
+};
+
+// malloc and free.
+class SystemAllocator : public HostAllocator {
+ protected:
+  void* Alloc(size_t size) override;
+  void Dealloc(void* ptr, size_t size) override;
+};
+
+// Keeps the freed blocks in size classes of four steps per power of two and
+// hands them out again, so that shape changes and growing buffers stop
+// going to the system allocator. Blocks from 2MB are 2MB aligned and
+// advised as transparent huge pages when `huge_pages` is set. At most
+// `max_cached_bytes` are kept, the blocks over the limit are freed.
+class CachingAllocator : public HostAllocator {
+ public:
+  static const size_t kHugePageSize = 2 << 20;
+
+  explicit CachingAllocator(bool huge_pages,
+                            int64_t max_cached_bytes = int64_t(1) << 30)
+      : huge_pages_(huge_pages), max_cached_bytes_(max_cached_bytes) {}
+
+  // The size of the class `size` belongs to.
+  static size_t ClassSize(size_t size);
+
+  void Release() override;
+
+ protected:
+  void* Alloc(size_t size) override;
+  void Dealloc(void* ptr, size_t size) override;
+
+ private:
+  void* SystemAlloc(size_t size);
+
+  const bool huge_pages_;
+  const int64_t max_cached_bytes_;
+  std::mutex mutex_;
+  std::unordered_map<size_t, std::vector<void*>> free_blocks_;
+};
+
+typedef void* (*MallocHook)(size_t size, void* user_data);
+typedef void (*FreeHook)(void* ptr, size_t size, void* user_data);
+
+// Functions supplied by the user.
+class HookAllocator : public HostAllocator {
+ public:
+  HookAllocator(MallocHook malloc_fn, FreeHook free_fn, void* user_data)
+      : malloc_fn_(malloc_fn), free_fn_(free_fn), user_data_(user_data) {}
+
+ protected:
+  void* Alloc(size_t size) override;
+  void Dealloc(void* ptr, size_t size) override;
+
+ private:
+  MallocHook malloc_fn_;
+  FreeHook free_fn_;
+  void* user_data_;
+};
+
+enum class AllocatorKind { kSystem = 0, kCaching, kCachingHugePages, kHook };
+
+HostAllocator* GetAllocator(AllocatorKind kind);
+
+// Installs the functions used by AllocatorKind::kHook, the blocks made by
+// the previous ones are still returned to them.
+void SetAllocatorHook(MallocHook malloc_fn, FreeHook free_fn, void* user_data);
+
+// The allocator of the host buffers malloced by the calling thread, the
+// system one by default.
+HostAllocator* CurrentAllocator();
+
+// Makes `kind` current on the calling thread.
+void SetCurrentAllocator(AllocatorKind kind);
+
+// The host memory of all the allocators together. The peak is the
+// high-water mark since the last ResetTotalPeak, the profiler restarts it
+// for every op.
+AllocatorStats TotalStats();
+void ResetTotalPeak();
+
+// Makes `kind` current on the calling thread for the scope of the guard.
+class AllocatorGuard {
+ public:
+  explicit AllocatorGuard(AllocatorKind kind);
+  ~AllocatorGuard();
+
+ private:
+  HostAllocator* prev_;
+};
+
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,166 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "lite/backends/host/allocator.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include "lite/core/target_wrapper.h"
+
+namespace paddle {
+namespace lite {
+namespace host {
+
+TEST(CachingAllocator, class_size) {
+  EXPECT_EQ(CachingAllocator::ClassSize(1), 64u);
+  EXPECT_EQ(CachingAllocator::ClassSize(64), 64u);
+  EXPECT_EQ(CachingAllocator::ClassSize(65), 80u);
+  EXPECT_EQ(CachingAllocator::ClassSize(100), 112u);
+  EXPECT_EQ(CachingAllocator::ClassSize(1025), 1280u);
+  for (size_t size = 65; size < (1 << 20); size += size / 7 + 1) {
+    size_t class_size = CachingAllocator::ClassSize(size);
+    // At most a quarter more than asked for, and stable.
+    EXPECT_GE(class_size, size);
+    EXPECT_LE(class_size, size + size / 4);
+    EXPECT_EQ(CachingAllocator::ClassSize(class_size), class_size);
+  }
+  for (size_t shift = 6; shift < 30; shift++) {
+    EXPECT_EQ(CachingAllocator::ClassSize(size_t(1) << shift),
+              size_t(1) << shift);
+  }
+}
+
+TEST(CachingAllocator, reuse_and_release) {
+  CachingAllocator allocator(false);
+  void* p = allocator.Malloc(1000);
+  ASSERT_TRUE(p);
+  allocator.Free(p, 1000);
+  EXPECT_EQ(allocator.stats().cached_bytes, 1024);
+  // The same size class gets the cached block back.
+  void* q = allocator.Malloc(1010);
+  EXPECT_EQ(q, p);
+  auto stats = allocator.stats();
+  EXPECT_EQ(stats.cache_hits, 1);
+  EXPECT_EQ(stats.cached_bytes, 0);
+  EXPECT_EQ(stats.live_bytes, 1010);
+  EXPECT_EQ(stats.peak_bytes, 1010);
+  EXPECT_EQ(stats.alloc_count, 2);
+  EXPECT_EQ(stats.free_count, 1);
+  // Another class does not.
+  void* r = allocator.Malloc(3000);
+  EXPECT_NE(r, p);
+  EXPECT_EQ(allocator.stats().cache_hits, 1);
+  EXPECT_EQ(allocator.stats().peak_bytes, 4010);
+  allocator.Free(q, 1010);
+  allocator.Free(r, 3000);
+  stats = allocator.stats();
+  EXPECT_EQ(stats.live_bytes, 0);
+  EXPECT_EQ(stats.cached_bytes, 1024 + 3072);
+  allocator.Release();
+  EXPECT_EQ(allocator.stats().cached_bytes, 0);
+  EXPECT_EQ(allocator.stats().free_count, 3);
+}
+
+TEST(CachingAllocator, max_cached_bytes) {
+  CachingAllocator allocator(false, 1024);
+  void* p = allocator.Malloc(1024);
+  void* q = allocator.Malloc(1024);
+  allocator.Free(p, 1024);
+  allocator.Free(q, 1024);
+  // The second block goes back to the system.
+  EXPECT_EQ(allocator.stats().cached_bytes, 1024);
+  allocator.Release();
+}
+
+TEST(CachingAllocator, huge_pages) {
+  CachingAllocator allocator(true);
+  void* p = allocator.Malloc(CachingAllocator::kHugePageSize + 1);
+  ASSERT_TRUE(p);
+#if defined(__linux__)
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % CachingAllocator::kHugePageSize,
+            0u);
+#endif
+  allocator.Free(p, CachingAllocator::kHugePageSize + 1);
+  allocator.Release();
+}
+
+struct HookCounter {
+  int mallocs{0};
+  int frees{0};
+  size_t freed_bytes{0};
+};
+
+static void* CountingMalloc(size_t size, void* user_data) {
+  static_cast<HookCounter*>(user_data)->mallocs++;
+  return malloc(size);
+}
+
+static void CountingFree(void* ptr, size_t size, void* user_data) {
+  auto* counter = static_cast<HookCounter*>(user_data);
+  counter->frees++;
+  counter->freed_bytes += size;
+  free(ptr);
+}
+
+TEST(HostAllocator, hook) {
+  HookCounter counter;
+  SetAllocatorHook(CountingMalloc, CountingFree, &counter);
+  void* p = nullptr;
+  {
+    AllocatorGuard guard(AllocatorKind::kHook);
+    EXPECT_EQ(CurrentAllocator(), GetAllocator(AllocatorKind::kHook));
+    p = TargetWrapperHost::Malloc(100);
+  }
+  EXPECT_EQ(CurrentAllocator(), GetAllocator(AllocatorKind::kSystem));
+  EXPECT_EQ(counter.mallocs, 1);
+  // The block goes back to the hook although it is no longer current.
+  TargetWrapperHost::Free(p);
+  EXPECT_EQ(counter.frees, 1);
+
+  // Blocks made by a replaced hook are still returned to it.
+  HookCounter next;
+  {
+    AllocatorGuard guard(AllocatorKind::kHook);
+    p = TargetWrapperHost::Malloc(100);
+    SetAllocatorHook(CountingMalloc, CountingFree, &next);
+  }
+  TargetWrapperHost::Free(p);
+  EXPECT_EQ(counter.mallocs, 2);
+  EXPECT_EQ(counter.frees, 2);
+  EXPECT_EQ(next.frees, 0);
+
+  void* q = GetAllocator(AllocatorKind::kHook)->Malloc(256);
+  GetAllocator(AllocatorKind::kHook)->Free(q, 256);
+  EXPECT_EQ(next.mallocs, 1);
+  EXPECT_EQ(next.freed_bytes, 256u);
+}
+
+TEST(HostAllocator, total_stats) {
+  auto before = TotalStats();
+  ResetTotalPeak();
+  void* p = TargetWrapperHost::Malloc(1 << 16);
+  auto during = TotalStats();
+  EXPECT_GT(during.live_bytes, before.live_bytes + (1 << 16) - 1);
+  EXPECT_GE(during.peak_bytes, during.live_bytes);
+  EXPECT_EQ(during.alloc_count, before.alloc_count + 1);
+  TargetWrapperHost::Free(p);
+  auto after = TotalStats();
+  EXPECT_EQ(after.live_bytes, before.live_bytes);
+  EXPECT_EQ(after.free_count, before.free_count + 1);
+  EXPECT_EQ(after.peak_bytes, during.peak_bytes);
+}
+
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,216 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/utils/log/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+namespace host {
+namespace math {
+
+// Program of the fused_elementwise op. The accumulator starts as X[0] and
+// every instruction updates it in place, binary ones read their second
+// operand from X[input], e.g. kRsub computes acc = X[input] - acc.
+enum class FusedElementwiseOpcode {
+  kAdd = 0,
+  kSub,
+  kRsub,
+  kMul,
+  kDiv,
+  kRdiv,
+  kMax,
+  kMin,
+  kScale,  // acc * p0 + p1
+  kRelu,
+  kRelu6,      // p0: threshold
+  kLeakyRelu,  // p0: alpha
+  kSigmoid,
+  kTanh,
+  kSwish,        // p0: beta
+  kHardSigmoid,  // p0: slope, p1: offset
+  kHardSwish,    // p0: threshold, p1: scale, p2: offset
+  kExp,
+  kAbs,
+};
+
+struct FusedElementwiseInstr {
+  FusedElementwiseOpcode opcode{FusedElementwiseOpcode::kAdd};
+  int input{-1};
+  float p0{0.f};
+  float p1{0.f};
+  float p2{0.f};
+};
+
+inline bool IsFusedElementwiseBinary(FusedElementwiseOpcode opcode) {
+  return opcode <= FusedElementwiseOpcode::kMin;
+}
+
+// Maps the names stored in the "fused_op_types" attribute to opcodes.
+inline bool ParseFusedElementwiseOpcode(const std::string& name,
+                                        FusedElementwiseOpcode* opcode) {
+  static const std::vector<std::string> kNames{"add",
+                                               "sub",
+                                               "rsub",
+                                               "mul",
+                                               "div",
+                                               "rdiv",
+                                               "max",
+                                               "min",
+                                               "scale",
+                                               "relu",
+                                               "relu6",
+                                               "leaky_relu",
+                                               "sigmoid",
+                                               "tanh",
+                                               "swish",
+                                               "hard_sigmoid",
+                                               "hard_swish",
+                                               "exp",
+                                               "abs"};
+  auto it = std::find(kNames.begin(), kNames.end(), name);
+  if (it == kNames.end()) return false;
+  *opcode = static_cast<FusedElementwiseOpcode>(it - kNames.begin());
+  return true;
+}
+
+// Builds the program from the attributes of the fused_elementwise op.
+inline std::vector<FusedElementwiseInstr> FusedElementwiseProgram(
+    const std::vector<std::string>& types,
+    const std::vector<int>& inputs,
+    const std::vector<float>& params) {
+  std::vector<FusedElementwiseInstr> program(types.size());
+  for (size_t i = 0; i < types.size(); i++) {
+    auto& instr = program[i];
+    CHECK(ParseFusedElementwiseOpcode(types[i], &instr.opcode))
+        << "fused_elementwise: unsupported op " << types[i];
+    CHECK_EQ(IsFusedElementwiseBinary(instr.opcode), (inputs[i] >= 0))
+        << "fused_elementwise: bad operand of " << types[i];
+    instr.input = inputs[i];
+    instr.p0 = params[i * 3];
+    instr.p1 = params[i * 3 + 1];
+    instr.p2 = params[i * 3 + 2];
+  }
+  return program;
+}
+
+// Scalar semantics of one instruction, also used for the SIMD tails.
+inline float FusedElementwiseApply(const FusedElementwiseInstr& instr,
+                                   float a,
+                                   float b) {
+  switch (instr.opcode) {
+    case FusedElementwiseOpcode::kAdd:
+      return a + b;
+    case FusedElementwiseOpcode::kSub:
+      return a - b;
+    case FusedElementwiseOpcode::kRsub:
+      return b - a;
+    case FusedElementwiseOpcode::kMul:
+      return a * b;
+    case FusedElementwiseOpcode::kDiv:
+      return a / b;
+    case FusedElementwiseOpcode::kRdiv:
+      return b / a;
+    case FusedElementwiseOpcode::kMax:
+      return std::max(a, b);
+    case FusedElementwiseOpcode::kMin:
+      return std::min(a, b);
+    case FusedElementwiseOpcode::kScale:
+      return a * instr.p0 + instr.p1;
+    case FusedElementwiseOpcode::kRelu:
+      return std::max(a, 0.f);
+    case FusedElementwiseOpcode::kRelu6:
+      return std::min(std::max(a, 0.f), instr.p0);
+    case FusedElementwiseOpcode::kLeakyRelu:
+      return a > 0.f ? a : a * instr.p0;
+    case FusedElementwiseOpcode::kSigmoid:
+      return 1.f / (1.f + std::exp(-a));
+    case FusedElementwiseOpcode::kTanh:
+      return std::tanh(a);
+    case FusedElementwiseOpcode::kSwish:
+      return a / (1.f + std::exp(-instr.p0 * a));
+    case FusedElementwiseOpcode::kHardSigmoid:
+      return std::min(std::max(a * instr.p0 + instr.p1, 0.f), 1.f);
+    case FusedElementwiseOpcode::kHardSwish:
+      return a * std::min(std::max(a + instr.p2, 0.f), instr.p0) / instr.p1;
+    case FusedElementwiseOpcode::kExp:
+      return std::exp(a);
+    case FusedElementwiseOpcode::kAbs:
+      return std::fabs(a);
+  }
+  return a;
+}
+
+// Number of outputs evaluated by one pass of the program, small enough for
+// the accumulator to stay in L1 while all instructions run over it.
+constexpr int64_t kFusedElementwiseChunk = 512;
+
+// Runs the chunks [task_begin, task_end) of an output of `shape`, where
+// every row of the innermost dim is split into chunks of
+// kFusedElementwiseChunk. `strides[j]` are the strides of X[j] along `shape`
+// (0 on broadcast dims). `eval` is the target evaluator with the signature
+//   void(const float* const* x, const bool* x_scalar, int len, float* acc),
+// x[j] points to the chunk of X[j], x_scalar[j] is set when X[j] is
+// broadcast along the innermost dim so x[j][0] applies to the whole chunk.
+template <typename EvalFn>
+void FusedElementwiseRun(const std::vector<int64_t>& shape,
+                         const std::vector<std::vector<int64_t>>& strides,
+                         const std::vector<const float*>& x,
+                         float* out,
+                         int64_t task_begin,
+                         int64_t task_end,
+                         EvalFn eval) {
+  const int rank = static_cast<int>(shape.size());
+  const int num = static_cast<int>(x.size());
+  const int64_t inner = shape[rank - 1];
+  const int64_t chunks =
+      (inner + kFusedElementwiseChunk - 1) / kFusedElementwiseChunk;
+  std::vector<const float*> ptrs(num);
+  std::unique_ptr<bool[]> scalar(new bool[num]);
+  for (int64_t task = task_begin; task < task_end; ++task) {
+    const int64_t row = task / chunks;
+    const int64_t begin = (task % chunks) * kFusedElementwiseChunk;
+    const int len =
+        static_cast<int>(std::min(kFusedElementwiseChunk, inner - begin));
+    for (int j = 0; j < num; ++j) {
+      int64_t offset = 0;
+      int64_t index = row;
+      for (int d = rank - 2; d >= 0; --d) {
+        offset += (index % shape[d]) * strides[j][d];
+        index /= shape[d];
+      }
+      scalar[j] = strides[j][rank - 1] == 0;
+      ptrs[j] = x[j] + offset + (scalar[j] ? 0 : begin);
+    }
+    eval(ptrs.data(), scalar.get(), len, out + row * inner + begin);
+  }
+}
+
+inline int64_t FusedElementwiseTasks(const std::vector<int64_t>& shape) {
+  int64_t rows = 1;
+  for (size_t d = 0; d + 1 < shape.size(); ++d) rows *= shape[d];
+  const int64_t inner = shape.back();
+  return rows * ((inner + kFusedElementwiseChunk - 1) /
+                 kFusedElementwiseChunk);
+}
+
+}  // namespace math
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
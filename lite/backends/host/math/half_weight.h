@@ -0,0 +1,94 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <string>
+
+namespace paddle {
+namespace lite {
+namespace host {
+namespace math {
+
+// Values of the "half_weight_type" attribute set by post_quant_dynamic_pass
+// for QUANT_FP16 / QUANT_BF16, the weight tensor then holds the 16 bit
+// patterns as int16.
+const char kHalfWeightFP16[] = "fp16";
+const char kHalfWeightBF16[] = "bf16";
+
+inline uint32_t float_bits(float f) {
+  uint32_t x;
+  memcpy(&x, &f, sizeof(x));
+  return x;
+}
+
+inline float bits_float(uint32_t x) {
+  float f;
+  memcpy(&f, &x, sizeof(f));
+  return f;
+}
+
+// IEEE half precision with round to nearest even, the out of range values
+// become inf.
+inline uint16_t float_to_fp16(float f) {
+  uint32_t x = float_bits(f);
+  uint32_t sign = (x >> 16) & 0x8000;
+  uint32_t abs = x & 0x7fffffff;
+  if (abs >= 0x7f800000) {
+    return sign | (abs > 0x7f800000 ? 0x7e00 : 0x7c00);
+  }
+  if (abs >= 0x477ff000) {
+    return sign | 0x7c00;
+  }
+  if (abs < 0x38800000) {
+    // Adding 0.5 aligns the float ulp with the half subnormal ulp (2^-24),
+    // so the FPU does the rounding.
+    return sign | (float_bits(bits_float(abs) + 0.5f) - 0x3f000000);
+  }
+  abs += 0xc8000fff + ((abs >> 13) & 1);
+  return sign | (abs >> 13);
+}
+
+inline float fp16_to_float(uint16_t h) {
+  uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+  uint32_t exp = (h >> 10) & 0x1f;
+  uint32_t mant = h & 0x3ff;
+  if (exp == 0x1f) {
+    return bits_float(sign | 0x7f800000 | (mant << 13));
+  }
+  if (exp == 0) {
+    return bits_float(sign |
+                      float_bits(static_cast<float>(mant) / 16777216.f));
+  }
+  return bits_float(sign | ((exp + 112) << 23) | (mant << 13));
+}
+
+// bfloat16 with round to nearest even, NaN stays quiet NaN.
+inline uint16_t float_to_bf16(float f) {
+  uint32_t x = float_bits(f);
+  if ((x & 0x7fffffff) > 0x7f800000) {
+    return static_cast<uint16_t>((x >> 16) | 0x40);
+  }
+  return static_cast<uint16_t>((x + 0x7fff + ((x >> 16) & 1)) >> 16);
+}
+
+inline float bf16_to_float(uint16_t h) {
+  return bits_float(static_cast<uint32_t>(h) << 16);
+}
+
+}  // namespace math
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
@@ -15,6 +15,7 @@
 #include "lite/core/target_wrapper.h"
 #include <cstring>
 #include <memory>
+#include "lite/backends/host/allocator.h"
 
 namespace paddle {
 namespace lite {
@@ -22,25 +23,31 @@ namespace lite {
 const int MALLOC_ALIGN = 64;
 const int MALLOC_EXTRA = 64;
 
+// The aligned pointer is preceded by the allocator of the block, the size
+// of the block and the block itself.
 void* TargetWrapper<TARGET(kHost)>::Malloc(size_t size) {
-  size_t offset = sizeof(void*) + MALLOC_ALIGN - 1;
+  size_t offset = 3 * sizeof(void*) + MALLOC_ALIGN - 1;
   CHECK(size);
   CHECK_GT(offset + size, size);
   size_t extra_size = sizeof(int8_t) * MALLOC_EXTRA;
   auto sum_size = offset + size;
   CHECK_GT(sum_size + extra_size, sum_size);
-  char* p = static_cast<char*>(malloc(sum_size + extra_size));
+  host::HostAllocator* allocator = host::CurrentAllocator();
+  char* p = static_cast<char*>(allocator->Malloc(sum_size + extra_size));
   CHECK(p) << "Error occurred in TargetWrapper::Malloc period: no enough for "
               "mallocing "
            << size << " bytes.";
   void* r = reinterpret_cast<void*>(reinterpret_cast<size_t>(p + offset) &
                                     (~(MALLOC_ALIGN - 1)));
   static_cast<void**>(r)[-1] = p;
+  static_cast<size_t*>(r)[-2] = sum_size + extra_size;
+  static_cast<host::HostAllocator**>(r)[-3] = allocator;
   return r;
 }
 void TargetWrapper<TARGET(kHost)>::Free(void* ptr) {
   if (ptr) {
-    free(static_cast<void**>(ptr)[-1]);
+    static_cast<host::HostAllocator**>(ptr)[-3]->Free(
+        static_cast<void**>(ptr)[-1], static_cast<size_t*>(ptr)[-2]);
   }
 }
 void TargetWrapper<TARGET(kHost)>::MemcpySync(void* dst,
@@ -25,11 +25,27 @@
 #include <unistd.h>
 #endif  // _WIN32
 
+#ifdef __linux__
+#include <sched.h>
+#endif
+
 #include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
 #include "lite/utils/log/cp_logging.h"
 
 #include "lite/utils/env.h"
 
+#include "lite/utils/macros.h"
+
+#if defined(PADDLE_WITH_MKLML) && !defined(__APPLE__)
+#include <omp.h>
+#endif
+
 #ifdef PADDLE_WITH_XBYAK
 #include "xbyak/xbyak.h"
 #include "xbyak/xbyak_util.h"
@@ -126,6 +142,224 @@ size_t CUDAPinnedMaxChunkSize() {
   return CUDAPinnedMaxAllocSize() / 256;
 }
 
+namespace {
+
+#ifdef __linux__
+bool ReadLine(const std::string& path, std::string* line) {
+  std::ifstream file(path);
+  return file && std::getline(file, *line);
+}
+
+int ReadInt(const std::string& path, int default_value) {
+  std::string line;
+  if (!ReadLine(path, &line)) return default_value;
+  return std::atoi(line.c_str());
+}
+
+// Cache sizes are reported as "32K" or "16M".
+size_t ParseCacheSize(const std::string& size) {
+  size_t value = std::strtoul(size.c_str(), nullptr, 10);
+  if (size.find('K') != std::string::npos) value <<= 10;
+  if (size.find('M') != std::string::npos) value <<= 20;
+  return value;
+}
+#endif
+
+}  // namespace
+
+std::vector<int> ParseCpuList(const std::string& list) {
+  std::vector<int> cpus;
+  size_t pos = 0;
+  while (pos < list.size()) {
+    size_t end = list.find(',', pos);
+    if (end == std::string::npos) end = list.size();
+    auto range = list.substr(pos, end - pos);
+    auto dash = range.find('-');
+    if (!range.empty()) {
+      int first = std::atoi(range.c_str());
+      int last = dash == std::string::npos
+                     ? first
+                     : std::atoi(range.c_str() + dash + 1);
+      for (int cpu = first; cpu <= last; cpu++) cpus.push_back(cpu);
+    }
+    pos = end + 1;
+  }
+  return cpus;
+}
+
+CpuTopology DetectCpuTopology(const std::string& sysfs_root) {
+  CpuTopology topo;
+  topo.num_cpus = std::max(1u, std::thread::hardware_concurrency());
+#ifdef __linux__
+  const std::string cpu_root = sysfs_root + "cpu/";
+  std::string line;
+  std::vector<int> cpus;
+  if (ReadLine(cpu_root + "online", &line)) cpus = ParseCpuList(line);
+  if (!cpus.empty()) {
+    topo.num_cpus = *std::max_element(cpus.begin(), cpus.end()) + 1;
+  }
+  topo.cpu_socket.assign(topo.num_cpus, 0);
+  topo.cpu_core.assign(topo.num_cpus, 0);
+  topo.cpu_numa_node.assign(topo.num_cpus, 0);
+  // Map the raw package and core ids to dense ones.
+  std::map<int, int> sockets;
+  std::map<std::pair<int, int>, int> cores;
+  std::vector<bool> first_thread(topo.num_cpus, true);
+  for (int cpu : cpus) {
+    auto dir = cpu_root + "cpu" + std::to_string(cpu) + "/topology/";
+    int package = ReadInt(dir + "physical_package_id", 0);
+    int core = ReadInt(dir + "core_id", cpu);
+    auto socket_it = sockets.emplace(package, sockets.size()).first;
+    auto key = std::make_pair(package, core);
+    auto core_it = cores.find(key);
+    if (core_it == cores.end()) {
+      core_it = cores.emplace(key, cores.size()).first;
+    } else {
+      first_thread[cpu] = false;
+    }
+    topo.cpu_socket[cpu] = socket_it->second;
+    topo.cpu_core[cpu] = core_it->second;
+  }
+  topo.num_sockets = std::max<int>(1, sockets.size());
+  topo.num_physical_cores = std::max<int>(1, cores.size());
+
+  const std::string node_root = sysfs_root + "node/";
+  std::vector<int> nodes;
+  if (ReadLine(node_root + "online", &line)) nodes = ParseCpuList(line);
+  for (int node : nodes) {
+    if (!ReadLine(node_root + "node" + std::to_string(node) + "/cpulist",
+                  &line)) {
+      continue;
+    }
+    auto node_cpus = ParseCpuList(line);
+    if (node_cpus.empty()) continue;  // A memory-only node.
+    for (int cpu : node_cpus) {
+      if (cpu < topo.num_cpus) {
+        topo.cpu_numa_node[cpu] = topo.numa_node_cpus.size();
+      }
+    }
+    topo.numa_node_cpus.push_back(node_cpus);
+  }
+  if (topo.numa_node_cpus.empty()) topo.numa_node_cpus.push_back(cpus);
+  for (auto& node_cpus : topo.numa_node_cpus) {
+    std::stable_partition(node_cpus.begin(),
+                          node_cpus.end(),
+                          [&](int cpu) {
+                            return cpu >= topo.num_cpus || first_thread[cpu];
+                          });
+  }
+  topo.num_numa_nodes = topo.numa_node_cpus.size();
+
+  for (int index = 0; index < 8; index++) {
+    auto dir = cpu_root + "cpu0/cache/index" + std::to_string(index) + "/";
+    if (!ReadLine(dir + "size", &line)) break;
+    size_t size = ParseCacheSize(line);
+    int level = ReadInt(dir + "level", 0);
+    std::string type;
+    ReadLine(dir + "type", &type);
+    if (level == 1 && type != "Instruction") topo.l1d_cache_size = size;
+    if (level == 2) topo.l2_cache_size = size;
+    if (level == 3) topo.l3_cache_size = size;
+  }
+#else
+  topo.num_physical_cores = topo.num_cpus;
+  topo.cpu_socket.assign(topo.num_cpus, 0);
+  topo.cpu_numa_node.assign(topo.num_cpus, 0);
+  topo.numa_node_cpus.resize(1);
+  for (int cpu = 0; cpu < topo.num_cpus; cpu++) {
+    topo.cpu_core.push_back(cpu);
+    topo.numa_node_cpus[0].push_back(cpu);
+  }
+#endif
+  return topo;
+}
+
+namespace {
+
+#ifdef __linux__
+bool SetThreadAffinity(const std::vector<int>& cpus) {
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  for (int cpu : cpus) {
+    if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &mask);
+  }
+  return sched_setaffinity(0, sizeof(mask), &mask) == 0;
+}
+#endif
+
+// The node the calling thread was last pinned to, pinning it again is
+// skipped.
+LITE_THREAD_LOCAL int bound_numa_node = -1;
+
+}  // namespace
+
+const CpuTopology& GetCpuTopology() {
+  static const CpuTopology topology =
+      DetectCpuTopology("/sys/devices/system/");
+  return topology;
+}
+
+bool BindThreadToNumaNode(int node) {
+  const auto& topo = GetCpuTopology();
+  if (node < 0 || node >= topo.num_numa_nodes) {
+    LOG(WARNING) << "NUMA node " << node << " does not exist, the machine has "
+                 << topo.num_numa_nodes << " node(s).";
+    return false;
+  }
+  if (bound_numa_node == node) return true;
+#ifdef __linux__
+  if (!SetThreadAffinity(topo.numa_node_cpus[node])) {
+    LOG(WARNING) << "Failed to pin the thread to NUMA node " << node;
+    return false;
+  }
+  bound_numa_node = node;
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool BindWorkerThreadsToNumaNode(int node, int num_threads) {
+  const auto& topo = GetCpuTopology();
+  if (node < 0 || node >= topo.num_numa_nodes) return false;
+  bool ok = true;
+#if defined(PADDLE_WITH_MKLML) && !defined(__APPLE__)
+  if (num_threads > 1) {
+    // The workers of the team are reused by later parallel regions of the
+    // calling thread and keep the affinity. The calling thread is the
+    // master of the team and is left as it is.
+#pragma omp parallel num_threads(num_threads)
+    {
+      if (omp_get_thread_num() != 0 && !BindThreadToNumaNode(node)) {
+#pragma omp atomic write
+        ok = false;
+      }
+    }
+  }
+#endif
+  return ok;
+}
+
+NumaNodeScope::NumaNodeScope(int node) {
+#ifdef __linux__
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  if (sched_getaffinity(0, sizeof(mask), &mask) != 0) return;
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (CPU_ISSET(cpu, &mask)) saved_cpus_.push_back(cpu);
+  }
+  if (!BindThreadToNumaNode(node)) saved_cpus_.clear();
+#endif
+}
+
+NumaNodeScope::~NumaNodeScope() {
+#ifdef __linux__
+  if (saved_cpus_.empty()) return;
+  SetThreadAffinity(saved_cpus_);
+  bound_numa_node = -1;
+#endif
+}
+
 #ifdef PADDLE_WITH_XBYAK
 static Xbyak::util::Cpu cpu;
 bool MayIUse(const cpu_isa_t cpu_isa) {
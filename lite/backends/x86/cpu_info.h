@@ -15,6 +15,8 @@
 #pragma once
 
 #include <stddef.h>
+#include <string>
+#include <vector>
 
 #ifdef _WIN32
 #if defined(__AVX2__)
@@ -75,6 +77,58 @@ typedef enum {
 // May I use some instruction
 bool MayIUse(const cpu_isa_t cpu_isa);
 
+//! Sockets, NUMA nodes, SMT siblings and caches of the machine, read from
+//! sysfs on Linux. Elsewhere all cpus are reported on one socket and one
+//! node. Ids are dense and start from 0: a node is an index into
+//! numa_node_cpus, which skips the sysfs nodes without cpus, so it may
+//! differ from the sysfs node id.
+struct CpuTopology {
+  int num_cpus{1};
+  int num_sockets{1};
+  int num_physical_cores{1};
+  int num_numa_nodes{1};
+  // Indexed by logical cpu.
+  std::vector<int> cpu_socket;
+  std::vector<int> cpu_core;
+  std::vector<int> cpu_numa_node;
+  // Logical cpus of each node, the first SMT thread of every core first.
+  std::vector<std::vector<int>> numa_node_cpus;
+  size_t l1d_cache_size{0};
+  size_t l2_cache_size{0};
+  size_t l3_cache_size{0};
+};
+
+//! Parse a sysfs cpu list such as "0-3,8,10-11".
+std::vector<int> ParseCpuList(const std::string& list);
+
+//! Read the topology from the sysfs tree under `sysfs_root`, such as
+//! "/sys/devices/system/".
+CpuTopology DetectCpuTopology(const std::string& sysfs_root);
+
+//! Detected once and cached.
+const CpuTopology& GetCpuTopology();
+
+//! Pin the calling thread to the cpus of the NUMA node of dense index
+//! `node`. Returns false when the node does not exist or the system does
+//! not support pinning. The thread stays pinned.
+bool BindThreadToNumaNode(int node);
+
+//! Pin the OpenMP workers the calling thread uses to a NUMA node, but not
+//! the calling thread itself.
+bool BindWorkerThreadsToNumaNode(int node, int num_threads);
+
+//! Pins the calling thread to a NUMA node while it is alive, memory first
+//! touched in the scope is then placed on that node. The previous affinity
+//! is restored on exit.
+class NumaNodeScope {
+ public:
+  explicit NumaNodeScope(int node);
+  ~NumaNodeScope();
+
+ private:
+  std::vector<int> saved_cpus_;
+};
+
 }  // namespace x86
 }  // namespace lite
 }  // namespace paddle
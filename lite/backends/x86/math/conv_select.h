@@ -0,0 +1,70 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// The implementations Conv2dCompute<kFloat, kFloat> picks from.
+enum class Conv2dImpl { kGemm, kDepthwise, kDirect };
+
+// The implementation the fp32 x86 conv2d kernel runs for a filter of
+// `output_channel` x (`input_channel` / `groups`) x `kernel_h` x `kernel_w`.
+// `paddings` is {top, bottom, left, right}. kGemm is im2col and GEMM.
+inline Conv2dImpl SelectConv2dImpl(int input_channel,
+                                   int output_channel,
+                                   int groups,
+                                   int kernel_h,
+                                   int kernel_w,
+                                   const std::vector<int>& strides,
+                                   const std::vector<int>& paddings,
+                                   const std::vector<int>& dilations) {
+  const int stride_h = strides[0];
+  const int stride_w = strides[1];
+  const bool dw_kernel = input_channel == groups && output_channel == groups;
+  const bool ks_equal = stride_h == stride_w && kernel_h == kernel_w;
+  const bool no_dilation = dilations[0] == 1 && dilations[1] == 1;
+  const bool kps_equal = paddings[0] == paddings[2] && ks_equal;
+  const bool pads_equal =
+      paddings[0] == paddings[1] && paddings[2] == paddings[3];
+  const bool stride_1_2 = stride_h == 1 || stride_h == 2;
+  const bool dw_3x3 = kernel_h == 3 && kernel_w == 3 && stride_1_2;
+  const bool dw_5x5 = kernel_h == 5 && kernel_w == 5 && stride_1_2;
+  if (dw_kernel && kps_equal && pads_equal &&
+      ((dw_5x5 && no_dilation) || (dw_3x3 && (groups & 3) == 0))) {
+    return Conv2dImpl::kDepthwise;
+  }
+#if defined(_WIN64) || defined(__MINGW64__) || \
+    (defined(__CYGWIN__) && defined(__x86_64__)) || defined(__x86_64__)
+  // support 3x3s1p01,5x5s1p01,7x7s1p01
+  //  3x3s2p012,5x5s1p012,7x7s1p012
+  const bool pad_all_equal = pads_equal && paddings[1] == paddings[2];
+  if (output_channel % 8 == 0 && groups == 1 &&
+      (kernel_h == 3 || kernel_h == 5 || kernel_h == 7) && stride_1_2 &&
+      no_dilation && kps_equal && pad_all_equal && paddings[0] <= stride_h) {
+    return Conv2dImpl::kDirect;
+  }
+#endif
+  return Conv2dImpl::kGemm;
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
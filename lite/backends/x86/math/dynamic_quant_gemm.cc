@@ -0,0 +1,197 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/dynamic_quant_gemm.h"
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#ifdef __AVX2__
+#include <immintrin.h>
+#include "lite/backends/x86/math/gemm_s8u8_compute.h"
+#elif defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+static float abs_max(const float* x, int K) {
+  float res = 0.f;
+  int k = 0;
+#ifdef __AVX__
+  const __m256 sign = _mm256_set1_ps(-0.f);
+  __m256 vmax = _mm256_setzero_ps();
+  for (; k + 8 <= K; k += 8) {
+    vmax = _mm256_max_ps(vmax, _mm256_andnot_ps(sign, _mm256_loadu_ps(x + k)));
+  }
+  float buf[8];
+  _mm256_storeu_ps(buf, vmax);
+  for (int i = 0; i < 8; ++i) {
+    res = std::max(res, buf[i]);
+  }
+#endif
+  for (; k < K; ++k) {
+    res = std::max(res, fabsf(x[k]));
+  }
+  return res;
+}
+
+// Rounds half to even like _mm256_cvtps_epi32, the callers guarantee that
+// the scaled values fit into int8.
+static void quantize_row(const float* x, int K, float inv_scale, int8_t* q) {
+  int k = 0;
+#ifdef __AVX2__
+  const __m256 vscale = _mm256_set1_ps(inv_scale);
+  for (; k + 8 <= K; k += 8) {
+    __m256i v32 =
+        _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(x + k), vscale));
+    __m128i v16 = _mm_packs_epi32(_mm256_castsi256_si128(v32),
+                                  _mm256_extracti128_si256(v32, 1));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(q + k),
+                     _mm_packs_epi16(v16, v16));
+  }
+#endif
+  for (; k < K; ++k) {
+    q[k] = static_cast<int8_t>(nearbyintf(x[k] * inv_scale));
+  }
+}
+
+void dynamic_quant_weight(
+    const float* w, int K, int N, int8_t* w_int8, float* w_scale) {
+  std::vector<float> col_max(N, 0.f);
+  for (int k = 0; k < K; ++k) {
+    for (int n = 0; n < N; ++n) {
+      col_max[n] = std::max(col_max[n], fabsf(w[k * N + n]));
+    }
+  }
+  for (int n = 0; n < N; ++n) {
+    w_scale[n] = col_max[n] / kDynamicQuantWeightRange;
+  }
+  std::vector<float> col_inv(N, 0.f);
+  for (int n = 0; n < N; ++n) {
+    if (col_max[n] > 0.f) col_inv[n] = kDynamicQuantWeightRange / col_max[n];
+  }
+  for (int k = 0; k < K; ++k) {
+    for (int n = 0; n < N; ++n) {
+      w_int8[k * N + n] =
+          static_cast<int8_t>(nearbyintf(w[k * N + n] * col_inv[n]));
+    }
+  }
+}
+
+void dynamic_quant_pack_weight(const int8_t* w_int8,
+                               int K,
+                               int N,
+                               std::vector<uint8_t>* packed) {
+  packed->clear();
+#ifdef __AVX2__
+  packed->resize(gemm_s8u8_packed_B_size(N, K));
+  gemm_s8u8_prepackB(N, K, w_int8, packed->data(), false);
+#endif
+}
+
+void dynamic_quant_gemm(const float* X,
+                        int M,
+                        int K,
+                        const int8_t* w_int8,
+                        const float* w_scale,
+                        int N,
+                        float alpha,
+                        const float* bias,
+                        int relu_type,
+                        float act_param,
+                        float* Y,
+                        const uint8_t* w_packed) {
+  std::vector<int8_t> x_int8(static_cast<size_t>(M) * K);
+  std::vector<float> x_scale(M);
+#pragma omp parallel for
+  for (int m = 0; m < M; ++m) {
+    float max_val = abs_max(X + static_cast<int64_t>(m) * K, K);
+    x_scale[m] = max_val / kDynamicQuantActRange;
+    quantize_row(X + static_cast<int64_t>(m) * K,
+                 K,
+                 max_val > 0.f ? kDynamicQuantActRange / max_val : 0.f,
+                 x_int8.data() + static_cast<int64_t>(m) * K);
+  }
+
+  // Y = X_int8 * W_int8 * x_scale[m], the column scales are applied below.
+#ifdef __AVX2__
+  generate_gemm_s8u8_x86_kern<float> gemm(false,
+                                          false,
+                                          M,
+                                          N,
+                                          K,
+                                          x_int8.data(),
+                                          N,
+                                          x_scale.data(),
+                                          1.f,
+                                          1.f,
+                                          nullptr,
+                                          0,
+                                          1.f);
+  if (w_packed != nullptr) {
+    gemm.compute_prepacked(x_int8.data(), w_packed, Y);
+  } else {
+    gemm.compute(x_int8.data(), w_int8, Y);
+  }
+#else
+#pragma omp parallel for
+  for (int m = 0; m < M; ++m) {
+    const int8_t* x_row = x_int8.data() + static_cast<int64_t>(m) * K;
+    for (int n = 0; n < N; ++n) {
+      int32_t acc = 0;
+      for (int k = 0; k < K; ++k) {
+        acc += static_cast<int32_t>(x_row[k]) * w_int8[k * N + n];
+      }
+      Y[static_cast<int64_t>(m) * N + n] = acc * x_scale[m];
+    }
+  }
+#endif
+
+  std::vector<float> col_scale(N);
+  std::vector<float> col_bias(N, 0.f);
+  for (int n = 0; n < N; ++n) {
+    col_scale[n] = w_scale[n] * alpha;
+    if (bias) col_bias[n] = bias[n];
+  }
+  const float lower = relu_type > 0 ? 0.f : -INFINITY;
+  const float upper = relu_type == 2 ? act_param : INFINITY;
+#pragma omp parallel for
+  for (int m = 0; m < M; ++m) {
+    float* y = Y + static_cast<int64_t>(m) * N;
+    int n = 0;
+#ifdef __AVX__
+    const __m256 vlower = _mm256_set1_ps(lower);
+    const __m256 vupper = _mm256_set1_ps(upper);
+    for (; n + 8 <= N; n += 8) {
+      __m256 v = _mm256_mul_ps(_mm256_loadu_ps(y + n),
+                               _mm256_loadu_ps(col_scale.data() + n));
+      v = _mm256_add_ps(v, _mm256_loadu_ps(col_bias.data() + n));
+      v = _mm256_min_ps(_mm256_max_ps(v, vlower), vupper);
+      _mm256_storeu_ps(y + n, v);
+    }
+#endif
+    for (; n < N; ++n) {
+      float v = y[n] * col_scale[n] + col_bias[n];
+      y[n] = std::min(std::max(v, lower), upper);
+    }
+  }
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
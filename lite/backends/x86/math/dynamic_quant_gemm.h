@@ -0,0 +1,61 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// Activations are quantized to [-63, 63] so that the pairwise u8 x s8
+// products of the AVX2 int8 gemm can never saturate int16.
+constexpr float kDynamicQuantActRange = 63.f;
+constexpr float kDynamicQuantWeightRange = 127.f;
+
+// Quantizes every column of the [K x N] weight with its own abs-max scale.
+void dynamic_quant_weight(
+    const float* w, int K, int N, int8_t* w_int8, float* w_scale);
+
+// Packs the quantized weight once into the layout consumed by the int8 gemm.
+// `packed` is left empty when the int8 gemm is not available.
+void dynamic_quant_pack_weight(const int8_t* w_int8,
+                               int K,
+                               int N,
+                               std::vector<uint8_t>* packed);
+
+// Y[M x N] = act(X[M x K] * W[K x N] * alpha + bias[N]), where X is quantized
+// per row with its abs-max at runtime and W was quantized per column by
+// dynamic_quant_weight. relu_type: 0 none, 1 relu, 2 relu6(act_param).
+// w_packed, when not null, is w_int8 packed by dynamic_quant_pack_weight.
+void dynamic_quant_gemm(const float* X,
+                        int M,
+                        int K,
+                        const int8_t* w_int8,
+                        const float* w_scale,
+                        int N,
+                        float alpha,
+                        const float* bias,
+                        int relu_type,
+                        float act_param,
+                        float* Y,
+                        const uint8_t* w_packed = nullptr);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
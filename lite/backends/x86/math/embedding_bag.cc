@@ -0,0 +1,262 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/embedding_bag.h"
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+#include "lite/utils/float16.h"
+#include "lite/utils/log/cp_logging.h"
+
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// How many ids ahead of the current one are prefetched, and at most how many
+// cache lines of every prefetched row.
+static const int kPrefetchDistance = 4;
+static const int kPrefetchMaxLines = 16;
+static const int kCacheLineSize = 64;
+
+static inline void prefetch_row(const char* row, int64_t bytes) {
+#ifdef __SSE__
+  int64_t lines = std::min<int64_t>((bytes + kCacheLineSize - 1) /
+                                        kCacheLineSize,
+                                    kPrefetchMaxLines);
+  for (int64_t i = 0; i < lines; i++) {
+    _mm_prefetch(row + i * kCacheLineSize, _MM_HINT_T0);
+  }
+#endif
+}
+
+static inline void accumulate_fp32(const float* src, float* dst, int64_t len) {
+  int64_t i = 0;
+#ifdef __AVX__
+  for (; i + 15 < len; i += 16) {
+    __m256 vdst0 = _mm256_loadu_ps(dst + i);
+    __m256 vdst1 = _mm256_loadu_ps(dst + i + 8);
+    vdst0 = _mm256_add_ps(vdst0, _mm256_loadu_ps(src + i));
+    vdst1 = _mm256_add_ps(vdst1, _mm256_loadu_ps(src + i + 8));
+    _mm256_storeu_ps(dst + i, vdst0);
+    _mm256_storeu_ps(dst + i + 8, vdst1);
+  }
+  for (; i + 7 < len; i += 8) {
+    _mm256_storeu_ps(
+        dst + i,
+        _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_loadu_ps(src + i)));
+  }
+#endif
+#ifdef __SSE__
+  for (; i + 3 < len; i += 4) {
+    _mm_storeu_ps(dst + i,
+                  _mm_add_ps(_mm_loadu_ps(dst + i), _mm_loadu_ps(src + i)));
+  }
+#endif
+  for (; i < len; i++) {
+    dst[i] += src[i];
+  }
+}
+
+static inline void accumulate_fp16(const uint16_t* src,
+                                   float* dst,
+                                   int64_t len) {
+  int64_t i = 0;
+#if defined(__AVX__) && defined(__F16C__)
+  for (; i + 7 < len; i += 8) {
+    __m256 vsrc = _mm256_cvtph_ps(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+    _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), vsrc));
+  }
+#endif
+  const float16* src_half = reinterpret_cast<const float16*>(src);
+  for (; i < len; i++) {
+    dst[i] += static_cast<float>(src_half[i]);
+  }
+}
+
+// bf16 is the upper half of a fp32, widen it with a shift.
+static inline void accumulate_bf16(const uint16_t* src,
+                                   float* dst,
+                                   int64_t len) {
+  int64_t i = 0;
+#ifdef __AVX2__
+  for (; i + 7 < len; i += 8) {
+    __m256i vbits = _mm256_slli_epi32(
+        _mm256_cvtepu16_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i))),
+        16);
+    _mm256_storeu_ps(
+        dst + i,
+        _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_castsi256_ps(vbits)));
+  }
+#endif
+  for (; i < len; i++) {
+    uint32_t bits = static_cast<uint32_t>(src[i]) << 16;
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    dst[i] += value;
+  }
+}
+
+// Same dequantization as the lookup_table_dequant kernel:
+// x = (max - min) / 256 * q + min
+static inline void accumulate_uint8_minmax(const float* row,
+                                           float* dst,
+                                           int64_t len) {
+  const float min = row[0];
+  const float scale = (row[1] - min) / 256.f;
+  const uint8_t* src = reinterpret_cast<const uint8_t*>(row + 2);
+  int64_t i = 0;
+#ifdef __AVX2__
+  __m256 vscale = _mm256_set1_ps(scale);
+  __m256 vmin = _mm256_set1_ps(min);
+  for (; i + 7 < len; i += 8) {
+    __m256i vq = _mm256_cvtepu8_epi32(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)));
+    __m256 vx = _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(vq), vscale),
+                              vmin);
+    _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), vx));
+  }
+#endif
+  for (; i < len; i++) {
+    dst[i] += scale * static_cast<int>(src[i]) + min;
+  }
+}
+
+static inline void scale_row(float* dst, int64_t len, float scale) {
+  int64_t i = 0;
+#ifdef __AVX__
+  __m256 vscale = _mm256_set1_ps(scale);
+  for (; i + 7 < len; i += 8) {
+    _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_loadu_ps(dst + i), vscale));
+  }
+#endif
+  for (; i < len; i++) {
+    dst[i] *= scale;
+  }
+}
+
+template <typename IdT>
+void embedding_bag(const IdT* ids,
+                   const uint64_t* offset,
+                   int bag_num,
+                   const void* table,
+                   EmbeddingTableType table_type,
+                   int64_t row_number,
+                   int64_t row_stride,
+                   int64_t row_width,
+                   int64_t padding_idx,
+                   EmbeddingPoolType pool_type,
+                   float pad_value,
+                   float* out) {
+  const char* table_data = static_cast<const char*>(table);
+
+// Bags are of very different length in CTR workloads, so they are handed out
+// dynamically instead of in equal static chunks.
+#pragma omp parallel for schedule(dynamic, 4)
+  for (int b = 0; b < bag_num; b++) {
+    float* dst = out + b * row_width;
+    const int64_t start = static_cast<int64_t>(offset[b]);
+    const int64_t end = static_cast<int64_t>(offset[b + 1]);
+    if (end == start) {
+      std::fill(dst, dst + row_width, pad_value);
+      continue;
+    }
+    memset(dst, 0, row_width * sizeof(float));
+
+    for (int64_t i = start; i < std::min(start + kPrefetchDistance, end); i++) {
+      if (ids[i] >= 0 && ids[i] < row_number) {
+        prefetch_row(table_data + ids[i] * row_stride, row_stride);
+      }
+    }
+    for (int64_t i = start; i < end; i++) {
+      int64_t next = i + kPrefetchDistance;
+      if (next < end && ids[next] >= 0 && ids[next] < row_number) {
+        prefetch_row(table_data + ids[next] * row_stride, row_stride);
+      }
+      const int64_t id = ids[i];
+      if (padding_idx != -1 && id == padding_idx) {
+        continue;
+      }
+      CHECK_LT(id, row_number) << "embedding_bag ids[i] < row_number check "
+                                  "failed";
+      CHECK_GE(id, 0) << "embedding_bag ids[i] >= 0 check failed";
+      const char* row = table_data + id * row_stride;
+      switch (table_type) {
+        case EmbeddingTableType::kFloat32:
+          accumulate_fp32(reinterpret_cast<const float*>(row), dst, row_width);
+          break;
+        case EmbeddingTableType::kFloat16:
+          accumulate_fp16(
+              reinterpret_cast<const uint16_t*>(row), dst, row_width);
+          break;
+        case EmbeddingTableType::kBFloat16:
+          accumulate_bf16(
+              reinterpret_cast<const uint16_t*>(row), dst, row_width);
+          break;
+        case EmbeddingTableType::kUInt8MinMax:
+          accumulate_uint8_minmax(
+              reinterpret_cast<const float*>(row), dst, row_width);
+          break;
+        default:
+          LOG(FATAL) << "unsupported embedding table type";
+      }
+    }
+
+    const float len = static_cast<float>(end - start);
+    if (pool_type == EmbeddingPoolType::kAverage) {
+      scale_row(dst, row_width, 1.f / len);
+    } else if (pool_type == EmbeddingPoolType::kSqrt) {
+      scale_row(dst, row_width, 1.f / std::sqrt(len));
+    }
+  }
+}
+
+template void embedding_bag<int64_t>(const int64_t* ids,
+                                     const uint64_t* offset,
+                                     int bag_num,
+                                     const void* table,
+                                     EmbeddingTableType table_type,
+                                     int64_t row_number,
+                                     int64_t row_stride,
+                                     int64_t row_width,
+                                     int64_t padding_idx,
+                                     EmbeddingPoolType pool_type,
+                                     float pad_value,
+                                     float* out);
+template void embedding_bag<int32_t>(const int32_t* ids,
+                                     const uint64_t* offset,
+                                     int bag_num,
+                                     const void* table,
+                                     EmbeddingTableType table_type,
+                                     int64_t row_number,
+                                     int64_t row_stride,
+                                     int64_t row_width,
+                                     int64_t padding_idx,
+                                     EmbeddingPoolType pool_type,
+                                     float pad_value,
+                                     float* out);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
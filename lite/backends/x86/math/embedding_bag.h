@@ -0,0 +1,60 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+enum class EmbeddingTableType {
+  kFloat32 = 0,
+  kFloat16,
+  // bf16 bits, see QuantType::QUANT_BF16
+  kBFloat16,
+  // Row layout of lookup_table_dequant: [min, max, uint8 x (width - 2) * 4]
+  kUInt8MinMax,
+};
+
+enum class EmbeddingPoolType {
+  kSum = 0,
+  kAverage,
+  kSqrt,
+};
+
+// Gathers the rows of `table` selected by `ids` and reduces every bag
+// [offset[i], offset[i + 1]) into one row of `out` (bag_num x row_width).
+// `row_stride` is the size in bytes of one stored table row. IdT is int64_t
+// or int32_t.
+template <typename IdT>
+void embedding_bag(const IdT* ids,
+                   const uint64_t* offset,
+                   int bag_num,
+                   const void* table,
+                   EmbeddingTableType table_type,
+                   int64_t row_number,
+                   int64_t row_stride,
+                   int64_t row_width,
+                   int64_t padding_idx,
+                   EmbeddingPoolType pool_type,
+                   float pad_value,
+                   float* out);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
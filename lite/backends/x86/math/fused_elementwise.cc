@@ -0,0 +1,221 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/fused_elementwise.h"
+#include <string.h>
+#ifdef __AVX__
+#include <immintrin.h>
+#include "lite/backends/x86/math/avx/avx_mathfuns.h"
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+using host::math::FusedElementwiseApply;
+using host::math::FusedElementwiseInstr;
+using host::math::FusedElementwiseOpcode;
+
+#ifdef __AVX__
+template <typename VecOp>
+static void unary_loop(const FusedElementwiseInstr& instr,
+                       int len,
+                       float* acc,
+                       VecOp op) {
+  int i = 0;
+  for (; i + 8 <= len; i += 8) {
+    _mm256_storeu_ps(acc + i, op(_mm256_loadu_ps(acc + i)));
+  }
+  for (; i < len; ++i) {
+    acc[i] = FusedElementwiseApply(instr, acc[i], 0.f);
+  }
+}
+
+template <typename VecOp>
+static void binary_loop(const FusedElementwiseInstr& instr,
+                        const float* b,
+                        bool b_scalar,
+                        int len,
+                        float* acc,
+                        VecOp op) {
+  int i = 0;
+  if (b_scalar) {
+    const __m256 vb = _mm256_set1_ps(b[0]);
+    for (; i + 8 <= len; i += 8) {
+      _mm256_storeu_ps(acc + i, op(_mm256_loadu_ps(acc + i), vb));
+    }
+    for (; i < len; ++i) {
+      acc[i] = FusedElementwiseApply(instr, acc[i], b[0]);
+    }
+    return;
+  }
+  for (; i + 8 <= len; i += 8) {
+    _mm256_storeu_ps(acc + i,
+                     op(_mm256_loadu_ps(acc + i), _mm256_loadu_ps(b + i)));
+  }
+  for (; i < len; ++i) {
+    acc[i] = FusedElementwiseApply(instr, acc[i], b[i]);
+  }
+}
+
+static inline __m256 sigmoid_m256(__m256 x) {
+  const __m256 one = _mm256_set1_ps(1.f);
+  __m256 e = exp256_ps(_mm256_sub_ps(_mm256_setzero_ps(), x));
+  return _mm256_div_ps(one, _mm256_add_ps(one, e));
+}
+
+// Returns false for the opcodes without a vector implementation.
+static bool eval_avx(const FusedElementwiseInstr& instr,
+                     const float* b,
+                     bool b_scalar,
+                     int len,
+                     float* acc) {
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 one = _mm256_set1_ps(1.f);
+  const __m256 p0 = _mm256_set1_ps(instr.p0);
+  const __m256 p1 = _mm256_set1_ps(instr.p1);
+  const __m256 p2 = _mm256_set1_ps(instr.p2);
+  switch (instr.opcode) {
+    case FusedElementwiseOpcode::kAdd:
+      binary_loop(instr, b, b_scalar, len, acc, [](__m256 a, __m256 v) {
+        return _mm256_add_ps(a, v);
+      });
+      return true;
+    case FusedElementwiseOpcode::kSub:
+      binary_loop(instr, b, b_scalar, len, acc, [](__m256 a, __m256 v) {
+        return _mm256_sub_ps(a, v);
+      });
+      return true;
+    case FusedElementwiseOpcode::kRsub:
+      binary_loop(instr, b, b_scalar, len, acc, [](__m256 a, __m256 v) {
+        return _mm256_sub_ps(v, a);
+      });
+      return true;
+    case FusedElementwiseOpcode::kMul:
+      binary_loop(instr, b, b_scalar, len, acc, [](__m256 a, __m256 v) {
+        return _mm256_mul_ps(a, v);
+      });
+      return true;
+    case FusedElementwiseOpcode::kDiv:
+      binary_loop(instr, b, b_scalar, len, acc, [](__m256 a, __m256 v) {
+        return _mm256_div_ps(a, v);
+      });
+      return true;
+    case FusedElementwiseOpcode::kRdiv:
+      binary_loop(instr, b, b_scalar, len, acc, [](__m256 a, __m256 v) {
+        return _mm256_div_ps(v, a);
+      });
+      return true;
+    case FusedElementwiseOpcode::kMax:
+      binary_loop(instr, b, b_scalar, len, acc, [](__m256 a, __m256 v) {
+        return _mm256_max_ps(a, v);
+      });
+      return true;
+    case FusedElementwiseOpcode::kMin:
+      binary_loop(instr, b, b_scalar, len, acc, [](__m256 a, __m256 v) {
+        return _mm256_min_ps(a, v);
+      });
+      return true;
+    case FusedElementwiseOpcode::kScale:
+      unary_loop(instr, len, acc, [&](__m256 a) {
+        return _mm256_fmadd_ps(a, p0, p1);
+      });
+      return true;
+    case FusedElementwiseOpcode::kRelu:
+      unary_loop(
+          instr, len, acc, [&](__m256 a) { return _mm256_max_ps(a, zero); });
+      return true;
+    case FusedElementwiseOpcode::kRelu6:
+      unary_loop(instr, len, acc, [&](__m256 a) {
+        return _mm256_min_ps(_mm256_max_ps(a, zero), p0);
+      });
+      return true;
+    case FusedElementwiseOpcode::kLeakyRelu:
+      unary_loop(instr, len, acc, [&](__m256 a) {
+        __m256 mask = _mm256_cmp_ps(a, zero, _CMP_GT_OS);
+        return _mm256_blendv_ps(_mm256_mul_ps(a, p0), a, mask);
+      });
+      return true;
+    case FusedElementwiseOpcode::kSigmoid:
+      unary_loop(instr, len, acc, [&](__m256 a) { return sigmoid_m256(a); });
+      return true;
+    case FusedElementwiseOpcode::kTanh: {
+      // tanh(x) = 2 * sigmoid(2x) - 1
+      const __m256 two = _mm256_set1_ps(2.f);
+      unary_loop(instr, len, acc, [&](__m256 a) {
+        __m256 s = sigmoid_m256(_mm256_mul_ps(a, two));
+        return _mm256_sub_ps(_mm256_mul_ps(s, two), one);
+      });
+      return true;
+    }
+    case FusedElementwiseOpcode::kSwish:
+      unary_loop(instr, len, acc, [&](__m256 a) {
+        return _mm256_mul_ps(a, sigmoid_m256(_mm256_mul_ps(a, p0)));
+      });
+      return true;
+    case FusedElementwiseOpcode::kHardSigmoid:
+      unary_loop(instr, len, acc, [&](__m256 a) {
+        __m256 v = _mm256_fmadd_ps(a, p0, p1);
+        return _mm256_min_ps(_mm256_max_ps(v, zero), one);
+      });
+      return true;
+    case FusedElementwiseOpcode::kHardSwish:
+      unary_loop(instr, len, acc, [&](__m256 a) {
+        __m256 v = _mm256_min_ps(_mm256_max_ps(_mm256_add_ps(a, p2), zero), p0);
+        return _mm256_div_ps(_mm256_mul_ps(a, v), p1);
+      });
+      return true;
+    case FusedElementwiseOpcode::kExp:
+      unary_loop(instr, len, acc, [&](__m256 a) { return exp256_ps(a); });
+      return true;
+    case FusedElementwiseOpcode::kAbs: {
+      const __m256 sign = _mm256_set1_ps(-0.f);
+      unary_loop(instr, len, acc, [&](__m256 a) {
+        return _mm256_andnot_ps(sign, a);
+      });
+      return true;
+    }
+  }
+  return false;
+}
+#endif
+
+void fused_elementwise_eval(const std::vector<FusedElementwiseInstr>& program,
+                            const float* const* x,
+                            const bool* x_scalar,
+                            int len,
+                            float* acc) {
+  if (x_scalar[0]) {
+    std::fill(acc, acc + len, x[0][0]);
+  } else {
+    memcpy(acc, x[0], len * sizeof(float));
+  }
+  for (const auto& instr : program) {
+    const float* b = instr.input >= 0 ? x[instr.input] : nullptr;
+    const bool b_scalar = instr.input >= 0 ? x_scalar[instr.input] : true;
+#ifdef __AVX__
+    if (eval_avx(instr, b, b_scalar, len, acc)) continue;
+#endif
+    for (int i = 0; i < len; ++i) {
+      float v = b == nullptr ? 0.f : (b_scalar ? b[0] : b[i]);
+      acc[i] = FusedElementwiseApply(instr, acc[i], v);
+    }
+  }
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
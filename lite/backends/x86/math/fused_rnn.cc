@@ -0,0 +1,220 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/fused_rnn.h"
+#include <string.h>
+#include <algorithm>
+#include <numeric>
+#include "lite/backends/x86/jit/kernels.h"
+#include "lite/backends/x86/legacy_place.h"
+#include "lite/backends/x86/math/blas.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// Packed gate s of LSTM comes from gate kLstmGateSrc[s] of the rnn op, the
+// jit kernel takes c, i, f, o.
+static const int kLstmGateSrc[4] = {2, 0, 1, 3};
+
+void FusedRnnCell::Init(bool lstm,
+                        int input_size,
+                        int hidden_size,
+                        const float* w_ih,
+                        const float* w_hh,
+                        const float* b_ih,
+                        const float* b_hh) {
+  lstm_ = lstm;
+  input_size_ = input_size;
+  hidden_size_ = hidden_size;
+  const int gates = lstm ? 4 : 3;
+  const int H = hidden_size;
+  const int GH = gates * H;
+  w_ih_.resize(static_cast<size_t>(input_size) * GH);
+  w_hh_.resize(static_cast<size_t>(H) * GH);
+  bias_.resize(GH);
+  for (int s = 0; s < gates; ++s) {
+    const int src = lstm ? kLstmGateSrc[s] : s;
+    for (int h = 0; h < H; ++h) {
+      const int row = src * H + h;
+      const int col = s * H + h;
+      for (int k = 0; k < input_size; ++k) {
+        w_ih_[static_cast<size_t>(k) * GH + col] =
+            w_ih[static_cast<size_t>(row) * input_size + k];
+      }
+      for (int k = 0; k < H; ++k) {
+        w_hh_[static_cast<size_t>(k) * GH + col] =
+            w_hh[static_cast<size_t>(row) * H + k];
+      }
+      // The GRU candidate adds b_hh to W_hh * h before the reset gate.
+      const bool hidden_bias = lstm || s < 2;
+      bias_[col] = b_ih[row] + (hidden_bias ? b_hh[row] : 0.f);
+    }
+  }
+  if (!lstm) {
+    bias_hc_.assign(b_hh + 2 * H, b_hh + 3 * H);
+  }
+}
+
+// gates holds x_r, x_z, x_c of one row and hh the W_hh * h part, the new
+// hidden state replaces h:
+//   r = sigmoid(x_r + hh_r), z = sigmoid(x_z + hh_z)
+//   c = tanh(x_c + r * (hh_c + b_hc)), h = (1 - z) * c + z * h
+static void gru_epilogue(float* gates,
+                         const float* hh,
+                         const float* bias_hc,
+                         int H,
+                         void (*act_gate)(const float*, float*, int),
+                         void (*act_cand)(const float*, float*, int),
+                         float* h) {
+  float* r = gates;
+  float* z = gates + H;
+  float* c = gates + 2 * H;
+  for (int i = 0; i < 2 * H; ++i) gates[i] += hh[i];
+  act_gate(gates, gates, 2 * H);
+  for (int i = 0; i < H; ++i) c[i] += r[i] * (hh[2 * H + i] + bias_hc[i]);
+  act_cand(c, c, H);
+  for (int i = 0; i < H; ++i) h[i] = c[i] + z[i] * (h[i] - c[i]);
+}
+
+void FusedRnnCell::Forward(const X86Context& ctx,
+                           const float* x,
+                           int steps,
+                           int batch,
+                           const int* seq_len,
+                           bool reverse,
+                           const float* h0,
+                           const float* c0,
+                           float* out,
+                           int out_stride,
+                           float* last_h,
+                           float* last_c) const {
+  const int H = hidden_size_;
+  const int GH = (lstm_ ? 4 : 3) * H;
+  const int rows = steps * batch;
+  Blas<lite::TargetType::kX86> blas(ctx);
+
+  // The input projection and the biases of all the steps at once.
+  std::vector<float> x_proj(static_cast<size_t>(rows) * GH);
+  for (int i = 0; i < rows; ++i) {
+    memcpy(x_proj.data() + static_cast<size_t>(i) * GH,
+           bias_.data(),
+           sizeof(float) * GH);
+  }
+  blas.GEMM<float>(false,
+                   false,
+                   rows,
+                   GH,
+                   input_size_,
+                   1.f,
+                   x,
+                   input_size_,
+                   w_ih_.data(),
+                   GH,
+                   1.f,
+                   x_proj.data(),
+                   GH);
+
+  // Batch rows by decreasing length, the state is kept in that order.
+  std::vector<int> order(batch);
+  std::iota(order.begin(), order.end(), 0);
+  if (seq_len) {
+    std::stable_sort(order.begin(), order.end(), [seq_len](int a, int b) {
+      return seq_len[a] > seq_len[b];
+    });
+  }
+  std::vector<float> h(static_cast<size_t>(batch) * H);
+  std::vector<float> c(lstm_ ? h.size() : 0);
+  std::vector<float> gates(static_cast<size_t>(batch) * GH);
+  std::vector<float> hh(lstm_ ? 0 : gates.size());
+  for (int j = 0; j < batch; ++j) {
+    memcpy(&h[j * H], h0 + order[j] * H, sizeof(float) * H);
+    if (lstm_) memcpy(&c[j * H], c0 + order[j] * H, sizeof(float) * H);
+  }
+
+  typedef lite::fluid::CPUPlace Place;
+  jit::lstm_attr_t lstm_attr(H, jit::kVSigmoid, jit::kVTanh, jit::kVTanh);
+  auto lstm_func =
+      lstm_ ? jit::KernelFuncs<jit::LSTMCtHtTuple<float>, Place>::Cache().At(
+                  lstm_attr)
+            : nullptr;
+  auto act_gate =
+      jit::KernelFuncs<jit::VSigmoidTuple<float>, Place>::Cache().At(2 * H);
+  auto act_cand =
+      jit::KernelFuncs<jit::VTanhTuple<float>, Place>::Cache().At(H);
+
+  for (int t = 0; t < steps; ++t) {
+    const int step = reverse ? steps - 1 - t : t;
+    int active = batch;
+    while (seq_len && active > 0 && seq_len[order[active - 1]] <= step) {
+      active--;
+    }
+    float* out_step = out + static_cast<size_t>(step) * batch * out_stride;
+    for (int j = active; j < batch; ++j) {
+      memset(out_step + order[j] * out_stride, 0, sizeof(float) * H);
+    }
+    if (active == 0) continue;
+
+    const float* proj_step =
+        x_proj.data() + static_cast<size_t>(step) * batch * GH;
+    for (int j = 0; j < active; ++j) {
+      memcpy(&gates[j * GH], proj_step + order[j] * GH, sizeof(float) * GH);
+    }
+    // LSTM accumulates W_hh * h into the gates, GRU needs it apart for the
+    // reset gate.
+    blas.GEMM<float>(false,
+                     false,
+                     active,
+                     GH,
+                     H,
+                     1.f,
+                     h.data(),
+                     H,
+                     w_hh_.data(),
+                     GH,
+                     lstm_ ? 1.f : 0.f,
+                     lstm_ ? gates.data() : hh.data(),
+                     GH);
+    for (int j = 0; j < active; ++j) {
+      if (lstm_) {
+        jit::lstm_t cell;
+        cell.gates = &gates[j * GH];
+        cell.ct_1 = &c[j * H];
+        cell.ct = &c[j * H];
+        cell.ht = &h[j * H];
+        lstm_func(&cell, &lstm_attr);
+      } else {
+        gru_epilogue(&gates[j * GH],
+                     &hh[j * GH],
+                     bias_hc_.data(),
+                     H,
+                     act_gate,
+                     act_cand,
+                     &h[j * H]);
+      }
+      memcpy(out_step + order[j] * out_stride, &h[j * H], sizeof(float) * H);
+    }
+  }
+
+  for (int j = 0; j < batch; ++j) {
+    memcpy(last_h + order[j] * H, &h[j * H], sizeof(float) * H);
+    if (lstm_) memcpy(last_c + order[j] * H, &c[j * H], sizeof(float) * H);
+  }
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,80 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vector>
+#include "lite/core/context.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// One direction of one layer of the rnn op in LSTM or GRU mode.
+//
+// The weights are packed once into row-major [in, gates * hidden] matrices.
+// Forward computes the input projection of all the steps with one GEMM,
+// then every step is a single GEMM of the hidden state by the recurrent
+// weight followed by a fused gate epilogue. The batch is ordered by
+// decreasing sequence length so that the rows still running at a step are
+// a prefix, the finished ones are skipped instead of masked.
+class FusedRnnCell {
+ public:
+  // w_ih is [gates * hidden, input], w_hh is [gates * hidden, hidden] and
+  // the biases are [gates * hidden], with the gates in the rnn op order:
+  // i, f, c, o for LSTM and r, z, c for GRU.
+  void Init(bool lstm,
+            int input_size,
+            int hidden_size,
+            const float* w_ih,
+            const float* w_hh,
+            const float* b_ih,
+            const float* b_hh);
+
+  // x is [steps, batch, input]. The hidden state of step t and batch b is
+  // written to out + (t * batch + b) * out_stride, the steps past the end
+  // of a sequence are zero. `seq_len` may be null when all sequences are
+  // full, `c0` and `last_c` are only used by LSTM.
+  void Forward(const X86Context& ctx,
+               const float* x,
+               int steps,
+               int batch,
+               const int* seq_len,
+               bool reverse,
+               const float* h0,
+               const float* c0,
+               float* out,
+               int out_stride,
+               float* last_h,
+               float* last_c) const;
+
+ private:
+  bool lstm_{true};
+  int input_size_{0};
+  int hidden_size_{0};
+  // [input, gates * hidden] and [hidden, gates * hidden], for LSTM the
+  // gates are reordered to c, i, f, o as the jit LSTMCtHt kernel expects.
+  std::vector<float> w_ih_;
+  std::vector<float> w_hh_;
+  // b_ih + b_hh, except the GRU candidate which only takes b_ih.
+  std::vector<float> bias_;
+  // b_hh of the GRU candidate, added before the reset gate is applied.
+  std::vector<float> bias_hc_;
+};
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -26,6 +26,20 @@ namespace lite {
 namespace x86 {
 namespace math {
 
+// Size in bytes of B[K x N] packed by gemm_s8u8_prepackB.
+inline size_t gemm_s8u8_packed_B_size(int N, int K) {
+  return static_cast<size_t>(N) * (((K + 3) >> 2) << 2);
+}
+
+// Packs the whole B once, e.g. constant weights, for
+// generate_gemm_s8u8_x86_kern::compute_prepacked. B is [K x N], or [N x K]
+// when is_trans. The 32-column panels of runpackB make the packed blocks
+// that compute() walks contiguous slices of this buffer.
+inline void gemm_s8u8_prepackB(
+    int N, int K, const int8_t *B, uint8_t *packed_B, bool is_trans) {
+  gemm_s8u8s8_runpackB(N, K, is_trans ? K : N, B, packed_B, is_trans);
+}
+
 #define PARAM_INIT               \
   _is_trans_A = is_trans_A;      \
   _is_trans_B = is_trans_B;      \
@@ -63,6 +77,18 @@ class generate_gemm_s8u8_x86_kern {
   ~generate_gemm_s8u8_x86_kern() { gemm_int8_deinit(); }
 
   void compute(const int8_t *A, const int8_t *B, TYPE_C *C) {
+    run(B, nullptr, C);
+  }
+
+  // Same as compute() with B packed by gemm_s8u8_prepackB beforehand.
+  void compute_prepacked(const int8_t *A,
+                         const uint8_t *packed_B,
+                         TYPE_C *C) {
+    run(nullptr, packed_B, C);
+  }
+
+ private:
+  void run(const int8_t *B, const uint8_t *packed_B, TYPE_C *C) {
     if (_relu_type < 0 || _relu_type > 3) {
       LOG(FATAL) << "relu_type: 1 for relu, 2 for relu6, 3 for leakyrelu, but "
                     "receive is "
@@ -80,9 +106,14 @@ class generate_gemm_s8u8_x86_kern {
     calc_block(_M, _N, _K, &block_m, &block_n);
     for (loop_n = 0; loop_n < _N; loop_n += block_n) {
       min_n = ((_N - loop_n) >= block_n) ? block_n : (_N - loop_n);
-      cur_b = _is_trans_B ? (_B + loop_n * _K) : (_B + loop_n);
-      int step = _is_trans_B ? _K : _N;
-      packB_i82u8(min_n, _K, step, cur_b, _pack_B, _is_trans_B);
+      uint8_t *cur_pack_b = _pack_B;
+      if (packed_B != nullptr) {
+        cur_pack_b = const_cast<uint8_t *>(packed_B) + loop_n * _k_align4;
+      } else {
+        cur_b = _is_trans_B ? (_B + loop_n * _K) : (_B + loop_n);
+        int step = _is_trans_B ? _K : _N;
+        packB_i82u8(min_n, _K, step, cur_b, _pack_B, _is_trans_B);
+      }
 
       for (loop_m = 0; loop_m < _M; loop_m += block_m) {
         min_m = ((_M - loop_m) >= block_m) ? block_m : (_M - loop_m);
@@ -94,7 +125,7 @@ class generate_gemm_s8u8_x86_kern {
                               min_n,
                               _K,
                               cur_a,
-                              _pack_B,
+                              cur_pack_b,
                               cur_c,
                               _ldc,
                               _scale + loop_m,
@@ -105,7 +136,6 @@ class generate_gemm_s8u8_x86_kern {
     }
   }
 
- private:
   // inner param
   int _k_align4;
   int _relu_type;
@@ -0,0 +1,217 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/half_weight_gemm.h"
+#include <algorithm>
+#include "lite/backends/host/math/half_weight.h"
+#if defined(__AVX2__) && defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// Columns and rows of Y computed by one task, the weight strip of a task
+// (K x 16 halves) is reused from cache by all its row blocks.
+static const int kHalfGemmCols = 16;
+static const int kHalfGemmRows = 64;
+
+template <bool kBF16>
+static inline float half_to_float(uint16_t h) {
+  return kBF16 ? host::math::bf16_to_float(h) : host::math::fp16_to_float(h);
+}
+
+static inline float epilogue(float v,
+                             float alpha,
+                             const float* bias,
+                             int n,
+                             bool relu) {
+  v = v * alpha + (bias ? bias[n] : 0.f);
+  return relu ? std::max(v, 0.f) : v;
+}
+
+// Rows [m_begin, m_end) and columns [n_begin, n_end) of Y, one element at
+// a time.
+template <bool kBF16>
+static void gemm_scalar(const float* X,
+                        int K,
+                        const uint16_t* W,
+                        int N,
+                        int m_begin,
+                        int m_end,
+                        int n_begin,
+                        int n_end,
+                        float alpha,
+                        const float* bias,
+                        bool relu,
+                        float* Y) {
+  for (int m = m_begin; m < m_end; ++m) {
+    const float* x = X + static_cast<int64_t>(m) * K;
+    for (int n = n_begin; n < n_end; ++n) {
+      float acc = 0.f;
+      for (int k = 0; k < K; ++k) {
+        acc += x[k] * half_to_float<kBF16>(W[static_cast<int64_t>(k) * N + n]);
+      }
+      Y[static_cast<int64_t>(m) * N + n] = epilogue(acc, alpha, bias, n, relu);
+    }
+  }
+}
+
+#if defined(__AVX2__) && defined(__F16C__)
+template <bool kBF16>
+static inline __m256 load_half8(const uint16_t* p) {
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  if (kBF16) {
+    // bf16 is the upper half of the fp32 bits.
+    return _mm256_castsi256_ps(
+        _mm256_slli_epi32(_mm256_cvtepu16_epi32(v), 16));
+  }
+  return _mm256_cvtph_ps(v);
+}
+
+static inline __m256 fmadd_m256(__m256 a, __m256 b, __m256 c) {
+#ifdef __FMA__
+  return _mm256_fmadd_ps(a, b, c);
+#else
+  return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+}
+
+// Up to 4 rows of Y from X and Y at row m, W, bias and Y at column n, over
+// kVecs * 8 columns. The missing rows repeat the last valid one.
+template <bool kBF16, int kVecs>
+static void kernel_4rows(const float* X,
+                         int K,
+                         const uint16_t* W,
+                         int N,
+                         int rows,
+                         float alpha,
+                         const float* bias,
+                         bool relu,
+                         float* Y) {
+  const float* x[4];
+  float* y[4];
+  for (int r = 0; r < 4; ++r) {
+    int row = std::min(r, rows - 1);
+    x[r] = X + static_cast<int64_t>(row) * K;
+    y[r] = Y + static_cast<int64_t>(row) * N;
+  }
+  __m256 acc[4][kVecs];
+  for (int r = 0; r < 4; ++r) {
+    for (int v = 0; v < kVecs; ++v) acc[r][v] = _mm256_setzero_ps();
+  }
+  for (int k = 0; k < K; ++k) {
+    const uint16_t* w_row = W + static_cast<int64_t>(k) * N;
+    __m256 w[kVecs];
+    for (int v = 0; v < kVecs; ++v) w[v] = load_half8<kBF16>(w_row + v * 8);
+    for (int r = 0; r < 4; ++r) {
+      __m256 xb = _mm256_set1_ps(x[r][k]);
+      for (int v = 0; v < kVecs; ++v) {
+        acc[r][v] = fmadd_m256(xb, w[v], acc[r][v]);
+      }
+    }
+  }
+  const __m256 valpha = _mm256_set1_ps(alpha);
+  for (int v = 0; v < kVecs; ++v) {
+    __m256 vbias = bias ? _mm256_loadu_ps(bias + v * 8) : _mm256_setzero_ps();
+    for (int r = 0; r < 4; ++r) {
+      __m256 out = fmadd_m256(acc[r][v], valpha, vbias);
+      if (relu) out = _mm256_max_ps(out, _mm256_setzero_ps());
+      _mm256_storeu_ps(y[r] + v * 8, out);
+    }
+  }
+}
+#endif
+
+template <bool kBF16>
+static void half_weight_gemm_impl(const float* X,
+                                  int M,
+                                  int K,
+                                  const uint16_t* W,
+                                  int N,
+                                  float alpha,
+                                  const float* bias,
+                                  bool relu,
+                                  float* Y) {
+  const int col_blocks = (N + kHalfGemmCols - 1) / kHalfGemmCols;
+  const int row_blocks = (M + kHalfGemmRows - 1) / kHalfGemmRows;
+#pragma omp parallel for
+  for (int task = 0; task < col_blocks * row_blocks; ++task) {
+    const int n_begin = (task % col_blocks) * kHalfGemmCols;
+    const int n_end = std::min(n_begin + kHalfGemmCols, N);
+    const int m_begin = (task / col_blocks) * kHalfGemmRows;
+    const int m_end = std::min(m_begin + kHalfGemmRows, M);
+    int n = n_begin;
+#if defined(__AVX2__) && defined(__F16C__)
+    const float* b = bias ? bias + n_begin : nullptr;
+    for (int m = m_begin; m < m_end; m += 4) {
+      const float* x = X + static_cast<int64_t>(m) * K;
+      float* y = Y + static_cast<int64_t>(m) * N + n_begin;
+      const int rows = std::min(4, m_end - m);
+      if (n_end - n_begin == 16) {
+        kernel_4rows<kBF16, 2>(
+            x, K, W + n_begin, N, rows, alpha, b, relu, y);
+      } else if (n_end - n_begin >= 8) {
+        kernel_4rows<kBF16, 1>(
+            x, K, W + n_begin, N, rows, alpha, b, relu, y);
+      }
+    }
+    n += (n_end - n_begin) / 8 * 8;
+#endif
+    gemm_scalar<kBF16>(
+        X, K, W, N, m_begin, m_end, n, n_end, alpha, bias, relu, Y);
+  }
+}
+
+void half_weight_gemm(const float* X,
+                      int M,
+                      int K,
+                      const uint16_t* W,
+                      bool bf16,
+                      int N,
+                      float alpha,
+                      const float* bias,
+                      bool relu,
+                      float* Y) {
+  if (bf16) {
+    half_weight_gemm_impl<true>(X, M, K, W, N, alpha, bias, relu, Y);
+  } else {
+    half_weight_gemm_impl<false>(X, M, K, W, N, alpha, bias, relu, Y);
+  }
+}
+
+void half_weight_to_float(const uint16_t* src,
+                          int64_t len,
+                          bool bf16,
+                          float* dst) {
+  int64_t i = 0;
+#if defined(__AVX2__) && defined(__F16C__)
+  for (; i + 8 <= len; i += 8) {
+    _mm256_storeu_ps(dst + i,
+                     bf16 ? load_half8<true>(src + i)
+                          : load_half8<false>(src + i));
+  }
+#endif
+  for (; i < len; ++i) {
+    dst[i] = bf16 ? host::math::bf16_to_float(src[i])
+                  : host::math::fp16_to_float(src[i]);
+  }
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
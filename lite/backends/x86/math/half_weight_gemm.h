@@ -0,0 +1,49 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// Y[M x N] = act(alpha * X[M x K] * W[K x N] + bias[N]) where W is stored
+// as fp16 (bf16 = false) or bf16 bits. The weights are widened to fp32 in
+// registers right before use and accumulated in fp32, so only half of the
+// weight bytes are read from memory. `bias` may be null, `relu` applies
+// max(0, x) at the end.
+void half_weight_gemm(const float* X,
+                      int M,
+                      int K,
+                      const uint16_t* W,
+                      bool bf16,
+                      int N,
+                      float alpha,
+                      const float* bias,
+                      bool relu,
+                      float* Y);
+
+// dst[i] = float(src[i]) for fp16 or bf16 bits.
+void half_weight_to_float(const uint16_t* src,
+                          int64_t len,
+                          bool bf16,
+                          float* dst);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,297 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/permute.h"
+#include <string.h>
+#include <algorithm>
+#include "lite/utils/log/cp_logging.h"
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// Edge of the square blocks of the 2D transposes, a block of 4 byte
+// elements and its transposed copy take 8KB and stay in L1.
+static const int64_t kPermuteBlock = 32;
+
+// Out dim i holds shape[i] elements at a stride of src_strides[i] in the
+// input, the output itself is dense.
+struct PermutePlan {
+  std::vector<int64_t> shape;
+  std::vector<int64_t> src_strides;
+};
+
+static PermutePlan simplify(const std::vector<int64_t>& dims,
+                            const std::vector<int>& axis) {
+  const int rank = static_cast<int>(dims.size());
+  std::vector<int64_t> in_strides(rank, 1);
+  for (int i = rank - 2; i >= 0; --i) {
+    in_strides[i] = in_strides[i + 1] * dims[i + 1];
+  }
+  PermutePlan plan;
+  for (int i = 0; i < rank; ++i) {
+    const int64_t size = dims[axis[i]];
+    const int64_t stride = in_strides[axis[i]];
+    if (size == 1) continue;
+    if (!plan.shape.empty() && plan.src_strides.back() == stride * size) {
+      plan.shape.back() *= size;
+      plan.src_strides.back() = stride;
+    } else {
+      plan.shape.push_back(size);
+      plan.src_strides.push_back(stride);
+    }
+  }
+  return plan;
+}
+
+template <typename T>
+static void transpose_scalar(const T* src,
+                             int64_t lda,
+                             T* dst,
+                             int64_t ldb,
+                             int64_t rows,
+                             int64_t cols) {
+  for (int64_t j = 0; j < cols; ++j) {
+    for (int64_t i = 0; i < rows; ++i) {
+      dst[j * ldb + i] = src[i * lda + j];
+    }
+  }
+}
+
+template <typename T>
+static void transpose_block(const T* src,
+                            int64_t lda,
+                            T* dst,
+                            int64_t ldb,
+                            int64_t rows,
+                            int64_t cols) {
+  transpose_scalar(src, lda, dst, ldb, rows, cols);
+}
+
+#ifdef __AVX__
+static inline void transpose8x8(const float* src,
+                                int64_t lda,
+                                float* dst,
+                                int64_t ldb) {
+  __m256 r0 = _mm256_loadu_ps(src);
+  __m256 r1 = _mm256_loadu_ps(src + lda);
+  __m256 r2 = _mm256_loadu_ps(src + 2 * lda);
+  __m256 r3 = _mm256_loadu_ps(src + 3 * lda);
+  __m256 r4 = _mm256_loadu_ps(src + 4 * lda);
+  __m256 r5 = _mm256_loadu_ps(src + 5 * lda);
+  __m256 r6 = _mm256_loadu_ps(src + 6 * lda);
+  __m256 r7 = _mm256_loadu_ps(src + 7 * lda);
+  __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+  __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+  __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+  __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+  __m256 t4 = _mm256_unpacklo_ps(r4, r5);
+  __m256 t5 = _mm256_unpackhi_ps(r4, r5);
+  __m256 t6 = _mm256_unpacklo_ps(r6, r7);
+  __m256 t7 = _mm256_unpackhi_ps(r6, r7);
+  __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+  __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+  __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+  __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+  __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+  __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+  __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+  __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+  _mm256_storeu_ps(dst, _mm256_permute2f128_ps(s0, s4, 0x20));
+  _mm256_storeu_ps(dst + ldb, _mm256_permute2f128_ps(s1, s5, 0x20));
+  _mm256_storeu_ps(dst + 2 * ldb, _mm256_permute2f128_ps(s2, s6, 0x20));
+  _mm256_storeu_ps(dst + 3 * ldb, _mm256_permute2f128_ps(s3, s7, 0x20));
+  _mm256_storeu_ps(dst + 4 * ldb, _mm256_permute2f128_ps(s0, s4, 0x31));
+  _mm256_storeu_ps(dst + 5 * ldb, _mm256_permute2f128_ps(s1, s5, 0x31));
+  _mm256_storeu_ps(dst + 6 * ldb, _mm256_permute2f128_ps(s2, s6, 0x31));
+  _mm256_storeu_ps(dst + 7 * ldb, _mm256_permute2f128_ps(s3, s7, 0x31));
+}
+
+// The 4 byte elements are moved as floats, the shuffles keep their bits.
+template <>
+void transpose_block<float>(const float* src,
+                            int64_t lda,
+                            float* dst,
+                            int64_t ldb,
+                            int64_t rows,
+                            int64_t cols) {
+  const int64_t rows8 = rows & ~7;
+  const int64_t cols8 = cols & ~7;
+  for (int64_t i = 0; i < rows8; i += 8) {
+    for (int64_t j = 0; j < cols8; j += 8) {
+      transpose8x8(src + i * lda + j, lda, dst + j * ldb + i, ldb);
+    }
+  }
+  if (cols8 < cols) {
+    transpose_scalar(
+        src + cols8, lda, dst + cols8 * ldb, ldb, rows8, cols - cols8);
+  }
+  if (rows8 < rows) {
+    transpose_scalar(
+        src + rows8 * lda, lda, dst + rows8, ldb, rows - rows8, cols);
+  }
+}
+#endif
+
+// Offset in the input of the index `flat` over the out dims `dims`.
+static inline int64_t src_offset(const PermutePlan& plan,
+                                 const std::vector<int>& dims,
+                                 int64_t flat) {
+  int64_t offset = 0;
+  for (int d = static_cast<int>(dims.size()) - 1; d >= 0; --d) {
+    const int64_t size = plan.shape[dims[d]];
+    offset += (flat % size) * plan.src_strides[dims[d]];
+    flat /= size;
+  }
+  return offset;
+}
+
+// The innermost out dim is contiguous in the input, copy whole rows.
+template <typename T>
+static void permute_rows(const T* in, T* out, const PermutePlan& plan) {
+  const int rank = static_cast<int>(plan.shape.size());
+  const int64_t inner = plan.shape[rank - 1];
+  std::vector<int> outer_dims;
+  int64_t rows = 1;
+  for (int d = 0; d < rank - 1; ++d) {
+    outer_dims.push_back(d);
+    rows *= plan.shape[d];
+  }
+#pragma omp parallel for
+  for (int64_t r = 0; r < rows; ++r) {
+    memcpy(out + r * inner,
+           in + src_offset(plan, outer_dims, r),
+           sizeof(T) * inner);
+  }
+}
+
+// Out dim q is the contiguous dim of the input and the last out dim p is
+// strided in it, every index of the other dims is a transpose of the
+// [shape[p], shape[q]] matrix, split into square blocks.
+template <typename T>
+static void permute_transpose(const T* in,
+                              T* out,
+                              const PermutePlan& plan,
+                              int q) {
+  const int rank = static_cast<int>(plan.shape.size());
+  const int p = rank - 1;
+  std::vector<int64_t> dst_strides(rank, 1);
+  for (int d = rank - 2; d >= 0; --d) {
+    dst_strides[d] = dst_strides[d + 1] * plan.shape[d + 1];
+  }
+  std::vector<int> outer_dims;
+  int64_t outer = 1;
+  for (int d = 0; d < rank; ++d) {
+    if (d == p || d == q) continue;
+    outer_dims.push_back(d);
+    outer *= plan.shape[d];
+  }
+  const int64_t rows = plan.shape[p];
+  const int64_t cols = plan.shape[q];
+  const int64_t lda = plan.src_strides[p];
+  const int64_t ldb = dst_strides[q];
+  const int64_t row_blocks = (rows + kPermuteBlock - 1) / kPermuteBlock;
+  const int64_t col_blocks = (cols + kPermuteBlock - 1) / kPermuteBlock;
+  const int64_t tasks = outer * row_blocks * col_blocks;
+#pragma omp parallel for
+  for (int64_t task = 0; task < tasks; ++task) {
+    const int64_t o = task / (row_blocks * col_blocks);
+    const int64_t i = (task / col_blocks) % row_blocks * kPermuteBlock;
+    const int64_t j = task % col_blocks * kPermuteBlock;
+    int64_t dst_offset = 0;
+    int64_t index = o;
+    for (int d = static_cast<int>(outer_dims.size()) - 1; d >= 0; --d) {
+      const int64_t size = plan.shape[outer_dims[d]];
+      dst_offset += (index % size) * dst_strides[outer_dims[d]];
+      index /= size;
+    }
+    transpose_block(in + src_offset(plan, outer_dims, o) + i * lda + j,
+                    lda,
+                    out + dst_offset + j * ldb + i,
+                    ldb,
+                    std::min(kPermuteBlock, rows - i),
+                    std::min(kPermuteBlock, cols - j));
+  }
+}
+
+template <typename T>
+static void permute_impl(const T* in,
+                         T* out,
+                         const std::vector<int64_t>& dims,
+                         const std::vector<int>& axis) {
+  int64_t num = 1;
+  for (auto d : dims) num *= d;
+  if (num == 0) return;
+  PermutePlan plan = simplify(dims, axis);
+  const int rank = static_cast<int>(plan.shape.size());
+  if (rank <= 1) {
+    memcpy(out, in, sizeof(T) * num);
+    return;
+  }
+  if (plan.src_strides[rank - 1] == 1) {
+    permute_rows(in, out, plan);
+    return;
+  }
+  // The innermost input dim of size > 1 has a stride of 1 and is kept.
+  const int q = static_cast<int>(
+      std::find(plan.src_strides.begin(), plan.src_strides.end(), 1) -
+      plan.src_strides.begin());
+  CHECK_LT(q, rank);
+  permute_transpose(in, out, plan, q);
+}
+
+void permute(const void* in,
+             void* out,
+             const std::vector<int64_t>& dims,
+             const std::vector<int>& axis,
+             size_t elem_size) {
+  CHECK_EQ(dims.size(), axis.size());
+  switch (elem_size) {
+    case 1:
+      permute_impl(static_cast<const uint8_t*>(in),
+                   static_cast<uint8_t*>(out),
+                   dims,
+                   axis);
+      break;
+    case 2:
+      permute_impl(static_cast<const uint16_t*>(in),
+                   static_cast<uint16_t*>(out),
+                   dims,
+                   axis);
+      break;
+    case 4:
+      permute_impl(static_cast<const float*>(in),
+                   static_cast<float*>(out),
+                   dims,
+                   axis);
+      break;
+    case 8:
+      permute_impl(static_cast<const uint64_t*>(in),
+                   static_cast<uint64_t*>(out),
+                   dims,
+                   axis);
+      break;
+    default:
+      LOG(FATAL) << "permute: unsupported element size " << elem_size;
+  }
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,50 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+/* Permutation of a dense tensor of `dims`, out dim i is in dim axis[i].
+ * The dims of size 1 are dropped and the neighbouring out dims which are
+ * also neighbours in the input are merged first, so most permutations turn
+ * into either a copy of contiguous rows or a batch of 2D transposes. The
+ * latter are cache blocked and use 8x8 register transposes for 4 byte
+ * elements. `elem_size` must be 1, 2, 4 or 8.
+ */
+void permute(const void* in,
+             void* out,
+             const std::vector<int64_t>& dims,
+             const std::vector<int>& axis,
+             size_t elem_size);
+
+template <typename T>
+inline void permute(const T* in,
+                    T* out,
+                    const std::vector<int64_t>& dims,
+                    const std::vector<int>& axis) {
+  permute(in, out, dims, axis, sizeof(T));
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,322 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/pooling_fast.h"
+#include <float.h>
+#include <algorithm>
+#include <vector>
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+template <bool kMax>
+static inline float identity() {
+  return kMax ? -FLT_MAX : 0.f;
+}
+
+template <bool kMax>
+static inline float reduce(float a, float b) {
+  return kMax ? std::max(a, b) : a + b;
+}
+
+#ifdef __AVX__
+template <bool kMax>
+static inline __m256 reduce(__m256 a, __m256 b) {
+  return kMax ? _mm256_max_ps(a, b) : _mm256_add_ps(a, b);
+}
+
+template <bool kMax>
+static inline float reduce_lanes(__m256 v) {
+  __m128 r = kMax ? _mm_max_ps(_mm256_castps256_ps128(v),
+                               _mm256_extractf128_ps(v, 1))
+                  : _mm_add_ps(_mm256_castps256_ps128(v),
+                               _mm256_extractf128_ps(v, 1));
+  float lanes[4];
+  _mm_storeu_ps(lanes, r);
+  return reduce<kMax>(reduce<kMax>(lanes[0], lanes[1]),
+                      reduce<kMax>(lanes[2], lanes[3]));
+}
+#endif
+
+#ifdef __AVX2__
+// p[0], p[2], ..., p[14].
+static inline __m256 load_even(const float* p) {
+  __m256 s = _mm256_shuffle_ps(
+      _mm256_loadu_ps(p), _mm256_loadu_ps(p + 8), _MM_SHUFFLE(2, 0, 2, 0));
+  return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(s),
+                                                _MM_SHUFFLE(3, 1, 2, 0)));
+}
+#endif
+
+// dst[w] = reduction of the rows [h0, h1) of `plane` at column w.
+template <bool kMax>
+static void reduce_rows(
+    const float* plane, int iw, int h0, int h1, float* dst) {
+  if (h0 >= h1) {
+    std::fill(dst, dst + iw, identity<kMax>());
+    return;
+  }
+  const float* first = plane + h0 * iw;
+  int w = 0;
+#ifdef __AVX__
+  for (; w + 8 <= iw; w += 8) {
+    __m256 acc = _mm256_loadu_ps(first + w);
+    for (int h = h0 + 1; h < h1; ++h) {
+      acc = reduce<kMax>(acc, _mm256_loadu_ps(plane + h * iw + w));
+    }
+    _mm256_storeu_ps(dst + w, acc);
+  }
+#endif
+  for (; w < iw; ++w) {
+    float acc = first[w];
+    for (int h = h0 + 1; h < h1; ++h) {
+      acc = reduce<kMax>(acc, plane[h * iw + w]);
+    }
+    dst[w] = acc;
+  }
+}
+
+// out[j] = reduction of buf[j * stride + k] for k in [0, kw). buf holds at
+// least 16 readable elements past the last window.
+template <bool kMax>
+static void reduce_windows(
+    const float* buf, int ow, int kw, int stride, float* out) {
+  int j = 0;
+#ifdef __AVX__
+  if (stride == 1) {
+    for (; j + 8 <= ow; j += 8) {
+      __m256 acc = _mm256_loadu_ps(buf + j);
+      for (int k = 1; k < kw; ++k) {
+        acc = reduce<kMax>(acc, _mm256_loadu_ps(buf + j + k));
+      }
+      _mm256_storeu_ps(out + j, acc);
+    }
+  }
+#endif
+#ifdef __AVX2__
+  if (stride == 2) {
+    for (; j + 8 <= ow; j += 8) {
+      __m256 acc = load_even(buf + 2 * j);
+      for (int k = 1; k < kw; ++k) {
+        acc = reduce<kMax>(acc, load_even(buf + 2 * j + k));
+      }
+      _mm256_storeu_ps(out + j, acc);
+    }
+  }
+#endif
+  for (; j < ow; ++j) {
+    const float* p = buf + j * stride;
+    float acc = p[0];
+    for (int k = 1; k < kw; ++k) acc = reduce<kMax>(acc, p[k]);
+    out[j] = acc;
+  }
+}
+
+// The window size the average divides by, see pool2d_fast.
+static int window_count(int start, int k, int size, int clip, bool exclusive) {
+  int end = std::min(start + k, size + clip);
+  if (!exclusive) return end - start;
+  return std::min(end, size) - std::max(start, 0);
+}
+
+template <bool kMax>
+static void pool2d_fast_impl(const float* in,
+                             float* out,
+                             int nc,
+                             int ih,
+                             int iw,
+                             int oh,
+                             int ow,
+                             int kh,
+                             int kw,
+                             int stride_h,
+                             int stride_w,
+                             int pad_top,
+                             int clip_bottom,
+                             int pad_left,
+                             int clip_right,
+                             bool exclusive) {
+  std::vector<float> inv_w(kMax ? 0 : ow);
+  for (int j = 0; j < static_cast<int>(inv_w.size()); ++j) {
+    const int start = j * stride_w - pad_left;
+    inv_w[j] = 1.f / window_count(start, kw, iw, clip_right, exclusive);
+  }
+  // Column x of the buffer is input column x - pad_left.
+  const int buf_len =
+      std::max(pad_left + iw, (ow - 1) * stride_w + kw) + 16;
+#pragma omp parallel
+  {
+    std::vector<float> buf(buf_len, identity<kMax>());
+#pragma omp for
+    for (int p = 0; p < nc; ++p) {
+      const float* plane = in + static_cast<int64_t>(p) * ih * iw;
+      float* out_plane = out + static_cast<int64_t>(p) * oh * ow;
+      for (int i = 0; i < oh; ++i) {
+        const int start = i * stride_h - pad_top;
+        const int h0 = std::max(start, 0);
+        const int h1 = std::min(start + kh, ih);
+        float* out_row = out_plane + i * ow;
+        reduce_rows<kMax>(plane, iw, h0, h1, buf.data() + pad_left);
+        reduce_windows<kMax>(buf.data(), ow, kw, stride_w, out_row);
+        if (!kMax) {
+          const float inv_h =
+              1.f / window_count(start, kh, ih, clip_bottom, exclusive);
+          for (int j = 0; j < ow; ++j) out_row[j] *= inv_h * inv_w[j];
+        }
+      }
+    }
+  }
+}
+
+void pool2d_fast(const float* in,
+                 float* out,
+                 int nc,
+                 int ih,
+                 int iw,
+                 int oh,
+                 int ow,
+                 int kh,
+                 int kw,
+                 int stride_h,
+                 int stride_w,
+                 int pad_top,
+                 int clip_bottom,
+                 int pad_left,
+                 int clip_right,
+                 bool max,
+                 bool exclusive) {
+  if (max) {
+    pool2d_fast_impl<true>(in,
+                           out,
+                           nc,
+                           ih,
+                           iw,
+                           oh,
+                           ow,
+                           kh,
+                           kw,
+                           stride_h,
+                           stride_w,
+                           pad_top,
+                           clip_bottom,
+                           pad_left,
+                           clip_right,
+                           exclusive);
+  } else {
+    pool2d_fast_impl<false>(in,
+                            out,
+                            nc,
+                            ih,
+                            iw,
+                            oh,
+                            ow,
+                            kh,
+                            kw,
+                            stride_h,
+                            stride_w,
+                            pad_top,
+                            clip_bottom,
+                            pad_left,
+                            clip_right,
+                            exclusive);
+  }
+}
+
+template <bool kMax>
+static void pool2d_adaptive_impl(
+    const float* in, float* out, int nc, int ih, int iw, int oh, int ow) {
+#pragma omp parallel
+  {
+    std::vector<float> buf(iw);
+#pragma omp for
+    for (int p = 0; p < nc; ++p) {
+      const float* plane = in + static_cast<int64_t>(p) * ih * iw;
+      float* out_row = out + static_cast<int64_t>(p) * oh * ow;
+      for (int i = 0; i < oh; ++i, out_row += ow) {
+        const int h0 = i * ih / oh;
+        const int h1 = ((i + 1) * ih + oh - 1) / oh;
+        reduce_rows<kMax>(plane, iw, h0, h1, buf.data());
+        for (int j = 0; j < ow; ++j) {
+          const int w0 = j * iw / ow;
+          const int w1 = ((j + 1) * iw + ow - 1) / ow;
+          float acc = buf[w0];
+          for (int w = w0 + 1; w < w1; ++w) acc = reduce<kMax>(acc, buf[w]);
+          out_row[j] = kMax ? acc : acc / ((h1 - h0) * (w1 - w0));
+        }
+      }
+    }
+  }
+}
+
+void pool2d_adaptive(const float* in,
+                     float* out,
+                     int nc,
+                     int ih,
+                     int iw,
+                     int oh,
+                     int ow,
+                     bool max) {
+  if (max) {
+    pool2d_adaptive_impl<true>(in, out, nc, ih, iw, oh, ow);
+  } else {
+    pool2d_adaptive_impl<false>(in, out, nc, ih, iw, oh, ow);
+  }
+}
+
+template <bool kMax>
+static float reduce_plane(const float* x, int size) {
+  int i = 0;
+  float acc = identity<kMax>();
+#ifdef __AVX__
+  if (size >= 32) {
+    // Four independent accumulators hide the latency of the adds.
+    __m256 acc0 = _mm256_loadu_ps(x);
+    __m256 acc1 = _mm256_loadu_ps(x + 8);
+    __m256 acc2 = _mm256_loadu_ps(x + 16);
+    __m256 acc3 = _mm256_loadu_ps(x + 24);
+    for (i = 32; i + 32 <= size; i += 32) {
+      acc0 = reduce<kMax>(acc0, _mm256_loadu_ps(x + i));
+      acc1 = reduce<kMax>(acc1, _mm256_loadu_ps(x + i + 8));
+      acc2 = reduce<kMax>(acc2, _mm256_loadu_ps(x + i + 16));
+      acc3 = reduce<kMax>(acc3, _mm256_loadu_ps(x + i + 24));
+    }
+    for (; i + 8 <= size; i += 8) {
+      acc0 = reduce<kMax>(acc0, _mm256_loadu_ps(x + i));
+    }
+    acc = reduce_lanes<kMax>(
+        reduce<kMax>(reduce<kMax>(acc0, acc1), reduce<kMax>(acc2, acc3)));
+  }
+#endif
+  for (; i < size; ++i) acc = reduce<kMax>(acc, x[i]);
+  return acc;
+}
+
+void pool2d_global(const float* in, float* out, int nc, int size, bool max) {
+#pragma omp parallel for
+  for (int p = 0; p < nc; ++p) {
+    const float* x = in + static_cast<int64_t>(p) * size;
+    out[p] = max ? reduce_plane<true>(x, size)
+                 : reduce_plane<false>(x, size) / size;
+  }
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,73 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+/* NCHW float pooling, `nc` planes of ih x iw into oh x ow. The planes are
+ * split between the threads. Every output row first reduces its input rows
+ * into a padded row buffer with 8 wide vector ops, the windows are then
+ * reduced along that buffer, with shifted vector loads for stride 1 and
+ * even/odd deinterleaving for stride 2. Padding never enters the window
+ * loops: the buffer borders hold the identity of the reduction.
+ *
+ * The average divides by the clipped window when `exclusive`, otherwise by
+ * the window clipped to [-pad_top, ih + clip_bottom) x
+ * [-pad_left, iw + clip_right). The output size already fixes the trailing
+ * padding, so the clip bounds only matter for that count; Pool2dFunctor
+ * clips to the leading paddings there.
+ */
+void pool2d_fast(const float* in,
+                 float* out,
+                 int nc,
+                 int ih,
+                 int iw,
+                 int oh,
+                 int ow,
+                 int kh,
+                 int kw,
+                 int stride_h,
+                 int stride_w,
+                 int pad_top,
+                 int clip_bottom,
+                 int pad_left,
+                 int clip_right,
+                 bool max,
+                 bool exclusive);
+
+/* Adaptive pooling, output row i covers the input rows
+ * [floor(i * ih / oh), ceil((i + 1) * ih / oh)) and the same for columns.
+ */
+void pool2d_adaptive(const float* in,
+                     float* out,
+                     int nc,
+                     int ih,
+                     int iw,
+                     int oh,
+                     int ow,
+                     bool max);
+
+/* Global pooling, out[i] is the max or the mean of plane i of `size`
+ * elements.
+ */
+void pool2d_global(const float* in, float* out, int nc, int size, bool max);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,308 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/sparse_spmm.h"
+#include <algorithm>
+#ifdef __AVX__
+#include <immintrin.h>
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+static inline float act_scalar(float x, SparseActType act, float act_param) {
+  switch (act) {
+    case SparseActType::kRelu:
+      return std::max(x, 0.f);
+    case SparseActType::kRelu6:
+      return std::min(std::max(x, 0.f), act_param);
+    default:
+      return x;
+  }
+}
+
+#ifdef __AVX__
+static inline __m256 fmadd_m256(__m256 a, __m256 b, __m256 c) {
+#ifdef __FMA__
+  return _mm256_fmadd_ps(a, b, c);
+#else
+  return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+}
+
+static inline __m256 act_m256(__m256 x, SparseActType act, float act_param) {
+  switch (act) {
+    case SparseActType::kRelu:
+      return _mm256_max_ps(x, _mm256_setzero_ps());
+    case SparseActType::kRelu6:
+      return _mm256_min_ps(_mm256_max_ps(x, _mm256_setzero_ps()),
+                           _mm256_set1_ps(act_param));
+    default:
+      return x;
+  }
+}
+#endif
+
+#ifdef __SSE__
+static inline __m128 act_m128(__m128 x, SparseActType act, float act_param) {
+  switch (act) {
+    case SparseActType::kRelu:
+      return _mm_max_ps(x, _mm_setzero_ps());
+    case SparseActType::kRelu6:
+      return _mm_min_ps(_mm_max_ps(x, _mm_setzero_ps()),
+                        _mm_set1_ps(act_param));
+    default:
+      return x;
+  }
+}
+#endif
+
+static inline int group_begin(const SparseMatrix& w, int g) {
+  return g == 0 ? 0 : w.row_ends[g * w.block_size - 1];
+}
+
+// One output row, every non-zero element scales a whole input row.
+static void spmm_row(const SparseMatrix& w,
+                     int g,
+                     const float* in,
+                     int P,
+                     float b,
+                     SparseActType act,
+                     float act_param,
+                     float* out) {
+  const int begin = group_begin(w, g);
+  const int end = w.row_ends[g];
+  const float* values = w.values;
+  const int32_t* cols = w.col_idx;
+  int p = 0;
+#ifdef __AVX__
+  for (; p + 32 <= P; p += 32) {
+    __m256 acc0 = _mm256_set1_ps(b);
+    __m256 acc1 = acc0;
+    __m256 acc2 = acc0;
+    __m256 acc3 = acc0;
+    for (int j = begin; j < end; ++j) {
+      const float* x = in + static_cast<int64_t>(cols[j]) * P + p;
+      __m256 v = _mm256_set1_ps(values[j]);
+      acc0 = fmadd_m256(v, _mm256_loadu_ps(x), acc0);
+      acc1 = fmadd_m256(v, _mm256_loadu_ps(x + 8), acc1);
+      acc2 = fmadd_m256(v, _mm256_loadu_ps(x + 16), acc2);
+      acc3 = fmadd_m256(v, _mm256_loadu_ps(x + 24), acc3);
+    }
+    _mm256_storeu_ps(out + p, act_m256(acc0, act, act_param));
+    _mm256_storeu_ps(out + p + 8, act_m256(acc1, act, act_param));
+    _mm256_storeu_ps(out + p + 16, act_m256(acc2, act, act_param));
+    _mm256_storeu_ps(out + p + 24, act_m256(acc3, act, act_param));
+  }
+  for (; p + 8 <= P; p += 8) {
+    __m256 acc = _mm256_set1_ps(b);
+    for (int j = begin; j < end; ++j) {
+      const float* x = in + static_cast<int64_t>(cols[j]) * P + p;
+      acc = fmadd_m256(_mm256_set1_ps(values[j]), _mm256_loadu_ps(x), acc);
+    }
+    _mm256_storeu_ps(out + p, act_m256(acc, act, act_param));
+  }
+#endif
+  for (; p < P; ++p) {
+    float acc = b;
+    for (int j = begin; j < end; ++j) {
+      acc += values[j] * in[static_cast<int64_t>(cols[j]) * P + p];
+    }
+    out[p] = act_scalar(acc, act, act_param);
+  }
+}
+
+// Four output rows sharing the same columns, every input row loaded from
+// memory is reused by the four accumulators.
+static void spmm_block4(const SparseMatrix& w,
+                        int g,
+                        const float* in,
+                        int P,
+                        const float* bias,
+                        SparseActType act,
+                        float act_param,
+                        float* out) {
+  const int begin = group_begin(w, g);
+  const int end = w.row_ends[g * 4];
+  const int row0 = g * 4;
+  const int valid = std::min(4, w.rows - row0);
+  float b[4] = {0.f, 0.f, 0.f, 0.f};
+  for (int r = 0; r < valid; ++r) {
+    b[r] = bias ? bias[row0 + r] : 0.f;
+  }
+  const float* values = w.values;
+  const int32_t* cols = w.col_idx;
+  float* out_r[4];
+  for (int r = 0; r < 4; ++r) {
+    // Padded rows write into the last valid row and get overwritten later.
+    out_r[r] = out + static_cast<int64_t>(row0 + std::min(r, valid - 1)) * P;
+  }
+  int p = 0;
+#ifdef __AVX__
+  for (; p + 8 <= P; p += 8) {
+    __m256 acc0 = _mm256_set1_ps(b[0]);
+    __m256 acc1 = _mm256_set1_ps(b[1]);
+    __m256 acc2 = _mm256_set1_ps(b[2]);
+    __m256 acc3 = _mm256_set1_ps(b[3]);
+    for (int j = begin; j < end; ++j) {
+      __m256 x =
+          _mm256_loadu_ps(in + static_cast<int64_t>(cols[j]) * P + p);
+      const float* v = values + j * 4;
+      acc0 = fmadd_m256(_mm256_set1_ps(v[0]), x, acc0);
+      acc1 = fmadd_m256(_mm256_set1_ps(v[1]), x, acc1);
+      acc2 = fmadd_m256(_mm256_set1_ps(v[2]), x, acc2);
+      acc3 = fmadd_m256(_mm256_set1_ps(v[3]), x, acc3);
+    }
+    _mm256_storeu_ps(out_r[3] + p, act_m256(acc3, act, act_param));
+    _mm256_storeu_ps(out_r[2] + p, act_m256(acc2, act, act_param));
+    _mm256_storeu_ps(out_r[1] + p, act_m256(acc1, act, act_param));
+    _mm256_storeu_ps(out_r[0] + p, act_m256(acc0, act, act_param));
+  }
+#endif
+  for (; p < P; ++p) {
+    float acc[4] = {b[0], b[1], b[2], b[3]};
+    for (int j = begin; j < end; ++j) {
+      const float x = in[static_cast<int64_t>(cols[j]) * P + p];
+      const float* v = values + j * 4;
+      acc[0] += v[0] * x;
+      acc[1] += v[1] * x;
+      acc[2] += v[2] * x;
+      acc[3] += v[3] * x;
+    }
+    for (int r = valid - 1; r >= 0; --r) {
+      out_r[r][p] = act_scalar(acc[r], act, act_param);
+    }
+  }
+}
+
+void sparse_spmm(const SparseMatrix& w,
+                 const float* in,
+                 int P,
+                 const float* bias,
+                 SparseActType act,
+                 float act_param,
+                 float* out) {
+  if (w.block_size == 4) {
+    const int groups = (w.rows + 3) / 4;
+#pragma omp parallel for
+    for (int g = 0; g < groups; ++g) {
+      spmm_block4(w, g, in, P, bias, act, act_param, out);
+    }
+  } else {
+#pragma omp parallel for
+    for (int n = 0; n < w.rows; ++n) {
+      spmm_row(w,
+               n,
+               in,
+               P,
+               bias ? bias[n] : 0.f,
+               act,
+               act_param,
+               out + static_cast<int64_t>(n) * P);
+    }
+  }
+}
+
+void sparse_gemv(const SparseMatrix& w,
+                 const float* in,
+                 int M,
+                 const float* bias,
+                 SparseActType act,
+                 float act_param,
+                 float* out) {
+  const int N = w.rows;
+  const int K = w.cols;
+  const float* values = w.values;
+  const int32_t* cols = w.col_idx;
+  if (w.block_size == 4) {
+    const int groups = (N + 3) / 4;
+#pragma omp parallel for
+    for (int g = 0; g < groups; ++g) {
+      const int begin = group_begin(w, g);
+      const int end = w.row_ends[g * 4];
+      const int row0 = g * 4;
+      const int valid = std::min(4, N - row0);
+      float b[4] = {0.f, 0.f, 0.f, 0.f};
+      for (int r = 0; r < valid; ++r) {
+        b[r] = bias ? bias[row0 + r] : 0.f;
+      }
+      for (int m = 0; m < M; ++m) {
+        const float* x = in + static_cast<int64_t>(m) * K;
+        float* y = out + static_cast<int64_t>(m) * N + row0;
+#ifdef __SSE__
+        __m128 acc = _mm_loadu_ps(b);
+        for (int j = begin; j < end; ++j) {
+          __m128 v = _mm_loadu_ps(values + j * 4);
+          acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(x[cols[j]]), v));
+        }
+        float res[4];
+        _mm_storeu_ps(res, act_m128(acc, act, act_param));
+        for (int r = 0; r < valid; ++r) {
+          y[r] = res[r];
+        }
+#else
+        float acc[4] = {b[0], b[1], b[2], b[3]};
+        for (int j = begin; j < end; ++j) {
+          for (int r = 0; r < 4; ++r) {
+            acc[r] += x[cols[j]] * values[j * 4 + r];
+          }
+        }
+        for (int r = 0; r < valid; ++r) {
+          y[r] = act_scalar(acc[r], act, act_param);
+        }
+#endif
+      }
+    }
+    return;
+  }
+#pragma omp parallel for
+  for (int n = 0; n < N; ++n) {
+    const int begin = group_begin(w, n);
+    const int end = w.row_ends[n];
+    const float b = bias ? bias[n] : 0.f;
+    for (int m = 0; m < M; ++m) {
+      const float* x = in + static_cast<int64_t>(m) * K;
+      float acc = b;
+      int j = begin;
+#ifdef __AVX2__
+      __m256 vacc = _mm256_setzero_ps();
+      for (; j + 8 <= end; j += 8) {
+        __m256i idx =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cols + j));
+        vacc = fmadd_m256(_mm256_loadu_ps(values + j),
+                          _mm256_i32gather_ps(x, idx, 4),
+                          vacc);
+      }
+      float sum[8];
+      _mm256_storeu_ps(sum, vacc);
+      for (int i = 0; i < 8; ++i) {
+        acc += sum[i];
+      }
+#endif
+      for (; j < end; ++j) {
+        acc += values[j] * x[cols[j]];
+      }
+      out[static_cast<int64_t>(m) * N + n] = act_scalar(acc, act, act_param);
+    }
+  }
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,72 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+enum class SparseActType {
+  kNone = 0,
+  kRelu,
+  kRelu6,
+};
+
+/* Compressed sparse weight of an N x K matrix as produced by
+ * sparse_conv_detect_pass for x86. The rows are grouped into blocks of
+ * `block_size` (1 or 4) consecutive rows, and every stored block covers one
+ * column k of such a row group:
+ *   values   [num_blocks * block_size]: the block elements, row-group major,
+ *            rows beyond N are padded with zeros;
+ *   row_ends [N]: the number of blocks stored up to the end of the row group
+ *            of row n, rows of the same group share the same value;
+ *   col_idx  [num_blocks]: the column k of every stored block.
+ */
+struct SparseMatrix {
+  const float* values{nullptr};
+  const int32_t* row_ends{nullptr};
+  const int32_t* col_idx{nullptr};
+  int rows{0};
+  int cols{0};
+  int block_size{1};
+};
+
+// out[N x P] = act(W[N x K] * in[K x P] + bias[N]), used by the 1x1
+// convolution where P is the spatial size of one image.
+void sparse_spmm(const SparseMatrix& w,
+                 const float* in,
+                 int P,
+                 const float* bias,
+                 SparseActType act,
+                 float act_param,
+                 float* out);
+
+// out[M x N] = act(in[M x K] * W^T + bias[N]), used by fc and matmul whose
+// dense weight [K x N] was transposed into W before compression.
+void sparse_gemv(const SparseMatrix& w,
+                 const float* in,
+                 int M,
+                 const float* bias,
+                 SparseActType act,
+                 float act_param,
+                 float* out);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
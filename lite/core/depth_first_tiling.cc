@@ -0,0 +1,362 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/depth_first_tiling.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include "lite/backends/x86/math/conv_select.h"
+#include "lite/core/program.h"
+#if (defined LITE_WITH_X86) && !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
+#include "lite/backends/x86/cpu_info.h"
+#endif
+
+namespace paddle {
+namespace lite {
+
+// Narrower bands recompute more halo rows than they save.
+static const int kMinBandRows = 8;
+
+static size_t DefaultBandBytes() {
+#if (defined LITE_WITH_X86) && !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
+  const size_t l3 = x86::GetCpuTopology().l3_cache_size;
+  if (l3 > 0) return l3 / 2;
+#endif
+  return 4 << 20;
+}
+
+DepthFirstChain::DepthFirstChain(const std::vector<Tensor*>& tensors,
+                                 const std::vector<DepthFirstStep>& steps,
+                                 size_t band_bytes)
+    : tensors_(tensors),
+      steps_(steps),
+      band_bytes_(band_bytes ? band_bytes : DefaultBandBytes()) {
+  CHECK_EQ(tensors_.size(), steps_.size() + 1);
+}
+
+void DepthFirstChain::Plan() {
+  dims_.clear();
+  band_rows_ = 0;
+  for (auto* tensor : tensors_) {
+    dims_.push_back(tensor->dims());
+    if (dims_.back().size() != 4) return;
+  }
+  // Bytes of all the tensors of the chain per row of its output.
+  const int64_t height = dims_.back()[2];
+  double row_bytes = 0;
+  for (auto& dims : dims_) {
+    row_bytes += static_cast<double>(dims[0] * dims[1] * dims[3]) *
+                 sizeof(float) * dims[2] / height;
+  }
+  const int rows =
+      std::max(kMinBandRows, static_cast<int>(band_bytes_ / row_bytes));
+  if (rows >= height) return;
+  band_rows_ = rows;
+  // The intermediate results are only kept for one band from now on.
+  for (size_t i = 1; i + 1 < tensors_.size(); i++) {
+    tensors_[i]->clear();
+  }
+  VLOG(4) << "depth first chain of " << steps_.size() << " ops, "
+          << band_rows_ << " of " << height << " rows per band";
+}
+
+void DepthFirstChain::Run() {
+  if (dims_.empty() || tensors_[0]->dims() != dims_[0]) {
+    for (auto& step : steps_) step.run();
+    Plan();
+    return;
+  }
+  if (band_rows_ == 0) {
+    for (auto& step : steps_) step.run();
+    return;
+  }
+
+  // The bands are run on private tensors, the input and the output get
+  // their buffers back afterwards.
+  Tensor* in = tensors_.front();
+  Tensor* out = tensors_.back();
+  Tensor full_in;
+  full_in.ShareDataWith(*in);
+  out->Resize(dims_.back());
+  out->mutable_data<float>();
+  Tensor full_out;
+  full_out.ShareDataWith(*out);
+  const int height = dims_.back()[2];
+  for (int row = 0; row < height; row += band_rows_) {
+    RunBand(row, std::min(height, row + band_rows_), full_in, &full_out);
+  }
+  in->ShareDataWith(full_in);
+  out->ShareDataWith(full_out);
+}
+
+// Moves the rows [offset, offset + rows) of every plane of `t` to the front.
+static void CropRows(Tensor* t, int offset, int rows) {
+  auto dims = t->dims();
+  const int64_t planes = dims[0] * dims[1];
+  const int64_t height = dims[2];
+  const int64_t width = dims[3];
+  float* data = t->mutable_data<float>();
+  for (int64_t p = 0; p < planes; p++) {
+    std::memmove(data + p * rows * width,
+                 data + (p * height + offset) * width,
+                 sizeof(float) * rows * width);
+  }
+  t->Resize({dims[0], dims[1], rows, width});
+}
+
+// Copies `rows` rows of every plane of `src` from the row `src_row` into
+// `dst` at the row `dst_row`.
+static void CopyRows(const Tensor& src,
+                     int src_row,
+                     Tensor* dst,
+                     int dst_row,
+                     int rows) {
+  const int64_t planes = src.dims()[0] * src.dims()[1];
+  const int64_t src_height = src.dims()[2];
+  const int64_t dst_height = dst->dims()[2];
+  const int64_t width = src.dims()[3];
+  const float* src_data = src.data<float>();
+  float* dst_data = dst->mutable_data<float>();
+  for (int64_t p = 0; p < planes; p++) {
+    std::memcpy(dst_data + (p * dst_height + dst_row) * width,
+                src_data + (p * src_height + src_row) * width,
+                sizeof(float) * rows * width);
+  }
+}
+
+void DepthFirstChain::RunBand(int row_begin,
+                              int row_end,
+                              const Tensor& full_in,
+                              Tensor* full_out) {
+  const int num = static_cast<int>(steps_.size());
+  // The rows [begin[i], end[i]) of tensors_[i] the band needs, the op
+  // writing tensors_[i] computes them from its row base[i] on.
+  std::vector<int> begin(num + 1), end(num + 1), base(num + 1, 0);
+  begin[num] = row_begin;
+  end[num] = row_end;
+  for (int i = num - 1; i >= 0; i--) {
+    auto& step = steps_[i];
+    // The first input row is a multiple of the stride, so the output rows
+    // line up with those of the untiled run.
+    int first = begin[i + 1] * step.stride - step.pad_top;
+    first = first <= 0 ? 0 : first / step.stride * step.stride;
+    begin[i] = first;
+    end[i] = std::min(
+        static_cast<int>(dims_[i][2]),
+        (end[i + 1] - 1) * step.stride - step.pad_top + step.window);
+    base[i + 1] = first / step.stride;
+  }
+
+  auto in_dims = dims_.front();
+  band_in_.Resize({in_dims[0], in_dims[1], end[0] - begin[0], in_dims[3]});
+  band_in_.set_lod(full_in.lod());
+  CopyRows(full_in, begin[0], &band_in_, 0, end[0] - begin[0]);
+  tensors_.front()->ShareDataWith(band_in_);
+  tensors_.back()->ShareDataWith(band_out_);
+  for (int i = 0; i < num; i++) {
+    steps_[i].run();
+    Tensor* out = tensors_[i + 1];
+    const int offset = begin[i + 1] - base[i + 1];
+    const int rows = end[i + 1] - begin[i + 1];
+    CHECK_GE(out->dims()[2], offset + rows);
+    if (i + 1 < num) {
+      CropRows(out, offset, rows);
+    } else {
+      CopyRows(*out, offset, full_out, row_begin, rows);
+      // Keeps the buffer in case the op had to grow it.
+      band_out_.ShareDataWith(*out);
+    }
+  }
+}
+
+// The activations whose vector and scalar code give the same bits, a band
+// moves the elements between the vector body and the scalar tail.
+static bool IsExactActivation(const std::string& type) {
+  return type == "relu" || type == "relu6" || type == "leaky_relu";
+}
+
+static bool IsElementwiseOp(const std::string& type) {
+  static const std::set<std::string> kTypes{
+      "elementwise_add",
+      "elementwise_sub",
+      "elementwise_mul",
+      "elementwise_div",
+      "fusion_elementwise_add_activation",
+      "fusion_elementwise_sub_activation",
+      "fusion_elementwise_mul_activation",
+      "fusion_elementwise_div_activation"};
+  return kTypes.count(type) > 0;
+}
+
+// Whether the x86 conv kernel runs the conv with DirectConv or
+// DepthwiseConv, which compute every output row the same way whatever the
+// input height. The im2col + GEMM path blocks the GEMM by the output size,
+// so its results may change in the last bits with the band.
+static bool IsRowwiseConv(const OpInfo& op_info,
+                          const DDim& filter_dims,
+                          const std::vector<int>& strides,
+                          const std::vector<int>& paddings,
+                          const std::vector<int>& dilations) {
+  const int groups = op_info.GetAttr<int>("groups");
+  // Paddings of the op are either {top, left} or {top, bottom, left, right}.
+  std::vector<int> pads = paddings;
+  if (pads.size() == 2) pads = {pads[0], pads[0], pads[1], pads[1]};
+  if (pads.size() != 4) return false;
+  return x86::math::SelectConv2dImpl(filter_dims[1] * groups,
+                                     filter_dims[0],
+                                     groups,
+                                     filter_dims[2],
+                                     filter_dims[3],
+                                     strides,
+                                     pads,
+                                     dilations) != x86::math::Conv2dImpl::kGemm;
+}
+
+// Describes `inst` as a step reading `in` and writing `out`, false when it
+// can not be part of a chain. Only the ops which compute every row of the
+// band exactly as in the untiled run are taken, so the tiled results are
+// bit-identical.
+static bool DescribeStep(Instruction* inst,
+                         DepthFirstStep* step,
+                         std::string* in,
+                         std::string* out,
+                         bool* is_conv) {
+  const auto* kernel = inst->kernel();
+  if (kernel->target() != TARGET(kX86) && kernel->target() != TARGET(kHost)) {
+    return false;
+  }
+  if (kernel->precision() != PRECISION(kFloat) &&
+      kernel->precision() != PRECISION(kAny)) {
+    return false;
+  }
+  auto* op = const_cast<OpLite*>(inst->op());
+  const auto* op_info = op->op_info();
+  const std::string type = op->Type();
+  *is_conv = type == "conv2d" || type == "depthwise_conv2d";
+  if (*is_conv) {
+    // SAME paddings depend on the input size, which the bands change.
+    if (op_info->HasAttr("padding_algorithm") &&
+        op_info->GetAttr<std::string>("padding_algorithm") == "SAME") {
+      return false;
+    }
+    if (op_info->HasAttr("fuse_elementwise_op_type") ||
+        (op_info->HasAttr("enable_int8") &&
+         op_info->GetAttr<bool>("enable_int8"))) {
+      return false;
+    }
+    if (op_info->HasAttr("with_act") && op_info->GetAttr<bool>("with_act") &&
+        !IsExactActivation(op_info->GetAttr<std::string>("act_type"))) {
+      return false;
+    }
+    auto strides = op_info->GetAttr<std::vector<int>>("strides");
+    auto paddings = op_info->GetAttr<std::vector<int>>("paddings");
+    auto dilations = op_info->GetAttr<std::vector<int>>("dilations");
+    auto* filter = op->scope()->FindVar(op_info->Input("Filter").front());
+    if (strides.size() != 2 || paddings.empty() || dilations.size() != 2 ||
+        filter == nullptr || kernel->target() != TARGET(kX86)) {
+      return false;
+    }
+    const auto filter_dims = filter->Get<Tensor>().dims();
+    if (filter_dims.size() != 4 ||
+        !IsRowwiseConv(*op_info, filter_dims, strides, paddings, dilations)) {
+      return false;
+    }
+    const int kernel_h = filter_dims[2];
+    step->stride = strides[0];
+    step->pad_top = paddings[0];
+    step->window = dilations[0] * (kernel_h - 1) + 1;
+    *in = op_info->Input("Input").front();
+    *out = op_info->Output("Output").front();
+  } else if (IsExactActivation(type)) {
+    *in = op_info->Input("X").front();
+    *out = op_info->Output("Out").front();
+  } else if (IsElementwiseOp(type)) {
+    // Y is a weight of one value or of one value per channel.
+    auto* y = op->scope()->FindVar(op_info->Input("Y").front());
+    if (y == nullptr) return false;
+    const auto& y_tensor = y->Get<Tensor>();
+    const int axis = op_info->GetAttr<int>("axis");
+    if (!y_tensor.persistable() ||
+        !(y_tensor.numel() == 1 ||
+          (y_tensor.dims().size() == 1 && axis == 1))) {
+      return false;
+    }
+    if (op_info->HasAttr("act_type") &&
+        !IsExactActivation(op_info->GetAttr<std::string>("act_type"))) {
+      return false;
+    }
+    *in = op_info->Input("X").front();
+    *out = op_info->Output("Out").front();
+  } else {
+    return false;
+  }
+  step->run = [inst]() { inst->Run(); };
+  return true;
+}
+
+std::map<size_t, std::unique_ptr<DepthFirstChain>> FindDepthFirstChains(
+    std::vector<Instruction>* insts,
+    const std::set<std::string>& pinned,
+    size_t band_bytes) {
+  std::map<std::string, int> readers;
+  for (auto& inst : *insts) {
+    for (auto& name : inst.op()->op_info()->input_names()) {
+      readers[name]++;
+    }
+  }
+
+  std::map<size_t, std::unique_ptr<DepthFirstChain>> chains;
+  size_t i = 0;
+  while (i < insts->size()) {
+    DepthFirstStep step;
+    std::string in, out;
+    bool is_conv = false;
+    if (!DescribeStep(&(*insts)[i], &step, &in, &out, &is_conv)) {
+      i++;
+      continue;
+    }
+    auto* scope = const_cast<OpLite*>((*insts)[i].op())->scope();
+    std::vector<DepthFirstStep> steps{step};
+    std::vector<std::string> names{in, out};
+    int convs = is_conv ? 1 : 0;
+    size_t j = i + 1;
+    for (; j < insts->size(); j++) {
+      const std::string& last = names.back();
+      if (readers[last] != 1 || pinned.count(last)) break;
+      std::string next_in, next_out;
+      if (!DescribeStep(&(*insts)[j], &step, &next_in, &next_out, &is_conv) ||
+          next_in != last ||
+          std::find(names.begin(), names.end(), next_out) != names.end()) {
+        break;
+      }
+      steps.push_back(step);
+      names.push_back(next_out);
+      convs += is_conv ? 1 : 0;
+    }
+    if (convs < 2) {
+      i++;
+      continue;
+    }
+    std::vector<Tensor*> tensors;
+    for (auto& name : names) {
+      tensors.push_back(scope->FindVar(name)->GetMutable<Tensor>());
+    }
+    chains[i].reset(new DepthFirstChain(tensors, steps, band_bytes));
+    i = j;
+  }
+  return chains;
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,97 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+
+class Instruction;
+
+// One op of a DepthFirstChain. Its output rows [a, b) read the input rows
+// [a * stride - pad_top, (b - 1) * stride - pad_top + window), the defaults
+// describe a pointwise op.
+struct DepthFirstStep {
+  int stride{1};
+  int pad_top{0};
+  int window{1};
+  // Runs the op on the current contents of its input tensor.
+  std::function<void()> run;
+};
+
+// Runs a chain of ops, each reading the output of the previous one, band by
+// band of output rows, so the intermediate feature maps only exist for one
+// band at a time instead of for the whole image.
+//
+// Every op of a band gets its input rows plus the halo its windows need and
+// runs with its own paddings. The output rows which read that padding at an
+// inner band border are dropped before the next op, the remaining ones are
+// computed from the same inputs as in the untiled run.
+//
+// tensors[i] and tensors[i + 1] are the NCHW float input and output of
+// steps[i]. The band of the intermediate results fits `band_bytes`.
+class DepthFirstChain {
+ public:
+  DepthFirstChain(const std::vector<Tensor*>& tensors,
+                  const std::vector<DepthFirstStep>& steps,
+                  size_t band_bytes);
+
+  // The first run, and every run with a new input shape, is untiled and
+  // gives the shapes the next runs are tiled with.
+  void Run();
+
+  size_t size() const { return steps_.size(); }
+  // Rows of the chain output per band, 0 while the chain runs untiled.
+  int band_rows() const { return band_rows_; }
+
+ private:
+  void Plan();
+  void RunBand(int row_begin,
+               int row_end,
+               const Tensor& full_in,
+               Tensor* full_out);
+
+  std::vector<Tensor*> tensors_;
+  std::vector<DepthFirstStep> steps_;
+  size_t band_bytes_{0};
+  // The untiled dims of the tensors.
+  std::vector<DDim> dims_;
+  int band_rows_{0};
+  Tensor band_in_;
+  Tensor band_out_;
+};
+
+// The chains of the block `insts` with at least two convs, keyed by the
+// index of their first instruction. A chain is a run of consecutive conv2d
+// and depthwise_conv2d instructions of the direct and depthwise x86
+// kernels, relu, relu6 and leaky_relu, and per-channel elementwise
+// instructions of fp32 kernels, every one reading the output of the
+// previous one, which nothing else reads. These compute each row the same
+// way whatever the band, so a tiled chain gives the bits of the untiled
+// run. `pinned` vars never are intermediate results.
+std::map<size_t, std::unique_ptr<DepthFirstChain>> FindDepthFirstChains(
+    std::vector<Instruction>* insts,
+    const std::set<std::string>& pinned,
+    size_t band_bytes);
+
+}  // namespace lite
+}  // namespace paddle
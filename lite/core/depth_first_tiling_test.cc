@@ -0,0 +1,237 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "lite/core/depth_first_tiling.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#ifdef LITE_WITH_X86
+#include "lite/core/op_registry.h"
+#include "lite/core/program.h"
+#endif
+
+namespace paddle {
+namespace lite {
+
+// A naive conv with square kernels and paddings on all sides, which sizes
+// its output from its input like the op does.
+static DepthFirstStep ConvStep(
+    Tensor* in, Tensor* out, int oc, int kernel, int stride, int pad) {
+  auto weights = std::make_shared<std::vector<float>>();
+  DepthFirstStep step;
+  step.stride = stride;
+  step.pad_top = pad;
+  step.window = kernel;
+  step.run = [=]() {
+    auto dims = in->dims();
+    const int ic = dims[1];
+    const int ih = dims[2];
+    const int iw = dims[3];
+    const int oh = (ih + 2 * pad - kernel) / stride + 1;
+    const int ow = (iw + 2 * pad - kernel) / stride + 1;
+    if (weights->empty()) {
+      for (int i = 0; i < oc * ic * kernel * kernel; i++) {
+        weights->push_back(((i * 7) % 11 - 5) * 0.1f);
+      }
+    }
+    out->Resize({dims[0], oc, oh, ow});
+    const float* x = in->data<float>();
+    float* y = out->mutable_data<float>();
+    for (int n = 0; n < dims[0]; n++) {
+      for (int o = 0; o < oc; o++) {
+        for (int r = 0; r < oh; r++) {
+          for (int c = 0; c < ow; c++) {
+            float sum = 0.f;
+            for (int i = 0; i < ic; i++) {
+              for (int kr = 0; kr < kernel; kr++) {
+                for (int kc = 0; kc < kernel; kc++) {
+                  const int xr = r * stride - pad + kr;
+                  const int xc = c * stride - pad + kc;
+                  if (xr < 0 || xr >= ih || xc < 0 || xc >= iw) continue;
+                  sum += x[((n * ic + i) * ih + xr) * iw + xc] *
+                         (*weights)[((o * ic + i) * kernel + kr) * kernel +
+                                    kc];
+                }
+              }
+            }
+            y[((n * oc + o) * oh + r) * ow + c] = sum;
+          }
+        }
+      }
+    }
+  };
+  return step;
+}
+
+static DepthFirstStep ReluStep(Tensor* in, Tensor* out) {
+  DepthFirstStep step;
+  step.run = [=]() {
+    out->Resize(in->dims());
+    const float* x = in->data<float>();
+    float* y = out->mutable_data<float>();
+    for (int64_t i = 0; i < in->numel(); i++) y[i] = x[i] > 0.f ? x[i] : 0.f;
+  };
+  return step;
+}
+
+// Runs conv3x3s1p1, relu, conv3x3s2p1, conv5x5s1p2 and conv1x1 twice on
+// the same input, the second run being tiled when `band_bytes` is small.
+static std::vector<float> RunChain(size_t band_bytes,
+                                   int height,
+                                   int* band_rows) {
+  std::vector<Tensor> tensors(6);
+  std::vector<Tensor*> ptrs;
+  for (auto& tensor : tensors) ptrs.push_back(&tensor);
+  std::vector<DepthFirstStep> steps{ConvStep(ptrs[0], ptrs[1], 4, 3, 1, 1),
+                                    ReluStep(ptrs[1], ptrs[2]),
+                                    ConvStep(ptrs[2], ptrs[3], 6, 3, 2, 1),
+                                    ConvStep(ptrs[3], ptrs[4], 3, 5, 1, 2),
+                                    ConvStep(ptrs[4], ptrs[5], 2, 1, 1, 0)};
+  DepthFirstChain chain(ptrs, steps, band_bytes);
+  ptrs[0]->Resize({2, 3, height, 17});
+  float* x = ptrs[0]->mutable_data<float>();
+  for (int64_t i = 0; i < ptrs[0]->numel(); i++) {
+    x[i] = ((i * 13) % 29 - 14) * 0.05f;
+  }
+  chain.Run();
+  chain.Run();
+  *band_rows = chain.band_rows();
+  EXPECT_EQ(ptrs[0]->dims(), DDim({2, 3, height, 17}));
+  EXPECT_EQ(ptrs[5]->dims(), DDim({2, 2, (height + 1) / 2, 9}));
+  const float* y = ptrs[5]->data<float>();
+  return std::vector<float>(y, y + ptrs[5]->numel());
+}
+
+TEST(DepthFirstChain, TiledMatchesUntiled) {
+  for (int height : {37, 64, 81}) {
+    int band_rows = 0;
+    auto untiled = RunChain(size_t(1) << 30, height, &band_rows);
+    EXPECT_EQ(band_rows, 0);
+    auto tiled = RunChain(1, height, &band_rows);
+    EXPECT_GT(band_rows, 0);
+    ASSERT_EQ(untiled.size(), tiled.size());
+    EXPECT_EQ(
+        std::memcmp(
+            untiled.data(), tiled.data(), untiled.size() * sizeof(float)),
+        0);
+  }
+}
+
+#ifdef LITE_WITH_X86
+// An instruction of the x86 fp32 kernel of `type`.
+static void AddInstruction(const std::string& type,
+                           const std::string& in,
+                           const std::string& out,
+                           int groups,
+                           const std::string& filter,
+                           Scope* scope,
+                           std::vector<Instruction>* insts) {
+  cpp::OpDesc desc;
+  desc.SetType(type);
+  if (filter.empty()) {
+    desc.SetInput("X", {in});
+    desc.SetOutput("Out", {out});
+  } else {
+    desc.SetInput("Input", {in});
+    desc.SetInput("Filter", {filter});
+    desc.SetOutput("Output", {out});
+    auto dims = scope->FindVar(filter)->Get<Tensor>().dims();
+    const int pad = static_cast<int>(dims[2]) / 2;
+    desc.SetAttr<std::vector<int>>("strides", {1, 1});
+    desc.SetAttr<std::vector<int>>("paddings", {pad, pad, pad, pad});
+    desc.SetAttr<std::vector<int>>("dilations", {1, 1});
+    desc.SetAttr<int>("groups", groups);
+  }
+  scope->Var(out)->GetMutable<Tensor>();
+  auto op = LiteOpRegistry::Global().Create(type);
+  ASSERT_TRUE(op);
+  op->Attach(desc, scope);
+  auto kernels =
+      op->CreateKernels({Place{TARGET(kX86), PRECISION(kFloat)}});
+  ASSERT_FALSE(kernels.empty());
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  kernels.front()->SetContext(std::move(ctx));
+  insts->emplace_back(op, std::move(kernels.front()));
+}
+
+static void AddFilter(const std::string& name,
+                      const std::vector<int64_t>& dims,
+                      Scope* scope) {
+  auto* filter = scope->Var(name)->GetMutable<Tensor>();
+  filter->Resize(dims);
+  filter->set_persistable(true);
+  float* data = filter->mutable_data<float>();
+  for (int64_t i = 0; i < filter->numel(); i++) {
+    data[i] = ((i * 7) % 11 - 5) * 0.07f;
+  }
+}
+
+// conv3x3 (direct) -> relu -> depthwise_conv3x3 -> conv3x3 (direct) ->
+// conv1x1 (GEMM) of the x86 kernels, run untiled and tiled.
+TEST(DepthFirstChain, KernelsTiledMatchUntiled) {
+  Scope scope;
+  AddFilter("w0", {8, 3, 3, 3}, &scope);
+  AddFilter("w1", {8, 1, 3, 3}, &scope);
+  AddFilter("w2", {16, 8, 3, 3}, &scope);
+  AddFilter("w3", {4, 16, 1, 1}, &scope);
+  auto* x = scope.Var("x")->GetMutable<Tensor>();
+  x->Resize({2, 3, 75, 29});
+  float* x_data = x->mutable_data<float>();
+  for (int64_t i = 0; i < x->numel(); i++) {
+    x_data[i] = ((i * 13) % 29 - 14) * 0.05f;
+  }
+  std::vector<Instruction> insts;
+  AddInstruction("conv2d", "x", "h0", 1, "w0", &scope, &insts);
+  AddInstruction("relu", "h0", "h1", 1, "", &scope, &insts);
+  AddInstruction("depthwise_conv2d", "h1", "h2", 8, "w1", &scope, &insts);
+  AddInstruction("conv2d", "h2", "h3", 1, "w2", &scope, &insts);
+  AddInstruction("conv2d", "h3", "y", 1, "w3", &scope, &insts);
+  ASSERT_EQ(insts.size(), 5u);
+
+  for (auto& inst : insts) inst.Run();
+  const auto* h3 = scope.FindVar("h3")->GetMutable<Tensor>();
+  const std::vector<float> untiled(h3->data<float>(),
+                                   h3->data<float>() + h3->numel());
+
+  // The GEMM conv1x1 is left out of the chain.
+  auto chains = FindDepthFirstChains(&insts, {}, 1);
+  ASSERT_EQ(chains.size(), 1u);
+  ASSERT_TRUE(chains.count(0));
+  auto& chain = chains.at(0);
+  EXPECT_EQ(chain->size(), 4u);
+  chain->Run();
+  chain->Run();
+  EXPECT_GT(chain->band_rows(), 0);
+  EXPECT_EQ(h3->dims(), DDim({2, 16, 75, 29}));
+  EXPECT_EQ(std::vector<float>(h3->data<float>(),
+                               h3->data<float>() + h3->numel()),
+            untiled);
+}
+#endif  // LITE_WITH_X86
+
+}  // namespace lite
+}  // namespace paddle
+
+#ifdef LITE_WITH_X86
+USE_LITE_OP(conv2d);
+USE_LITE_OP(depthwise_conv2d);
+USE_LITE_OP(relu);
+USE_LITE_KERNEL(conv2d, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(depthwise_conv2d, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(relu, kX86, kFloat, kNCHW, def);
+#endif
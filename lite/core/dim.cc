@@ -14,22 +14,29 @@
 
 #include "lite/core/dim.h"
 #include <string>
+#include "lite/utils/log/cp_logging.h"
 
 namespace paddle {
 namespace lite {
 using value_type = int64_t;
 
-value_type DDimLite::production() const {
-  value_type res = 1;
-  for (size_t i = 0; i < data_.size(); i++) {
-    res *= data_[i];
+constexpr int DDimLite::kMaxRank;
+
+void DDimLite::Assign(const value_type *x, size_t size) {
+  CHECK_LE(size, static_cast<size_t>(kMaxRank))
+      << "Tensors with rank at most " << kMaxRank << " are supported";
+  std::copy(x, x + size, data_);
+  size_ = size;
+  production_ = 1;
+  for (size_t i = 0; i < size; i++) {
+    production_ *= data_[i];
   }
-  return res;
+  production_valid_ = true;
 }
 
 value_type DDimLite::count(int start, int end) const {
   start = std::max(start, 0);
-  end = std::min(end, static_cast<int>(data_.size()));
+  end = std::min(end, static_cast<int>(size_));
   if (end < start) {
     return 0;
   }
@@ -42,12 +49,10 @@ value_type DDimLite::count(int start, int end) const {
 
 DDimLite DDimLite::Slice(int start, int end) const {
   start = std::max(start, 0);
-  end = std::min(end, static_cast<int>(data_.size()));
-  std::vector<value_type> new_dim(end - start);
-  for (int i = start; i < end; i++) {
-    new_dim[i - start] = data_[i];
-  }
-  return DDim(new_dim);
+  end = std::min(end, static_cast<int>(size_));
+  DDimLite res;
+  res.Assign(data_ + start, std::max(end - start, 0));
+  return res;
 }
 
 std::string DDimLite::repr() const {
@@ -30,6 +30,51 @@ namespace lite {
 class DDimLite {
  public:
   using value_type = int64_t;
+  // The same bound as the DDim of the training framework.
+  static constexpr int kMaxRank = 9;
+
+  // Read-only view of the dims, it stays valid as long as the DDimLite it
+  // comes from is neither destroyed nor resized.
+  class ConstView {
+   public:
+    using const_iterator = const value_type *;
+    using iterator = const_iterator;
+
+    ConstView(const value_type *data, size_t size)
+        : data_(data), size_(size) {}
+
+    const value_type *begin() const { return data_; }
+    const value_type *end() const { return data_ + size_; }
+    const value_type *data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const value_type &operator[](size_t offset) const { return data_[offset]; }
+    const value_type &front() const { return data_[0]; }
+    const value_type &back() const { return data_[size_ - 1]; }
+
+    operator std::vector<value_type>() const {
+      return std::vector<value_type>(begin(), end());
+    }
+
+    friend bool operator==(const ConstView &a, const ConstView &b) {
+      return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+    }
+    friend bool operator!=(const ConstView &a, const ConstView &b) {
+      return !(a == b);
+    }
+    friend STL::ostream &operator<<(STL::ostream &os, const ConstView &v) {
+      os << "{";
+      for (size_t i = 0; i < v.size(); i++) {
+        os << (i == 0 ? "" : ",") << v[i];
+      }
+      os << "}";
+      return os;
+    }
+
+   private:
+    const value_type *data_;
+    size_t size_;
+  };
 
   DDimLite() = default;
 
@@ -37,25 +82,41 @@ class DDimLite {
   // DDimLite(std::initializer_list<value_type> init_list) :
   // DDimLite(std::vector<value_type>(init_list)) {}
 
-  void ConstructFrom(const std::vector<value_type> &x) { data_ = x; }
+  void ConstructFrom(const std::vector<value_type> &x) {
+    Assign(x.data(), x.size());
+  }
 
   value_type operator[](int offset) const { return data_[offset]; }
-  value_type &operator[](int offset) { return data_[offset]; }
-  std::vector<int64_t> Vectorize() const { return data_; }
+  // The element may be changed through the reference, so the cached
+  // production has to be recomputed.
+  value_type &operator[](int offset) {
+    production_valid_ = false;
+    return data_[offset];
+  }
+  std::vector<int64_t> Vectorize() const {
+    return std::vector<int64_t>(data_, data_ + size_);
+  }
 
-  size_t size() const { return data_.size(); }
-  bool empty() const { return data_.empty(); }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
 
-  value_type production() const;
+  value_type production() const {
+    return production_valid_ ? production_
+                             : count(0, static_cast<int>(size_));
+  }
 
-  const std::vector<value_type> &data() const { return data_; }
+  ConstView data() const & { return ConstView(data_, size_); }
+  // A temporary would leave the view dangling, it hands out a copy.
+  std::vector<value_type> data() const && { return Vectorize(); }
   value_type count(int start, int end) const;
 
   DDimLite Slice(int start, int end) const;
 
   DDimLite Flatten2D(int col) const {
-    return DDimLite(std::vector<value_type>(
-        {Slice(0, col).production(), Slice(col, size()).production()}));
+    value_type dims[2] = {count(0, col), count(col, static_cast<int>(size_))};
+    DDimLite res;
+    res.Assign(dims, 2);
+    return res;
   }
 
   std::string repr() const;
@@ -74,15 +135,18 @@ class DDimLite {
   }
 
   friend bool operator!=(const DDimLite &a, const DDimLite &b) {
-    if (a.size() != b.size()) return true;
-    for (size_t i = 0; i < a.size(); i++) {
-      if (a[i] != b[i]) return true;
-    }
-    return false;
+    return !(a == b);
   }
 
  private:
-  std::vector<value_type> data_;
+  void Assign(const value_type *x, size_t size);
+
+  // The dims are kept inline, so copying, resizing and comparing the shapes
+  // never touches the heap.
+  value_type data_[kMaxRank] = {};
+  size_t size_{0};
+  value_type production_{1};
+  bool production_valid_{true};
 };
 
 using DDim = paddle::lite::DDimLite;
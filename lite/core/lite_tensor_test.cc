@@ -14,6 +14,8 @@
 
 #include <gtest/gtest.h>
 #include <cstring>
+#include <type_traits>
+#include <vector>
 #include "lite/core/tensor.h"
 
 namespace paddle {
@@ -58,5 +60,34 @@ TEST(tensor, shared_memory) {
 #endif
 }
 
+TEST(tensor, dims) {
+  DDim dims(std::vector<int64_t>({2, 3, 4, 5}));
+  EXPECT_EQ(dims.production(), 120);
+  EXPECT_EQ(dims.Slice(1, 3), DDim(std::vector<int64_t>({3, 4})));
+  EXPECT_EQ(dims.Flatten2D(2), DDim(std::vector<int64_t>({6, 20})));
+  EXPECT_EQ(dims.Slice(3, 1).production(), 1);
+
+  DDim copied = dims;
+  copied[0] = 7;
+  EXPECT_EQ(copied.production(), 420);
+  EXPECT_EQ(dims.production(), 120);
+  EXPECT_NE(copied, dims);
+
+  std::vector<int64_t> vec = dims.data();
+  EXPECT_EQ(vec, dims.Vectorize());
+  EXPECT_EQ(std::vector<int64_t>(dims.data().begin(), dims.data().end()), vec);
+
+  TensorLite tensor;
+  tensor.Resize(vec);
+  EXPECT_EQ(tensor.numel(), 120);
+  tensor.Resize(dims.Flatten2D(1));
+  // A temporary hands out a copy of its dims instead of a view.
+  static_assert(std::is_same<decltype(DDim().data()),
+                             std::vector<int64_t>>::value,
+                "");
+  std::vector<int64_t> flat = DDim(std::vector<int64_t>({2, 60})).data();
+  EXPECT_EQ(std::vector<int64_t>(tensor.dims().data()), flat);
+}
+
 }  // namespace lite
 }  // namespace paddle
@@ -22,6 +22,11 @@
 namespace paddle {
 namespace lite {
 
+#ifdef LITE_WITH_PROFILE
+std::atomic<int64_t> profile::BufferCounter::allocs{0};
+std::atomic<int64_t> profile::BufferCounter::reallocs{0};
+#endif
+
 void* TargetMalloc(TargetType target, size_t size) {
   void* data{nullptr};
   switch (target) {
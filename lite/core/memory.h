@@ -14,7 +14,10 @@
 
 #pragma once
 #include <algorithm>
+#include <atomic>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "lite/api/paddle_place.h"
@@ -124,6 +127,23 @@ void CopySync(void* dst, const void* src, size_t size, IoDirection dir) {
   }
 }
 
+// kHost, kX86 and kARM all use the host allocator.
+inline bool IsHostMemoryTarget(TargetType target) {
+  return target == TARGET(kHost) || target == TARGET(kX86) ||
+         target == TARGET(kARM);
+}
+
+#ifdef LITE_WITH_PROFILE
+namespace profile {
+// The buffers Buffer::ResetLazy allocated for the first time or grew, for
+// the memory accounting of the profiler.
+struct BufferCounter {
+  static std::atomic<int64_t> allocs;
+  static std::atomic<int64_t> reallocs;
+};
+}  // namespace profile
+#endif  // LITE_WITH_PROFILE
+
 // Memory buffer manager.
 class Buffer {
  public:
@@ -138,6 +158,10 @@ class Buffer {
   virtual void ResetLazy(TargetType target, size_t size) {
     if (target != target_ || space_ < size) {
       CHECK_EQ(own_data_, true) << "Can not reset unowned buffer.";
+#ifdef LITE_WITH_PROFILE
+      (space_ > 0 ? profile::BufferCounter::reallocs
+                  : profile::BufferCounter::allocs)++;
+#endif
       Free();
       data_ = TargetMalloc(target, size);
       target_ = target;
@@ -273,5 +297,93 @@ class Buffer {
   TargetType target_{TargetType::kHost};
 };
 
+// Caller memory a tensor is produced into. Unlike an unowned Buffer, asking
+// it for more space than the caller gave, or for memory of another kind,
+// does not fail: it detaches from the caller memory and uses its own until
+// it is attached again.
+class ExternalBuffer : public Buffer {
+ public:
+  ExternalBuffer(void* data, TargetType target, size_t size)
+      : Buffer(data, target, size),
+        external_data_(data),
+        external_target_(target),
+        external_space_(size) {}
+
+  bool attached() const { return !own_data_ && data_ == external_data_; }
+
+  void Attach() {
+    if (attached()) return;
+    Free();
+    data_ = external_data_;
+    target_ = external_target_;
+    space_ = external_space_;
+    own_data_ = false;
+  }
+
+  void Detach() {
+    if (own_data_) return;
+    data_ = nullptr;
+    space_ = 0;
+    own_data_ = true;
+  }
+
+  void ResetLazy(TargetType target, size_t size) override {
+    if (!own_data_) {
+      if (attached() && size <= space_ && Compatible(target)) {
+        target_ = target;
+        return;
+      }
+      Detach();
+    }
+    Buffer::ResetLazy(target, size);
+  }
+
+ private:
+  bool Compatible(TargetType target) const {
+    return target == external_target_ ||
+           (IsHostMemoryTarget(target) && IsHostMemoryTarget(external_target_));
+  }
+
+  void* external_data_{nullptr};
+  TargetType external_target_{TargetType::kHost};
+  size_t external_space_{0};
+};
+
+// A view of immutable host memory shared by the tensors of several models,
+// see WeightRegistry. Every tensor has a view of its own, asking the view
+// for mutable memory gives its tensor a private copy first, so writing a
+// shared weight never changes the other models.
+class SharedBuffer : public Buffer {
+ public:
+  SharedBuffer(const std::shared_ptr<void>& blob, size_t size)
+      : Buffer(blob.get(), TARGET(kHost), size), blob_(blob) {}
+
+  bool shared() const { return blob_ != nullptr; }
+
+  void ResetLazy(TargetType target, size_t size) override {
+    if (!blob_) {
+      Buffer::ResetLazy(target, size);
+      return;
+    }
+    auto blob = std::move(blob_);
+    size_t copy_size = (std::min)(size, space_);
+    data_ = nullptr;
+    space_ = 0;
+    own_data_ = true;
+    Buffer::ResetLazy(target, size);
+    if (IsHostMemoryTarget(target)) {
+      TargetCopy(TARGET(kHost), data_, blob.get(), copy_size);
+    }
+  }
+
+  void Free() override {
+    blob_.reset();
+    Buffer::Free();
+  }
+
+ private:
+  std::shared_ptr<void> blob_;
+};
+
 }  // namespace lite
 }  // namespace paddle
@@ -14,6 +14,7 @@
 
 #include "lite/core/memory.h"
 #include <gtest/gtest.h>
+#include <vector>
 
 namespace paddle {
 namespace lite {
@@ -36,5 +37,25 @@ TEST(memory, test) {
 #endif
 }
 
+TEST(memory, external_buffer) {
+  std::vector<float> external(16);
+  ExternalBuffer buf(external.data(), TARGET(kHost), 16 * sizeof(float));
+  // A fitting host request keeps the caller memory.
+  buf.ResetLazy(TARGET(kX86), 8 * sizeof(float));
+  EXPECT_TRUE(buf.attached());
+  EXPECT_EQ(buf.data(), external.data());
+  // A larger request falls back to memory of its own.
+  buf.ResetLazy(TARGET(kHost), 32 * sizeof(float));
+  EXPECT_FALSE(buf.attached());
+  EXPECT_TRUE(buf.own_data());
+  EXPECT_NE(buf.data(), external.data());
+  buf.Attach();
+  EXPECT_TRUE(buf.attached());
+  EXPECT_EQ(buf.space(), 16 * sizeof(float));
+  buf.Detach();
+  EXPECT_FALSE(buf.attached());
+  EXPECT_EQ(buf.data(), nullptr);
+}
+
 }  // namespace lite
 }  // namespace paddle
@@ -41,7 +41,8 @@ std::string ByteReader::ReadToString(size_t size) const {
   return tmp;
 }
 
-BinaryFileReader::BinaryFileReader(const std::string& path, size_t offset) {
+BinaryFileReader::BinaryFileReader(const std::string& path, size_t offset)
+    : offset_(offset) {
   file_ = fopen(path.c_str(), "rb");
   CHECK(file_) << "Unable to open file: " << path;
   fseek(file_, 0L, SEEK_END);
@@ -56,6 +57,13 @@ void BinaryFileReader::Read(void* dst, size_t size) const {
   cur_ += size;
 }
 
+void BinaryFileReader::Seek(size_t position) const {
+  CHECK_LE(position, length_);
+  CHECK_EQ(fseek(file_, offset_ + position, SEEK_SET), 0)
+      << "Failed to seek to " << position;
+  cur_ = position;
+}
+
 void BinaryFileWriter::Write(const void* src, size_t size) const {
   CHECK(src);
   CHECK_EQ(fwrite(src, 1, size, file_), size) << "Failed to read " << size
@@ -83,6 +83,8 @@ class ByteReader {
   virtual size_t length() const = 0;
   virtual size_t current() const = 0;
   virtual bool ReachEnd() const = 0;
+  // Move to `position`, counted like current().
+  virtual void Seek(size_t position) const = 0;
 
   template <typename T,
             typename = typename std::enable_if<
@@ -138,9 +140,11 @@ class BinaryFileReader : public ByteReader {
   bool ReachEnd() const override { return cur_ >= length_; }
   size_t length() const override { return length_; }
   size_t current() const override { return cur_; }
+  void Seek(size_t position) const override;
 
  private:
   FILE* file_{};
+  size_t offset_{0};
   size_t length_{0};
   mutable size_t cur_{0};
 };
@@ -190,6 +194,10 @@ class StringBufferReader : public ByteReader {
   bool ReachEnd() const override { return cur_ >= length_; }
   size_t length() const override { return length_; }
   size_t current() const override { return cur_; }
+  void Seek(size_t position) const override {
+    CHECK_LE(position, length_);
+    cur_ = position;
+  }
 
  private:
   const std::string& str_;
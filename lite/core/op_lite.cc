@@ -130,6 +130,12 @@ bool OpLite::Attach(const cpp::OpDesc &opdesc, lite::Scope *scope) {
   return AttachImpl(*op_info(), scope);
 }
 
+void OpLite::AttachDesc(const cpp::OpDesc &opdesc, lite::Scope *scope) {
+  CHECK(scope != nullptr);
+  scope_ = scope;
+  op_info_.reset(new OpInfo(opdesc));
+}
+
 const Tensor *OpLite::GetTensor(lite::Scope *scope,
                                 const std::string &name) const {
   auto *var = scope->FindVar(name);
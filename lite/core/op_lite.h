@@ -86,6 +86,10 @@ class OpLite : public Registry {
 
   // Link the external execution environ to internal context.
   bool Attach(const cpp::OpDesc &opdesc, lite::Scope *scope);
+  // Keep the description of the op without linking its variables, so that
+  // the kernels can be created before the inputs read by Attach are ready.
+  // Attach, and AttachKernel for the kernels, must follow before a run.
+  void AttachDesc(const cpp::OpDesc &opdesc, lite::Scope *scope);
 
   const OpInfo *op_info() const { return op_info_.get(); }
   OpInfo *mutable_op_info() { return op_info_.get(); }
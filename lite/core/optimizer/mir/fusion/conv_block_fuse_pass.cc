@@ -0,0 +1,56 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "lite/core/optimizer/mir/fusion/conv_block_fuse_pass.h"
+#include <memory>
+#include <vector>
+#include "lite/core/optimizer/mir/fusion/conv_block_fuser.h"
+#include "lite/core/optimizer/mir/pass_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+void ConvBlockFusePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  for (auto& place : graph->valid_places()) {
+    if (place.precision == PRECISION(kInt8)) return;
+  }
+  // The longest blocks first, so they are not split by a shorter match.
+  for (auto has_pool : {true, false}) {
+    for (auto residual_relu : {true, false}) {
+      for (std::string residual_arg : {"Y", "X", ""}) {
+        if (residual_arg.empty() && (residual_relu || !has_pool)) continue;
+        for (auto conv_has_bias : {true, false}) {
+          VLOG(4) << "conv_has_bias: " << conv_has_bias
+                  << " residual_arg: " << residual_arg
+                  << " residual_relu: " << residual_relu
+                  << " has_pool: " << has_pool;
+          fusion::ConvBlockFuser fuser(
+              conv_has_bias, residual_arg, residual_relu, has_pool);
+          fuser.apply_impl(graph.get());
+        }
+      }
+    }
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(lite_conv_block_fuse_pass,
+                  paddle::lite::mir::ConvBlockFusePass)
+    .BindTargets({TARGET(kX86)})
+    .BindKernel("fusion_conv2d_block");
@@ -0,0 +1,50 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include "lite/core/optimizer/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// Fuses the tail of a CNN block into one fusion_conv2d_block op:
+//
+//   conv2d(+bias+act) -> elementwise_add(residual) -> relu -> pool2d
+//
+// where the residual add, the relu and the pooling are each optional but
+// at least the add or the pooling is there. The x86 kernel computes the
+// conv a band of rows at a time and applies the rest of the block while
+// the band is in cache, instead of writing the conv output to memory and
+// reading it back for every following op.
+//
+// Limitations:
+// * conv2d with groups == 1 in fp32, its fused activation (if any) is one
+//   of relu, relu6, leaky_relu and hard_swish.
+// * The residual broadcasts to the conv output, the add may not broadcast
+//   the conv output to a larger shape.
+// * pool2d is max or avg, neither adaptive nor ceil_mode, with explicit
+//   paddings.
+class ConvBlockFusePass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
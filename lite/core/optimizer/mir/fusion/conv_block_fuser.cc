@@ -0,0 +1,222 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/fusion/conv_block_fuser.h"
+#include <memory>
+#include <vector>
+#include "lite/operators/fusion_conv2d_block_op.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+namespace fusion {
+
+void ConvBlockFuser::BuildPattern() {
+  // The conv epilogue must be one the x86 fill_bias_act knows.
+  auto conv_teller = [](const Node* node) -> bool {
+    auto* op_info = const_cast<Node*>(node)->AsStmt().op_info();
+    if (op_info->GetAttr<int>("groups") != 1) return false;
+    if (op_info->HasAttr("enable_int8") &&
+        op_info->GetAttr<bool>("enable_int8")) {
+      return false;
+    }
+    if (op_info->HasAttr("fuse_elementwise_op_type")) return false;
+    if (op_info->HasAttr("data_format") &&
+        op_info->GetAttr<std::string>("data_format") == "NHWC") {
+      return false;
+    }
+    if (op_info->HasAttr("with_act") && op_info->GetAttr<bool>("with_act")) {
+      auto act_type = op_info->GetAttr<std::string>("act_type");
+      return act_type == "relu" || act_type == "relu6" ||
+             act_type == "leaky_relu" || act_type == "hard_swish";
+    }
+    return true;
+  };
+  auto add_teller = [](const Node* node) -> bool {
+    auto* op_info = const_cast<Node*>(node)->AsStmt().op_info();
+    int axis = op_info->GetAttr<int>("axis");
+    return (axis == -1 || axis == 0) && !op_info->HasAttr("fuse_scale") &&
+           !op_info->HasAttr("act_type");
+  };
+  // Floor mode windows with explicit paddings only.
+  auto pool_teller = [](const Node* node) -> bool {
+    auto* op_info = const_cast<Node*>(node)->AsStmt().op_info();
+    auto pooling_type = op_info->GetAttr<std::string>("pooling_type");
+    if (pooling_type != "max" && pooling_type != "avg") return false;
+    if (op_info->HasAttr("adaptive") && op_info->GetAttr<bool>("adaptive")) {
+      return false;
+    }
+    if (op_info->HasAttr("ceil_mode") && op_info->GetAttr<bool>("ceil_mode")) {
+      return false;
+    }
+    if (op_info->HasAttr("padding_algorithm")) {
+      auto algorithm = op_info->GetAttr<std::string>("padding_algorithm");
+      if (!algorithm.empty() && algorithm != "EXPLICIT") return false;
+    }
+    if (op_info->HasAttr("data_format") &&
+        op_info->GetAttr<std::string>("data_format") == "NHWC") {
+      return false;
+    }
+    return op_info->GetAttr<std::vector<int>>("ksize").size() == 2UL;
+  };
+
+  auto* input =
+      VarNode("input")->assert_is_op_input("conv2d", "Input")->AsInput();
+  auto* filter = VarNode("filter")
+                     ->assert_is_op_input("conv2d", "Filter")
+                     ->assert_is_persistable_var()
+                     ->AsInput();
+  auto* conv = OpNode("conv", "conv2d")
+                   ->assert_node_satisfied(conv_teller)
+                   ->AsIntermediate();
+  auto* conv_out = VarNode("conv_out")
+                       ->assert_is_op_output("conv2d", "Output")
+                       ->assert_only_one_output()
+                       ->AsIntermediate();
+  std::vector<PMNode*> conv_inputs{input, filter};
+  if (conv_has_bias_) {
+    auto* bias = VarNode("bias")
+                     ->assert_is_op_input("conv2d", "Bias")
+                     ->assert_is_persistable_var()
+                     ->AsInput();
+    conv_inputs.push_back(bias);
+  }
+  conv->LinksFrom(conv_inputs).LinksTo({conv_out});
+
+  PMNode* last = conv_out;
+  output_key_ = "conv_out";
+  if (!residual_arg_.empty()) {
+    const std::string other_arg = residual_arg_ == "X" ? "Y" : "X";
+    conv_out->assert_is_op_input("elementwise_add", residual_arg_);
+    auto* residual = VarNode("residual")
+                         ->assert_is_op_input("elementwise_add", other_arg)
+                         ->assert_var_not_persistable()
+                         ->AsInput();
+    auto* add = OpNode("add", "elementwise_add")
+                    ->assert_node_satisfied(add_teller)
+                    ->AsIntermediate();
+    auto* add_out =
+        VarNode("add_out")->assert_is_op_output("elementwise_add", "Out");
+    add->LinksFrom({conv_out, residual}).LinksTo({add_out});
+    last = add_out;
+    output_key_ = "add_out";
+    if (residual_relu_) {
+      add_out->assert_is_op_input("relu", "X")
+          ->assert_only_one_output()
+          ->AsIntermediate();
+      auto* relu = OpNode("relu", "relu")->AsIntermediate();
+      auto* relu_out = VarNode("relu_out")->assert_is_op_output("relu", "Out");
+      relu->LinksFrom({add_out}).LinksTo({relu_out});
+      last = relu_out;
+      output_key_ = "relu_out";
+    }
+  }
+  if (has_pool_) {
+    last->assert_is_op_input("pool2d", "X")
+        ->assert_only_one_output()
+        ->AsIntermediate();
+    auto* pool = OpNode("pool", "pool2d")
+                     ->assert_node_satisfied(pool_teller)
+                     ->AsIntermediate();
+    auto* pool_out = VarNode("pool_out")->assert_is_op_output("pool2d", "Out");
+    pool->LinksFrom({last}).LinksTo({pool_out});
+    last = pool_out;
+    output_key_ = "pool_out";
+  }
+  last->AsOutput();
+}
+
+void ConvBlockFuser::InsertNewNode(SSAGraph* graph,
+                                   const key2nodes_t& matched) {
+  auto conv_old = matched.at("conv")->stmt()->op();
+  auto* scope = conv_old->scope();
+  // The kernel broadcasts the residual to the conv output, skip the adds
+  // whose known dims broadcast the conv output instead.
+  if (!residual_arg_.empty()) {
+    auto* conv_out_var = scope->FindVar(matched.at("conv_out")->arg()->name);
+    auto* residual_var = scope->FindVar(matched.at("residual")->arg()->name);
+    if (conv_out_var && residual_var) {
+      auto conv_out_dims = conv_out_var->Get<Tensor>().dims();
+      auto residual_dims = residual_var->Get<Tensor>().dims();
+      const int axis =
+          matched.at("add")->stmt()->op_info()->GetAttr<int>("axis");
+      if (conv_out_dims.size() > 0 && residual_dims.size() > 0 &&
+          !operators::BlockResidualBroadcasts(
+              residual_dims, conv_out_dims, axis)) {
+        VLOG(4) << "Residual dims " << residual_dims
+                << " do not broadcast to the conv output dims "
+                << conv_out_dims << ". Skip this pass!";
+        return;
+      }
+    }
+  }
+
+  for (const std::string key :
+       {"conv", "conv_out", "add", "add_out", "relu", "relu_out", "pool"}) {
+    if (matched.count(key) && key != output_key_) {
+      nodes2rm_.insert(matched.at(key));
+    }
+  }
+
+  auto op_desc = GenOpDesc(matched);
+  auto block_op = LiteOpRegistry::Global().Create("fusion_conv2d_block");
+  auto& valid_places = conv_old->valid_places();
+  block_op->Attach(op_desc, scope);
+  auto* new_op_node = graph->GraphCreateInstructNode(block_op, valid_places);
+
+  IR_NODE_LINK_TO(matched.at("input"), new_op_node);
+  IR_NODE_LINK_TO(matched.at("filter"), new_op_node);
+  if (conv_has_bias_) {
+    IR_NODE_LINK_TO(matched.at("bias"), new_op_node);
+  }
+  if (!residual_arg_.empty()) {
+    IR_NODE_LINK_TO(matched.at("residual"), new_op_node);
+  }
+  IR_NODE_LINK_TO(new_op_node, matched.at(output_key_));
+}
+
+cpp::OpDesc ConvBlockFuser::GenOpDesc(const key2nodes_t& matched) {
+  cpp::OpDesc op_desc = *matched.at("conv")->stmt()->op_info();
+  op_desc.SetType("fusion_conv2d_block");
+  op_desc.SetOutput("Output", {matched.at(output_key_)->arg()->name});
+  if (!residual_arg_.empty()) {
+    op_desc.SetInput("ResidualData", {matched.at("residual")->arg()->name});
+    op_desc.SetAttr("residual_axis",
+                    matched.at("add")->stmt()->op_info()->GetAttr<int>("axis"));
+    op_desc.SetAttr("residual_relu", residual_relu_);
+  }
+  if (has_pool_) {
+    auto* pool_info = matched.at("pool")->stmt()->op_info();
+    op_desc.SetAttr("pool_type",
+                    pool_info->GetAttr<std::string>("pooling_type"));
+    op_desc.SetAttr("pool_ksize",
+                    pool_info->GetAttr<std::vector<int>>("ksize"));
+    op_desc.SetAttr("pool_strides",
+                    pool_info->GetAttr<std::vector<int>>("strides"));
+    op_desc.SetAttr("pool_paddings",
+                    pool_info->GetAttr<std::vector<int>>("paddings"));
+    bool global = pool_info->HasAttr("global_pooling") &&
+                  pool_info->GetAttr<bool>("global_pooling");
+    bool exclusive = !pool_info->HasAttr("exclusive") ||
+                     pool_info->GetAttr<bool>("exclusive");
+    op_desc.SetAttr("pool_global", global);
+    op_desc.SetAttr("pool_exclusive", exclusive);
+  }
+  return op_desc;
+}
+
+}  // namespace fusion
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
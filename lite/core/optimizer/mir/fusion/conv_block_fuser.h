@@ -0,0 +1,71 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <set>
+#include <string>
+#include "lite/core/optimizer/mir/pattern_matcher_high_api.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+namespace fusion {
+
+// conv2d [-> elementwise_add(residual) [-> relu]] [-> pool2d]
+// `residual_arg` is the elementwise_add argument the conv output is bound
+// to, "X" or "Y", or empty when the block has no residual add.
+class ConvBlockFuser : public FuseBase {
+ public:
+  ConvBlockFuser(bool conv_has_bias,
+                 const std::string& residual_arg,
+                 bool residual_relu,
+                 bool has_pool)
+      : conv_has_bias_(conv_has_bias),
+        residual_arg_(residual_arg),
+        residual_relu_(residual_relu),
+        has_pool_(has_pool) {}
+
+  size_t apply_impl(SSAGraph* graph) {
+    BuildPattern();
+    PerformPatternMatcher(graph);
+
+    for (const auto& matched : key2nodes_) {
+      InsertNewNode(graph, matched);
+    }
+
+    GraphSafeRemoveNodes(graph, nodes2rm_);
+    return key2nodes_.size();
+  }
+
+  void BuildPattern() override;
+  void InsertNewNode(SSAGraph* graph, const key2nodes_t& matched) override;
+
+ private:
+  cpp::OpDesc GenOpDesc(const key2nodes_t& matched) override;
+
+  bool conv_has_bias_{false};
+  std::string residual_arg_;
+  bool residual_relu_{false};
+  bool has_pool_{false};
+  // Key of the var the block writes.
+  std::string output_key_;
+  std::set<const Node*> nodes2rm_;
+};
+
+}  // namespace fusion
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,41 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/fusion/embedding_bag_fuse_pass.h"
+#include <memory>
+#include <vector>
+#include "lite/core/optimizer/mir/fusion/embedding_bag_fuser.h"
+#include "lite/core/optimizer/mir/pass_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+void EmbeddingBagFusePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  // lookup_table_dequant is left alone: it only has an ARM kernel, and fusing
+  // it here would silently move the lookup onto X86.
+  for (auto lookup_type : {"lookup_table", "lookup_table_v2"}) {
+    fusion::EmbeddingBagFuser fuser(lookup_type);
+    fuser(graph.get());
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(lite_embedding_bag_fuse_pass,
+                  paddle::lite::mir::EmbeddingBagFusePass)
+    .BindTargets({TARGET(kX86)})
+    .BindKernel("embedding_bag");
@@ -0,0 +1,147 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "lite/core/optimizer/mir/fusion/embedding_bag_fuse_pass.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/op_registry.h"
+#include "lite/core/optimizer/mir/pass_registry.h"
+#include "lite/core/optimizer/mir/ssa_graph.h"
+#include "lite/core/program.h"
+#include "lite/model_parser/cpp_desc.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// ids, w -> lookup_type -> emb -> sequence_pool(pool_type) -> out
+std::shared_ptr<cpp::ProgramDesc> BuildLookupPoolProgram(
+    const std::shared_ptr<Scope>& scope,
+    const std::string& lookup_type,
+    const std::string& pool_type,
+    const std::string& half_weight_type) {
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto* block_desc = program_desc->AddBlock<cpp::BlockDesc>();
+  block_desc->ClearOps();
+  block_desc->ClearVars();
+  for (auto name : {"ids", "w", "emb", "out", "max_index"}) {
+    auto* var_desc = block_desc->AddVar<cpp::VarDesc>();
+    var_desc->SetName(name);
+    var_desc->SetPersistable(std::string(name) == "w");
+  }
+  auto* w = scope->Var("w")->GetMutable<Tensor>();
+  w->Resize({16, 8});
+  w->mutable_data<float>();
+  auto* ids = scope->Var("ids")->GetMutable<Tensor>();
+  ids->Resize({4, 1});
+  ids->mutable_data<int64_t>();
+
+  auto* lookup = block_desc->AddOp<cpp::OpDesc>();
+  lookup->SetType(lookup_type);
+  lookup->SetInput("Ids", {"ids"});
+  lookup->SetInput("W", {"w"});
+  lookup->SetOutput("Out", {"emb"});
+  lookup->SetAttr<int64_t>("padding_idx", -1);
+  if (!half_weight_type.empty()) {
+    lookup->SetAttr<std::string>("half_weight_type", half_weight_type);
+  }
+
+  auto* pool = block_desc->AddOp<cpp::OpDesc>();
+  pool->SetType("sequence_pool");
+  pool->SetInput("X", {"emb"});
+  pool->SetOutput("Out", {"out"});
+  pool->SetOutput("MaxIndex", {"max_index"});
+  pool->SetAttr<std::string>("pooltype", pool_type);
+  return program_desc;
+}
+
+std::vector<std::string> ApplyEmbeddingBagFuse(
+    const std::string& lookup_type,
+    const std::string& pool_type,
+    const std::string& half_weight_type = "") {
+  std::vector<Place> valid_places{{TARGET(kX86), PRECISION(kFloat)}};
+  auto scope = std::make_shared<Scope>();
+  auto program_desc = BuildLookupPoolProgram(
+      scope, lookup_type, pool_type, half_weight_type);
+  Program program(program_desc, scope, valid_places);
+  std::unique_ptr<SSAGraph> graph(new SSAGraph());
+  graph->Build(program, valid_places);
+
+  auto* pass = PassManager::Global().LookUp("lite_embedding_bag_fuse_pass");
+  CHECK(pass);
+  pass->Apply(graph);
+
+  std::vector<std::string> op_types;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    op_types.push_back(node->AsStmt().op_type());
+    if (op_types.back() == "embedding_bag") {
+      auto* op_info = node->AsStmt().op_info();
+      EXPECT_EQ(op_info->GetAttr<std::string>("pooltype"), pool_type);
+      EXPECT_EQ(op_info->Input("Ids").front(), "ids");
+      EXPECT_EQ(op_info->Input("W").front(), "w");
+      EXPECT_EQ(op_info->Output("Out").front(), "out");
+      EXPECT_EQ(op_info->HasAttr("half_weight_type"),
+                !half_weight_type.empty());
+      if (!half_weight_type.empty()) {
+        EXPECT_EQ(op_info->GetAttr<std::string>("half_weight_type"),
+                  half_weight_type);
+      }
+    }
+  }
+  return op_types;
+}
+
+TEST(EmbeddingBagFusePass, fuse_lookup_and_pool) {
+  for (auto lookup_type : {"lookup_table", "lookup_table_v2"}) {
+    for (auto pool_type : {"SUM", "AVERAGE", "SQRT"}) {
+      auto op_types = ApplyEmbeddingBagFuse(lookup_type, pool_type);
+      ASSERT_EQ(op_types.size(), 1u);
+      EXPECT_EQ(op_types[0], "embedding_bag");
+    }
+  }
+}
+
+TEST(EmbeddingBagFusePass, keep_half_weight_type) {
+  for (auto half_weight_type : {"fp16", "bf16"}) {
+    auto op_types =
+        ApplyEmbeddingBagFuse("lookup_table_v2", "SUM", half_weight_type);
+    ASSERT_EQ(op_types.size(), 1u);
+    EXPECT_EQ(op_types[0], "embedding_bag");
+  }
+}
+
+TEST(EmbeddingBagFusePass, skip_unsupported_chains) {
+  // MAX pooling has no embedding_bag counterpart.
+  auto op_types = ApplyEmbeddingBagFuse("lookup_table_v2", "MAX");
+  EXPECT_EQ(op_types,
+            std::vector<std::string>({"lookup_table_v2", "sequence_pool"}));
+  // lookup_table_dequant only has an ARM kernel.
+  op_types = ApplyEmbeddingBagFuse("lookup_table_dequant", "SUM");
+  EXPECT_EQ(op_types[0], "lookup_table_dequant");
+  EXPECT_EQ(op_types.size(), 2u);
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(lookup_table);
+USE_LITE_OP(lookup_table_v2);
+USE_LITE_OP(lookup_table_dequant);
+USE_LITE_OP(sequence_pool);
+USE_LITE_OP(embedding_bag);
+USE_MIR_PASS(lite_embedding_bag_fuse_pass);
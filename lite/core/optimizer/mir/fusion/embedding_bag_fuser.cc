@@ -0,0 +1,124 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/fusion/embedding_bag_fuser.h"
+
+#include <memory>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace mir {
+namespace fusion {
+
+// """
+// merge {lookup_table, sequence_pool} => embedding_bag
+//     ids    w                     ids    w
+//       \   /                        \   /
+//    lookup_table                 embedding_bag
+//         |             =>             |
+//   sequence_pool(SUM/AVERAGE/SQRT)   out
+//         |
+//        out
+// """
+void EmbeddingBagFuser::BuildPattern() {
+  auto pool_type_teller = [](const std::string& pool_type) {
+    return pool_type == "SUM" || pool_type == "AVERAGE" || pool_type == "SQRT";
+  };
+
+  // create input nodes.
+  auto* ids =
+      VarNode("ids")->assert_is_op_input(lookup_type_, "Ids")->AsInput();
+  auto* w = VarNode("w")->assert_is_op_input(lookup_type_, "W")->AsInput();
+
+  // create op nodes
+  auto* lookup_table = OpNode("lookup_table", lookup_type_)
+                           ->assert_is_op(lookup_type_)
+                           ->AsIntermediate();
+  auto* sequence_pool =
+      OpNode("sequence_pool", "sequence_pool")
+          ->assert_is_op("sequence_pool")
+          ->assert_op_attr_satisfied<std::string>("pooltype", pool_type_teller)
+          ->AsIntermediate();
+
+  // create intermediate nodes
+  auto* lookup_table_out = VarNode("lookup_table_out")
+                               ->assert_is_op_output(lookup_type_, "Out")
+                               ->assert_is_op_input("sequence_pool", "X")
+                               ->assert_only_one_output()
+                               ->AsIntermediate();
+  auto* max_index = VarNode("max_index")
+                        ->assert_is_op_output("sequence_pool", "MaxIndex")
+                        ->AsIntermediate();
+
+  // create output node
+  auto* out =
+      VarNode("out")->assert_is_op_output("sequence_pool", "Out")->AsOutput();
+
+  // create topology.
+  *ids >> *lookup_table >> *lookup_table_out >> *sequence_pool >> *out;
+  *w >> *lookup_table;
+  *sequence_pool >> *max_index;
+}
+
+void EmbeddingBagFuser::InsertNewNode(SSAGraph* graph,
+                                      const key2nodes_t& matched) {
+  auto op_desc = GenOpDesc(matched);
+  auto fuse_op = LiteOpRegistry::Global().Create("embedding_bag");
+  auto lookup_table = matched.at("lookup_table")->stmt()->op();
+  auto* scope = lookup_table->scope();
+  auto& valid_places = lookup_table->valid_places();
+  fuse_op->Attach(op_desc, scope);
+
+  auto* new_op_node = graph->GraphCreateInstructNode(fuse_op, valid_places);
+
+  IR_NODE_LINK_TO(matched.at("ids"), new_op_node);
+  IR_NODE_LINK_TO(matched.at("w"), new_op_node);
+  IR_NODE_LINK_TO(new_op_node, matched.at("out"));
+}
+
+cpp::OpDesc EmbeddingBagFuser::GenOpDesc(const key2nodes_t& matched) {
+  auto* lookup_info = matched.at("lookup_table")->stmt()->op_info();
+  auto* pool_info = matched.at("sequence_pool")->stmt()->op_info();
+
+  cpp::OpDesc op_desc;
+  op_desc.SetType("embedding_bag");
+  op_desc.SetInput("Ids", {matched.at("ids")->arg()->name});
+  op_desc.SetInput("W", {matched.at("w")->arg()->name});
+  op_desc.SetOutput("Out", {matched.at("out")->arg()->name});
+  if (lookup_info->HasAttr("padding_idx")) {
+    op_desc.SetAttr<int64_t>("padding_idx",
+                             lookup_info->GetAttr<int64_t>("padding_idx"));
+  }
+  op_desc.SetAttr<std::string>("pooltype",
+                               pool_info->GetAttr<std::string>("pooltype"));
+  if (pool_info->HasAttr("pad_value")) {
+    op_desc.SetAttr<float>("pad_value", pool_info->GetAttr<float>("pad_value"));
+  }
+  op_desc.SetAttr<std::string>(
+      "table_quant_type",
+      lookup_type_ == "lookup_table_dequant" ? "uint8_minmax" : "none");
+  // Set by post_quant_dynamic_pass for QUANT_FP16/QUANT_BF16.
+  if (lookup_info->HasAttr("half_weight_type")) {
+    op_desc.SetAttr<std::string>(
+        "half_weight_type",
+        lookup_info->GetAttr<std::string>("half_weight_type"));
+  }
+  return op_desc;
+}
+
+}  // namespace fusion
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
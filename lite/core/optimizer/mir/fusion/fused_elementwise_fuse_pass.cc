@@ -0,0 +1,274 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/fusion/fused_elementwise_fuse_pass.h"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+#include "lite/core/op_registry.h"
+#include "lite/core/optimizer/mir/pass_registry.h"
+#include "lite/core/optimizer/mir/pattern_matcher.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+namespace {
+
+// The step names of the binary ops, the second entry is used when the
+// accumulator is the Y input.
+const std::map<std::string, std::pair<std::string, std::string>>&
+BinaryOps() {
+  static const std::map<std::string, std::pair<std::string, std::string>>
+      kOps{{"elementwise_add", {"add", "add"}},
+           {"elementwise_sub", {"sub", "rsub"}},
+           {"elementwise_mul", {"mul", "mul"}},
+           {"elementwise_div", {"div", "rdiv"}},
+           {"elementwise_max", {"max", "max"}},
+           {"elementwise_min", {"min", "min"}}};
+  return kOps;
+}
+
+float AttrOr(const OpInfo* op_info, const std::string& name, float value) {
+  return op_info->HasAttr(name) ? op_info->GetAttr<float>(name) : value;
+}
+
+// FP32 in the VarType of the model.
+const int kFloatDType = 5;
+
+}  // namespace
+
+bool FusedElementwiseFusePass::IsFloatArg(const Node* node) const {
+  const Type* type = node->arg()->type;
+  return type != nullptr && type->IsTensor() &&
+         type->precision() == PRECISION(kFloat);
+}
+
+Node* FusedElementwiseFusePass::OutputArg(Node* node) const {
+  if (node->outlinks.size() != 1) return nullptr;
+  auto* out = node->outlinks.front();
+  auto out_names = node->stmt()->op_info()->Output("Out");
+  if (out_names.size() != 1 || out->arg()->name != out_names.front()) {
+    return nullptr;
+  }
+  return IsFloatArg(out) ? out : nullptr;
+}
+
+bool FusedElementwiseFusePass::ParseStep(Node* node,
+                                         const std::string& acc,
+                                         Step* step) const {
+  if (!node->IsStmt()) return false;
+  const auto* op_info = node->stmt()->op_info();
+  const auto& op_type = op_info->Type();
+  if (op_info->HasAttr("enable_int8") &&
+      op_info->GetAttr<bool>("enable_int8")) {
+    return false;
+  }
+  if (op_info->HasAttr("activation_type") &&
+      !op_info->GetAttr<std::string>("activation_type").empty()) {
+    return false;
+  }
+
+  auto binary = BinaryOps().find(op_type);
+  if (binary != BinaryOps().end()) {
+    if (op_info->HasAttr("fuse_scale") &&
+        op_info->GetAttr<bool>("fuse_scale")) {
+      return false;
+    }
+    auto x = op_info->Input("X").front();
+    auto y = op_info->Input("Y").front();
+    if (x == y) return false;
+    if (acc == x) {
+      step->type = binary->second.first;
+      step->operand = y;
+    } else if (acc == y) {
+      step->type = binary->second.second;
+      step->operand = x;
+    } else {
+      return false;
+    }
+    step->axis = op_info->HasAttr("axis") ? op_info->GetAttr<int>("axis") : -1;
+    for (auto* in : node->inlinks) {
+      if (in->arg()->name == step->operand) {
+        step->operand_arg = in;
+      }
+    }
+    return step->operand_arg != nullptr && IsFloatArg(step->operand_arg);
+  }
+
+  auto x_names = op_info->Input("X");
+  if (x_names.size() != 1 || x_names.front() != acc ||
+      node->inlinks.size() != 1) {
+    return false;
+  }
+  step->type = op_type;
+  if (op_type == "scale") {
+    if (op_info->HasInput("ScaleTensor") &&
+        !op_info->Input("ScaleTensor").empty()) {
+      return false;
+    }
+    float scale = AttrOr(op_info, "scale", 1.f);
+    float bias = AttrOr(op_info, "bias", 0.f);
+    if (op_info->HasAttr("bias_after_scale") &&
+        !op_info->GetAttr<bool>("bias_after_scale")) {
+      bias *= scale;
+    }
+    step->params[0] = scale;
+    step->params[1] = bias;
+  } else if (op_type == "cast") {
+    if (op_info->GetAttr<int>("in_dtype") != kFloatDType ||
+        op_info->GetAttr<int>("out_dtype") != kFloatDType) {
+      return false;
+    }
+    step->type.clear();
+  } else if (op_type == "relu6") {
+    step->params[0] = AttrOr(op_info, "threshold", 6.f);
+  } else if (op_type == "leaky_relu") {
+    step->params[0] = AttrOr(op_info, "alpha", 0.02f);
+  } else if (op_type == "swish") {
+    step->params[0] = AttrOr(op_info, "beta", 1.f);
+  } else if (op_type == "hard_sigmoid") {
+    step->params[0] = AttrOr(op_info, "slope", 0.2f);
+    step->params[1] = AttrOr(op_info, "offset", 0.5f);
+  } else if (op_type == "hard_swish") {
+    step->params[0] = AttrOr(op_info, "threshold", 6.f);
+    step->params[1] = AttrOr(op_info, "scale", 6.f);
+    step->params[2] = AttrOr(op_info, "offset", 3.f);
+  } else if (op_type != "relu" && op_type != "sigmoid" && op_type != "tanh" &&
+             op_type != "exp" && op_type != "abs") {
+    return false;
+  }
+  return true;
+}
+
+void FusedElementwiseFusePass::InsertFusedOp(SSAGraph* graph,
+                                             const std::vector<Node*>& ops,
+                                             const std::vector<Step>& steps,
+                                             Node* in_arg,
+                                             Node* out_arg) {
+  std::vector<Node*> x_args{in_arg};
+  std::vector<std::string> x_names{in_arg->arg()->name};
+  std::vector<std::string> types;
+  std::vector<int> inputs;
+  std::vector<int> axes;
+  std::vector<float> params;
+  for (auto& step : steps) {
+    if (step.type.empty()) continue;
+    int input = -1;
+    if (step.operand_arg != nullptr) {
+      auto it = std::find(x_names.begin(), x_names.end(), step.operand);
+      input = static_cast<int>(it - x_names.begin());
+      if (it == x_names.end()) {
+        x_names.push_back(step.operand);
+        x_args.push_back(step.operand_arg);
+      }
+    }
+    types.push_back(step.type);
+    inputs.push_back(input);
+    axes.push_back(step.axis);
+    params.insert(params.end(), step.params, step.params + 3);
+  }
+
+  cpp::OpDesc op_desc;
+  op_desc.SetType("fused_elementwise");
+  op_desc.SetInput("X", x_names);
+  op_desc.SetOutput("Out", {out_arg->arg()->name});
+  op_desc.SetAttr("fused_op_types", types);
+  op_desc.SetAttr("fused_op_inputs", inputs);
+  op_desc.SetAttr("fused_op_axes", axes);
+  op_desc.SetAttr("fused_op_params", params);
+
+  auto* scope = ops.front()->stmt()->op()->scope();
+  auto fused_op = LiteOpRegistry::Global().Create("fused_elementwise");
+  CHECK(fused_op) << "Unregistered op fused_elementwise";
+  fused_op->Attach(op_desc, scope);
+  auto* fused_node =
+      graph->GraphCreateInstructNode(fused_op, graph->valid_places());
+  for (auto* arg : x_args) {
+    DirectedLink(arg, fused_node);
+  }
+  DirectedLink(fused_node, out_arg);
+
+  std::set<const Node*> nodes2rm;
+  for (size_t i = 0; i < ops.size(); i++) {
+    nodes2rm.insert(ops[i]);
+    if (i + 1 < ops.size()) nodes2rm.insert(ops[i]->outlinks.front());
+  }
+  GraphSafeRemoveNodes(graph, nodes2rm);
+  VLOG(4) << "fused " << types.size() << " ops into fused_elementwise of "
+          << out_arg->arg()->name;
+}
+
+void FusedElementwiseFusePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  // The fused kernel is fp32 on the CPU, leave the other devices and the
+  // fp16 graphs to their own kernels.
+  for (auto& place : graph->valid_places()) {
+    if (place.precision == PRECISION(kFP16)) return;
+    if (place.target != TARGET(kX86) && place.target != TARGET(kARM) &&
+        place.target != TARGET(kHost) && place.target != TARGET(kAny)) {
+      return;
+    }
+  }
+
+  std::set<const Node*> fused;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    // The fused nodes are removed already, only compare their addresses.
+    if (fused.count(node)) continue;
+    auto x_names = node->stmt()->op_info()->Input("X");
+    if (x_names.empty()) continue;
+    Step first;
+    if (!ParseStep(node, x_names.front(), &first)) continue;
+    Node* in_arg = nullptr;
+    for (auto* in : node->inlinks) {
+      if (in->arg()->name == x_names.front()) in_arg = in;
+    }
+    if (in_arg == nullptr || !IsFloatArg(in_arg)) continue;
+
+    std::vector<Node*> ops{node};
+    std::vector<Step> steps{first};
+    while (true) {
+      Node* out = OutputArg(ops.back());
+      if (out == nullptr || out->outlinks.size() != 1 ||
+          out->arg()->is_weight || out->arg()->is_persist) {
+        break;
+      }
+      Node* next = out->outlinks.front();
+      Step step;
+      if (fused.count(next) || !ParseStep(next, out->arg()->name, &step)) {
+        break;
+      }
+      ops.push_back(next);
+      steps.push_back(step);
+    }
+    Node* out_arg = OutputArg(ops.back());
+    int num = std::count_if(steps.begin(), steps.end(), [](const Step& s) {
+      return !s.type.empty();
+    });
+    if (out_arg == nullptr || num < 2) continue;
+
+    fused.insert(ops.begin(), ops.end());
+    InsertFusedOp(graph.get(), ops, steps, in_arg, out_arg);
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(lite_fused_elementwise_fuse_pass,
+                  paddle::lite::mir::FusedElementwiseFusePass)
+    .BindTargets({TARGET(kX86), TARGET(kARM)})
+    .BindKernel("fused_elementwise");
@@ -0,0 +1,62 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/optimizer/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// Collects the maximal chains of fp32 elementwise (with broadcast), scale,
+// unary activation and identity cast ops, where every intermediate result
+// has a single consumer, into one fused_elementwise op, e.g.
+//
+//   elementwise_add(x, y) -> scale -> sigmoid -> elementwise_mul(., z)
+//
+// becomes fused_elementwise(X=[x, y, z]) evaluating the four ops in a single
+// pass over memory instead of one pass per op.
+class FusedElementwiseFusePass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+ private:
+  // One op of a chain, see operators::FusedElementwiseParam.
+  struct Step {
+    std::string type;
+    std::string operand;  // empty for unary ops
+    Node* operand_arg{nullptr};
+    int axis{-1};
+    float params[3]{0.f, 0.f, 0.f};
+  };
+
+  // Parses the op of `node` whose accumulator input is `acc`, returns false
+  // if it can't be fused. Identity casts give a step with an empty type.
+  bool ParseStep(Node* node, const std::string& acc, Step* step) const;
+  bool IsFloatArg(const Node* node) const;
+  Node* OutputArg(Node* node) const;
+  void InsertFusedOp(SSAGraph* graph,
+                     const std::vector<Node*>& ops,
+                     const std::vector<Step>& steps,
+                     Node* in_arg,
+                     Node* out_arg);
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,138 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "lite/core/optimizer/mir/fusion/fused_elementwise_fuse_pass.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/op_registry.h"
+#include "lite/core/optimizer/mir/pass_registry.h"
+#include "lite/core/optimizer/mir/ssa_graph.h"
+#include "lite/core/program.h"
+#include "lite/model_parser/cpp_desc.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// One op of a straight chain: `type` reads the previous output as X, and
+// `y` as Y when it is not empty.
+struct ChainOp {
+  std::string type;
+  std::string y;
+};
+
+// Builds the chain over the fp32 input "x" and applies `passes` in order,
+// returns the op types left in the graph.
+std::vector<std::string> FuseChain(const std::vector<ChainOp>& chain,
+                                   const std::vector<std::string>& passes) {
+  std::vector<Place> valid_places{{TARGET(kX86), PRECISION(kFloat)}};
+  auto scope = std::make_shared<Scope>();
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto* block_desc = program_desc->AddBlock<cpp::BlockDesc>();
+  block_desc->ClearOps();
+  block_desc->ClearVars();
+  auto add_var = [&](const std::string& name) {
+    auto* var_desc = block_desc->AddVar<cpp::VarDesc>();
+    var_desc->SetName(name);
+    var_desc->SetType(VarDescAPI::Type::LOD_TENSOR);
+    var_desc->SetDataType(VarDescAPI::VarDataType::FP32);
+    auto* tensor = scope->Var(name)->GetMutable<Tensor>();
+    tensor->Resize({2, 8});
+    tensor->mutable_data<float>();
+  };
+  add_var("x");
+  std::string in = "x";
+  for (size_t i = 0; i < chain.size(); i++) {
+    std::string out = "out" + std::to_string(i);
+    add_var(out);
+    auto* op = block_desc->AddOp<cpp::OpDesc>();
+    op->SetType(chain[i].type);
+    op->SetInput("X", {in});
+    op->SetOutput("Out", {out});
+    if (!chain[i].y.empty()) {
+      add_var(chain[i].y);
+      op->SetInput("Y", {chain[i].y});
+      op->SetAttr<int>("axis", -1);
+    }
+    if (chain[i].type == "scale") {
+      op->SetAttr<float>("scale", 2.f);
+      op->SetAttr<float>("bias", 1.f);
+      op->SetAttr<bool>("bias_after_scale", true);
+    }
+    in = out;
+  }
+
+  Program program(program_desc, scope, valid_places);
+  std::unique_ptr<SSAGraph> graph(new SSAGraph());
+  graph->Build(program, valid_places);
+  graph->SetValidPlaces(valid_places);
+  for (auto& name : passes) {
+    auto* pass = PassManager::Global().LookUp(name);
+    CHECK(pass) << name;
+    pass->Apply(graph);
+  }
+
+  std::vector<std::string> op_types;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    op_types.push_back(node->AsStmt().op_type());
+  }
+  return op_types;
+}
+
+TEST(FusedElementwiseFusePass, fuse_chain) {
+  auto op_types = FuseChain({{"elementwise_mul", "y"},
+                             {"sigmoid", ""},
+                             {"elementwise_sub", "z"},
+                             {"scale", ""}},
+                            {"lite_fused_elementwise_fuse_pass"});
+  EXPECT_EQ(op_types, std::vector<std::string>({"fused_elementwise"}));
+}
+
+TEST(FusedElementwiseFusePass, keep_elementwise_activation_fusion) {
+  // In the order of RunDefaultOptimizer, elementwise + relu is left to
+  // lite_elementwise_activation_fuse_pass and only the tail is fused.
+  auto op_types = FuseChain({{"elementwise_add", "y"},
+                             {"relu", ""},
+                             {"scale", ""},
+                             {"sigmoid", ""}},
+                            {"lite_elementwise_activation_fuse_pass",
+                             "lite_fused_elementwise_fuse_pass"});
+  EXPECT_EQ(op_types,
+            std::vector<std::string>(
+                {"fusion_elementwise_add_activation", "fused_elementwise"}));
+}
+
+TEST(FusedElementwiseFusePass, skip_single_op) {
+  auto op_types = FuseChain({{"elementwise_add", "y"}},
+                            {"lite_fused_elementwise_fuse_pass"});
+  EXPECT_EQ(op_types, std::vector<std::string>({"elementwise_add"}));
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(elementwise_add);
+USE_LITE_OP(elementwise_sub);
+USE_LITE_OP(elementwise_mul);
+USE_LITE_OP(relu);
+USE_LITE_OP(sigmoid);
+USE_LITE_OP(scale);
+USE_LITE_OP(fusion_elementwise_add_activation);
+USE_LITE_OP(fused_elementwise);
+USE_MIR_PASS(lite_elementwise_activation_fuse_pass);
+USE_MIR_PASS(lite_fused_elementwise_fuse_pass);
@@ -19,6 +19,7 @@
 #include <string>
 #include <vector>
 #include "lite/api/paddle_place.h"
+#include "lite/backends/host/math/half_weight.h"
 #include "lite/core/optimizer/mir/pass_registry.h"
 
 namespace paddle {
@@ -31,6 +32,12 @@ const std::vector<std::string> PostQuantDynamicPass::quant_axis1_ops = {
 std::vector<std::string> PostQuantDynamicPass::quant_ops = {
     "conv2d", "mul", "lookup_table"};
 
+const std::vector<std::string> PostQuantDynamicPass::dynamic_quant_ops = {
+    "mul", "fc", "matmul"};
+
+const std::vector<std::string> PostQuantDynamicPass::half_weight_ops = {
+    "mul", "fc", "matmul", "lookup_table", "lookup_table_v2"};
+
 static bool abs_compare(float a, float b) {
   return std::fabs(a) < std::fabs(b);
 }
@@ -154,22 +161,103 @@ void PostQuantDynamicPerChannel(OpInfo* op_info,
   op_info->SetAttr(weight_name + "_quant_scale", scales);
 }
 
+void PostQuantDynamicPass::ApplyHalfWeight(
+    const std::unique_ptr<SSAGraph>& graph, bool bf16) {
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (!node->IsStmt()) continue;
+    const std::string op_type = node->stmt()->op_type();
+    if (std::find(half_weight_ops.begin(), half_weight_ops.end(), op_type) ==
+        half_weight_ops.end()) {
+      continue;
+    }
+    OpInfo* op_info = node->stmt()->mutable_op_info();
+    if (op_type == "matmul" && (op_info->GetAttr<bool>("transpose_X") ||
+                                op_info->GetAttr<bool>("transpose_Y"))) {
+      continue;
+    }
+    // The fp16/bf16 fc kernel neither reads padded weights nor fuses other
+    // activations than relu.
+    if (op_type == "fc" &&
+        ((op_info->HasAttr("padding_weights") &&
+          op_info->GetAttr<bool>("padding_weights")) ||
+         (op_info->HasAttr("activation_type") &&
+          !op_info->GetAttr<std::string>("activation_type").empty() &&
+          op_info->GetAttr<std::string>("activation_type") != "relu"))) {
+      continue;
+    }
+    const std::string arg_name =
+        (op_type == "mul" || op_type == "matmul") ? "Y" : "W";
+    if (!op_info->HasInput(arg_name) || op_info->Input(arg_name).size() != 1) {
+      continue;
+    }
+    const std::string weight_name = op_info->Input(arg_name).front();
+    mir::Node* weight_node = nullptr;
+    for (auto* in_node : node->inlinks) {
+      if (in_node->IsArg() && in_node->arg()->name == weight_name) {
+        weight_node = in_node;
+      }
+    }
+    // A weight shared with other ops keeps its fp32 data for them.
+    if (!weight_node || !weight_node->arg()->is_weight ||
+        weight_node->outlinks.size() != 1) {
+      continue;
+    }
+    auto* scope = node->stmt()->op()->scope();
+    Tensor* weight = scope->FindVar(weight_name)->GetMutable<Tensor>();
+    CHECK(weight) << "Can not find the weight in scope.";
+    if (weight->precision() != PrecisionType::kFloat ||
+        weight->dims().size() != 2) {
+      continue;
+    }
+
+    Tensor tmp_tensor;
+    tmp_tensor.CopyDataFrom(*weight);
+    weight->clear();
+    weight->set_precision(PRECISION(kInt16));
+    const float* src = tmp_tensor.data<float>();
+    uint16_t* dst =
+        reinterpret_cast<uint16_t*>(weight->mutable_data<int16_t>());
+    for (int64_t i = 0; i < tmp_tensor.numel(); i++) {
+      dst[i] = bf16 ? host::math::float_to_bf16(src[i])
+                    : host::math::float_to_fp16(src[i]);
+    }
+    op_info->SetAttr<std::string>("half_weight_type",
+                                  bf16 ? host::math::kHalfWeightBF16
+                                       : host::math::kHalfWeightFP16);
+  }
+}
+
 void PostQuantDynamicPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  if (quant_type_ == lite_api::QuantType::QUANT_FP16 ||
+      quant_type_ == lite_api::QuantType::QUANT_BF16) {
+    ApplyHalfWeight(graph, quant_type_ == lite_api::QuantType::QUANT_BF16);
+    return;
+  }
   int quant_bits = 16;
+  bool dynamic_quant = false;
   if (quant_type_ == lite_api::QuantType::QUANT_INT8) {
     quant_bits = 8;
+  } else if (quant_type_ == lite_api::QuantType::QUANT_INT8_DYNAMIC) {
+    quant_bits = 8;
+    dynamic_quant = true;
   } else if (quant_type_ == lite_api::QuantType::QUANT_INT16) {
     quant_bits = 16;
   } else {
     LOG(FATAL) << "Not support quant type:" << static_cast<int>(quant_type_);
   }
 
+  auto is_dynamic_quant_op = [](const std::string& op_type) {
+    return std::find(dynamic_quant_ops.begin(),
+                     dynamic_quant_ops.end(),
+                     op_type) != dynamic_quant_ops.end();
+  };
   std::vector<mir::Node*> nodes;
   for (auto* node : graph->StmtTopologicalOrder()) {
     if (node->IsStmt()) {
       const std::string op_type = node->stmt()->op_type();
       auto iter = std::find(quant_ops.begin(), quant_ops.end(), op_type);
-      if (iter != quant_ops.end()) {
+      if (iter != quant_ops.end() ||
+          (dynamic_quant && is_dynamic_quant_op(op_type))) {
         nodes.push_back(node);
       }
     }
@@ -179,6 +267,12 @@ void PostQuantDynamicPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
     const std::string op_type = node->stmt()->op_type();
     OpInfo* op_info = node->stmt()->mutable_op_info();
     auto* scope = node->stmt()->op()->scope();
+    bool is_matmul = op_type == "matmul" || op_type == "matmul_v2";
+    if (is_matmul &&
+        (op_info->GetAttr<bool>(op_type == "matmul" ? "transpose_Y"
+                                                    : "trans_y"))) {
+      continue;
+    }
     for (auto* in_node : node->inlinks) {
       CHECK(in_node->IsArg()) << "The input node should be variable.";
       if (in_node->arg()->is_weight) {
@@ -190,11 +284,20 @@ void PostQuantDynamicPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
                     << "so skip quantizing the weight of " << weight_name;
           continue;
         }
+        if (is_matmul && weight->dims().size() != 2) {
+          continue;
+        }
         auto iter =
             std::find(quant_axis1_ops.begin(), quant_axis1_ops.end(), op_type);
-        int quant_axis = iter != quant_axis1_ops.end() ? 1 : 0;
+        int quant_axis =
+            (iter != quant_axis1_ops.end() || is_dynamic_quant_op(op_type))
+                ? 1
+                : 0;
         PostQuantDynamicPerChannel(
             op_info, weight, weight_name, quant_axis, quant_bits);
+        if (dynamic_quant && is_dynamic_quant_op(op_type)) {
+          op_info->SetAttr<bool>("enable_dynamic_quant", true);
+        }
       }
     }
   }
@@ -30,6 +30,12 @@ namespace mir {
  * weights to int8/16. So the size of the quantized weights is reduced 4x/2x.
  * In inference stage, the quantized weights are dequantized to fp32 and run
  * all ops to get output.
+ * With QUANT_INT8_DYNAMIC the ops in dynamic_quant_ops are also marked with
+ * `enable_dynamic_quant`, their kernels may then quantize the activations at
+ * runtime and compute in int8.
+ * With QUANT_FP16/QUANT_BF16 only the 2-D weights of half_weight_ops are
+ * converted, they are stored as the 16 bit patterns in int16 tensors and the
+ * ops are marked with `half_weight_type`.
  */
 class PostQuantDynamicPass : public ProgramPass {
  public:
@@ -39,10 +45,17 @@ class PostQuantDynamicPass : public ProgramPass {
   // For the ops in quant_axis1_ops, the quantized axis is 1.
   // Default, quant_axis1_ops = {"mul", "lookup_table"}
   static const std::vector<std::string> quant_axis1_ops;
+  // The ops whose weights are quantized along axis 1 and marked with
+  // `enable_dynamic_quant` for QUANT_INT8_DYNAMIC.
+  static const std::vector<std::string> dynamic_quant_ops;
+  // The ops whose weights are stored as fp16/bf16 for QUANT_FP16/QUANT_BF16.
+  static const std::vector<std::string> half_weight_ops;
 
  public:
   void Apply(const std::unique_ptr<SSAGraph>& graph) override;
 
+  void ApplyHalfWeight(const std::unique_ptr<SSAGraph>& graph, bool bf16);
+
   void SetQuantType(lite_api::QuantType quant_type) {
     quant_type_ = quant_type;
   }
@@ -0,0 +1,110 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/post_quant_dynamic_pass.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "lite/backends/host/math/half_weight.h"
+#include "lite/core/optimizer/mir/pass_registry.h"
+#include "lite/core/optimizer/mir/ssa_graph.h"
+#include "lite/core/program.h"
+#include "lite/model_parser/cpp_desc.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// Runs post_quant_dynamic_pass with QUANT_FP16 over a single fc of a 16x8
+// weight, and returns the resulting op and the precision of its weight.
+std::unique_ptr<cpp::OpDesc> ApplyHalfWeightFc(const std::string& act_type,
+                                               bool padding_weights,
+                                               PrecisionType* precision) {
+  std::vector<Place> valid_places{{TARGET(kX86), PRECISION(kFloat)}};
+  auto scope = std::make_shared<Scope>();
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto* block_desc = program_desc->AddBlock<cpp::BlockDesc>();
+  block_desc->ClearOps();
+  block_desc->ClearVars();
+  for (auto name : {"x", "w", "out"}) {
+    auto* var_desc = block_desc->AddVar<cpp::VarDesc>();
+    var_desc->SetName(name);
+    var_desc->SetPersistable(std::string(name) == "w");
+  }
+  auto* x = scope->Var("x")->GetMutable<Tensor>();
+  x->Resize({2, 16});
+  x->mutable_data<float>();
+  auto* w = scope->Var("w")->GetMutable<Tensor>();
+  w->Resize({16, 8});
+  auto* w_data = w->mutable_data<float>();
+  for (int i = 0; i < 16 * 8; i++) {
+    w_data[i] = 0.25f * (i % 7);
+  }
+  w->set_persistable(true);
+
+  auto* fc = block_desc->AddOp<cpp::OpDesc>();
+  fc->SetType("fc");
+  fc->SetInput("Input", {"x"});
+  fc->SetInput("W", {"w"});
+  fc->SetOutput("Out", {"out"});
+  fc->SetAttr<int>("in_num_col_dims", 1);
+  fc->SetAttr<std::string>("activation_type", act_type);
+  fc->SetAttr<bool>("padding_weights", padding_weights);
+
+  Program program(program_desc, scope, valid_places);
+  std::unique_ptr<SSAGraph> graph(new SSAGraph());
+  graph->Build(program, valid_places);
+  graph->SetValidPlaces(valid_places);
+  auto* pass = dynamic_cast<PostQuantDynamicPass*>(
+      PassManager::Global().LookUp("post_quant_dynamic_pass"));
+  CHECK(pass);
+  pass->SetQuantType(lite_api::QuantType::QUANT_FP16);
+  pass->Apply(graph);
+
+  *precision = scope->FindVar("w")->Get<Tensor>().precision();
+  auto stmts = graph->StmtTopologicalOrder();
+  CHECK_EQ(stmts.size(), 1u);
+  return std::unique_ptr<cpp::OpDesc>(
+      new cpp::OpDesc(*stmts.front()->AsStmt().op_info()));
+}
+
+TEST(PostQuantDynamicPass, half_weight_fc) {
+  for (auto act_type : {"", "relu"}) {
+    PrecisionType precision;
+    auto op = ApplyHalfWeightFc(act_type, false, &precision);
+    EXPECT_EQ(op->GetAttr<std::string>("half_weight_type"),
+              host::math::kHalfWeightFP16);
+    EXPECT_EQ(precision, PRECISION(kInt16));
+  }
+}
+
+TEST(PostQuantDynamicPass, half_weight_keep_fc) {
+  // The fp16/bf16 fc kernel can not read padded weights nor fuse sigmoid.
+  for (auto config : std::vector<std::pair<std::string, bool>>{
+           {"", true}, {"relu", true}, {"sigmoid", false}}) {
+    PrecisionType precision;
+    auto op = ApplyHalfWeightFc(config.first, config.second, &precision);
+    EXPECT_FALSE(op->HasAttr("half_weight_type"));
+    EXPECT_EQ(precision, PRECISION(kFloat));
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(fc);
+USE_MIR_PASS(post_quant_dynamic_pass);
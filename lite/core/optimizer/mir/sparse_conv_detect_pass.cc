@@ -16,9 +16,12 @@
 // operations with the kernel size of 1x1. In practice, the pass requires the
 // convolutional weights to be sparse. And, the sparser the weights
 // are, the more latency improvement we would potentially obtain.
+// On x86 the fc and matmul ops with a constant 2-D weight are converted into
+// sparse_fc as well.
 
 #include "lite/core/optimizer/mir/sparse_conv_detect_pass.h"
 #include <math.h>
+#include <algorithm>
 #include <list>
 #include <memory>
 #include <string>
@@ -68,13 +71,14 @@ int SparseConvDetectPass::ComputeSparseWeight(
   }
   int tmp_diff = 0;
   int tmp_ik = 0;
-  for (size_t ocb = 0; ocb < M; ocb++) {
+  for (int ocb = 0; ocb < M; ocb++) {
     if (ocb == 0) {
-      for (int ik = 0; ik < oc_nonzeros[ocb]; ik++) {
+      for (uint32_t ik = 0; ik < oc_nonzeros[ocb]; ik++) {
         tmp_diff += diffs[tmp_ik++];
       }
     } else {
-      for (int ik = 0; ik < (oc_nonzeros[ocb] - oc_nonzeros[ocb - 1]); ik++) {
+      uint32_t num = oc_nonzeros[ocb] - oc_nonzeros[ocb - 1];
+      for (uint32_t ik = 0; ik < num; ik++) {
         tmp_diff += diffs[tmp_ik++];
       }
     }
@@ -145,13 +149,13 @@ int SparseConvDetectPass::ComputeSparseWeight(
   }
 
   int left_index = 0, right_index = 0;
-  for (size_t ocb = 0; ocb < M; ocb++) {
+  for (int ocb = 0; ocb < M; ocb++) {
     if (ocb == 0) {
-      for (int i = 0; i < oc_nonzeros[ocb]; i++) {
+      for (uint32_t i = 0; i < oc_nonzeros[ocb]; i++) {
         diffs[right_index++] = act_diffs[left_index++];
       }
       if (oc_nonzeros[ocb] % 4 != 0) {
-        size_t extra_zeros = 4 - (oc_nonzeros[ocb] % 4);
+        int extra_zeros = 4 - (oc_nonzeros[ocb] % 4);
         for (int j = 0; j < extra_zeros; j++) {
           diffs[right_index++] = 0;
         }
@@ -166,7 +170,7 @@ int SparseConvDetectPass::ComputeSparseWeight(
         diffs[right_index++] = act_diffs[left_index++];
       }
       if (cur_num % 4 != 0) {
-        size_t extra_zeros = 4 - (cur_num % 4);
+        int extra_zeros = 4 - (cur_num % 4);
         for (int j = 0; j < extra_zeros; j++) {
           diffs[right_index++] = 0;
         }
@@ -175,13 +179,14 @@ int SparseConvDetectPass::ComputeSparseWeight(
   }
   int tmp_diff = 0;
   int tmp_ik = 0;
-  for (size_t ocb = 0; ocb < M; ocb++) {
+  for (int ocb = 0; ocb < M; ocb++) {
     if (ocb == 0) {
-      for (int ik = 0; ik < oc_nonzeros[ocb]; ik++) {
+      for (uint32_t ik = 0; ik < oc_nonzeros[ocb]; ik++) {
         tmp_diff += diffs[tmp_ik++];
       }
     } else {
-      for (int ik = 0; ik < (oc_nonzeros[ocb] - oc_nonzeros[ocb - 1]); ik++) {
+      uint32_t num = oc_nonzeros[ocb] - oc_nonzeros[ocb - 1];
+      for (uint32_t ik = 0; ik < num; ik++) {
         tmp_diff += diffs[tmp_ik++];
       }
     }
@@ -602,7 +607,293 @@ void SparseConvDetectPass::CopyOutputScaleFromOpInfo(cpp::OpDesc* op_desc,
   }
 }
 
+int SparseConvDetectPass::ComputeX86SparseWeight(
+    const float* weights,
+    const int rows,
+    const int cols,
+    const bool transposed,
+    const float scale,
+    lite::Tensor* nonzero_output_tensor,
+    lite::Tensor* oc_nonzeros_tensor,
+    lite::Tensor* diffs_tensor) {
+  auto at = [&](int r, int c) {
+    return transposed ? weights[c * rows + r] : weights[r * cols + c];
+  };
+  // Blocks of four output rows let the kernel reuse every loaded input for
+  // four accumulators, so they are taken as long as at least half of the
+  // stored elements are real non-zeros.
+  int num_nonzeros = 0;
+  int num_blocks4 = 0;
+  for (int g = 0; g < rows; g += 4) {
+    for (int c = 0; c < cols; c++) {
+      bool nonzero_block = false;
+      for (int r = g; r < std::min(g + 4, rows); r++) {
+        if (at(r, c) != 0.f) {
+          num_nonzeros++;
+          nonzero_block = true;
+        }
+      }
+      if (nonzero_block) num_blocks4++;
+    }
+  }
+  const int block_size = (num_nonzeros >= num_blocks4 * 2) ? 4 : 1;
+  const int num_blocks = block_size == 4 ? num_blocks4 : num_nonzeros;
+  nonzero_output_tensor->Resize({std::max(num_blocks * block_size, 1)});
+  oc_nonzeros_tensor->Resize({rows});
+  diffs_tensor->Resize({std::max(num_blocks, 1)});
+  float* values = nonzero_output_tensor->mutable_data<float>();
+  auto* row_ends = oc_nonzeros_tensor->mutable_data<int32_t>();
+  auto* col_idx = diffs_tensor->mutable_data<int32_t>();
+  int index = 0;
+  for (int g = 0; g < rows; g += block_size) {
+    const int g_end = std::min(g + block_size, rows);
+    for (int c = 0; c < cols; c++) {
+      bool nonzero_block = false;
+      for (int r = g; r < g_end; r++) {
+        nonzero_block |= at(r, c) != 0.f;
+      }
+      if (!nonzero_block) continue;
+      col_idx[index] = c;
+      for (int r = 0; r < block_size; r++) {
+        values[index * block_size + r] =
+            g + r < rows ? at(g + r, c) * scale : 0.f;
+      }
+      index++;
+    }
+    for (int r = g; r < g_end; r++) {
+      row_ends[r] = index;
+    }
+  }
+  nonzero_output_tensor->set_precision(PRECISION(kFloat));
+  oc_nonzeros_tensor->set_precision(PRECISION(kInt32));
+  diffs_tensor->set_precision(PRECISION(kInt32));
+  nonzero_output_tensor->set_persistable(true);
+  oc_nonzeros_tensor->set_persistable(true);
+  diffs_tensor->set_persistable(true);
+  return block_size;
+}
+
+bool SparseConvDetectPass::ReplaceWithX86SparseOp(
+    const std::unique_ptr<SSAGraph>& graph,
+    Node* node,
+    const std::string& weight_name,
+    const float* weights,
+    const int rows,
+    const int cols,
+    const bool transposed,
+    const float scale,
+    cpp::OpDesc* op_desc) {
+  auto* scope = node->stmt()->op()->scope();
+  auto nonzeros_output_name =
+      string_format("%s_nonzeros_output", weight_name.c_str());
+  auto oc_nonzeros_name = string_format("%s_oc_nonzeros", weight_name.c_str());
+  auto ic_diffs_name = string_format("%s_ic_diffs", weight_name.c_str());
+  if (scope->FindVar(nonzeros_output_name)) {
+    VLOG(4) << "The weight " << weight_name << " is shared by several ops";
+    return false;
+  }
+  auto* nonzeros_output_t =
+      scope->Var(nonzeros_output_name)->GetMutable<Tensor>();
+  auto* oc_nonzeros_t = scope->Var(oc_nonzeros_name)->GetMutable<Tensor>();
+  auto* ic_diffs_t = scope->Var(ic_diffs_name)->GetMutable<Tensor>();
+  int block_size = ComputeX86SparseWeight(weights,
+                                          rows,
+                                          cols,
+                                          transposed,
+                                          scale,
+                                          nonzeros_output_t,
+                                          oc_nonzeros_t,
+                                          ic_diffs_t);
+  VLOG(4) << "x86 sparse " << op_desc->Type() << " of " << weight_name
+          << " block_size: " << block_size;
+  op_desc->SetInput("NonZeroWeights", {nonzeros_output_name});
+  op_desc->SetInput("OcNonZeros", {oc_nonzeros_name});
+  op_desc->SetInput("Diffs", {ic_diffs_name});
+  op_desc->SetAttr<int>("sparse_block_size", block_size);
+  auto sparse_op = LiteOpRegistry::Global().Create(op_desc->Type());
+  CHECK(sparse_op) << "Unregistered op " << op_desc->Type();
+  sparse_op->Attach(*op_desc, scope);
+  auto* sparse_op_node =
+      graph->GraphCreateInstructNode(sparse_op, graph->valid_places());
+
+  std::vector<std::string> arg_names{
+      nonzeros_output_name, oc_nonzeros_name, ic_diffs_name};
+  for (auto& arg_name : arg_names) {
+    auto* arg = graph->NewArgumentNode(arg_name);
+    arg->AsArg().is_persist = true;
+    arg->AsArg().is_weight = true;
+    DirectedLink(arg, sparse_op_node);
+  }
+  for (auto iter = node->inlinks.begin(); iter != node->inlinks.end();) {
+    auto it =
+        std::find((*iter)->outlinks.begin(), (*iter)->outlinks.end(), node);
+    if (it != (*iter)->outlinks.end()) {
+      (*iter)->outlinks.erase(it);
+    }
+    if ((*iter)->IsArg() && (*iter)->AsArg().name == weight_name) {
+      if ((*iter)->outlinks.empty()) graph->RemoveNode(*iter);
+    } else {
+      DirectedLink(*iter, sparse_op_node);
+    }
+    iter = node->inlinks.erase(iter);
+  }
+  for (auto iter = node->outlinks.begin(); iter != node->outlinks.end();) {
+    DirectedLink(sparse_op_node, *iter);
+    auto it =
+        std::find((*iter)->inlinks.begin(), (*iter)->inlinks.end(), node);
+    if (it != (*iter)->inlinks.end()) {
+      (*iter)->inlinks.erase(it);
+    }
+    iter = node->outlinks.erase(iter);
+  }
+  graph->RemoveNode(node);
+  return true;
+}
+
+void SparseConvDetectPass::ApplyX86(const std::unique_ptr<SSAGraph>& graph) {
+  auto is_sparse = [&](const lite::Tensor& w) {
+    int zero_num = ComputeSparseZeros<float>(&w, w.numel());
+    float sparse_zero_percent =
+        static_cast<float>(zero_num) / static_cast<float>(w.numel());
+    VLOG(4) << "sparse zero num percent: " << sparse_zero_percent;
+    return sparse_zero_percent >= sparse_threshold_;
+  };
+  auto supported_act = [](const std::string& act_type) {
+    return act_type.empty() || act_type == "relu" || act_type == "relu6";
+  };
+  for (auto& node : graph->StmtTopologicalOrder()) {
+    if (!node->IsStmt()) continue;
+    auto op_type = node->AsStmt().op_type();
+    if (op_type != "conv2d" && op_type != "fc" && op_type != "matmul" &&
+        op_type != "matmul_v2") {
+      continue;
+    }
+    auto* scope = node->stmt()->op()->scope();
+    auto* op_info = node->stmt()->mutable_op_info();
+    if (op_info->HasAttr("enable_int8") &&
+        op_info->GetAttr<bool>("enable_int8")) {
+      VLOG(4) << "The x86 sparse " << op_type << " only supports fp32";
+      continue;
+    }
+    cpp::OpDesc op_desc;
+    std::string w;
+    int rows = 0, cols = 0;
+    bool transposed = false;
+    float scale = 1.f;
+    if (op_type == "conv2d") {
+      w = op_info->Input("Filter").front();
+      auto& w_tensor = scope->FindVar(w)->Get<lite::Tensor>();
+      auto weight_dims = w_tensor.dims();
+      auto groups = op_info->GetAttr<int>("groups");
+      auto strides = op_info->GetAttr<std::vector<int>>("strides");
+      auto paddings = op_info->GetAttr<std::vector<int>>("paddings");
+      bool with_act =
+          op_info->HasAttr("with_act") && op_info->GetAttr<bool>("with_act");
+      if (w_tensor.precision() != PrecisionType::kFloat ||
+          weight_dims.size() != 4 || weight_dims[2] != 1 ||
+          weight_dims[3] != 1 || groups != 1 || strides[0] != 1 ||
+          strides[1] != 1 ||
+          std::any_of(paddings.begin(), paddings.end(), [](int p) {
+            return p != 0;
+          })) {
+        VLOG(4) << "The x86 sparse conv only supports fp32 1x1 conv with "
+                   "stride 1, padding 0 and groups 1";
+        continue;
+      }
+      if (with_act &&
+          !supported_act(op_info->GetAttr<std::string>("act_type"))) {
+        continue;
+      }
+      if (!is_sparse(w_tensor)) continue;
+      rows = weight_dims[0];
+      cols = weight_dims[1];
+      op_desc.SetType("sparse_conv2d");
+      op_desc.SetInput("Input", op_info->Input("Input"));
+      if (op_info->HasInput("Bias") && !op_info->Input("Bias").empty()) {
+        op_desc.SetInput("Bias", op_info->Input("Bias"));
+      }
+      op_desc.SetOutput("Output", op_info->Output("Output"));
+      std::vector<std::string> attr_names = op_info->AttrNames();
+      for (size_t i = 0; i < attr_names.size(); i++) {
+        CopyAttrFromOpInfo(&op_desc, op_info, attr_names[i]);
+      }
+    } else {
+      bool is_fc = op_type == "fc";
+      w = op_info->Input(is_fc ? "W" : "Y").front();
+      auto x = op_info->Input(is_fc ? "Input" : "X").front();
+      auto& w_tensor = scope->FindVar(w)->Get<lite::Tensor>();
+      auto x_dims = scope->FindVar(x)->Get<lite::Tensor>().dims();
+      auto weight_dims = w_tensor.dims();
+      if (!w_tensor.persistable() ||
+          w_tensor.precision() != PrecisionType::kFloat ||
+          weight_dims.size() != 2) {
+        continue;
+      }
+      int in_num_col_dims = 1;
+      if (is_fc) {
+        in_num_col_dims = op_info->GetAttr<int>("in_num_col_dims");
+        if ((op_info->HasAttr("padding_weights") &&
+             op_info->GetAttr<bool>("padding_weights")) ||
+            (op_info->HasAttr("activation_type") &&
+             !supported_act(
+                 op_info->GetAttr<std::string>("activation_type")))) {
+          continue;
+        }
+        op_desc.SetAttr<std::string>(
+            "activation_type",
+            op_info->HasAttr("activation_type")
+                ? op_info->GetAttr<std::string>("activation_type")
+                : "");
+        if (op_info->HasInput("Bias") && !op_info->Input("Bias").empty()) {
+          op_desc.SetInput("Bias", op_info->Input("Bias"));
+        }
+      } else {
+        bool is_v2 = op_type == "matmul_v2";
+        if (op_info->GetAttr<bool>(is_v2 ? "trans_x" : "transpose_X") ||
+            op_info->GetAttr<bool>(is_v2 ? "trans_y" : "transpose_Y")) {
+          continue;
+        }
+        if (x_dims.size() < 2) {
+          VLOG(4) << "The rank of the matmul input is unknown";
+          continue;
+        }
+        in_num_col_dims = x_dims.size() - 1;
+        if (op_info->HasAttr("alpha")) {
+          scale = op_info->GetAttr<float>("alpha");
+        }
+      }
+      if (!is_sparse(w_tensor)) continue;
+      rows = weight_dims[1];
+      cols = weight_dims[0];
+      transposed = true;
+      op_desc.SetType("sparse_fc");
+      op_desc.SetInput("Input", {x});
+      op_desc.SetOutput("Out", op_info->Output("Out"));
+      op_desc.SetAttr<int>("in_num_col_dims", in_num_col_dims);
+    }
+    auto& w_tensor = scope->FindVar(w)->Get<lite::Tensor>();
+    ReplaceWithX86SparseOp(graph,
+                           node,
+                           w,
+                           w_tensor.data<float>(),
+                           rows,
+                           cols,
+                           transposed,
+                           scale,
+                           &op_desc);
+  }
+}
+
 void SparseConvDetectPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  bool has_arm = false, has_x86 = false;
+  for (auto& place : graph->valid_places()) {
+    has_arm |= place.target == TARGET(kARM);
+    has_x86 |= place.target == TARGET(kX86);
+  }
+  if (has_x86 && !has_arm) {
+    ApplyX86(graph);
+    return;
+  }
   for (auto& node : graph->StmtTopologicalOrder()) {
     if (node->IsStmt() && node->AsStmt().op_type() == "conv2d") {
       auto* scope = node->stmt()->op()->scope();
@@ -860,9 +1151,8 @@ void SparseConvDetectPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
 
 REGISTER_MIR_PASS(sparse_conv_detect_pass,
                   paddle::lite::mir::SparseConvDetectPass)
-    .BindTargets({TARGET(kARM)})
+    .BindTargets({TARGET(kARM), TARGET(kX86)})
     .ExcludeTargets({TARGET(kXPU)})
     .ExcludeTargets({TARGET(kBM)})
     .ExcludeTargets({TARGET(kOpenCL)})
-    .ExcludeTargets({TARGET(kNPU)})
-    .ExcludeTargets({TARGET(kX86)});
+    .ExcludeTargets({TARGET(kNPU)});
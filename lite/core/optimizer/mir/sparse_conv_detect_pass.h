@@ -90,11 +90,36 @@ class SparseConvDetectPass : public ProgramPass {
                                  OpInfo* op_info,
                                  const std::string& name);
 
+  // Compresses the dense fp32 weight [rows x cols], or [cols x rows] when
+  // `transposed`, with the x86 layout of lite/backends/x86/math/sparse_spmm.h
+  // and returns the chosen block size.
+  int ComputeX86SparseWeight(const float* weights,
+                             const int rows,
+                             const int cols,
+                             const bool transposed,
+                             const float scale,
+                             lite::Tensor* nonzero_output_tensor,
+                             lite::Tensor* oc_nonzeros_tensor,
+                             lite::Tensor* diffs_tensor);
+
   void SetSparseThreshold(float sparse_threshold) {
     sparse_threshold_ = sparse_threshold;
   }
 
  private:
+  // x86 converts 1x1 conv2d into sparse_conv2d and fc/matmul with a constant
+  // 2-D weight into sparse_fc.
+  void ApplyX86(const std::unique_ptr<SSAGraph>& graph);
+  bool ReplaceWithX86SparseOp(const std::unique_ptr<SSAGraph>& graph,
+                              Node* node,
+                              const std::string& weight_name,
+                              const float* weights,
+                              const int rows,
+                              const int cols,
+                              const bool transposed,
+                              const float scale,
+                              cpp::OpDesc* op_desc);
+
   float sparse_threshold_{0.5f};
 };
 
@@ -0,0 +1,102 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "lite/core/optimizer/mir/sparse_conv_detect_pass.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/optimizer/mir/pass_registry.h"
+#include "lite/core/optimizer/mir/ssa_graph.h"
+#include "lite/core/program.h"
+#include "lite/model_parser/cpp_desc.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// Runs sparse_conv_detect_pass for x86 over a single fc of a 16x8 weight
+// whose first `nonzero_rows` rows are non-zero, and returns the resulting op.
+std::unique_ptr<cpp::OpDesc> DetectSparseFc(int nonzero_rows,
+                                            const std::string& act_type) {
+  std::vector<Place> valid_places{{TARGET(kX86), PRECISION(kFloat)}};
+  auto scope = std::make_shared<Scope>();
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto* block_desc = program_desc->AddBlock<cpp::BlockDesc>();
+  block_desc->ClearOps();
+  block_desc->ClearVars();
+  for (auto name : {"x", "w", "out"}) {
+    auto* var_desc = block_desc->AddVar<cpp::VarDesc>();
+    var_desc->SetName(name);
+    var_desc->SetPersistable(std::string(name) == "w");
+  }
+  auto* x = scope->Var("x")->GetMutable<Tensor>();
+  x->Resize({2, 16});
+  x->mutable_data<float>();
+  auto* w = scope->Var("w")->GetMutable<Tensor>();
+  w->Resize({16, 8});
+  auto* w_data = w->mutable_data<float>();
+  for (int i = 0; i < 16 * 8; i++) {
+    w_data[i] = i < nonzero_rows * 8 ? 0.5f : 0.f;
+  }
+  w->set_persistable(true);
+
+  auto* fc = block_desc->AddOp<cpp::OpDesc>();
+  fc->SetType("fc");
+  fc->SetInput("Input", {"x"});
+  fc->SetInput("W", {"w"});
+  fc->SetOutput("Out", {"out"});
+  fc->SetAttr<int>("in_num_col_dims", 1);
+  fc->SetAttr<std::string>("activation_type", act_type);
+
+  Program program(program_desc, scope, valid_places);
+  std::unique_ptr<SSAGraph> graph(new SSAGraph());
+  graph->Build(program, valid_places);
+  graph->SetValidPlaces(valid_places);
+  auto* pass = PassManager::Global().LookUp("sparse_conv_detect_pass");
+  CHECK(pass);
+  pass->Apply(graph);
+
+  auto stmts = graph->StmtTopologicalOrder();
+  CHECK_EQ(stmts.size(), 1u);
+  return std::unique_ptr<cpp::OpDesc>(
+      new cpp::OpDesc(*stmts.front()->AsStmt().op_info()));
+}
+
+TEST(SparseConvDetectPass, x86_sparse_fc) {
+  for (auto act_type : {"", "relu", "relu6"}) {
+    auto op = DetectSparseFc(4, act_type);
+    EXPECT_EQ(op->Type(), "sparse_fc");
+    EXPECT_EQ(op->GetAttr<std::string>("activation_type"), act_type);
+    EXPECT_EQ(op->Input("Input").front(), "x");
+    EXPECT_EQ(op->Output("Out").front(), "out");
+    EXPECT_FALSE(op->Input("NonZeroWeights").empty());
+  }
+}
+
+TEST(SparseConvDetectPass, x86_keep_fc) {
+  // Too dense.
+  EXPECT_EQ(DetectSparseFc(12, "relu")->Type(), "fc");
+  // Activations other than relu and relu6 are not fused by sparse_fc.
+  EXPECT_EQ(DetectSparseFc(4, "sigmoid")->Type(), "fc");
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(fc);
+USE_LITE_OP(sparse_fc);
+USE_MIR_PASS(sparse_conv_detect_pass);
@@ -154,6 +154,7 @@ std::unique_ptr<RuntimeProgram> RunDefaultOptimizer(
        // TODO(Superjomn) Refine the fusion related design to select fusion
        // kernels for devices automatically.
        "lite_conv_activation_fuse_pass",              //
+       "lite_conv_block_fuse_pass",                   //
        "lite_var_conv_2d_activation_fuse_pass",       //
        "lite_match_matrix_activation_fuse_pass",      //
        "lite_squeeze2_matmul_fuse_pass",              //
@@ -167,6 +168,7 @@ std::unique_ptr<RuntimeProgram> RunDefaultOptimizer(
        "identity_scale_eliminate_pass",               //
        "lite_scales_fuse_pass",                       //
        "lite_sequence_reverse_embedding_fuse_pass",   //
+       "lite_embedding_bag_fuse_pass",                //
        "elementwise_mul_constant_eliminate_pass",     //
        "lite_sequence_pool_concat_fuse_pass",         //
        "lite_scale_activation_fuse_pass",             //
@@ -179,6 +181,9 @@ std::unique_ptr<RuntimeProgram> RunDefaultOptimizer(
        "lite_conv_scale_fuse_pass",
        "lite_conv_elementwise_tree_fuse_pass",
        "lite_greater_than_cast_fuse_pass",
+       // After the fusions above so that they keep their elementwise, scale
+       // and activation patterns.
+       "lite_fused_elementwise_fuse_pass",
        "fill_range_fuse_pass",
        "identity_dropout_eliminate_pass",
        "sparse_conv_detect_pass",
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "lite/core/profile/profiler.h"
+#include <algorithm>
 #include <iomanip>
 #include <map>
 #include <string>
@@ -117,6 +118,29 @@ float Profiler::GetKernelFuncSummaryGOPs(const std::string& op_type,
   return GOPs * 1e-9f;
 }
 
+float Profiler::GetKernelFuncSummaryMBytes(
+    const std::string& op_type,
+    const std::string& kernel_attr,
+    const std::string& kernel_func_name) {
+  float bytes = 0;
+  for (size_t i = 0; i < units_.size(); ++i) {
+    if ((units_[i].character.kernel_func_name == kernel_func_name) &&
+        (units_[i].character.kernel_attr == kernel_attr) &&
+        (units_[i].character.op_type == op_type)) {
+      bytes += units_[i].character.bytes();
+    }
+  }
+  return bytes * 1e-6f;
+}
+
+// GB/s of `bytes` moved in `ms`, and operations per byte.
+static float GBps(float bytes, float ms) {
+  return ms > 0 ? 1e-6f * bytes / ms : 0.f;
+}
+static float OpsPerByte(float ops, float bytes) {
+  return bytes > 0 ? ops / bytes : 0.f;
+}
+
 std::string Profiler::Summary(Type type, bool concise, size_t w) {
   using std::setw;
   using std::left;
@@ -159,6 +183,16 @@ std::string Profiler::Summary(Type type, bool concise, size_t w) {
   if (concise) {
     ss << " " << setw(11) << left << "CalledTimes";
   }
+  ss << " " << setw(9) << left << "MB"
+     << " " << setw(7) << left << "GB/s"
+     << " " << setw(7) << left << "Ops/B";
+  if (!concise) {
+    ss << " " << setw(7) << left << "Allocs"
+       << " " << setw(8) << left << "Reallocs"
+       << " " << setw(9) << left << "TempMB"
+       << " " << setw(9) << left << "PeakMB"
+       << " " << setw(9) << left << "RunPeakMB";
+  }
 #ifdef LITE_WITH_OPENCL
   ss << " " << setw(9) << left << "clAvg(ms)"
      << " " << setw(9) << left << "clMin(ms)"
@@ -235,6 +269,17 @@ std::string Profiler::Summary(Type type, bool concise, size_t w) {
          << GetKernelFuncCalledTimes(item.first.op_type,
                                      item.first.kernel_attr,
                                      item.first.kernel_func_name);
+      float mbytes = GetKernelFuncSummaryMBytes(item.first.op_type,
+                                                item.first.kernel_attr,
+                                                item.first.kernel_func_name);
+      float gops = GetKernelFuncSummaryGOPs(item.first.op_type,
+                                            item.first.kernel_attr,
+                                            item.first.kernel_func_name);
+      ss << " " << setw(9) << left << fixed << setprecision(3) << mbytes
+         << " " << setw(7) << left << fixed << setprecision(2)
+         << GBps(1e6f * mbytes, item.second.avg)
+         << " " << setw(7) << left << fixed << setprecision(2)
+         << OpsPerByte(1e9f * gops, 1e6f * mbytes);
 #ifdef LITE_WITH_OPENCL
       float cl_percent = 0;
       if (cl_total > 0) {
@@ -264,9 +309,12 @@ std::string Profiler::Summary(Type type, bool concise, size_t w) {
       cl_total += cl_times.Avg(w);
     }
 #endif
+    // The high-water mark of the ops run so far.
+    float running_peak = 0;
     for (auto& unit : units_) {
       const auto& times = unit.Timer(type)->LapTimes();
       float run = times.Avg(w);
+      running_peak = std::max(running_peak, unit.Character().peak_bytes);
       float percent = 0;
       if (total > 0) {
         percent = 100 * (run / total);
@@ -298,7 +346,21 @@ std::string Profiler::Summary(Type type, bool concise, size_t w) {
          << " " << setw(7) << left << fixed << setprecision(3)
                 << 1e-9f * unit.Character().macs
          << " " << setw(7) << left << fixed << setprecision(2)
-                << 1e-6f * unit.Character().macs / times.Avg(w);
+                << 1e-6f * unit.Character().macs / times.Avg(w)
+         << " " << setw(9) << left << fixed << setprecision(3)
+                << 1e-6f * unit.Character().bytes()
+         << " " << setw(7) << left << fixed << setprecision(2)
+                << GBps(unit.Character().bytes(), times.Avg(w))
+         << " " << setw(7) << left << fixed << setprecision(2)
+                << OpsPerByte(unit.Character().macs, unit.Character().bytes())
+         << " " << setw(7) << left << unit.Character().allocs
+         << " " << setw(8) << left << unit.Character().reallocs
+         << " " << setw(9) << left << fixed << setprecision(3)
+                << 1e-6f * unit.Character().temp_bytes
+         << " " << setw(9) << left << fixed << setprecision(3)
+                << 1e-6f * unit.Character().peak_bytes
+         << " " << setw(9) << left << fixed << setprecision(3)
+                << 1e-6f * running_peak;
 // clang-format on
 #ifdef LITE_WITH_OPENCL
       ss << " " << setw(9) << left << fixed << setprecision(3)
@@ -313,6 +375,23 @@ std::string Profiler::Summary(Type type, bool concise, size_t w) {
       ss << std::endl;
     }
   }
+
+  // The roofline view of the whole model.
+  float total_ms = 0;
+  float total_ops = 0;
+  float total_bytes = 0;
+  float peak_bytes = 0;
+  for (auto& unit : units_) {
+    total_ms += unit.Timer(type)->LapTimes().Avg(w);
+    total_ops += unit.Character().macs;
+    total_bytes += unit.Character().bytes();
+    peak_bytes = std::max(peak_bytes, unit.Character().peak_bytes);
+  }
+  ss << "Total: " << fixed << setprecision(3) << total_ms << " ms, "
+     << 1e-9f * total_ops << " GOPs, " << 1e-6f * total_bytes << " MB, "
+     << setprecision(2) << GBps(total_bytes, total_ms) << " GB/s, "
+     << OpsPerByte(total_ops, total_bytes) << " Ops/B, host activation peak "
+     << setprecision(3) << 1e-6f * peak_bytes << " MB" << std::endl;
   return ss.str();
 }
 
@@ -64,6 +64,20 @@ struct OpCharacter {
   float macs{0};
   float macs_ps{0};
 
+  // Bytes of the inputs and outputs of the last run, and of the host memory
+  // the kernel allocated and freed again while it ran. The host memory is
+  // what the host allocator handed out, see host::TotalStats, the memory
+  // of devices and of third-party libraries is not counted.
+  float input_bytes{0};
+  float output_bytes{0};
+  float temp_bytes{0};
+  // Tensor buffers allocated for the first time and grown, over all runs.
+  int64_t allocs{0};
+  int64_t reallocs{0};
+  // High-water mark of the host memory while the op ran, less the
+  // persistable tensors such as the weights, that is the activations.
+  float peak_bytes{0};
+
   float io_duration{0};
 
 #ifdef LITE_WITH_OPENCL
@@ -99,6 +113,9 @@ struct OpCharacter {
     return dim_str;
   }
 
+  // The bytes the op touches at least once.
+  float bytes() const { return input_bytes + output_bytes + temp_bytes; }
+
   std::string str() {
     std::string str{""};
     str += kernel_name + "/" + kernel_func_name + "/" + remark + "/" +
@@ -134,6 +151,9 @@ class Profiler final {
   float GetKernelFuncSummaryGOPs(const std::string& op_type,
                                  const std::string& kernel_attr,
                                  const std::string& kernel_func_name);
+  float GetKernelFuncSummaryMBytes(const std::string& op_type,
+                                   const std::string& kernel_attr,
+                                   const std::string& kernel_func_name);
   OpCharacter* GetOpCharacter(const size_t index);
 
  private:
@@ -38,6 +38,38 @@ TEST(timer, real_latency) {
   LOG(INFO) << "LapTimes().Avg() = " << timer.LapTimes().Avg();
 }
 
+TEST(profiler, memory_accounting) {
+  int64_t allocs = BufferCounter::allocs;
+  int64_t reallocs = BufferCounter::reallocs;
+  Tensor tensor;
+  tensor.Resize({16});
+  tensor.mutable_data<float>();
+  tensor.Resize({1024});
+  tensor.mutable_data<float>();
+  tensor.Resize({8});
+  tensor.mutable_data<float>();
+  EXPECT_EQ(BufferCounter::allocs, allocs + 1);
+  EXPECT_EQ(BufferCounter::reallocs, reallocs + 1);
+
+  Profiler profiler("name");
+  OpCharacter ch;
+  ch.target = TargetType::kHost;
+  ch.op_type = "operator/1";
+  ch.kernel_name = "kernel/1";
+  ch.macs = 4e6f;
+  ch.input_bytes = 1e6f;
+  ch.output_bytes = 1e6f;
+  int idx = profiler.NewTimer(ch);
+  KernelContext ctx;
+  profiler.StartTiming(Type::kDispatch, idx, &ctx);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  profiler.StopTiming(Type::kDispatch, idx, &ctx);
+  auto summary = profiler.Summary(Type::kDispatch, false, 0);
+  EXPECT_NE(summary.find("GB/s"), std::string::npos);
+  EXPECT_NE(summary.find("2.00 Ops/B"), std::string::npos);
+  LOG(INFO) << summary;
+}
+
 #ifdef LITE_WITH_CUDA
 TEST(gpu_timer, real_latency) {
   DeviceTimer<TargetType::kCUDA> timer;
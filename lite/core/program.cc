@@ -28,6 +28,9 @@
 #ifdef LITE_WITH_FPGA
 #include "lite/backends/fpga/monitor.hpp"
 #endif
+#ifdef LITE_WITH_PROFILE
+#include "lite/backends/host/allocator.h"
+#endif
 
 namespace paddle {
 namespace lite {
@@ -258,7 +261,9 @@ void RuntimeProgram::SaveRuntimProgramIntoProgramDesc(
 RuntimeProgram::RuntimeProgram(
     const std::shared_ptr<const cpp::ProgramDesc>& program_desc,
     Scope* exec_scope,
-    int block_idx)
+    int block_idx,
+    const std::shared_ptr<WeightStream>& weight_stream,
+    const std::function<void(int, size_t)>& prepare_weights)
     : exec_scope_(exec_scope) {
   CHECK(program_desc);
   auto block_size = program_desc->BlocksSize();
@@ -305,7 +310,43 @@ RuntimeProgram::RuntimeProgram(
       static_cast<operators::SubgraphOp*>(op.get())->SetProgramDesc(
           program_desc);
     }
-    op->Attach(*op_desc, exec_scope_);
+    // Attach and InferShape read the shapes and the values of the weights,
+    // an op whose weights are still being loaded is attached by its first
+    // run. The ops with sub blocks run programs of their own, which read
+    // weights that are not inputs of this op.
+    std::function<void()> prepare;
+    bool pending = false;
+    if (weight_stream) {
+      if (op_type == "while" || op_type == "conditional_block" ||
+          op_type == "subgraph") {
+        pending = !weight_stream->IsDone();
+        prepare = [=]() {
+          weight_stream->WaitAll();
+          if (!prepare_weights) return;
+          for (int i = 0; i < static_cast<int>(block_size); i++) {
+            if (i == block_idx) continue;
+            auto* block = program_desc->GetBlock<cpp::BlockDesc>(i);
+            for (size_t k = 0; k < block->OpsSize(); k++) {
+              prepare_weights(i, k);
+            }
+          }
+        };
+      } else {
+        for (auto& name : op_desc->input_vars()) {
+          pending = pending || weight_stream->IsPending(name);
+        }
+        prepare = [=]() {
+          for (auto& name : op_desc->input_vars()) weight_stream->Wait(name);
+          if (prepare_weights) prepare_weights(block_idx, op_idx);
+        };
+      }
+    }
+    if (pending) {
+      op->AttachDesc(*op_desc, exec_scope_);
+    } else {
+      if (prepare) prepare();
+      op->Attach(*op_desc, exec_scope_);
+    }
     std::unique_ptr<KernelBase> kernel;
     if (op_desc->HasAttr(kKernelTypeAttr)) {
       // Create op and pick up the best kernel according to the
@@ -367,7 +408,17 @@ RuntimeProgram::RuntimeProgram(
         LOG(WARNING) << "No kernels found for " << op_type;
       }
     }
-    instructions_[kRootBlockIdx].emplace_back(std::move(op), std::move(kernel));
+    KernelBase* kernel_ptr = kernel.get();
+    instructions_[kRootBlockIdx].emplace_back(op, std::move(kernel));
+    if (pending) {
+      // The kernels were given the param of the op before it was attached.
+      auto* scope = exec_scope_;
+      instructions_[kRootBlockIdx].back().DeferAttach([=]() {
+        prepare();
+        op->Attach(*op_desc, scope);
+        if (kernel_ptr) op->AttachKernel(kernel_ptr);
+      });
+    }
   }
   Init();
 }
@@ -395,7 +446,52 @@ void RuntimeProgram::SaveOutput() {
 }
 #endif
 
+void RuntimeProgram::StartWarmUp(const std::function<void()>& thread_init) {
+  StopWarmUp();
+  warmup_stop_ = false;
+  warmup_thread_ = std::thread([this, thread_init]() {
+    if (thread_init) thread_init();
+    for (auto& inst : instructions_[kRootBlockIdx]) {
+      if (warmup_stop_) return;
+#if !defined(LITE_WITH_FPGA) && !defined(LITE_WITH_METAL)
+      if (inst.is_feed_fetch_op()) continue;
+#endif
+      inst.Run();
+    }
+    VLOG(4) << "Warm-up of " << instructions_[kRootBlockIdx].size()
+            << " instructions done";
+  });
+}
+
+void RuntimeProgram::StopWarmUp() {
+  if (!warmup_thread_.joinable()) return;
+  warmup_stop_ = true;
+  warmup_thread_.join();
+}
+
+#ifdef LITE_WITH_PROFILE
+// The host bytes of the persistable tensors of `scope` and its parents.
+static int64_t PersistableHostBytes(const Scope* scope) {
+  int64_t bytes = 0;
+  for (; scope != nullptr; scope = scope->parent()) {
+    for (auto& name : scope->LocalVarNames()) {
+      auto* var = scope->FindLocalVar(name);
+      if (var == nullptr || !var->IsType<Tensor>()) continue;
+      const auto& tensor = var->Get<Tensor>();
+      if (!tensor.persistable() || !tensor.IsInitialized()) continue;
+      if (tensor.target() == TARGET(kHost) ||
+          tensor.target() == TARGET(kX86) || tensor.target() == TARGET(kARM)) {
+        bytes += static_cast<int64_t>(tensor.memory_size());
+      }
+    }
+  }
+  return bytes;
+}
+#endif
+
 void RuntimeProgram::Run() {
+  StopWarmUp();
+  AttachExternalOutputs();
 #ifdef LITE_WITH_PRECISION_PROFILE
   auto inst_precision_profiler = paddle::lite::profile::PrecisionProfiler();
   std::string precision_profiler_summary =
@@ -416,11 +512,34 @@ void RuntimeProgram::Run() {
   monitor.inferStart();
 #endif
 
+  // The chains are looked for once every op is attached, as the streamed
+  // weights decide which convs can be chained.
+  if (depth_first_tiling_ && !depth_first_chains_found_ &&
+      std::all_of(instructions_[kRootBlockIdx].begin(),
+                  instructions_[kRootBlockIdx].end(),
+                  [](const Instruction& inst) { return inst.attached(); })) {
+    // The bound outputs have to be written as a whole.
+    std::set<std::string> pinned;
+    for (auto& item : external_outputs_) pinned.insert(item.first);
+    depth_first_chains_ = FindDepthFirstChains(
+        &instructions_[kRootBlockIdx], pinned, depth_first_band_bytes_);
+    depth_first_chains_found_ = true;
+  }
+
   int idx = -1;
 
+#ifdef LITE_WITH_PROFILE
+  // Counted once per run, the weights only change while ops are attached.
+  const int64_t persistable_bytes = PersistableHostBytes(exec_scope_);
+#endif
+
   auto& insts = instructions_[kRootBlockIdx];
-  for (auto& inst : insts) {
+  for (size_t i = 0; i < insts.size(); i++) {
+    auto& inst = insts[i];
     ++idx;
+#ifdef LITE_WITH_PROFILE
+    inst.set_persistable_bytes(persistable_bytes);
+#endif
 #if !defined(LITE_WITH_FPGA) && !defined(LITE_WITH_METAL)
     if (inst.is_feed_fetch_op()) continue;
 #endif
@@ -446,6 +565,16 @@ void RuntimeProgram::Run() {
     inst.Flush(idx);
 #endif
 
+    auto chain = depth_first_chains_.find(i);
+    if (chain != depth_first_chains_.end()) {
+      // The precision profiler only sees the bands of the chain, it is
+      // skipped.
+      chain->second->Run();
+      i += chain->second->size() - 1;
+      idx += static_cast<int>(chain->second->size()) - 1;
+      continue;
+    }
+
     inst.Run();
 
 #ifdef LITE_WITH_FPGA
@@ -469,6 +598,8 @@ void RuntimeProgram::Run() {
   }
 #endif
 
+  CopyExternalOutputs();
+
 #ifdef LITE_WITH_PROFILE
   LOG(INFO) << "\n" << profiler_.Summary(profile::Type::kDispatch, false, 1);
 #endif
@@ -479,6 +610,93 @@ void RuntimeProgram::Run() {
 #endif
 }
 
+void RuntimeProgram::BindExternalOutput(const std::string& name,
+                                        void* data,
+                                        size_t memory_size,
+                                        TargetType target) {
+  StopWarmUp();
+  CHECK(data) << "The memory bound to " << name << " is null.";
+  CHECK(IsHostMemoryTarget(target))
+      << "Only host memory can be bound to an output, but got "
+      << TargetToStr(target);
+  CHECK(exec_scope_->FindVar(name)) << "No variable named " << name;
+  UnbindExternalOutput(name);
+  depth_first_chains_found_ = false;
+  ExternalOutput output;
+  output.data = data;
+  output.memory_size = memory_size;
+  output.buffer = std::make_shared<ExternalBuffer>(data, target, memory_size);
+  // The last instruction writing the variable produces it.
+  const Instruction* producer = nullptr;
+  for (auto& inst : instructions_[kRootBlockIdx]) {
+    if (inst.is_feed_fetch_op()) continue;
+    const auto& out_names = inst.op()->op_info()->output_names();
+    if (std::find(out_names.begin(), out_names.end(), name) !=
+        out_names.end()) {
+      producer = &inst;
+    }
+  }
+  output.in_place =
+      producer && IsHostMemoryTarget(producer->kernel()->target());
+  VLOG(4) << "Bind " << name << " to external memory, "
+          << (output.in_place ? "written in place" : "copied after run");
+  external_outputs_[name] = output;
+}
+
+void RuntimeProgram::UnbindExternalOutput(const std::string& name) {
+  auto it = external_outputs_.find(name);
+  if (it == external_outputs_.end()) return;
+  StopWarmUp();
+  depth_first_chains_found_ = false;
+  // The variable may still hold the buffer, it gets memory of its own.
+  it->second.buffer->Detach();
+  external_outputs_.erase(it);
+}
+
+void RuntimeProgram::EnableDepthFirstTiling(size_t band_bytes) {
+  StopWarmUp();
+  depth_first_tiling_ = true;
+  depth_first_band_bytes_ = band_bytes;
+  depth_first_chains_found_ = false;
+}
+
+void RuntimeProgram::AttachExternalOutputs() {
+  for (auto& item : external_outputs_) {
+    auto& output = item.second;
+    if (!output.in_place) continue;
+    auto* tensor = exec_scope_->FindVar(item.first)->GetMutable<Tensor>();
+    output.buffer->Attach();
+    if (tensor->raw_data() == output.data) continue;
+    // The tensor left from the last run must fit, otherwise the output is
+    // copied after the run.
+    if (tensor->offset() != 0 || tensor->memory_size() > output.memory_size) {
+      continue;
+    }
+    tensor->ResetBuffer(output.buffer, tensor->memory_size());
+  }
+}
+
+void RuntimeProgram::CopyExternalOutputs() {
+  for (auto& item : external_outputs_) {
+    auto& output = item.second;
+    const auto* tensor = exec_scope_->FindVar(item.first)->GetMutable<Tensor>();
+    if (!tensor->IsInitialized() || tensor->raw_data() == output.data) {
+      continue;
+    }
+    CHECK(IsHostMemoryTarget(tensor->target()))
+        << "The output " << item.first << " is on "
+        << TargetToStr(tensor->target()) << ", it can not be copied into "
+        << "the bound host memory.";
+    CHECK_LE(tensor->memory_size(), output.memory_size)
+        << "The output " << item.first << " needs " << tensor->memory_size()
+        << " bytes, but only " << output.memory_size << " bytes are bound.";
+    TargetCopy(TARGET(kHost),
+               output.data,
+               tensor->raw_data(),
+               tensor->memory_size());
+  }
+}
+
 void Program::Build(const std::shared_ptr<cpp::ProgramDesc>& program_desc) {
   CHECK(ops_.empty()) << "Executor duplicate Build found";
 
@@ -642,6 +860,11 @@ void Instruction::Run() {
   CHECK(op_) << "op null";
   CHECK(kernel_) << "kernel null";
 
+  if (attach_) {
+    attach_();
+    attach_ = nullptr;
+  }
+
   if (first_epoch_) {
     first_epoch_ = false;
     CHECK(op_->CheckShape());
@@ -651,6 +874,13 @@ void Instruction::Run() {
     return;
   }
 
+#ifdef LITE_WITH_PROFILE
+  host::ResetTotalPeak();
+  const int64_t live_bytes = host::TotalStats().live_bytes;
+  const int64_t allocs = profile::BufferCounter::allocs;
+  const int64_t reallocs = profile::BufferCounter::reallocs;
+#endif
+
   op_->InferShape();
   kernel_->Launch();
   has_run_ = true;
@@ -662,9 +892,43 @@ void Instruction::Run() {
     SetProfileRuntimeOpInfo(op_ch);
     first_epoch_for_profiler_ = false;
   }
+  SetProfileRuntimeMemoryInfo(
+      profiler_->GetOpCharacter(profile_id_), live_bytes, allocs, reallocs);
 #endif
 }
 
+#ifdef LITE_WITH_PROFILE
+static float TensorBytes(Scope* scope, const std::vector<std::string>& names) {
+  float bytes = 0;
+  for (auto& name : names) {
+    auto* var = scope->FindVar(name);
+    if (var == nullptr || !var->IsType<Tensor>()) continue;
+    const auto& tensor = var->Get<Tensor>();
+    bytes += tensor.numel() * lite_api::PrecisionTypeLength(tensor.precision());
+  }
+  return bytes;
+}
+
+void Instruction::SetProfileRuntimeMemoryInfo(profile::OpCharacter* ch,
+                                              int64_t live_bytes_before,
+                                              int64_t allocs_before,
+                                              int64_t reallocs_before) {
+  auto* scope = op_->scope();
+  ch->input_bytes = TensorBytes(scope, op_->op_info()->input_names());
+  ch->output_bytes = TensorBytes(scope, op_->op_info()->output_names());
+  auto memory = host::TotalStats();
+  // What was allocated beyond the memory held before and after the run was
+  // freed again within it.
+  ch->temp_bytes = static_cast<float>(
+      memory.peak_bytes - std::max(live_bytes_before, memory.live_bytes));
+  ch->peak_bytes = std::max(
+      ch->peak_bytes,
+      static_cast<float>(memory.peak_bytes - persistable_bytes_));
+  ch->allocs += profile::BufferCounter::allocs - allocs_before;
+  ch->reallocs += profile::BufferCounter::reallocs - reallocs_before;
+}
+#endif
+
 STL::ostream& operator<<(STL::ostream& os, const Instruction& other) {
   os << other.kernel_->summary() << "\t(" << other.kernel_->doc() << ")";
   return os;
@@ -13,15 +13,20 @@
 // limitations under the License.
 
 #pragma once
+#include <atomic>
+#include <functional>
 #include <list>
 #include <map>
 #include <memory>
 #include <string>
+#include <thread>  //NOLINT
 #include <utility>
 #include <vector>
+#include "lite/core/depth_first_tiling.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_lite.h"
 #include "lite/core/op_registry.h"
+#include "lite/core/weight_stream.h"
 #include "lite/model_parser/cpp_desc.h"
 #ifdef LITE_WITH_PROFILE
 #include "lite/core/profile/profiler.h"
@@ -130,6 +135,13 @@ struct Instruction {
 
   bool is_feed_fetch_op() const { return is_feed_fetch_op_; }
 
+  // Attach the op on the first Run instead, by calling `attach`, as the
+  // weights it reads are still being loaded, see RuntimeProgram.
+  void DeferAttach(std::function<void()> attach) {
+    attach_ = std::move(attach);
+  }
+  bool attached() const { return !attach_; }
+
 #ifdef LITE_WITH_CUDA
   bool need_sync() const {
     if (kernel_->target() == TargetType::kCUDA) {
@@ -177,6 +189,17 @@ struct Instruction {
     CHECK(op_lite != nullptr) << "op_lite should not be nullptr.";
     op_lite->GetOpRuntimeInfo(ch);
   }
+
+  // The bytes the last run touched and the memory it allocated, given the
+  // host memory and buffer counts from before the run.
+  void SetProfileRuntimeMemoryInfo(paddle::lite::profile::OpCharacter* ch,
+                                   int64_t live_bytes_before,
+                                   int64_t allocs_before,
+                                   int64_t reallocs_before);
+
+  // The host bytes held by the persistable tensors, which are left out of
+  // the peak of the activations, see RuntimeProgram::Run.
+  void set_persistable_bytes(int64_t bytes) { persistable_bytes_ = bytes; }
 #endif
 
  private:
@@ -185,11 +208,13 @@ struct Instruction {
   bool is_feed_fetch_op_{false};
   bool first_epoch_{true};
   bool has_run_{false};
+  std::function<void()> attach_;
 
 #ifdef LITE_WITH_PROFILE
   profile::Profiler* profiler_;
   int profile_id_{-1};
   bool first_epoch_for_profiler_{true};
+  int64_t persistable_bytes_{0};
 #endif  // LITE_WITH_PROFILE
 };
 
@@ -202,11 +227,21 @@ class LITE_API RuntimeProgram {
       : instructions_(std::move(insts)) {
     Init();
   }
+  // With `weight_stream`, the ops which read weights that are still being
+  // loaded are attached by the first run of their instruction, which waits
+  // for the weights and lets `prepare_weights` convert them first. The
+  // other ops have their weights prepared and are attached right away.
+  // `prepare_weights` is called with the block and op index of every op
+  // whose weights are ready, the ops with sub blocks wait for the whole
+  // model and prepare the ops of the other blocks.
   explicit RuntimeProgram(
       const std::shared_ptr<const cpp::ProgramDesc>& program_desc,
       Scope* exec_scope,
-      int block_idx = kRootBlockIdx);
+      int block_idx = kRootBlockIdx,
+      const std::shared_ptr<WeightStream>& weight_stream = nullptr,
+      const std::function<void(int, size_t)>& prepare_weights = nullptr);
   ~RuntimeProgram() {
+    StopWarmUp();
 #ifdef LITE_WITH_OPENCL
     // save program kernel cache & tuned params
     CLRuntime::Global()->SaveProgram();
@@ -285,6 +320,31 @@ class LITE_API RuntimeProgram {
   void SaveOutput();
 #endif
 
+  // The kernels are prepared by the first run of their instruction, as the
+  // preparation needs the shapes of the inputs. StartWarmUp runs the
+  // instructions in order on a background thread with the inputs which are
+  // set, `thread_init` sets up the per-thread runtime state. StopWarmUp, as
+  // well as Run, stops it after the current instruction and waits for it,
+  // the next Run prepares the instructions it did not reach.
+  void StartWarmUp(const std::function<void()>& thread_init = nullptr);
+  void StopWarmUp();
+
+  // Let the instruction producing the variable `name` write it directly into
+  // caller memory, which is attached to the variable before every Run. When
+  // the producer can not use it, because the output does not fit, is made by
+  // a device kernel or shares the buffer of another tensor, the output is
+  // copied into the caller memory after the run instead.
+  void BindExternalOutput(const std::string& name,
+                          void* data,
+                          size_t memory_size,
+                          TargetType target = TARGET(kHost));
+  void UnbindExternalOutput(const std::string& name);
+
+  // Run the chains of convs of the root block band by band of output rows,
+  // see DepthFirstChain. The chains are found by the next Run, `band_bytes`
+  // of 0 picks a size from the cache of the CPU.
+  void EnableDepthFirstTiling(size_t band_bytes = 0);
+
   void set_exec_scope(Scope* x) { exec_scope_ = x; }
   Scope* exec_scope() { return exec_scope_; }
 
@@ -324,6 +384,24 @@ class LITE_API RuntimeProgram {
   std::vector<std::vector<Instruction>> instructions_;
   Scope* exec_scope_{};
   int64_t version_{0};
+  std::thread warmup_thread_;
+  std::atomic<bool> warmup_stop_{false};
+
+  struct ExternalOutput {
+    void* data{nullptr};
+    size_t memory_size{0};
+    std::shared_ptr<ExternalBuffer> buffer;
+    // Whether the producer works on host memory and may write in place.
+    bool in_place{false};
+  };
+  void AttachExternalOutputs();
+  void CopyExternalOutputs();
+  std::map<std::string, ExternalOutput> external_outputs_;
+
+  bool depth_first_tiling_{false};
+  size_t depth_first_band_bytes_{0};
+  bool depth_first_chains_found_{false};
+  std::map<size_t, std::unique_ptr<DepthFirstChain>> depth_first_chains_;
 
 #ifdef LITE_WITH_METAL
   std::unique_ptr<KernelContext> metal_ctx_{nullptr};
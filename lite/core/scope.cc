@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "lite/core/scope.h"
+#include <algorithm>
 #define SCOPE_KIDS_READER_LOCK \
   lite::fluid::AutoRDLock auto_lock(kids_lock_.get());
 #define SCOPE_KIDS_WRITER_LOCK \
@@ -46,8 +47,7 @@ Variable *Scope::Var(const std::string &name) {
   auto *var = FindVar(name);
   if (var) return var;
   // create a new variable.
-  vars_.emplace(name, std::unique_ptr<Variable>(new Variable));
-  return vars_[name].get();
+  return NewLocalVar(name);
 }
 
 Variable *Scope::LocalVar(const std::string &name) {
@@ -55,8 +55,15 @@ Variable *Scope::LocalVar(const std::string &name) {
   auto *var = FindLocalVar(name);
   if (var) return var;
   // create a new variable.
-  vars_.emplace(name, std::unique_ptr<Variable>(new Variable));
-  return vars_[name].get();
+  return NewLocalVar(name);
+}
+
+Variable *Scope::NewLocalVar(const std::string &name) {
+  rwlock_->WRLock();
+  auto *var = new Variable;
+  vars_[name].reset(var);
+  rwlock_->UNLock();
+  return var;
 }
 
 Variable *Scope::FindVar(const std::string &name) const {
@@ -76,8 +83,9 @@ Variable *Scope::FindLocalVar(const std::string &name) const {
   rwlock_->RDLock();
   auto it = vars_.find(name);
   if (it != vars_.end()) {
+    auto *var = it->second.get();
     rwlock_->UNLock();
-    return it->second.get();
+    return var;
   }
   rwlock_->UNLock();
   return nullptr;
@@ -94,7 +102,7 @@ std::vector<std::string> Scope::AttributeVarNames() const {
   }
   // remove feed and fetch
   std::vector<std::string> skiped_vars = {"feed", "fetch"};
-  for (int i = 0; i < skiped_vars.size(); i++) {
+  for (size_t i = 0; i < skiped_vars.size(); i++) {
     auto iter =
         std::find(resulted_keys.begin(), resulted_keys.end(), skiped_vars[i]);
     while (iter != resulted_keys.end()) {
@@ -108,13 +116,12 @@ std::vector<std::string> Scope::AttributeVarNames() const {
 
 std::vector<std::string> Scope::LocalVarNames() const {
   std::vector<std::string> keys;
-  {
-    rwlock_->RDLock();
-    for (const auto &item : vars_) {
-      keys.push_back(item.first);
-    }
-    rwlock_->UNLock();
-  }
+  rwlock_->RDLock();
+  keys.reserve(vars_.size());
+  for (const auto &item : vars_) keys.push_back(item.first);
+  rwlock_->UNLock();
+  // Sorted as callers such as model saving rely on a stable order.
+  std::sort(keys.begin(), keys.end());
   return keys;
 }
 
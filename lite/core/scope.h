@@ -14,9 +14,9 @@
 
 #pragma once
 #include <list>
-#include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include "lite/backends/x86/fluid/rw_lock.h"
@@ -95,10 +95,16 @@ class Scope final {
   }
 
  private:
+  // Insert a new variable, it takes the writer `rwlock_` itself. Callers
+  // hold the vars writer lock so that the lookup before it and the
+  // insertion are atomic.
+  Variable* NewLocalVar(const std::string& name);
+
   // Scope in `kids_` are owned by this class.
   mutable std::list<Scope*> kids_;
   const Scope* parent_{nullptr};
-  std::map<std::string, std::unique_ptr<Variable>> vars_;
+  // Hashed by name for the lookups, LocalVarNames sorts the names.
+  std::unordered_map<std::string, std::unique_ptr<Variable>> vars_;
   std::unique_ptr<lite::fluid::RWLock> kids_lock_{nullptr};
   std::unique_ptr<lite::fluid::RWLock> vars_lock_{nullptr};
   std::unique_ptr<lite::fluid::RWLock> rwlock_{nullptr};
@@ -14,6 +14,8 @@
 
 #include "lite/core/scope.h"
 #include <gtest/gtest.h>
+#include <string>
+#include <vector>
 
 namespace paddle {
 namespace lite {
@@ -33,5 +35,22 @@ TEST(Scope, FindVar) {
   ASSERT_TRUE(scope.FindVar("x"));
 }
 
+TEST(Scope, LocalVar) {
+  Scope scope;
+  auto* y = scope.Var("y");
+  auto* x = scope.Var("x");
+  ASSERT_EQ(scope.Var("y"), y);
+  ASSERT_EQ(scope.LocalVarNames(), std::vector<std::string>({"x", "y"}));
+
+  auto& kid = scope.NewScope();
+  ASSERT_FALSE(kid.FindLocalVar("x"));
+  ASSERT_EQ(kid.FindVar("x"), x);
+  ASSERT_EQ(kid.Var("x"), x);
+  auto* local_x = kid.LocalVar("x");
+  ASSERT_NE(local_x, x);
+  ASSERT_EQ(kid.FindVar("x"), local_x);
+  ASSERT_EQ(kid.LocalVarNames(), std::vector<std::string>({"x"}));
+}
+
 }  // namespace lite
 }  // namespace paddle
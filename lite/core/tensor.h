@@ -221,6 +221,9 @@ class TensorLite {
 
   bool IsInitialized() const { return buffer_->data(); }
 
+  // Whether other tensors hold the buffer of this one.
+  bool buffer_shared() const { return buffer_.use_count() > 1; }
+
   // Other share data to this.
   void ShareDataWith(const TensorLite &other);
 
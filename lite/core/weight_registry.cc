@@ -0,0 +1,98 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/weight_registry.h"
+#include <cstring>
+#include <string>
+#include <vector>
+#include "lite/utils/hash.h"
+
+namespace paddle {
+namespace lite {
+
+WeightRegistry& WeightRegistry::Global() {
+  static auto* x = new WeightRegistry;
+  return *x;
+}
+
+bool WeightRegistry::Share(Tensor* tensor) {
+  CHECK(tensor);
+  if (!IsHostMemoryTarget(tensor->target()) || !tensor->IsInitialized() ||
+      tensor->memory_size() == 0 || tensor->offset() != 0) {
+    return false;
+  }
+  const void* data = tensor->raw_data();
+  const size_t size = tensor->memory_size();
+  const uint64_t hash = HashBytes(data, size);
+  std::shared_ptr<void> blob;
+  bool reused = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto range = entries_.equal_range(hash);
+    for (auto it = range.first; it != range.second;) {
+      auto stored = it->second.blob.lock();
+      if (!stored) {
+        it = entries_.erase(it);
+        continue;
+      }
+      if (it->second.size == size && !std::memcmp(stored.get(), data, size)) {
+        blob = stored;
+        reused = true;
+        break;
+      }
+      ++it;
+    }
+    if (!blob) {
+      void* copy = TargetMalloc(TARGET(kHost), size);
+      TargetCopy(TARGET(kHost), copy, data, size);
+      blob.reset(copy, [](void* ptr) { TargetFree(TARGET(kHost), ptr); });
+      entries_.emplace(hash, Entry{size, blob});
+    }
+  }
+  if (reused) saved_bytes_ += size;
+  auto target = tensor->target();
+  tensor->ResetBuffer(std::make_shared<SharedBuffer>(blob, size), size);
+  tensor->set_target(target);
+  return reused;
+}
+
+void WeightRegistry::ShareScope(Scope* scope) {
+  CHECK(scope);
+  size_t reused = 0;
+  for (const auto& name : scope->LocalVarNames()) {
+    auto* var = scope->FindLocalVar(name);
+    if (!var || !var->IsType<Tensor>()) continue;
+    auto* tensor = var->GetMutable<Tensor>();
+    if (!tensor->persistable()) continue;
+    if (Share(tensor)) reused++;
+  }
+  VLOG(3) << reused << " weights of the scope were already stored.";
+}
+
+size_t WeightRegistry::stored_bytes() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t bytes = 0;
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->second.blob.expired()) {
+      it = entries_.erase(it);
+    } else {
+      bytes += it->second.size;
+      ++it;
+    }
+  }
+  return bytes;
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,74 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>  //NOLINT
+#include <unordered_map>
+#include "lite/core/scope.h"
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+
+/*
+ * Process-wide store of immutable weights keyed by their content, so that
+ * the models of one process which hold identical tensors, such as the
+ * fine-tuned variants of one backbone, keep a single copy of them.
+ *
+ * A shared tensor gets a SharedBuffer view of the stored bytes, writing it
+ * gives the tensor a private copy first. The bytes are released when the
+ * last tensor viewing them goes, the registry only keeps weak references.
+ * The kernels share their prepacked weights the same way once the registry
+ * is enabled by a predictor which asked for weight sharing.
+ */
+class WeightRegistry {
+ public:
+  static WeightRegistry& Global();
+
+  void Enable() { enabled_ = true; }
+  bool enabled() const { return enabled_; }
+
+  // Make `tensor` view the stored copy of its bytes, storing them if they
+  // are new. Only host tensors are shared. Returns whether a stored copy
+  // was reused.
+  bool Share(Tensor* tensor);
+
+  // Share the persistable tensors held by `scope` itself.
+  void ShareScope(Scope* scope);
+
+  // Bytes stored once for all the tensors viewing them.
+  size_t stored_bytes();
+  // Bytes the reused copies saved since the process started.
+  size_t saved_bytes() const { return saved_bytes_; }
+
+ private:
+  WeightRegistry() = default;
+  WeightRegistry(const WeightRegistry&) = delete;
+  WeightRegistry& operator=(const WeightRegistry&) = delete;
+
+  struct Entry {
+    size_t size;
+    std::weak_ptr<void> blob;
+  };
+
+  std::mutex mutex_;
+  std::unordered_multimap<uint64_t, Entry> entries_;
+  std::atomic<bool> enabled_{false};
+  std::atomic<size_t> saved_bytes_{0};
+};
+
+}  // namespace lite
+}  // namespace paddle
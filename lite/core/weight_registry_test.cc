@@ -0,0 +1,77 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/weight_registry.h"
+#include <gtest/gtest.h>
+#include <memory>
+
+namespace paddle {
+namespace lite {
+
+static void FillWeight(Tensor* tensor, float value) {
+  tensor->Resize({4, 8});
+  auto* data = tensor->mutable_data<float>();
+  for (int i = 0; i < tensor->numel(); i++) data[i] = value + i;
+  tensor->set_persistable(true);
+}
+
+TEST(WeightRegistry, ShareIdentical) {
+  auto& registry = WeightRegistry::Global();
+  size_t stored = registry.stored_bytes();
+  {
+    Tensor a, b, c;
+    FillWeight(&a, 1.f);
+    FillWeight(&b, 1.f);
+    FillWeight(&c, 2.f);
+    EXPECT_FALSE(registry.Share(&a));
+    EXPECT_TRUE(registry.Share(&b));
+    EXPECT_FALSE(registry.Share(&c));
+    EXPECT_EQ(a.data<float>(), b.data<float>());
+    EXPECT_NE(a.data<float>(), c.data<float>());
+    EXPECT_EQ(registry.stored_bytes(), stored + 2 * a.memory_size());
+  }
+  // The bytes go with the last tensor viewing them.
+  EXPECT_EQ(registry.stored_bytes(), stored);
+}
+
+TEST(WeightRegistry, CopyOnWrite) {
+  auto& registry = WeightRegistry::Global();
+  Tensor a, b;
+  FillWeight(&a, 3.f);
+  FillWeight(&b, 3.f);
+  registry.Share(&a);
+  registry.Share(&b);
+  auto* written = b.mutable_data<float>();
+  EXPECT_NE(written, a.data<float>());
+  EXPECT_EQ(written[5], 8.f);
+  written[5] = 0.f;
+  EXPECT_EQ(a.data<float>()[5], 8.f);
+}
+
+TEST(WeightRegistry, ShareScope) {
+  Scope scope;
+  FillWeight(scope.Var("w0")->GetMutable<Tensor>(), 5.f);
+  FillWeight(scope.Var("w1")->GetMutable<Tensor>(), 5.f);
+  auto* act = scope.Var("act")->GetMutable<Tensor>();
+  FillWeight(act, 5.f);
+  act->set_persistable(false);
+  WeightRegistry::Global().ShareScope(&scope);
+  EXPECT_EQ(scope.FindVar("w0")->Get<Tensor>().data<float>(),
+            scope.FindVar("w1")->Get<Tensor>().data<float>());
+  EXPECT_NE(act->data<float>(),
+            scope.FindVar("w0")->Get<Tensor>().data<float>());
+}
+
+}  // namespace lite
+}  // namespace paddle
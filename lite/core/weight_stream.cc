@@ -0,0 +1,61 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/weight_stream.h"
+#include <utility>
+
+namespace paddle {
+namespace lite {
+
+WeightStream::~WeightStream() {
+  if (thread_.joinable()) thread_.join();
+}
+
+void WeightStream::Start(std::function<void(WeightStream*)> load) {
+  thread_ = std::thread([this, load]() {
+    load(this);
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.clear();
+    done_ = true;
+    cond_.notify_all();
+  });
+}
+
+void WeightStream::Publish(const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (pending_.erase(name)) cond_.notify_all();
+}
+
+bool WeightStream::IsPending(const std::string& name) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pending_.count(name) > 0;
+}
+
+bool WeightStream::IsDone() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return done_;
+}
+
+void WeightStream::Wait(const std::string& name) const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cond_.wait(lock, [&]() { return done_ || !pending_.count(name); });
+}
+
+void WeightStream::WaitAll() const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cond_.wait(lock, [this]() { return done_; });
+}
+
+}  // namespace lite
+}  // namespace paddle
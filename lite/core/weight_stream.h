@@ -0,0 +1,70 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <condition_variable>  //NOLINT
+#include <functional>
+#include <mutex>  //NOLINT
+#include <string>
+#include <thread>  //NOLINT
+#include <unordered_set>
+
+namespace paddle {
+namespace lite {
+
+/*
+ * Persistable tensors which are filled by a loader thread while the program
+ * is built and run. The loader publishes every tensor once it is filled, the
+ * consumers only wait for the tensors they read. Names which were not
+ * announced as pending are ready from the start.
+ *
+ * The consumers must not touch a pending tensor before waiting for it, and
+ * the tensors must be created in the scope before the loader starts so that
+ * it never has to insert a variable a consumer could be reading.
+ */
+class WeightStream {
+ public:
+  explicit WeightStream(std::unordered_set<std::string> pending)
+      : pending_(std::move(pending)) {}
+  // Waits for the loader, the scope it fills must outlive the stream.
+  ~WeightStream();
+
+  // Run `load` on the loader thread. It calls Publish for the tensors it
+  // fills, all the names still pending are released when it returns.
+  void Start(std::function<void(WeightStream*)> load);
+
+  void Publish(const std::string& name);
+
+  bool IsPending(const std::string& name) const;
+
+  // Whether the loader has finished.
+  bool IsDone() const;
+
+  void Wait(const std::string& name) const;
+
+  void WaitAll() const;
+
+ private:
+  WeightStream(const WeightStream&) = delete;
+  WeightStream& operator=(const WeightStream&) = delete;
+
+  mutable std::mutex mutex_;
+  mutable std::condition_variable cond_;
+  std::unordered_set<std::string> pending_;
+  bool done_{false};
+  std::thread thread_;
+};
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,61 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "lite/core/weight_stream.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>  //NOLINT
+#include <string>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+TEST(WeightStream, WaitForOneTensor) {
+  std::vector<int> filled(3, 0);
+  std::atomic<bool> release{false};
+  WeightStream stream({"w0", "w1", "w2"});
+  stream.Start([&](WeightStream* loader) {
+    filled[0] = 1;
+    loader->Publish("w0");
+    while (!release) std::this_thread::yield();
+    filled[1] = 1;
+    loader->Publish("w1");
+    filled[2] = 1;
+    loader->Publish("w2");
+  });
+  stream.Wait("w0");
+  ASSERT_EQ(filled[0], 1);
+  ASSERT_FALSE(stream.IsPending("w0"));
+  ASSERT_TRUE(stream.IsPending("w2"));
+  // Not announced, ready from the start.
+  stream.Wait("x");
+  release = true;
+  stream.Wait("w2");
+  ASSERT_EQ(filled[2], 1);
+  stream.WaitAll();
+  ASSERT_EQ(filled[1], 1);
+}
+
+TEST(WeightStream, MissingTensorIsReleased) {
+  WeightStream stream({"w0", "missing"});
+  stream.Start([](WeightStream* loader) { loader->Publish("w0"); });
+  stream.Wait("missing");
+  stream.WaitAll();
+  ASSERT_FALSE(stream.IsPending("missing"));
+}
+
+}  // namespace lite
+}  // namespace paddle
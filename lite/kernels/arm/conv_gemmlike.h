@@ -22,6 +22,7 @@
 #include "lite/core/context.h"
 #include "lite/core/kernel.h"
 #include "lite/core/target_wrapper.h"
+#include "lite/core/weight_registry.h"
 #ifdef ENABLE_ARM_FP16
 #include "lite/backends/arm/math/fp16/funcs_fp16.h"
 #endif
@@ -96,6 +97,9 @@ class GemmLikeConv : public KernelLite<TARGET(kARM), Ptype> {
         lite::arm::math::trans_gemm_weights<Ptype>(
             *(param.filter), weights_, param.groups, &ctx);
       }
+      if (WeightRegistry::Global().enabled()) {
+        WeightRegistry::Global().Share(&weights_);
+      }
       flag_trans_weights_ = true;
     } else if (n == 1 || m == 1) {
       flag_trans_weights_ = false;
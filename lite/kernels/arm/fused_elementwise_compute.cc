@@ -0,0 +1,74 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/arm/fused_elementwise_compute.h"
+#include <algorithm>
+#include "lite/backends/arm/math/fused_elementwise.h"
+#include "lite/core/parallel_defines.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace arm {
+
+void FusedElementwiseCompute::PrepareForRun() {
+  auto& param = this->Param<param_t>();
+  program_ = host::math::FusedElementwiseProgram(
+      param.op_types, param.op_inputs, param.op_params);
+}
+
+void FusedElementwiseCompute::Run() {
+  auto& param = this->Param<param_t>();
+  std::vector<const float*> x;
+  for (auto* t : param.X) {
+    x.push_back(t->data<float>());
+  }
+  float* out = param.Out->mutable_data<float>();
+  const int64_t tasks = host::math::FusedElementwiseTasks(param.shape);
+  auto eval = [&](const float* const* xs,
+                  const bool* x_scalar,
+                  int len,
+                  float* acc) {
+    lite::arm::math::fused_elementwise_eval(program_, xs, x_scalar, len, acc);
+  };
+  // Several chunks per parallel task to amortize the task setup.
+  const int64_t step = 16;
+  const int blocks = static_cast<int>((tasks + step - 1) / step);
+  LITE_PARALLEL_BEGIN(i, tid, blocks) {
+    const int64_t begin = i * step;
+    host::math::FusedElementwiseRun(param.shape,
+                                    param.x_strides,
+                                    x,
+                                    out,
+                                    begin,
+                                    std::min(begin + step, tasks),
+                                    eval);
+  }
+  LITE_PARALLEL_END();
+}
+
+}  // namespace arm
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(fused_elementwise,
+                     kARM,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::arm::FusedElementwiseCompute,
+                     def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kARM))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kARM))})
+    .Finalize();
@@ -598,7 +598,7 @@ BatchElementWiseArg<T, int64_t> GenBatchElementWiseArg(const lite::Tensor *X,
   std::vector<int64_t> y_dims;
   fix_x_y_dims<int64_t>(X, Y, Out, axis, &x_dims, &y_dims);
 
-  auto &z_dims = Out->dims().data();
+  auto z_dims = Out->dims().data();
   // gen stride
   std::vector<int64_t> x_stride(out_dim_size, 1);
   std::vector<int64_t> y_stride(out_dim_size, 1);
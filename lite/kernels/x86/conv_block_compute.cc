@@ -0,0 +1,325 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "lite/kernels/x86/conv_block_compute.h"
+#include <algorithm>
+#include <limits>
+#include "lite/backends/x86/cpu_info.h"
+#include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/fill_bias_activate.h"
+#include "lite/backends/x86/math/pooling_fast.h"
+#include "lite/operators/fusion_conv2d_block_op.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// im2col restricted to the output rows [r0, r1), column (r - r0) * ow + x.
+static void im2col_rows(const float* din,
+                        int chin,
+                        int ih,
+                        int iw,
+                        int kh,
+                        int kw,
+                        int pad_top,
+                        int pad_left,
+                        int stride_h,
+                        int stride_w,
+                        int dila_h,
+                        int dila_w,
+                        int ow,
+                        int r0,
+                        int r1,
+                        float* col) {
+  const int n = (r1 - r0) * ow;
+#pragma omp parallel for
+  for (int c = 0; c < chin; c++) {
+    const float* plane = din + static_cast<int64_t>(c) * ih * iw;
+    for (int i = 0; i < kh; i++) {
+      for (int j = 0; j < kw; j++) {
+        float* dst = col + static_cast<int64_t>((c * kh + i) * kw + j) * n;
+        for (int r = r0; r < r1; r++, dst += ow) {
+          const int y = r * stride_h - pad_top + i * dila_h;
+          if (y < 0 || y >= ih) {
+            std::fill(dst, dst + ow, 0.f);
+            continue;
+          }
+          const float* row = plane + y * iw;
+          for (int x = 0; x < ow; x++) {
+            const int xx = x * stride_w - pad_left + j * dila_w;
+            dst[x] = (xx >= 0 && xx < iw) ? row[xx] : 0.f;
+          }
+        }
+      }
+    }
+  }
+}
+
+void Conv2dBlockCompute::ConvRows(const float* din,
+                                  const float* residual,
+                                  int r0,
+                                  int r1,
+                                  float* dst,
+                                  int ldc) {
+  auto& ctx = ctx_->As<X86Context>();
+  auto& param = this->Param<param_t>();
+  const auto in_dims = param.x->dims();
+  const auto w_dims = param.filter->dims();
+  const int ih = in_dims[2];
+  const int iw = in_dims[3];
+  const int m = w_dims[0];
+  const int n = (r1 - r0) * ow_;
+  const int k = in_dims[1] * w_dims[2] * w_dims[3];
+  auto& paddings = *param.paddings;
+  auto& dilations = *param.dilations;
+
+  // The 1x1 stride 1 conv reads the input rows in place.
+  const float* b = din + r0 * ow_;
+  int ldb = ih * iw;
+  if (!flag_1x1_) {
+    im2col_rows(din,
+                in_dims[1],
+                ih,
+                iw,
+                w_dims[2],
+                w_dims[3],
+                paddings[0],
+                paddings[2],
+                param.strides[0],
+                param.strides[1],
+                dilations[0],
+                dilations[1],
+                ow_,
+                r0,
+                r1,
+                col_.data());
+    b = col_.data();
+    ldb = n;
+  }
+  lite::x86::math::Blas<lite::TargetType::kX86> matmul(ctx);
+  matmul.GEMM<float>(false,
+                     false,
+                     m,
+                     n,
+                     k,
+                     1.f,
+                     param.filter->data<float>(),
+                     k,
+                     b,
+                     ldb,
+                     0.f,
+                     dst,
+                     ldc);
+
+  const float* bias = param.bias ? param.bias->data<float>() : nullptr;
+  const bool residual_relu = param.residual_relu;
+  auto* act_param = &param.activation_param;
+#pragma omp parallel for
+  for (int c = 0; c < m; c++) {
+    float* out = dst + static_cast<int64_t>(c) * ldc;
+    lite::x86::math::fill_bias_act(
+        out, bias ? bias + c : nullptr, 1, n, bias != nullptr, act_param);
+    if (!residual) continue;
+    const float* res = residual + c * residual_strides_[1];
+    if (residual_strides_[2] == ow_ && residual_strides_[3] == 1) {
+      res += r0 * ow_;
+      if (residual_relu) {
+        for (int j = 0; j < n; j++) out[j] = std::max(out[j] + res[j], 0.f);
+      } else {
+        for (int j = 0; j < n; j++) out[j] += res[j];
+      }
+      continue;
+    }
+    // A broadcast residual, the strides of its missing dims are 0.
+    for (int y = r0; y < r1; y++) {
+      const float* res_row = res + y * residual_strides_[2];
+      float* out_row = out + (y - r0) * ow_;
+      for (int x = 0; x < ow_; x++) {
+        out_row[x] += res_row[x * residual_strides_[3]];
+      }
+    }
+    if (residual_relu) {
+      for (int j = 0; j < n; j++) out[j] = std::max(out[j], 0.f);
+    }
+  }
+}
+
+void Conv2dBlockCompute::Run() {
+  auto& param = this->Param<param_t>();
+  const auto in_dims = param.x->dims();
+  const auto w_dims = param.filter->dims();
+  const int num = in_dims[0];
+  const int chout = w_dims[0];
+  const int kh = w_dims[2];
+  const int kw = w_dims[3];
+  auto& paddings = *param.paddings;
+  auto& dilations = *param.dilations;
+  oh_ = (in_dims[2] + paddings[0] + paddings[1] -
+         (dilations[0] * (kh - 1) + 1)) /
+            param.strides[0] +
+        1;
+  ow_ = (in_dims[3] + paddings[2] + paddings[3] -
+         (dilations[1] * (kw - 1) + 1)) /
+            param.strides[1] +
+        1;
+  flag_1x1_ = kh == 1 && kw == 1 && param.strides[0] == 1 &&
+              param.strides[1] == 1 && paddings[0] == 0 && paddings[1] == 0 &&
+              paddings[2] == 0 && paddings[3] == 0;
+  const int k = in_dims[1] * kh * kw;
+  const int plane = oh_ * ow_;
+
+  // Rows of a band: its im2col slice and its conv tile share half of L2.
+  const size_t l2 = std::max<size_t>(
+      lite::x86::GetCpuTopology().l2_cache_size, 256 * 1024);
+  const int64_t budget = static_cast<int64_t>(l2 / 2 / sizeof(float));
+  int band = static_cast<int>(budget / ((flag_1x1_ ? 0 : k) + chout) / ow_);
+  band = std::max(1, std::min(band, oh_));
+
+  const bool has_pool = !param.block_pool_type.empty();
+  const bool pool_max = param.block_pool_type == "max";
+  const bool pool_window = has_pool && !param.block_pool_global;
+  int pkh = 0, pkw = 0, psh = 1, psw = 1, ppt = 0, ppl = 0;
+  int ph = 0, pw = 0, pool_band = 0;
+  if (pool_window) {
+    pkh = param.block_pool_ksize[0];
+    pkw = param.block_pool_ksize[1];
+    psh = param.block_pool_strides[0];
+    psw = param.block_pool_strides[1];
+    ppt = param.block_pool_paddings[0];
+    ppl = param.block_pool_paddings[2];
+    ph = param.output->dims()[2];
+    pw = param.output->dims()[3];
+    // Whole pooling windows per band, at least one.
+    pool_band = std::max(1, (band - pkh) / psh + 1);
+    band = std::min(oh_, (pool_band - 1) * psh + pkh);
+  }
+  if (!flag_1x1_) col_.resize(static_cast<size_t>(k) * band * ow_);
+  if (has_pool) tile_.resize(static_cast<size_t>(chout) * band * ow_);
+  if (pool_window) pooled_.resize(static_cast<size_t>(chout) * pool_band * pw);
+
+  const float* din = param.x->data<float>();
+  const float* residual =
+      param.residualData ? param.residualData->data<float>() : nullptr;
+  if (residual) {
+    // Line the residual up with the conv output dims.
+    const auto res_dims = param.residualData->dims();
+    const int rank = static_cast<int>(res_dims.size());
+    const int start =
+        operators::BlockResidualStart(rank, param.residual_axis);
+    int64_t stride = 1;
+    for (int i = 3; i >= 0; i--) {
+      const int j = i - start;
+      const bool broadcast = j < 0 || j >= rank || res_dims[j] == 1;
+      residual_strides_[i] = broadcast ? 0 : stride;
+      if (j >= 0 && j < rank) stride *= res_dims[j];
+    }
+  }
+  float* dout = param.output->mutable_data<float>();
+  const int64_t in_size = in_dims.production() / num;
+  const int64_t out_size = param.output->dims().production() / num;
+  for (int i = 0; i < num; i++) {
+    const float* din_batch = din + i * in_size;
+    const float* res_batch =
+        residual ? residual + i * residual_strides_[0] : nullptr;
+    float* dout_batch = dout + i * out_size;
+    if (!has_pool) {
+      for (int r0 = 0; r0 < oh_; r0 += band) {
+        ConvRows(din_batch,
+                 res_batch,
+                 r0,
+                 std::min(oh_, r0 + band),
+                 dout_batch + r0 * ow_,
+                 plane);
+      }
+    } else if (!pool_window) {
+      // Global pooling folds every band into one value per channel.
+      std::fill(dout_batch,
+                dout_batch + chout,
+                pool_max ? std::numeric_limits<float>::lowest() : 0.f);
+      for (int r0 = 0; r0 < oh_; r0 += band) {
+        const int r1 = std::min(oh_, r0 + band);
+        const int n = (r1 - r0) * ow_;
+        ConvRows(din_batch, res_batch, r0, r1, tile_.data(), n);
+        for (int c = 0; c < chout; c++) {
+          const float* t = tile_.data() + static_cast<int64_t>(c) * n;
+          float acc = dout_batch[c];
+          if (pool_max) {
+            for (int j = 0; j < n; j++) acc = std::max(acc, t[j]);
+          } else {
+            for (int j = 0; j < n; j++) acc += t[j];
+          }
+          dout_batch[c] = acc;
+        }
+      }
+      if (!pool_max) {
+        for (int c = 0; c < chout; c++) dout_batch[c] /= plane;
+      }
+    } else {
+      // Pool rows [p0, p1) read the conv rows [r0, r1), the rows shared
+      // with the previous band are computed again.
+      for (int p0 = 0; p0 < ph; p0 += pool_band) {
+        const int p1 = std::min(ph, p0 + pool_band);
+        const int r0 = std::max(0, p0 * psh - ppt);
+        const int r1 = std::min(oh_, (p1 - 1) * psh - ppt + pkh);
+        const int n = (r1 - r0) * ow_;
+        // The pool kernel clips non-exclusive windows to oh_ + ppt.
+        const int clip_bottom = oh_ + ppt - r1;
+        ConvRows(din_batch, res_batch, r0, r1, tile_.data(), n);
+        lite::x86::math::pool2d_fast(tile_.data(),
+                                     pooled_.data(),
+                                     chout,
+                                     r1 - r0,
+                                     ow_,
+                                     p1 - p0,
+                                     pw,
+                                     pkh,
+                                     pkw,
+                                     psh,
+                                     psw,
+                                     r0 - (p0 * psh - ppt),
+                                     clip_bottom,
+                                     ppl,
+                                     ppl,
+                                     pool_max,
+                                     param.block_pool_exclusive);
+        const int len = (p1 - p0) * pw;
+        for (int c = 0; c < chout; c++) {
+          std::copy(pooled_.data() + static_cast<int64_t>(c) * len,
+                    pooled_.data() + static_cast<int64_t>(c + 1) * len,
+                    dout_batch + static_cast<int64_t>(c) * ph * pw + p0 * pw);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(fusion_conv2d_block,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::Conv2dBlockCompute,
+                     def)
+    .BindInput("Input", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Filter", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("ResidualData", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Output", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
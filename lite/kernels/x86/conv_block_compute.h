@@ -0,0 +1,64 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+#include <vector>
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+#include "lite/operators/op_params.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// fusion_conv2d_block: the conv output is produced a band of rows at a
+// time, sized to stay in L2, and every band gets bias, activation,
+// residual add, relu and pooling before the next one is computed. Pooling
+// windows that straddle two bands recompute the overlapping conv rows.
+class Conv2dBlockCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+ public:
+  using param_t = operators::ConvParam;
+
+  void Run() override;
+
+  virtual ~Conv2dBlockCompute() = default;
+
+ private:
+  // Conv rows [r0, r1) of one image into `dst`, channel c at dst + c * ldc,
+  // followed by the epilogue up to the residual relu.
+  void ConvRows(const float* din,
+                const float* residual,
+                int r0,
+                int r1,
+                float* dst,
+                int ldc);
+
+  // Conv output size of the current input.
+  int oh_{0};
+  int ow_{0};
+  bool flag_1x1_{false};
+  // Strides of the residual over the conv output dims, 0 where it is
+  // broadcast.
+  int64_t residual_strides_[4]{0, 0, 0, 0};
+  std::vector<float> col_;
+  std::vector<float> tile_;
+  std::vector<float> pooled_;
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
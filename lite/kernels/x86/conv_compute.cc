@@ -14,6 +14,7 @@
 
 #include "lite/kernels/x86/conv_compute.h"
 #include <utility>
+#include "lite/backends/x86/math/conv_select.h"
 #include "lite/backends/x86/math/fill_bias_activate.h"
 #include "lite/kernels/x86/conv_depthwise.h"
 #include "lite/kernels/x86/conv_direct.h"
@@ -41,27 +42,21 @@ namespace x86 {
   int n = hout * wout;                  \
   int k = chin * kw * kh / group;
 
-#define PREPARE_PARAM                                                         \
-  auto& param = this->Param<param_t>();                                       \
-  const int input_channel = param.x->dims()[1];                               \
-  const int output_channel = param.filter->dims()[0];                         \
-  const int groups = param.groups;                                            \
-  const int kernel_h = param.filter->dims()[2];                               \
-  const int kernel_w = param.filter->dims()[3];                               \
-  const int stride_h = param.strides[0];                                      \
-  const int stride_w = param.strides[1];                                      \
-  auto paddings = *param.paddings;                                            \
-  auto dilations = *param.dilations;                                          \
-  bool dw_kernel = (input_channel == groups && output_channel == groups);     \
-  bool ks_equal = (stride_h == stride_w) && (kernel_h == kernel_w);           \
-  bool no_dilation = (dilations[0] == 1) && (dilations[1] == 1);              \
-  bool kps_equal = (paddings[0] == paddings[2]) && ks_equal;                  \
-  bool pads_equal =                                                           \
-      ((paddings[0] == paddings[1]) && (paddings[2] == paddings[3]));         \
-  bool flag_dw_3x3 =                                                          \
-      (kernel_h == 3) && (kernel_w == 3) && (stride_h == 1 || stride_h == 2); \
-  bool flag_dw_5x5 =                                                          \
-      (kernel_h == 5) && (kernel_w == 5) && (stride_h == 1 || stride_h == 2);
+#define PREPARE_PARAM                                                    \
+  auto& param = this->Param<param_t>();                                  \
+  const int input_channel = param.x->dims()[1];                          \
+  const int output_channel = param.filter->dims()[0];                    \
+  const int groups = param.groups;                                       \
+  const int kernel_h = param.filter->dims()[2];                          \
+  const int kernel_w = param.filter->dims()[3];                          \
+  const int stride_h = param.strides[0];                                 \
+  const int stride_w = param.strides[1];                                 \
+  auto paddings = *param.paddings;                                       \
+  auto dilations = *param.dilations;                                     \
+  bool ks_equal = (stride_h == stride_w) && (kernel_h == kernel_w);      \
+  bool kps_equal = (paddings[0] == paddings[2]) && ks_equal;             \
+  bool pads_equal =                                                      \
+      ((paddings[0] == paddings[1]) && (paddings[2] == paddings[3]));
 
 #define PREPARE_PARAM_INT8                                          \
   auto& param = this->Param<param_t>();                             \
@@ -82,8 +77,6 @@ namespace x86 {
 template <>
 void Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {
   PREPARE_PARAM
-  //! todo add conv_5x5_depthwise implement
-  bool flag_dw = flag_dw_3x3 || flag_dw_5x5;
   if (kernel_w == 1 && stride_w == 1 && paddings[0] == 0 && kps_equal &&
       pads_equal) {
     flag_1x1gemm_ = true;
@@ -91,33 +84,28 @@ void Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {
     flag_1x1gemm_ = false;
   }
 
-  bool nodilations = true;
-  for (auto ele : *(param.dilations))
-    if (ele != 1) nodilations = false;
-
-  bool pad_all_equal = (paddings[0] == paddings[1]) &&
-                       (paddings[1] == paddings[2]) &&
-                       (paddings[2] == paddings[3]);
-  bool flag_p = paddings[0] <= stride_h;
-
-  //! select conv impl
-  if (dw_kernel && kps_equal && flag_dw && pads_equal &&
-      ((flag_dw_5x5 && no_dilation) || (flag_dw_3x3 && (groups & 3) == 0))) {
-    impl_ = new DepthwiseConv<PRECISION(kFloat), PRECISION(kFloat)>;
-    VLOG(3) << "invoking conv_depthwise_3x3p0p1 or conv_depthwise_5x5";
-  }
-
-  // support 3x3s1p01,5x5s1p01,7x7s1p01
-  //  3x3s2p012,5x5s1p012,7x7s1p012
-  if (output_channel % 8 == 0 && groups == 1 &&
-      (kernel_h == 3 || kernel_h == 5 || kernel_h == 7) &&
-      (stride_h == 2 || stride_h == 1) && nodilations && kps_equal &&
-      pad_all_equal && flag_p) {
+  //! select conv impl, depth_first_tiling.cc follows the same selection
+  switch (lite::x86::math::SelectConv2dImpl(input_channel,
+                                            output_channel,
+                                            groups,
+                                            kernel_h,
+                                            kernel_w,
+                                            param.strides,
+                                            paddings,
+                                            dilations)) {
+    case lite::x86::math::Conv2dImpl::kDepthwise:
+      impl_ = new DepthwiseConv<PRECISION(kFloat), PRECISION(kFloat)>;
+      VLOG(3) << "invoking conv_depthwise_3x3p0p1 or conv_depthwise_5x5";
+      break;
+    case lite::x86::math::Conv2dImpl::kDirect:
 #if defined(_WIN64) || defined(__MINGW64__) || \
     (defined(__CYGWIN__) && defined(__x86_64__)) || defined(__x86_64__)
-    impl_ = new DirectConv<PRECISION(kFloat), PRECISION(kFloat)>();
-    VLOG(3) << "invoking directConv";
+      impl_ = new DirectConv<PRECISION(kFloat), PRECISION(kFloat)>();
+      VLOG(3) << "invoking directConv";
 #endif
+      break;
+    default:
+      break;
   }
 
   if (impl_) {
@@ -15,13 +15,17 @@
 #pragma once
 
 #include <cmath>
+#include <map>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 #include "lite/backends/x86/math/avx/conv_utils.h"
 #include "lite/backends/x86/math/conv_direct_fp32.h"
 #include "lite/core/context.h"
 #include "lite/core/kernel.h"
 #include "lite/core/target_wrapper.h"
+#include "lite/core/weight_registry.h"
 
 namespace paddle {
 namespace lite {
@@ -35,7 +39,7 @@ template <PrecisionType Ptype, PrecisionType OutType>
 class DirectConv : public KernelLite<TARGET(kX86), Ptype> {
  public:
   DirectConv() = default;
-  ~DirectConv() { delete code_; }
+  ~DirectConv() = default;
 
   virtual void Run();
 
@@ -59,22 +63,40 @@ class DirectConv : public KernelLite<TARGET(kX86), Ptype> {
     auto weights_w_data = weights_.mutable_data<float>();
     lite::x86::math::conv_trans_weights_numc(
         filter_data, weights_w_data, oc, ic, wh, ww, block);
+    if (WeightRegistry::Global().enabled()) {
+      WeightRegistry::Global().Share(&weights_);
+    }
+  }
 
+  // The generated code is specialized for the input size. The code of every
+  // size is kept, as the depth first tiling switches between a few sizes.
+  virtual void ReInitWhenNeeded() {
+    auto& param = this->template Param<param_t>();
     auto x_dims = param.x->dims();
-    auto w_dims = param.filter->dims();
-    auto o_dims = param.output->dims();
-
-    const int ph = (*(param.paddings))[0];
-    const int pw = (*(param.paddings))[2];
-
-    int iw = x_dims[3];
-    int ih = x_dims[2];
-    int oh = o_dims[2];
-    int ow = o_dims[3];
-    code_ = new lite::x86::math::conv_direct();
-    code_->generate_code(
-        ic, ih, iw, oc, oc_expand_, oh, ow, ph, pw, wh, ww, param.strides[1]);
-    code_->ready();
+    if (code_ && x_dims == last_x_dims_) return;
+    last_x_dims_ = x_dims;
+    auto& code = codes_[std::make_pair(x_dims[2], x_dims[3])];
+    if (!code) {
+      auto w_dims = param.filter->dims();
+      auto o_dims = param.output->dims();
+      const int ph = (*(param.paddings))[0];
+      const int pw = (*(param.paddings))[2];
+      code.reset(new lite::x86::math::conv_direct());
+      code->generate_code(w_dims[1],
+                          x_dims[2],
+                          x_dims[3],
+                          w_dims[0],
+                          oc_expand_,
+                          o_dims[2],
+                          o_dims[3],
+                          ph,
+                          pw,
+                          w_dims[2],
+                          w_dims[3],
+                          param.strides[1]);
+      code->ready();
+    }
+    code_ = code.get();
   }
 
 #ifdef LITE_WITH_PROFILE
@@ -95,7 +117,11 @@ class DirectConv : public KernelLite<TARGET(kX86), Ptype> {
   bool flag_trans_bias_{false};
   std::vector<float> w_scale_;
   int oc_expand_;
-  lite::x86::math::conv_direct* code_;
+  lite::x86::math::conv_direct* code_{nullptr};
+  std::map<std::pair<int64_t, int64_t>,
+           std::unique_ptr<lite::x86::math::conv_direct>>
+      codes_;
+  DDim last_x_dims_;
 };
 
 }  // namespace x86
@@ -0,0 +1,97 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/embedding_bag_compute.h"
+#include "lite/backends/host/math/half_weight.h"
+#include "lite/backends/x86/math/embedding_bag.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+template <typename IdT>
+void EmbeddingBagCompute<IdT>::Run() {
+  auto& param = this->Param<param_t>();
+  auto* w = param.W;
+  auto* ids = param.Ids;
+  auto* out = param.Out;
+
+  const auto& lod = ids->lod();
+  const auto& offset = lod.back();
+  int bag_num = static_cast<int>(offset.size()) - 1;
+
+  int64_t row_number = w->dims()[0];
+  int64_t row_width = out->dims()[1];
+  int64_t row_stride = w->dims()[1] * sizeof(float);
+  auto table_type = lite::x86::math::EmbeddingTableType::kFloat32;
+  if (param.table_quant_type == "uint8_minmax") {
+    table_type = lite::x86::math::EmbeddingTableType::kUInt8MinMax;
+  } else if (param.half_weight_type == lite::host::math::kHalfWeightBF16) {
+    table_type = lite::x86::math::EmbeddingTableType::kBFloat16;
+    row_stride = w->dims()[1] * sizeof(uint16_t);
+  } else if (!param.half_weight_type.empty() ||
+             w->precision() == PRECISION(kFP16)) {
+    table_type = lite::x86::math::EmbeddingTableType::kFloat16;
+    row_stride = w->dims()[1] * sizeof(uint16_t);
+  }
+
+  auto pool_type = lite::x86::math::EmbeddingPoolType::kSum;
+  if (param.pool_type == "AVERAGE") {
+    pool_type = lite::x86::math::EmbeddingPoolType::kAverage;
+  } else if (param.pool_type == "SQRT") {
+    pool_type = lite::x86::math::EmbeddingPoolType::kSqrt;
+  } else {
+    CHECK_EQ(param.pool_type, "SUM") << "embedding_bag does not support "
+                                     << param.pool_type << " pooling";
+  }
+
+  lite::x86::math::embedding_bag(ids->data<IdT>(),
+                                 offset.data(),
+                                 bag_num,
+                                 w->raw_data(),
+                                 table_type,
+                                 row_number,
+                                 row_stride,
+                                 row_width,
+                                 param.padding_idx,
+                                 pool_type,
+                                 param.pad_value,
+                                 out->mutable_data<float>());
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+using embedding_bag_int64 =
+    paddle::lite::kernels::x86::EmbeddingBagCompute<int64_t>;
+REGISTER_LITE_KERNEL(
+    embedding_bag, kX86, kFloat, kNCHW, embedding_bag_int64, def)
+    .BindInput("W",
+               {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kAny))})
+    .BindInput("Ids", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt64))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
+
+using embedding_bag_int32 =
+    paddle::lite::kernels::x86::EmbeddingBagCompute<int32_t>;
+REGISTER_LITE_KERNEL(
+    embedding_bag, kX86, kFloat, kNCHW, embedding_bag_int32, int32_ids)
+    .BindInput("W",
+               {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kAny))})
+    .BindInput("Ids", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt32))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
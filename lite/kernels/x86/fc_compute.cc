@@ -13,7 +13,10 @@
 // limitations under the License.
 
 #include "lite/kernels/x86/fc_compute.h"
+#include "lite/backends/host/math/half_weight.h"
+#include "lite/backends/x86/math/dynamic_quant_gemm.h"
 #include "lite/backends/x86/math/gemm_s8u8_compute.h"
+#include "lite/backends/x86/math/half_weight_gemm.h"
 #include "lite/backends/x86/math/saturate.h"
 
 namespace paddle {
@@ -139,6 +142,25 @@ class FCFunctor {
   }
 };
 
+template <>
+void FcCompute<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {
+  auto& param = *param_.get_mutable<param_t>();
+  if (!param.enable_dynamic_quant || param.padding_weights ||
+      (param.activation_type != "" && param.activation_type != "relu")) {
+    return;
+  }
+  const auto& w_dims = param.w->dims();
+  w_int8_.resize(w_dims.production());
+  w_scale_.resize(w_dims[1]);
+  lite::x86::math::dynamic_quant_weight(param.w->data<float>(),
+                                        w_dims[0],
+                                        w_dims[1],
+                                        w_int8_.data(),
+                                        w_scale_.data());
+  lite::x86::math::dynamic_quant_pack_weight(
+      w_int8_.data(), w_dims[0], w_dims[1], &w_packed_);
+}
+
 template <>
 void FcCompute<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
   auto& param = *param_.get_mutable<param_t>();
@@ -156,6 +178,39 @@ void FcCompute<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
   int M = output->dims().production() / w_dims1;
 
   const float* input_data = input->template data<float>();
+  if (!param.half_weight_type.empty()) {
+    CHECK(!padding_weights) << "fp16/bf16 fc weights can not be padded";
+    CHECK(param.activation_type.empty() || with_relu)
+        << "fc with fp16/bf16 weights only fuses relu";
+    lite::x86::math::half_weight_gemm(
+        input_data,
+        M,
+        w_dims0,
+        reinterpret_cast<const uint16_t*>(w->template data<int16_t>()),
+        param.half_weight_type == lite::host::math::kHalfWeightBF16,
+        w_dims1,
+        1.f,
+        bias ? bias->template data<float>() : nullptr,
+        with_relu,
+        output->template mutable_data<float>());
+    return;
+  }
+  if (!w_int8_.empty()) {
+    lite::x86::math::dynamic_quant_gemm(
+        input_data,
+        M,
+        w_dims0,
+        w_int8_.data(),
+        w_scale_.data(),
+        w_dims1,
+        1.f,
+        bias ? bias->template data<float>() : nullptr,
+        with_relu ? 1 : 0,
+        0.f,
+        output->template mutable_data<float>(),
+        w_packed_.empty() ? nullptr : w_packed_.data());
+    return;
+  }
   const float* w_data = w->template data<float>();
   float* output_data = output->template mutable_data<float>();
 
@@ -173,12 +228,28 @@ void FcCompute<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
      padding_weights);
 }
 
+// The int8 weight is constant, pack it once instead of per gemm block in
+// every Run.
+static void PrepackInt8Weight(const operators::FcParam& param,
+                              std::vector<uint8_t>* w_packed) {
+  const auto& w_dims = param.w->dims();
+  int k = w_dims[0];
+  int n = w_dims[1];
+  w_packed->resize(lite::x86::math::gemm_s8u8_packed_B_size(n, k));
+  lite::x86::math::gemm_s8u8_prepackB(
+      n, k, param.w->data<int8_t>(), w_packed->data(), false);
+}
+
+template <>
+void FcCompute<PRECISION(kInt8), PRECISION(kInt8)>::PrepareForRun() {
+  PrepackInt8Weight(this->Param<operators::FcParam>(), &w_packed_);
+}
+
 template <>
 void FcCompute<PRECISION(kInt8), PRECISION(kInt8)>::Run() {
   auto& param = this->Param<operators::FcParam>();
   auto* i_data = param.input->data<int8_t>();
   auto* o_data = param.output->mutable_data<int8_t>();
-  auto* w_data = param.w->data<int8_t>();
   const float* b_data = param.bias ? param.bias->data<float>() : nullptr;
   auto w_dims = param.w->dims();
   int k = w_dims[0];
@@ -196,17 +267,17 @@ void FcCompute<PRECISION(kInt8), PRECISION(kInt8)>::Run() {
   if (param.weight_scale.size() == 1) {
     for (int i = 0; i < m; i++) w_scale[i] = param.weight_scale[0];
     GEMM_OUT_INT8;
-    gemm.compute(i_data, w_data, o_data);
+    gemm.compute_prepacked(i_data, w_packed_.data(), o_data);
   } else if (param.weight_scale.size() == m) {
     for (int i = 0; i < m; i++) w_scale[i] = param.weight_scale[i];
     GEMM_OUT_INT8;
-    gemm.compute(i_data, w_data, o_data);
+    gemm.compute_prepacked(i_data, w_packed_.data(), o_data);
   } else if (param.weight_scale.size() == n) {
     for (int i = 0; i < m; i++) w_scale[i] = 1.f;
     float* tmp_output =
         static_cast<float*>(TargetMalloc(TARGET(kX86), m * n * sizeof(float)));
     GEMM_OUT_FLOAT;
-    gemm.compute(i_data, w_data, tmp_output);
+    gemm.compute_prepacked(i_data, w_packed_.data(), tmp_output);
     for (int nn = 0; nn < n; nn++) {
       float tmp_scale = param.weight_scale[nn] / output_scale;
       for (int mm = 0; mm < m; mm++) {
@@ -223,12 +294,16 @@ void FcCompute<PRECISION(kInt8), PRECISION(kInt8)>::Run() {
   TargetFree(TARGET(kX86), w_scale);
 }
 
+template <>
+void FcCompute<PRECISION(kInt8), PRECISION(kFloat)>::PrepareForRun() {
+  PrepackInt8Weight(this->Param<operators::FcParam>(), &w_packed_);
+}
+
 template <>
 void FcCompute<PRECISION(kInt8), PRECISION(kFloat)>::Run() {
   auto& param = this->Param<operators::FcParam>();
   auto* i_data = param.input->data<int8_t>();
   auto* o_data = param.output->mutable_data<float>();
-  auto* w_data = param.w->data<int8_t>();
   const float* b_data = param.bias ? param.bias->data<float>() : nullptr;
   auto w_dims = param.w->dims();
   int k = w_dims[0];
@@ -246,15 +321,15 @@ void FcCompute<PRECISION(kInt8), PRECISION(kFloat)>::Run() {
   if (param.weight_scale.size() == 1) {
     for (int i = 0; i < m; i++) w_scale[i] = param.weight_scale[0];
     GEMM_OUT_FLOAT;
-    gemm.compute(i_data, w_data, o_data);
+    gemm.compute_prepacked(i_data, w_packed_.data(), o_data);
   } else if (param.weight_scale.size() == m) {
     for (int i = 0; i < m; i++) w_scale[i] = param.weight_scale[i];
     GEMM_OUT_FLOAT;
-    gemm.compute(i_data, w_data, o_data);
+    gemm.compute_prepacked(i_data, w_packed_.data(), o_data);
   } else if (param.weight_scale.size() == n) {
     for (int i = 0; i < m; i++) w_scale[i] = 1.f;
     GEMM_OUT_FLOAT;
-    gemm.compute(i_data, w_data, o_data);
+    gemm.compute_prepacked(i_data, w_packed_.data(), o_data);
     for (int nn = 0; nn < n; nn++) {
       float tmp_scale = param.weight_scale[nn];
       for (int mm = 0; mm < m; mm++) {
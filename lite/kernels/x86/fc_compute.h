@@ -35,11 +35,27 @@ class FcCompute : public KernelLite<TARGET(kX86), PType> {
  public:
   using param_t = operators::FcParam;
 
+  virtual void PrepareForRun() {}
+
   virtual void Run();
 
   virtual ~FcCompute() = default;
+
+ private:
+  // int8 weight and per column scales for enable_dynamic_quant
+  std::vector<int8_t> w_int8_;
+  std::vector<float> w_scale_;
+  // int8 weight packed once for the int8 gemm, see gemm_s8u8_prepackB
+  std::vector<uint8_t> w_packed_;
 };
 
+template <>
+void FcCompute<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun();
+template <>
+void FcCompute<PRECISION(kInt8), PRECISION(kInt8)>::PrepareForRun();
+template <>
+void FcCompute<PRECISION(kInt8), PRECISION(kFloat)>::PrepareForRun();
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
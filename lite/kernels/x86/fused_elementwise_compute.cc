@@ -0,0 +1,71 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/fused_elementwise_compute.h"
+#include <algorithm>
+#include "lite/backends/x86/math/fused_elementwise.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+void FusedElementwiseCompute::PrepareForRun() {
+  auto& param = this->Param<param_t>();
+  program_ = host::math::FusedElementwiseProgram(
+      param.op_types, param.op_inputs, param.op_params);
+}
+
+void FusedElementwiseCompute::Run() {
+  auto& param = this->Param<param_t>();
+  std::vector<const float*> x;
+  for (auto* t : param.X) {
+    x.push_back(t->data<float>());
+  }
+  float* out = param.Out->mutable_data<float>();
+  const int64_t tasks = host::math::FusedElementwiseTasks(param.shape);
+  auto eval = [&](const float* const* xs,
+                  const bool* x_scalar,
+                  int len,
+                  float* acc) {
+    lite::x86::math::fused_elementwise_eval(program_, xs, x_scalar, len, acc);
+  };
+  // Several chunks per omp iteration to amortize the task setup.
+  const int64_t step = 16;
+#pragma omp parallel for
+  for (int64_t task = 0; task < tasks; task += step) {
+    host::math::FusedElementwiseRun(param.shape,
+                                    param.x_strides,
+                                    x,
+                                    out,
+                                    task,
+                                    std::min(task + step, tasks),
+                                    eval);
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(fused_elementwise,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::FusedElementwiseCompute,
+                     def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
@@ -0,0 +1,166 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "lite/kernels/x86/layout_compute.h"
+#include <vector>
+#include "lite/backends/x86/math/permute.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// NCHW -> NHWC when `to_nhwc` is set, NHWC -> NCHW otherwise.
+template <typename T>
+void LayoutTrans(const operators::LayoutParam& param, bool to_nhwc) {
+  auto x_dims = param.x->dims();
+  if (x_dims.size() != 4) {
+    LOG(WARNING) << "The layout transform should guarantee that the input "
+                    "dims should be 4, but received "
+                 << x_dims.size();
+    param.y->ShareDataWith(*param.x);
+    return;
+  }
+  std::vector<int> axis = to_nhwc ? std::vector<int>{0, 2, 3, 1}
+                                  : std::vector<int>{0, 3, 1, 2};
+  param.y->Resize(
+      {x_dims[axis[0]], x_dims[axis[1]], x_dims[axis[2]], x_dims[axis[3]]});
+  lite::x86::math::permute(param.x->template data<T>(),
+                           param.y->template mutable_data<T>(),
+                           x_dims.Vectorize(),
+                           axis);
+}
+
+template <>
+void NCHWToNHWCCompute<PRECISION(kFloat)>::Run() {
+  LayoutTrans<float>(Param<param_t>(), true);
+}
+
+template <>
+void NCHWToNHWCCompute<PRECISION(kInt8)>::Run() {
+  LayoutTrans<int8_t>(Param<param_t>(), true);
+}
+
+template <>
+void NHWCToNCHWCompute<PRECISION(kFloat)>::Run() {
+  LayoutTrans<float>(Param<param_t>(), false);
+}
+
+template <>
+void NHWCToNCHWCompute<PRECISION(kInt8)>::Run() {
+  LayoutTrans<int8_t>(Param<param_t>(), false);
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+typedef paddle::lite::kernels::x86::NCHWToNHWCCompute<PRECISION(kFloat)>
+    NCHW_fp32;
+typedef paddle::lite::kernels::x86::NCHWToNHWCCompute<PRECISION(kInt8)>
+    NCHW_int8;
+typedef paddle::lite::kernels::x86::NHWCToNCHWCompute<PRECISION(kFloat)>
+    NHWC_fp32;
+typedef paddle::lite::kernels::x86::NHWCToNCHWCompute<PRECISION(kInt8)>
+    NHWC_int8;
+
+REGISTER_LITE_KERNEL(layout, kX86, kFloat, kNCHW, NCHW_fp32, nchw2nhwc)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNHWC))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(layout, kX86, kFloat, kNCHW, NHWC_fp32, nhwc2nchw)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNHWC))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(layout, kX86, kInt8, kNCHW, NCHW_int8, int8_nchw2nhwc)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kInt8),
+                                      DATALAYOUT(kNCHW))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kInt8),
+                                       DATALAYOUT(kNHWC))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(layout, kX86, kInt8, kNCHW, NHWC_int8, int8_nhwc2nchw)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kInt8),
+                                      DATALAYOUT(kNHWC))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kInt8),
+                                       DATALAYOUT(kNCHW))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(layout_once, kX86, kFloat, kNCHW, NCHW_fp32, nchw2nhwc)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNHWC))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(layout_once, kX86, kFloat, kNCHW, NHWC_fp32, nhwc2nchw)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNHWC))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(layout_once, kX86, kInt8, kNCHW, NCHW_int8, int8_nchw2nhwc)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kInt8),
+                                      DATALAYOUT(kNCHW))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kInt8),
+                                       DATALAYOUT(kNHWC))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(layout_once, kX86, kInt8, kNCHW, NHWC_int8, int8_nhwc2nchw)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kInt8),
+                                      DATALAYOUT(kNHWC))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kInt8),
+                                       DATALAYOUT(kNCHW))})
+    .Finalize();
@@ -14,7 +14,9 @@
 #pragma once
 
 #include <vector>
+#include "lite/backends/host/math/half_weight.h"
 #include "lite/backends/x86/fluid/eigen.h"
+#include "lite/backends/x86/math/half_weight_gemm.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 
@@ -40,18 +42,31 @@ class LookupTableCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     int64_t row_number = table_t->dims()[0];
     int64_t row_width = table_t->dims()[1];
 
-    const T *table = table_t->template data<T>();
     T *output = output_t->template mutable_data<T>();
     memset(output, 0, output_t->dims().production() * sizeof(T));
+    // fp16/bf16 rows are widened while they are gathered.
+    const bool half = !param.half_weight_type.empty();
+    const bool bf16 =
+        param.half_weight_type == lite::host::math::kHalfWeightBF16;
     for (int64_t i = 0; i < ids_numel; ++i) {
       if (padding_idx != -1 && ids[i] == padding_idx) {
         memset(output + i * row_width, 0, row_width * sizeof(T));
       } else {
         CHECK_LT(ids[i], row_number);
         CHECK_GE(ids[i], 0);
-        memcpy(output + i * row_width,
-               table + ids[i] * row_width,
-               row_width * sizeof(T));
+        if (half) {
+          lite::x86::math::half_weight_to_float(
+              reinterpret_cast<const uint16_t *>(
+                  table_t->template data<int16_t>()) +
+                  ids[i] * row_width,
+              row_width,
+              bf16,
+              output + i * row_width);
+        } else {
+          memcpy(output + i * row_width,
+                 table_t->template data<T>() + ids[i] * row_width,
+                 row_width * sizeof(T));
+        }
       }
     }
   }
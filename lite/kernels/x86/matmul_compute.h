@@ -13,7 +13,11 @@
 // limitations under the License.
 #pragma once
 
+#include <vector>
+#include "lite/backends/host/math/half_weight.h"
 #include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/dynamic_quant_gemm.h"
+#include "lite/backends/x86/math/half_weight_gemm.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/types.h"
@@ -49,6 +53,24 @@ class MatMulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
   using param_t = operators::MatMulParam;
 
+  void PrepareForRun() override {
+    auto &param = *param_.get_mutable<operators::MatMulParam>();
+    auto *y = param.Y;
+    if (!param.enable_dynamic_quant || param.transpose_X ||
+        param.transpose_Y || !y->persistable() || y->dims().size() != 2) {
+      return;
+    }
+    w_int8_.resize(y->numel());
+    w_scale_.resize(y->dims()[1]);
+    lite::x86::math::dynamic_quant_weight(y->template data<float>(),
+                                          y->dims()[0],
+                                          y->dims()[1],
+                                          w_int8_.data(),
+                                          w_scale_.data());
+    lite::x86::math::dynamic_quant_pack_weight(
+        w_int8_.data(), y->dims()[0], y->dims()[1], &w_packed_);
+  }
+
   void Run() override {
     auto &context = ctx_->As<X86Context>();
     auto &param = *param_.get_mutable<operators::MatMulParam>();
@@ -58,6 +80,42 @@ class MatMulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     auto *out = param.Out;
     out->template mutable_data<T>();
 
+    const int K = y->dims()[0];
+    const int N = y->dims()[1];
+    if (!param.half_weight_type.empty()) {
+      // Set by post_quant_dynamic_pass only for a 2-D Y without transpose.
+      CHECK_EQ(x->dims()[x->dims().size() - 1], K);
+      lite::x86::math::half_weight_gemm(
+          x->template data<float>(),
+          x->numel() / K,
+          K,
+          reinterpret_cast<const uint16_t *>(y->template data<int16_t>()),
+          param.half_weight_type == lite::host::math::kHalfWeightBF16,
+          N,
+          param.alpha,
+          nullptr,
+          false,
+          out->template mutable_data<float>());
+      return;
+    }
+    if (!w_int8_.empty() && x->dims().size() >= 2 &&
+        x->dims()[x->dims().size() - 1] == K) {
+      lite::x86::math::dynamic_quant_gemm(x->template data<float>(),
+                                          x->numel() / K,
+                                          K,
+                                          w_int8_.data(),
+                                          w_scale_.data(),
+                                          N,
+                                          param.alpha,
+                                          nullptr,
+                                          0,
+                                          0.f,
+                                          out->template mutable_data<float>(),
+                                          w_packed_.empty() ? nullptr
+                                                            : w_packed_.data());
+      return;
+    }
+
     auto blas = lite::x86::math::GetBlas<lite::TargetType::kX86, T>(context);
     auto mat_dim_a = lite::x86::math::CreateMatrixDescriptor(
         RowMatrixFromVector(x->dims()), 0, param.transpose_X);
@@ -68,6 +126,13 @@ class MatMulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
   }
 
   virtual ~MatMulCompute() = default;
+
+ private:
+  // int8 Y and per column scales for enable_dynamic_quant
+  std::vector<int8_t> w_int8_;
+  std::vector<float> w_scale_;
+  // w_int8_ packed once for the int8 gemm
+  std::vector<uint8_t> w_packed_;
 };
 
 }  // namespace x86
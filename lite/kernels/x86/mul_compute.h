@@ -13,7 +13,11 @@
 // limitations under the License.
 #pragma once
 
+#include <vector>
+#include "lite/backends/host/math/half_weight.h"
 #include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/dynamic_quant_gemm.h"
+#include "lite/backends/x86/math/half_weight_gemm.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/types.h"
@@ -39,6 +43,24 @@ class MulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
   using param_t = operators::MulParam;
 
+  void PrepareForRun() override {
+    auto& param = *param_.get_mutable<operators::MulParam>();
+    auto* y = param.y;
+    if (!param.enable_dynamic_quant || !y->persistable() ||
+        y->dims().size() != 2 || param.y_num_col_dims != 1) {
+      return;
+    }
+    w_int8_.resize(y->numel());
+    w_scale_.resize(y->dims()[1]);
+    lite::x86::math::dynamic_quant_weight(y->template data<float>(),
+                                          y->dims()[0],
+                                          y->dims()[1],
+                                          w_int8_.data(),
+                                          w_scale_.data());
+    lite::x86::math::dynamic_quant_pack_weight(
+        w_int8_.data(), y->dims()[0], y->dims()[1], &w_packed_);
+  }
+
   void Run() override {
     auto& context = ctx_->As<X86Context>();
     auto& param = *param_.get_mutable<operators::MulParam>();
@@ -49,6 +71,42 @@ class MulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     auto* x = param.x;
     auto* y = param.y;
 
+    if (!param.half_weight_type.empty()) {
+      // y is a 2-D fp16/bf16 weight, see post_quant_dynamic_pass.
+      const auto x_mat_dims = x->dims().Flatten2D(param.x_num_col_dims);
+      CHECK_EQ(x_mat_dims[1], y->dims()[0]);
+      lite::x86::math::half_weight_gemm(
+          x->template data<float>(),
+          x_mat_dims[0],
+          x_mat_dims[1],
+          reinterpret_cast<const uint16_t*>(y->template data<int16_t>()),
+          param.half_weight_type == lite::host::math::kHalfWeightBF16,
+          y->dims()[1],
+          1.f,
+          nullptr,
+          false,
+          z->template mutable_data<float>());
+      return;
+    }
+    if (!w_int8_.empty()) {
+      const auto x_mat_dims = x->dims().Flatten2D(param.x_num_col_dims);
+      CHECK_EQ(x_mat_dims[1], y->dims()[0]);
+      lite::x86::math::dynamic_quant_gemm(x->template data<float>(),
+                                          x_mat_dims[0],
+                                          x_mat_dims[1],
+                                          w_int8_.data(),
+                                          w_scale_.data(),
+                                          y->dims()[1],
+                                          1.f,
+                                          nullptr,
+                                          0,
+                                          0.f,
+                                          z->template mutable_data<float>(),
+                                          w_packed_.empty() ? nullptr
+                                                            : w_packed_.data());
+      return;
+    }
+
     Tensor x_matrix, y_matrix;
 
     if (x->dims().size() > 2) {
@@ -79,6 +137,13 @@ class MulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
   }
 
   virtual ~MulCompute() = default;
+
+ private:
+  // int8 Y and per column scales for enable_dynamic_quant
+  std::vector<int8_t> w_int8_;
+  std::vector<float> w_scale_;
+  // w_int8_ packed once for the int8 gemm
+  std::vector<uint8_t> w_packed_;
 };
 
 }  // namespace x86
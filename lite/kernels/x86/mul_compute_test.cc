@@ -80,6 +80,48 @@ TEST(mul_x86, run_test) {
   }
 }
 
+TEST(mul_x86, dynamic_quant) {
+  lite::Tensor x, y, out;
+  constexpr int M = 5, K = 37, N = 19;
+  x.Resize({M, K});
+  y.Resize({K, N});
+  y.set_persistable(true);
+  out.Resize({M, N});
+  auto x_data = x.mutable_data<float>();
+  auto y_data = y.mutable_data<float>();
+  for (int64_t i = 0; i < x.numel(); i++) {
+    x_data[i] = static_cast<float>((i * 7) % 13) / 13.f - 0.5f;
+  }
+  for (int64_t i = 0; i < y.numel(); i++) {
+    y_data[i] = static_cast<float>((i * 5) % 11) / 11.f - 0.5f;
+  }
+
+  MulCompute<float> mul;
+  operators::MulParam param;
+  param.x = &x;
+  param.y = &y;
+  param.output = &out;
+  param.enable_dynamic_quant = true;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  mul.SetContext(std::move(ctx));
+  mul.SetParam(param);
+  mul.PrepareForRun();
+  mul.Run();
+
+  auto out_data = out.data<float>();
+  for (int m = 0; m < M; m++) {
+    for (int n = 0; n < N; n++) {
+      float ref = 0.f;
+      for (int k = 0; k < K; k++) {
+        ref += x_data[m * K + k] * y_data[k * N + n];
+      }
+      // Activations use 7 bits and weights 8 bits.
+      EXPECT_NEAR(out_data[m * N + n], ref, 5e-2);
+    }
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
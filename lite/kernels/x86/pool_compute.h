@@ -14,9 +14,11 @@
 #pragma once
 
 #include <Eigen/Core>
+#include <type_traits>
 #include "lite/backends/x86/fluid/eigen.h"
 #include "lite/backends/x86/math/math_function.h"
 #include "lite/backends/x86/math/pooling.h"
+#include "lite/backends/x86/math/pooling_fast.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/types.h"
@@ -38,6 +40,11 @@ class PoolCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
         param.ksize[i] = static_cast<int>(param.x->dims()[i + 2]);
       }
     }
+    if (std::is_same<T, float>::value && param.ksize.size() == 2 &&
+        (param.pooling_type == "max" || param.pooling_type == "avg")) {
+      RunFloat2d(param);
+      return;
+    }
     switch (param.ksize.size()) {
       case 2: {
         if (param.pooling_type == "max") {
@@ -54,7 +61,7 @@ class PoolCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
                          *param.paddings,
                          pool_process,
                          true,
-                         false,
+                         param.adaptive,
                          param.output);
         } else if (param.pooling_type == "avg") {
           paddle::lite::x86::math::Pool2dFunctor<
@@ -79,6 +86,54 @@ class PoolCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     }
   }
   virtual ~PoolCompute() = default;
+
+ private:
+  // NCHW float pooling, picks the global, adaptive or windowed kernel by
+  // the shape.
+  void RunFloat2d(const param_t& param) {
+    const auto& x_dims = param.x->dims();
+    const auto& out_dims = param.output->dims();
+    const int nc = static_cast<int>(x_dims[0] * x_dims[1]);
+    const int ih = static_cast<int>(x_dims[2]);
+    const int iw = static_cast<int>(x_dims[3]);
+    const int oh = static_cast<int>(out_dims[2]);
+    const int ow = static_cast<int>(out_dims[3]);
+    const auto& pads = *param.paddings;
+    const bool max = param.pooling_type == "max";
+    const float* x = param.x->template data<float>();
+    float* out = param.output->template mutable_data<float>();
+
+    const bool no_pad = pads[0] == 0 && pads[1] == 0 && pads[2] == 0 &&
+                        pads[3] == 0;
+    const bool whole_plane =
+        param.adaptive ||
+        (param.ksize[0] == ih && param.ksize[1] == iw && no_pad);
+    if (oh == 1 && ow == 1 && whole_plane) {
+      lite::x86::math::pool2d_global(x, out, nc, ih * iw, max);
+    } else if (param.adaptive) {
+      lite::x86::math::pool2d_adaptive(x, out, nc, ih, iw, oh, ow, max);
+    } else {
+      // Like Pool2dFunctor, the non-exclusive average clips its window to
+      // the input plus the leading padding on both ends.
+      lite::x86::math::pool2d_fast(x,
+                                   out,
+                                   nc,
+                                   ih,
+                                   iw,
+                                   oh,
+                                   ow,
+                                   param.ksize[0],
+                                   param.ksize[1],
+                                   param.strides[0],
+                                   param.strides[1],
+                                   pads[0],
+                                   pads[0],
+                                   pads[2],
+                                   pads[2],
+                                   max,
+                                   param.exclusive);
+    }
+  }
 };
 
 }  // namespace x86
@@ -0,0 +1,84 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/sparse_conv_compute.h"
+#include "lite/backends/x86/math/sparse_spmm.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+void SparseConvCompute::Run() {
+  auto& param = this->Param<param_t>();
+  const auto& x_dims = param.x->dims();
+  const auto& o_dims = param.output->dims();
+  const int batch = x_dims[0];
+  const int ch_in = x_dims[1];
+  const int ch_out = o_dims[1];
+  const int im_size = x_dims[2] * x_dims[3];
+  CHECK_EQ(im_size, o_dims[2] * o_dims[3])
+      << "The x86 sparse conv only supports 1x1 kernel with stride 1";
+
+  lite::x86::math::SparseMatrix w;
+  w.values = param.nonzero_weights->data<float>();
+  w.row_ends = param.oc_nonzeros->data<int32_t>();
+  w.col_idx = param.diffs->data<int32_t>();
+  w.rows = ch_out;
+  w.cols = ch_in;
+  w.block_size = param.block_size;
+
+  auto act = lite::x86::math::SparseActType::kNone;
+  float act_param = 0.f;
+  if (param.activation_param.has_active) {
+    switch (param.activation_param.active_type) {
+      case lite_api::ActivationType::kRelu:
+        act = lite::x86::math::SparseActType::kRelu;
+        break;
+      case lite_api::ActivationType::kRelu6:
+        act = lite::x86::math::SparseActType::kRelu6;
+        act_param = param.activation_param.Relu_clipped_coef;
+        break;
+      default:
+        LOG(FATAL) << "The x86 sparse conv only supports relu and relu6";
+    }
+  }
+  const float* bias = param.bias ? param.bias->data<float>() : nullptr;
+  const float* din = param.x->data<float>();
+  float* dout = param.output->mutable_data<float>();
+  for (int b = 0; b < batch; ++b) {
+    const float* in = din + static_cast<int64_t>(b) * ch_in * im_size;
+    float* out = dout + static_cast<int64_t>(b) * ch_out * im_size;
+    lite::x86::math::sparse_spmm(w, in, im_size, bias, act, act_param, out);
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(sparse_conv2d,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::SparseConvCompute,
+                     def)
+    .BindInput("Input", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("NonZeroWeights", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("OcNonZeros", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Diffs", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Output", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
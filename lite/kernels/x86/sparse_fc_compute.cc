@@ -0,0 +1,76 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/sparse_fc_compute.h"
+#include "lite/backends/x86/math/sparse_spmm.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+void SparseFcCompute::Run() {
+  auto& param = this->Param<param_t>();
+  auto in_mat_dims = param.input->dims().Flatten2D(param.in_num_col_dims);
+
+  lite::x86::math::SparseMatrix w;
+  w.values = param.nonzero_weights->data<float>();
+  w.row_ends = param.oc_nonzeros->data<int32_t>();
+  w.col_idx = param.diffs->data<int32_t>();
+  w.rows = param.oc_nonzeros->numel();
+  w.cols = in_mat_dims[1];
+  w.block_size = param.block_size;
+
+  auto act = lite::x86::math::SparseActType::kNone;
+  float act_param = 0.f;
+  if (param.activation_param.has_active) {
+    switch (param.activation_param.active_type) {
+      case lite_api::ActivationType::kRelu:
+        act = lite::x86::math::SparseActType::kRelu;
+        break;
+      case lite_api::ActivationType::kRelu6:
+        act = lite::x86::math::SparseActType::kRelu6;
+        act_param = param.activation_param.Relu_clipped_coef;
+        break;
+      default:
+        LOG(FATAL) << "The x86 sparse fc only supports relu and relu6";
+    }
+  }
+  lite::x86::math::sparse_gemv(w,
+                               param.input->data<float>(),
+                               in_mat_dims[0],
+                               param.bias ? param.bias->data<float>() : nullptr,
+                               act,
+                               act_param,
+                               param.output->mutable_data<float>());
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(sparse_fc,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::SparseFcCompute,
+                     def)
+    .BindInput("Input", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("NonZeroWeights", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("OcNonZeros", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Diffs", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
@@ -13,8 +13,10 @@
 // limitations under the License.
 
 #include "lite/model_parser/flatbuffers/io.h"
+#include <algorithm>
 #include <cstring>
 #include <limits>
+#include <map>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -115,7 +117,9 @@ void ParamSerializer::WriteHeader() {
 }
 #endif
 
-void ParamDeserializer::ForwardRead(lite::Scope* scope) {
+void ParamDeserializer::ForwardRead(
+    lite::Scope* scope,
+    const std::function<void(const std::string&)>& on_param) {
   CHECK(scope) << "The pointer of scope is nullptr";
   uint16_t header_size = reader_->Read<uint16_t>();
   ReadBytesToBuffer(header_size);
@@ -133,6 +137,97 @@ void ParamDeserializer::ForwardRead(lite::Scope* scope) {
     ReadBytesToBuffer(param_bytes);
     fbs::ParamDescView param(buf_.get());
     FillTensor(scope->Var(param.Name())->GetMutable<lite::Tensor>(), param);
+    if (on_param) on_param(param.Name());
+  }
+}
+
+// The name of the param serialized in the first `size` bytes of `data`, or
+// an empty string if the name does not lie within them. The builder writes
+// the data first and the tables last, so the name is usually near the start.
+static std::string ParamNameInPrefix(const uint8_t* data, size_t size) {
+  using flatbuffers::ReadScalar;
+  using flatbuffers::soffset_t;
+  using flatbuffers::uoffset_t;
+  using flatbuffers::voffset_t;
+  if (size < sizeof(uoffset_t)) return "";
+  const size_t table = ReadScalar<uoffset_t>(data);
+  if (table + sizeof(soffset_t) > size) return "";
+  const int64_t vtable = static_cast<int64_t>(table) -
+                         ReadScalar<soffset_t>(data + table);
+  const size_t field = proto::ParamDesc::VT_NAME;
+  if (vtable < 0 || vtable + field + sizeof(voffset_t) > size ||
+      field + sizeof(voffset_t) > ReadScalar<voffset_t>(data + vtable)) {
+    return "";
+  }
+  const voffset_t field_offset = ReadScalar<voffset_t>(data + vtable + field);
+  const size_t name_ref = table + field_offset;
+  if (field_offset == 0 || name_ref + sizeof(uoffset_t) > size) return "";
+  const size_t name = name_ref + ReadScalar<uoffset_t>(data + name_ref);
+  if (name + sizeof(uoffset_t) > size) return "";
+  const size_t length = ReadScalar<uoffset_t>(data + name);
+  if (name + sizeof(uoffset_t) + length > size) return "";
+  return std::string(
+      reinterpret_cast<const char*>(data + name + sizeof(uoffset_t)), length);
+}
+
+void ParamDeserializer::ReadInOrder(
+    lite::Scope* scope,
+    const std::vector<std::string>& order,
+    const std::function<void(const std::string&)>& on_param) {
+  CHECK(scope) << "The pointer of scope is nullptr";
+  uint16_t header_size = reader_->Read<uint16_t>();
+  ReadBytesToBuffer(header_size);
+  char const* data = static_cast<char const*>(buf_->data());
+  uint16_t params_size = *reinterpret_cast<uint16_t const*>(data);
+  uint32_t max_tensor_size =
+      *reinterpret_cast<uint32_t const*>(data + sizeof(uint16_t));
+
+  // Index the params by name, reading only the start of each of them.
+  constexpr size_t kNamePrefixBytes = 1024;
+  struct Param {
+    size_t position;
+    uint32_t bytes;
+  };
+  std::vector<Param> params(params_size);
+  std::vector<std::string> names(params_size);
+  std::map<std::string, size_t> ids;
+  for (size_t i = 0; i < params_size; ++i) {
+    uint32_t total_size = reader_->Read<uint32_t>();
+    uint32_t offset = reader_->Read<uint32_t>();
+    params[i].position = reader_->current() + offset - sizeof(offset);
+    params[i].bytes = total_size - offset;
+    reader_->Seek(params[i].position);
+    ReadBytesToBuffer(std::min<size_t>(params[i].bytes, kNamePrefixBytes));
+    names[i] = ParamNameInPrefix(static_cast<const uint8_t*>(buf_->data()),
+                                 buf_->size());
+    if (names[i].empty()) {
+      reader_->Seek(params[i].position);
+      ReadBytesToBuffer(params[i].bytes);
+      names[i] = fbs::ParamDescView(buf_.get()).Name();
+    }
+    ids[names[i]] = i;
+    reader_->Seek(params[i].position + params[i].bytes);
+  }
+
+  std::vector<size_t> sequence;
+  std::vector<bool> queued(params_size, false);
+  for (auto& name : order) {
+    auto it = ids.find(name);
+    if (it == ids.end() || queued[it->second]) continue;
+    queued[it->second] = true;
+    sequence.push_back(it->second);
+  }
+  for (size_t i = 0; i < params_size; ++i) {
+    if (!queued[i]) sequence.push_back(i);
+  }
+
+  buf_->ResetLazy(max_tensor_size);
+  for (auto i : sequence) {
+    reader_->Seek(params[i].position);
+    ReadBytesToBuffer(params[i].bytes);
+    fbs::ParamDescView param(buf_.get());
+    FillTensor(scope->Var(names[i])->GetMutable<lite::Tensor>(), param);
+    if (on_param) on_param(names[i]);
   }
 }
 
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <set>
 #include <string>
@@ -62,7 +63,17 @@ class ParamDeserializer {
         << "A valid reader should be passed in the ctor of param deserializer.";
     ReadHeader();
   }
-  void ForwardRead(lite::Scope* scope);
+  // `on_param` is called with the name of every tensor once it is filled.
+  void ForwardRead(
+      lite::Scope* scope,
+      const std::function<void(const std::string&)>& on_param = nullptr);
+  // Like ForwardRead, but fills the params named in `order` first and in
+  // that order, the others follow in file order. The names are read ahead
+  // of the data, skipping over the data with Seek.
+  void ReadInOrder(
+      lite::Scope* scope,
+      const std::vector<std::string>& order,
+      const std::function<void(const std::string&)>& on_param = nullptr);
 
  private:
   void ReadBytesToBuffer(size_t size) {
@@ -128,6 +128,21 @@ TEST(CombinedParamsDesc, Scope) {
     deserializer.ForwardRead(&scope_3);
     check_params(scope_3);
   }
+
+  /* --------- Scope in the given order ---------- */
+  {
+    Scope scope_4;
+    model_parser::BinaryFileReader reader(path);
+    fbs::ParamDeserializer deserializer(&reader);
+    std::vector<std::string> filled;
+    deserializer.ReadInOrder(&scope_4,
+                             {"var_2", "missing", "var_0", "var_2"},
+                             [&](const std::string& name) {
+                               filled.push_back(name);
+                             });
+    EXPECT_EQ(filled, std::vector<std::string>({"var_2", "var_0", "var_1"}));
+    check_params(scope_4);
+  }
 }
 #endif  // LITE_WITH_FLATBUFFERS_DESC
 
@@ -17,7 +17,9 @@
 #include <fstream>
 #include <limits>
 #include <set>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "lite/api/paddle_api.h"
 #include "lite/core/model/base/apis.h"
@@ -866,12 +868,11 @@ void LoadModelNaiveV0FromFile(const std::string &filename,
   VLOG(4) << "Load naive buffer model in '" << filename << "' successfully";
 }
 #endif  // LITE_ON_TINY_PUBLISH
-void LoadModelFbsFromFile(model_parser::BinaryFileReader *reader,
-                          Scope *scope,
-                          cpp::ProgramDesc *cpp_prog,
-                          uint16_t meta_version) {
+// Reads the opt version and the topology of a naive buffer model, the reader
+// is left at the start of the params.
+static void LoadProgramFbsFromFile(model_parser::BinaryFileReader *reader,
+                                   cpp::ProgramDesc *cpp_prog) {
   CHECK(cpp_prog);
-  CHECK(scope);
   CHECK_EQ(cpp_prog->BlocksSize(), 0);
 
   // get opt version
@@ -908,6 +909,14 @@ void LoadModelFbsFromFile(model_parser::BinaryFileReader *reader,
   fbs::ProgramDesc program(buf);
   TransformProgramDescAnyToCpp(program, cpp_prog);
 #endif
+}
+
+void LoadModelFbsFromFile(model_parser::BinaryFileReader *reader,
+                          Scope *scope,
+                          cpp::ProgramDesc *cpp_prog,
+                          uint16_t meta_version) {
+  CHECK(scope);
+  LoadProgramFbsFromFile(reader, cpp_prog);
 
   /* 2. Load scope from params.fbs */
   switch (meta_version) {
@@ -931,6 +940,65 @@ void LoadModelFbsFromFile(model_parser::BinaryFileReader *reader,
   }
 }
 
+std::shared_ptr<WeightStream> LoadModelNaiveFromFileStreaming(
+    const std::string &filename, Scope *scope, cpp::ProgramDesc *cpp_prog) {
+  CHECK(cpp_prog);
+  CHECK(scope);
+  model_parser::BinaryFileReader reader(filename, 0);
+  uint16_t meta_version;
+  reader.Read(&meta_version, sizeof(uint16_t));
+  if (meta_version != 2) {
+    VLOG(4) << "Params of meta_version " << meta_version
+            << " can not be streamed, load them at once";
+    LoadModelNaiveFromFile(filename, scope, cpp_prog);
+    return nullptr;
+  }
+  LoadProgramFbsFromFile(&reader, cpp_prog);
+
+  // Create all the persistable tensors before the loader starts, it then
+  // only fills tensors which already exist.
+  std::unordered_set<std::string> pending;
+  for (size_t i = 0; i < cpp_prog->BlocksSize(); ++i) {
+    auto *block = cpp_prog->GetBlock<cpp::BlockDesc>(i);
+    for (size_t j = 0; j < block->VarsSize(); ++j) {
+      auto *var = block->GetVar<cpp::VarDesc>(j);
+      if (!var->Persistable() ||
+          var->GetType() != VarDescAPI::Type::LOD_TENSOR ||
+          var->Name() == "feed" || var->Name() == "fetch") {
+        continue;
+      }
+      scope->Var(var->Name())->GetMutable<lite::Tensor>();
+      pending.insert(var->Name());
+    }
+  }
+  // The params are stored in name order, fill them in the order the ops
+  // first read them instead. The ops of the sub blocks wait for the whole
+  // model, their params come last.
+  std::vector<std::string> order;
+  std::unordered_set<std::string> ordered;
+  for (size_t i = 0; i < cpp_prog->BlocksSize(); ++i) {
+    auto *block = cpp_prog->GetBlock<cpp::BlockDesc>(i);
+    for (size_t j = 0; j < block->OpsSize(); ++j) {
+      for (auto &name : block->GetOp<cpp::OpDesc>(j)->input_vars()) {
+        if (pending.count(name) && ordered.insert(name).second) {
+          order.push_back(name);
+        }
+      }
+    }
+  }
+  std::shared_ptr<WeightStream> stream(new WeightStream(std::move(pending)));
+  const size_t params_offset = reader.current();
+  stream->Start([filename, params_offset, scope, order](WeightStream *loader) {
+    model_parser::BinaryFileReader params(filename, params_offset);
+    fbs::ParamDeserializer deserializer(&params);
+    deserializer.ReadInOrder(scope, order, [loader](const std::string &name) {
+      loader->Publish(name);
+    });
+    VLOG(4) << "Streamed the params of '" << filename << "'";
+  });
+  return stream;
+}
+
 void LoadModelNaiveFromMemory(const std::string &model_buffer,
                               Scope *scope,
                               cpp::ProgramDesc *cpp_prog) {
@@ -27,6 +27,7 @@
 #include "lite/core/model/base/io.h"
 #include "lite/core/scope.h"
 #include "lite/core/variable.h"
+#include "lite/core/weight_stream.h"
 #include "lite/model_parser/compatible_pb.h"
 
 namespace paddle {
@@ -148,6 +149,14 @@ void LoadModelNaiveFromFile(const std::string& filename,
                             lite::Scope* scope,
                             cpp::ProgramDesc* prog);
 
+// Same as LoadModelNaiveFromFile, but only the program is read before it
+// returns. The params of a meta_version 2 model are filled by a loader
+// thread in the order the program first reads them, and published through
+// the returned stream. The other formats are loaded at once and null is
+// returned.
+std::shared_ptr<WeightStream> LoadModelNaiveFromFileStreaming(
+    const std::string& filename, Scope* scope, cpp::ProgramDesc* cpp_prog);
+
 void LoadModelNaiveFromMemory(const std::string& model_buffer,
                               lite::Scope* scope,
                               cpp::ProgramDesc* cpp_prog);
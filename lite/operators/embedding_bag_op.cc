@@ -0,0 +1,97 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/operators/embedding_bag_op.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+bool EmbeddingBagOp::CheckShape() const {
+  CHECK_OR_FALSE(param_.W)
+  CHECK_OR_FALSE(param_.Ids)
+  CHECK_OR_FALSE(param_.Out)
+  CHECK_EQ(param_.Ids->lod().empty(), false)
+      << "Input(Ids) Tensor of EmbeddingBagOp does not contain LoD "
+         "information.";
+  CHECK_GE_OR_FALSE(2UL, param_.Ids->lod().size())
+
+  const auto& table_dims = param_.W->dims();
+  CHECK_EQ_OR_FALSE(table_dims.size(), 2)
+  if (param_.table_quant_type == "uint8_minmax") {
+    CHECK_GT_OR_FALSE(table_dims[1], 2)
+  }
+  CHECK_OR_FALSE(param_.pool_type == "SUM" || param_.pool_type == "AVERAGE" ||
+                 param_.pool_type == "SQRT")
+  return true;
+}
+
+bool EmbeddingBagOp::InferShapeImpl() const {
+  const auto& table_dims = param_.W->dims();
+  const auto& lod = param_.Ids->lod();
+  int64_t row_width = table_dims[1];
+  if (param_.table_quant_type == "uint8_minmax") {
+    // Every float of a quantized row packs four uint8 values, the leading two
+    // floats are the min/max of the row.
+    row_width = (table_dims[1] - 2) * 4;
+  }
+  int64_t bag_num = static_cast<int64_t>(lod.back().size()) - 1;
+  param_.Out->Resize({bag_num, row_width});
+
+  LoD out_lod;
+  if (lod.size() == 2) {
+    out_lod.push_back(lod[0]);
+  } else {
+    std::vector<uint64_t> offset(bag_num + 1);
+    for (int64_t i = 0; i <= bag_num; i++) {
+      offset[i] = i;
+    }
+    out_lod.push_back(offset);
+  }
+  param_.Out->set_lod(out_lod);
+  return true;
+}
+
+bool EmbeddingBagOp::AttachImpl(const cpp::OpDesc& op_desc,
+                                lite::Scope* scope) {
+  auto input = op_desc.Input("W").front();
+  auto ids = op_desc.Input("Ids").front();
+  auto out = op_desc.Output("Out").front();
+
+  param_.W = scope->FindTensor(input);
+  param_.Ids = scope->FindTensor(ids);
+  param_.Out = scope->FindMutableTensor(out);
+
+  if (op_desc.HasAttr("padding_idx")) {
+    param_.padding_idx = op_desc.GetAttr<int64_t>("padding_idx");
+  }
+  param_.pool_type = op_desc.GetAttr<std::string>("pooltype");
+  if (op_desc.HasAttr("pad_value")) {
+    param_.pad_value = op_desc.GetAttr<float>("pad_value");
+  }
+  if (op_desc.HasAttr("table_quant_type")) {
+    param_.table_quant_type = op_desc.GetAttr<std::string>("table_quant_type");
+  }
+  if (op_desc.HasAttr("half_weight_type")) {
+    param_.half_weight_type = op_desc.GetAttr<std::string>("half_weight_type");
+  }
+  return true;
+}
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_OP(embedding_bag, paddle::lite::operators::EmbeddingBagOp);
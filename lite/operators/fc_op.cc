@@ -102,6 +102,13 @@ bool FcOpLite::AttachImpl(const cpp::OpDesc& op_desc, lite::Scope* scope) {
   if (op_desc.HasAttr("activation_type")) {
     param_.activation_type = op_desc.GetAttr<std::string>("activation_type");
   }
+  if (op_desc.HasAttr("enable_dynamic_quant")) {
+    param_.enable_dynamic_quant = op_desc.GetAttr<bool>("enable_dynamic_quant");
+  }
+  if (op_desc.HasAttr("half_weight_type")) {
+    param_.half_weight_type =
+        op_desc.GetAttr<std::string>("half_weight_type");
+  }
   if (op_desc.HasAttr("padding_weights")) {
     param_.padding_weights = op_desc.GetAttr<bool>("padding_weights");
   } else {
@@ -0,0 +1,148 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/operators/fused_elementwise_op.h"
+#include <algorithm>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+bool FusedElementwiseOp::CheckShape() const {
+  CHECK_OR_FALSE(!param_.X.empty())
+  CHECK_OR_FALSE(param_.Out)
+  const size_t num = param_.op_types.size();
+  CHECK_GT_OR_FALSE(num, 0UL)
+  CHECK_EQ_OR_FALSE(param_.op_inputs.size(), num)
+  CHECK_EQ_OR_FALSE(param_.op_axes.size(), num)
+  CHECK_EQ_OR_FALSE(param_.op_params.size(), num * 3)
+  for (auto input : param_.op_inputs) {
+    CHECK_GT_OR_FALSE(static_cast<int>(param_.X.size()), input)
+  }
+  return true;
+}
+
+bool FusedElementwiseOp::InferShapeImpl() const {
+  const int num_x = static_cast<int>(param_.X.size());
+  // Every X[j] covers the output dims [offset[j], offset[j] + rank of X[j]),
+  // binary ops broadcast like the elementwise ops with their axis.
+  std::vector<int64_t> out_dims = param_.X[0]->dims().Vectorize();
+  std::vector<int> offset(num_x, 0);
+  for (size_t i = 0; i < param_.op_inputs.size(); i++) {
+    const int input = param_.op_inputs[i];
+    if (input < 0) continue;
+    const auto y_dims = param_.X[input]->dims().Vectorize();
+    const int x_rank = static_cast<int>(out_dims.size());
+    const int y_rank = static_cast<int>(y_dims.size());
+    int axis = param_.op_axes[i];
+    std::vector<int64_t> big = out_dims;
+    std::vector<int64_t> small = y_dims;
+    if (x_rank < y_rank) {
+      std::swap(big, small);
+    }
+    axis = axis < 0 ? static_cast<int>(big.size() - small.size()) : axis;
+    CHECK_LE(axis + small.size(), big.size())
+        << "fused_elementwise: invalid broadcast axis " << param_.op_axes[i];
+    for (size_t k = 0; k < small.size(); k++) {
+      int64_t& d = big[axis + k];
+      CHECK(d == small[k] || d == 1 || small[k] == 1)
+          << "fused_elementwise: dims mismatch at " << param_.op_types[i];
+      d = std::max(d, small[k]);
+    }
+    if (x_rank < y_rank) {
+      // The accumulator is placed into the larger operand.
+      for (int j = 0; j < num_x; j++) {
+        if (j != input) offset[j] += axis;
+      }
+      offset[input] = 0;
+    } else {
+      offset[input] = axis;
+    }
+    out_dims = big;
+  }
+  param_.Out->Resize(out_dims);
+  param_.Out->set_lod(param_.X[0]->lod());
+
+  // Strides of every X along the output dims, then merge the adjacent dims
+  // along which all the inputs are either contiguous or broadcast.
+  const int rank = static_cast<int>(out_dims.size());
+  std::vector<std::vector<int64_t>> strides(num_x,
+                                            std::vector<int64_t>(rank, 0));
+  for (int j = 0; j < num_x; j++) {
+    const auto x_dims = param_.X[j]->dims().Vectorize();
+    int64_t stride = 1;
+    for (int k = static_cast<int>(x_dims.size()) - 1; k >= 0; k--) {
+      if (x_dims[k] != 1) strides[j][offset[j] + k] = stride;
+      stride *= x_dims[k];
+    }
+  }
+  param_.shape.clear();
+  param_.x_strides.assign(num_x, std::vector<int64_t>());
+  for (int d = 0; d < rank; d++) {
+    if (out_dims[d] == 1) continue;
+    bool merge = !param_.shape.empty();
+    for (int j = 0; j < num_x && merge; j++) {
+      int64_t inner = param_.x_strides[j].back();
+      merge = (inner == 0 && strides[j][d] == 0) ||
+              (inner != 0 && inner == strides[j][d] * out_dims[d]);
+    }
+    if (merge) {
+      param_.shape.back() *= out_dims[d];
+      for (int j = 0; j < num_x; j++) {
+        param_.x_strides[j].back() = strides[j][d];
+      }
+    } else {
+      param_.shape.push_back(out_dims[d]);
+      for (int j = 0; j < num_x; j++) {
+        param_.x_strides[j].push_back(strides[j][d]);
+      }
+    }
+  }
+  if (param_.shape.empty()) {
+    param_.shape.push_back(1);
+    for (int j = 0; j < num_x; j++) {
+      param_.x_strides[j].push_back(0);
+    }
+  }
+  return true;
+}
+
+bool FusedElementwiseOp::AttachImpl(const cpp::OpDesc& op_desc,
+                                    lite::Scope* scope) {
+  param_.X.clear();
+  input_tensor_ptrs_cache_.clear();
+  for (auto& name : op_desc.Input("X")) {
+    auto* x = scope->FindMutableTensor(name);
+    CHECK(x) << "fused_elementwise: input " << name << " not found";
+    param_.X.push_back(x);
+    input_tensor_ptrs_cache_.push_back(x);
+  }
+  param_.Out = scope->FindMutableTensor(op_desc.Output("Out").front());
+  output_tensor_ptrs_cache_.clear();
+  output_tensor_ptrs_cache_.push_back(param_.Out);
+
+  param_.op_types = op_desc.GetAttr<std::vector<std::string>>("fused_op_types");
+  param_.op_inputs = op_desc.GetAttr<std::vector<int>>("fused_op_inputs");
+  param_.op_axes = op_desc.GetAttr<std::vector<int>>("fused_op_axes");
+  param_.op_params = op_desc.GetAttr<std::vector<float>>("fused_op_params");
+  return true;
+}
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_OP(fused_elementwise,
+                 paddle::lite::operators::FusedElementwiseOp);
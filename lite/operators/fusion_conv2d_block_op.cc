@@ -0,0 +1,108 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "lite/operators/fusion_conv2d_block_op.h"
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+inline int BlockPoolOutputSize(
+    int input_size, int ksize, int pad_begin, int pad_end, int stride) {
+  return (input_size - ksize + pad_begin + pad_end) / stride + 1;
+}
+
+bool FusionConv2dBlockOp::CheckShape() const {
+  CHECK_OR_FALSE(ConvOpLite::CheckShape())
+  CHECK_EQ_OR_FALSE(param_.x->dims().size(), 4UL)
+  CHECK_EQ_OR_FALSE(param_.groups, 1)
+  if (!param_.block_pool_type.empty()) {
+    CHECK_EQ_OR_FALSE(param_.block_pool_ksize.size(), 2UL)
+    CHECK_EQ_OR_FALSE(param_.block_pool_strides.size(), 2UL)
+    CHECK_EQ_OR_FALSE(param_.block_pool_paddings.size(), 4UL)
+  }
+  return true;
+}
+
+bool FusionConv2dBlockOp::InferShapeImpl() const {
+  // The output holds the conv dims first, the pooling shrinks them.
+  CHECK(ConvOpLite::InferShapeImpl());
+  auto conv_dims = param_.output->dims();
+  if (param_.residualData) {
+    // The residual is broadcast to the conv output like the smaller operand
+    // of elementwise_add, it can not grow the output.
+    auto residual_dims = param_.residualData->dims();
+    CHECK(BlockResidualBroadcasts(
+        residual_dims, conv_dims, param_.residual_axis))
+        << "fusion_conv2d_block: the residual dims " << residual_dims
+        << " do not broadcast to the conv output dims " << conv_dims;
+  }
+  if (param_.block_pool_type.empty()) return true;
+
+  std::vector<int64_t> out_dims{conv_dims[0], conv_dims[1], 1, 1};
+  if (!param_.block_pool_global) {
+    auto& ksize = param_.block_pool_ksize;
+    auto& strides = param_.block_pool_strides;
+    auto& paddings = param_.block_pool_paddings;
+    for (int i = 0; i < 2; i++) {
+      out_dims[i + 2] = BlockPoolOutputSize(conv_dims[i + 2],
+                                            ksize[i],
+                                            paddings[2 * i],
+                                            paddings[2 * i + 1],
+                                            strides[i]);
+    }
+  }
+  param_.output->Resize(out_dims);
+  return true;
+}
+
+bool FusionConv2dBlockOp::AttachImpl(const cpp::OpDesc &op_desc,
+                                     lite::Scope *scope) {
+  ConvOpLite::AttachImpl(op_desc, scope);
+  if (op_desc.HasAttr("residual_axis")) {
+    param_.residual_axis = op_desc.GetAttr<int>("residual_axis");
+  }
+  if (op_desc.HasAttr("residual_relu")) {
+    param_.residual_relu = op_desc.GetAttr<bool>("residual_relu");
+  }
+  if (op_desc.HasAttr("pool_type")) {
+    param_.block_pool_type = op_desc.GetAttr<std::string>("pool_type");
+  }
+  if (param_.block_pool_type.empty()) return true;
+  CHECK(param_.block_pool_type == "max" || param_.block_pool_type == "avg")
+      << "fusion_conv2d_block: unsupported pooling "
+      << param_.block_pool_type;
+  param_.block_pool_ksize = op_desc.GetAttr<std::vector<int>>("pool_ksize");
+  param_.block_pool_strides =
+      op_desc.GetAttr<std::vector<int>>("pool_strides");
+  auto paddings = op_desc.GetAttr<std::vector<int>>("pool_paddings");
+  // 2-pad to 4-pad
+  if (paddings.size() == 2L) {
+    paddings = {paddings[0], paddings[0], paddings[1], paddings[1]};
+  }
+  param_.block_pool_paddings = paddings;
+  param_.block_pool_global = op_desc.GetAttr<bool>("pool_global");
+  param_.block_pool_exclusive = op_desc.GetAttr<bool>("pool_exclusive");
+  return true;
+}
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_OP(fusion_conv2d_block,
+                 paddle::lite::operators::FusionConv2dBlockOp);
@@ -0,0 +1,60 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+#include <string>
+#include "lite/operators/conv_op.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+// The first conv output dim the residual of rank `rank` lines up with, as
+// elementwise_add aligns its smaller operand.
+inline int BlockResidualStart(int rank, int axis) {
+  return axis == -1 || rank == 4 ? 4 - rank : axis;
+}
+
+// Whether the residual broadcasts to the 4-D conv output without growing it.
+inline bool BlockResidualBroadcasts(const DDim &residual_dims,
+                                    const DDim &conv_dims,
+                                    int axis) {
+  const int rank = static_cast<int>(residual_dims.size());
+  const int start = BlockResidualStart(rank, axis);
+  if (conv_dims.size() != 4UL || start < 0 || start + rank > 4) return false;
+  for (int i = 0; i < rank; i++) {
+    if (residual_dims[i] != 1 && residual_dims[i] != conv_dims[start + i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// conv2d -> bias -> act -> (residual add) -> (relu) -> (pool2d), collected
+// by lite_conv_block_fuse_pass and computed tile by tile.
+class FusionConv2dBlockOp : public ConvOpLite {
+ public:
+  FusionConv2dBlockOp() {}
+  explicit FusionConv2dBlockOp(const std::string &type) : ConvOpLite(type) {}
+
+  bool CheckShape() const override;
+  bool InferShapeImpl() const override;
+  bool AttachImpl(const cpp::OpDesc &opdesc, lite::Scope *scope) override;
+  std::string DebugString() const override { return "fusion_conv2d_block"; }
+};
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
@@ -69,6 +69,10 @@ bool LookupTableOpLite::AttachImpl(const cpp::OpDesc& op_desc,
   if (op_desc.HasAttr("entry")) {
     param_.entry = op_desc.GetAttr<std::string>("entry");
   }
+  if (op_desc.HasAttr("half_weight_type")) {
+    param_.half_weight_type =
+        op_desc.GetAttr<std::string>("half_weight_type");
+  }
 
   return true;
 }
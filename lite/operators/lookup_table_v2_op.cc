@@ -57,6 +57,10 @@ bool LookupTableV2OpLite::AttachImpl(const cpp::OpDesc &op_desc,
   param_.Out = scope->FindMutableTensor(out);
 
   param_.padding_idx = op_desc.GetAttr<int64_t>("padding_idx");
+  if (op_desc.HasAttr("half_weight_type")) {
+    param_.half_weight_type =
+        op_desc.GetAttr<std::string>("half_weight_type");
+  }
 
   return true;
 }
@@ -150,6 +150,13 @@ bool MatMulOpLite::AttachImpl(const cpp::OpDesc &op_desc, lite::Scope *scope) {
   param_.transpose_X = op_desc.GetAttr<bool>("transpose_X");
   param_.transpose_Y = op_desc.GetAttr<bool>("transpose_Y");
   param_.alpha = op_desc.GetAttr<float>("alpha");
+  if (op_desc.HasAttr("enable_dynamic_quant")) {
+    param_.enable_dynamic_quant = op_desc.GetAttr<bool>("enable_dynamic_quant");
+  }
+  if (op_desc.HasAttr("half_weight_type")) {
+    param_.half_weight_type =
+        op_desc.GetAttr<std::string>("half_weight_type");
+  }
   input_tensor_ptrs_cache_.push_back(param_.X);
   input_tensor_ptrs_cache_.push_back(param_.Y);
   output_tensor_ptrs_cache_.push_back(param_.Out);
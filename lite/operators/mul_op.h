@@ -58,6 +58,14 @@ class MulOpLite : public OpLite {
     param_.output = var->GetMutable<Tensor>();
     param_.x_num_col_dims = op_desc.GetAttr<int>("x_num_col_dims");
     param_.y_num_col_dims = op_desc.GetAttr<int>("y_num_col_dims");
+    if (op_desc.HasAttr("enable_dynamic_quant")) {
+      param_.enable_dynamic_quant =
+          op_desc.GetAttr<bool>("enable_dynamic_quant");
+    }
+    if (op_desc.HasAttr("half_weight_type")) {
+      param_.half_weight_type =
+          op_desc.GetAttr<std::string>("half_weight_type");
+    }
 
     const OpInfo *op_info = static_cast<const OpInfo *>(&op_desc);
     if (op_info != nullptr && op_info->HasAttr("enable_int8")) {
@@ -105,6 +105,10 @@ struct FcParam : ParamBase {
   bool padding_weights{false};
   std::string Prelu_mode{
       "channel"};  // prelu param, can be "all", "channel" or "element"
+  // quantize the input at runtime, see QuantType::QUANT_INT8_DYNAMIC
+  bool enable_dynamic_quant{false};
+  // fp16/bf16 weight bits, see QuantType::QUANT_FP16
+  std::string half_weight_type{};
   // for int8
   WITH_INT8_CONFIG
 };
@@ -144,6 +148,10 @@ struct MulParam : ParamBase {
 
   int x_num_col_dims{1};
   int y_num_col_dims{1};
+  // quantize the input at runtime, see QuantType::QUANT_INT8_DYNAMIC
+  bool enable_dynamic_quant{false};
+  // fp16/bf16 weight bits, see QuantType::QUANT_FP16
+  std::string half_weight_type{};
   // for int8
   WITH_INT8_CONFIG
 };
@@ -340,6 +348,9 @@ struct SparseConvParam : ParamBase {
   lite::Tensor* output{};
   int first_ic{0};
   int flag_semi{0};
+  // x86 only: the diffs hold plain input channel indices of the non-zero
+  // blocks of `block_size` output channels, see x86/math/sparse_spmm.h
+  int block_size{1};
   std::vector<int> strides{1, 1};
   std::shared_ptr<std::vector<int>> paddings;
   int groups{1};
@@ -354,6 +365,22 @@ struct SparseConvParam : ParamBase {
   int bit_length{8};
 };
 
+// For Sparse fc op, the weight is compressed by sparse_conv_detect_pass from
+// the [K x N] weight of fc/matmul, see x86/math/sparse_spmm.h
+struct SparseFcParam : ParamBase {
+  const lite::Tensor* input{};
+  const lite::Tensor* nonzero_weights{};
+  // the number of non-zero blocks up to the end of each output feature
+  const lite::Tensor* oc_nonzeros{};
+  // the input feature index of each non-zero block
+  const lite::Tensor* diffs{};
+  const lite::Tensor* bias{nullptr};
+  lite::Tensor* output{};
+  int in_num_col_dims{1};
+  int block_size{1};
+  ActivationParam activation_param;
+};
+
 // For Convolution op
 struct ConvParam : ParamBase {
   lite::Tensor* x{};
@@ -420,6 +447,17 @@ struct ConvParam : ParamBase {
   WITH_INT8_CONFIG
   // for Conv2d+Scale fusion
   std::string scale_activation_type{""};
+  // for fusion_conv2d_block: the axis of the residual add, relu after it
+  // and the trailing pool2d, block_pool_type is "" when the block has no
+  // pooling
+  int residual_axis{-1};
+  bool residual_relu{false};
+  std::string block_pool_type{""};
+  std::vector<int> block_pool_ksize;
+  std::vector<int> block_pool_strides;
+  std::vector<int> block_pool_paddings;
+  bool block_pool_global{false};
+  bool block_pool_exclusive{true};
 };
 
 // For BatchNorm op
@@ -565,6 +603,24 @@ struct FusionElementwiseActivationGradParam : public ElementwiseGradParam {
   std::string act_type;
 };
 
+struct FusedElementwiseParam : ParamBase {
+  // X[0] seeds the accumulator, the other inputs are the second operands
+  std::vector<const lite::Tensor*> X{};
+  lite::Tensor* Out{};
+  // One entry per fused op: its name, the index in X of its second operand
+  // (-1 for unary ops), the broadcast axis of that operand and three
+  // constants, see host::math::FusedElementwiseOpcode.
+  std::vector<std::string> op_types{};
+  std::vector<int> op_inputs{};
+  std::vector<int> op_axes{};
+  std::vector<float> op_params{};
+  // Set by InferShape: the output dims with the adjacent dims sharing the
+  // same broadcast pattern merged and the strides of every X along them,
+  // 0 for broadcast dims.
+  std::vector<int64_t> shape{};
+  std::vector<std::vector<int64_t>> x_strides{};
+};
+
 /// ----------------------- mean operators ----------------------
 struct MeanParam : ParamBase {
   const lite::Tensor* X{};
@@ -957,6 +1013,8 @@ struct LookupTableParam : ParamBase {
   bool is_test{true};
   std::string entry_config{""};  // used in distributed training
   std::string entry{"none"};
+  // fp16/bf16 weight bits, see QuantType::QUANT_FP16
+  std::string half_weight_type{};
 };
 
 struct LookupTableDequantParam : ParamBase {
@@ -966,6 +1024,20 @@ struct LookupTableDequantParam : ParamBase {
   int64_t padding_idx{-1};
 };
 
+// Fused lookup_table(_v2/_dequant) + sequence_pool(SUM/AVERAGE/SQRT)
+struct EmbeddingBagParam : ParamBase {
+  const lite::Tensor* W{nullptr};
+  const lite::Tensor* Ids{nullptr};
+  lite::Tensor* Out{nullptr};
+  int64_t padding_idx{-1};
+  std::string pool_type{"SUM"};
+  float pad_value{0.0f};
+  // "none": fp32 or fp16 table, "uint8_minmax": lookup_table_dequant layout
+  std::string table_quant_type{"none"};
+  // fp16/bf16 table bits, see QuantType::QUANT_FP16
+  std::string half_weight_type{};
+};
+
 struct Im2SequenceParam : ParamBase {
   const lite::Tensor* X{};
   const lite::Tensor* Y{};
@@ -1377,6 +1449,10 @@ struct MatMulParam : ParamBase {
   bool transpose_X{false};
   bool transpose_Y{false};
   float alpha{1.0f};
+  // quantize X at runtime, see QuantType::QUANT_INT8_DYNAMIC
+  bool enable_dynamic_quant{false};
+  // fp16/bf16 weight bits, see QuantType::QUANT_FP16
+  std::string half_weight_type{};
   WITH_INT8_CONFIG
 };
 
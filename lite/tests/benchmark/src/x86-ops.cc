@@ -0,0 +1,882 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Micro benchmarks of the x86 and host kernels.
+//
+//   ./x86-ops-bench [--benchmark_filter=...] [--threads=N]
+//     runs the built-in shape sets and reports FLOPS and bytes_per_second.
+//
+//   ./x86-ops-bench --ops_path=ops.txt
+//       --latency_lookup_table_path=latency_lookup_table.txt
+//     measures every line of ops.txt and writes the latency lookup table in
+//     the format of get_latency_lookup_table.py.
+
+#include <benchmark/benchmark.h>
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "lite/tests/benchmark/src/convolution_configs.h"
+#include "lite/tests/benchmark/src/gemm_configs.h"
+
+#include "lite/backends/x86/parallel.h"
+#include "lite/core/context.h"
+#include "lite/core/profile/timer.h"
+#include "lite/core/tensor.h"
+#include "lite/kernels/host/multiclass_nms_compute.h"
+#include "lite/kernels/host/topk_compute.h"
+#include "lite/kernels/x86/activation_compute.h"
+#include "lite/kernels/x86/batch_norm_compute.h"
+#include "lite/kernels/x86/conv_compute.h"
+#include "lite/kernels/x86/elementwise_compute.h"
+#include "lite/kernels/x86/fc_compute.h"
+#include "lite/kernels/x86/layer_norm_compute.h"
+#include "lite/kernels/x86/matmul_compute.h"
+#include "lite/kernels/x86/pool_compute.h"
+#include "lite/kernels/x86/softmax_compute.h"
+#include "lite/kernels/x86/transpose_compute.h"
+#include "lite/operators/op_params.h"
+#include "lite/tests/utils/tensor_utils.h"
+
+DEFINE_int32(threads, 1, "Number of math threads of the x86 kernels.");
+DEFINE_string(ops_path,
+              "",
+              "Measure the ops of this file instead of the built-in shapes.");
+DEFINE_string(latency_lookup_table_path,
+              "latency_lookup_table.txt",
+              "Output of --ops_path.");
+DEFINE_int32(warmup_times, 5, "Warmup runs of every op of --ops_path.");
+DEFINE_int32(repeats_times, 100, "Timed runs of every op of --ops_path.");
+
+namespace {
+
+using paddle::lite::DDim;
+using paddle::lite::KernelBase;
+using paddle::lite::KernelContext;
+using paddle::lite::Tensor;
+namespace operators = paddle::lite::operators;
+namespace host = paddle::lite::kernels::host;
+namespace x86 = paddle::lite::kernels::x86;
+
+// A kernel ready to Launch() together with the tensors it uses, the work of
+// one run is used for the FLOPS and bytes_per_second counters. `bytes` only
+// counts the compulsory traffic: every input read and every output written
+// once.
+struct OpCase {
+  std::unique_ptr<KernelBase> kernel;
+  std::vector<std::unique_ptr<Tensor>> tensors;
+  DDim output_dims;
+  double flops{0.};
+  double bytes{0.};
+
+  // Float tensor filled with values in [-1, 1], counted in `bytes`.
+  Tensor* Input(const DDim& dims) {
+    Tensor* t = NewTensor(dims);
+    paddle::lite::fill_tensor_rand(*t, -1.f, 1.f);
+    bytes += t->numel() * sizeof(float);
+    return t;
+  }
+
+  Tensor* Output(const DDim& dims) {
+    Tensor* t = NewTensor(dims);
+    t->mutable_data<float>();
+    bytes += t->numel() * sizeof(float);
+    if (output_dims.empty()) output_dims = dims;
+    return t;
+  }
+
+  Tensor* NewTensor(const DDim& dims) {
+    tensors.emplace_back(new Tensor);
+    tensors.back()->Resize(dims);
+    tensors.back()->set_precision(PRECISION(kFloat));
+    return tensors.back().get();
+  }
+
+  template <typename KernelT, typename ContextT, typename ParamT>
+  void Init(KernelT* k, const ParamT& param) {
+    std::unique_ptr<KernelContext> ctx(new KernelContext);
+    ctx->As<ContextT>();
+    k->SetParam(param);
+    k->SetContext(std::move(ctx));
+    kernel.reset(k);
+  }
+};
+
+typedef std::unique_ptr<OpCase> OpCasePtr;
+
+// Input [m, k] times weight [k, n].
+OpCasePtr MakeGemm(int m, int n, int k) {
+  OpCasePtr c(new OpCase);
+  operators::MatMulParam param;
+  param.X = c->Input(DDim({m, k}));
+  param.Y = c->Input(DDim({k, n}));
+  param.Out = c->Output(DDim({m, n}));
+  c->flops = 2. * m * n * k;
+  c->Init<x86::MatMulCompute<float>, paddle::lite::X86Context>(
+      new x86::MatMulCompute<float>, param);
+  return c;
+}
+
+OpCasePtr MakeFc(int m, int n, int k, bool bias) {
+  OpCasePtr c(new OpCase);
+  operators::FcParam param;
+  param.input = c->Input(DDim({m, k}));
+  param.w = c->Input(DDim({k, n}));
+  param.bias = bias ? c->Input(DDim({1, n})) : nullptr;
+  param.output = c->Output(DDim({m, n}));
+  param.in_num_col_dims = 1;
+  param.in_mat_dims = param.input->dims();
+  c->flops = 2. * m * n * k;
+  typedef x86::FcCompute<PRECISION(kFloat), PRECISION(kFloat)> Kernel;
+  c->Init<Kernel, paddle::lite::X86Context>(new Kernel, param);
+  return c;
+}
+
+// pads are top, bottom, left, right. flag_act: 0 none, 1 relu, 2 relu6,
+// 4 leaky_relu.
+OpCasePtr MakeConv(const DDim& in,
+                   int ch_out,
+                   int group,
+                   int kernel_h,
+                   int kernel_w,
+                   const std::vector<int>& strides,
+                   const std::vector<int>& pads,
+                   const std::vector<int>& dilations,
+                   bool bias,
+                   int flag_act) {
+  OpCasePtr c(new OpCase);
+  const int ch_in = in[1];
+  const int h_out = (in[2] + pads[0] + pads[1] -
+                     (dilations[0] * (kernel_h - 1) + 1)) /
+                        strides[0] +
+                    1;
+  const int w_out = (in[3] + pads[2] + pads[3] -
+                     (dilations[1] * (kernel_w - 1) + 1)) /
+                        strides[1] +
+                    1;
+  operators::ConvParam param;
+  param.x = c->Input(in);
+  param.filter = c->Input(DDim({ch_out, ch_in / group, kernel_h, kernel_w}));
+  param.bias = bias ? c->Input(DDim({ch_out})) : nullptr;
+  param.output = c->Output(DDim({in[0], ch_out, h_out, w_out}));
+  param.strides = strides;
+  param.paddings = std::make_shared<std::vector<int>>(pads);
+  param.dilations = std::make_shared<std::vector<int>>(dilations);
+  param.groups = group;
+  if (flag_act > 0) {
+    param.activation_param.has_active = true;
+    param.activation_param.active_type =
+        static_cast<paddle::lite_api::ActivationType>(flag_act);
+    param.activation_param.Relu_clipped_coef = 6.f;
+    param.activation_param.Leaky_relu_alpha = 0.1f;
+    param.fuse_relu = flag_act == 1;
+  }
+  c->flops = 2. * in[0] * ch_out * h_out * w_out * (ch_in / group) *
+             kernel_h * kernel_w;
+  typedef x86::Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)> Kernel;
+  c->Init<Kernel, paddle::lite::X86Context>(new Kernel, param);
+  return c;
+}
+
+// A kernel size of 0 means global pooling.
+OpCasePtr MakePool(const DDim& in,
+                   int kernel,
+                   int stride,
+                   const std::vector<int>& pads,
+                   const std::string& pooling_type,
+                   bool exclusive,
+                   bool ceil_mode) {
+  OpCasePtr c(new OpCase);
+  const bool global = kernel == 0;
+  int h_out = 1;
+  int w_out = 1;
+  if (!global) {
+    const int round = ceil_mode ? stride - 1 : 0;
+    h_out = (in[2] - kernel + pads[0] + pads[1] + round) / stride + 1;
+    w_out = (in[3] - kernel + pads[2] + pads[3] + round) / stride + 1;
+  }
+  operators::PoolParam param;
+  param.x = c->Input(in);
+  param.output = c->Output(DDim({in[0], in[1], h_out, w_out}));
+  param.pooling_type = pooling_type;
+  param.global_pooling = global;
+  param.ksize = global ? std::vector<int>{static_cast<int>(in[2]),
+                                          static_cast<int>(in[3])}
+                       : std::vector<int>{kernel, kernel};
+  param.strides = {stride, stride};
+  param.paddings = std::make_shared<std::vector<int>>(pads);
+  param.exclusive = exclusive;
+  param.ceil_mode = ceil_mode;
+  c->flops = static_cast<double>(in[0]) * in[1] * h_out * w_out *
+             param.ksize[0] * param.ksize[1];
+  c->Init<x86::PoolCompute<float>, paddle::lite::X86Context>(
+      new x86::PoolCompute<float>, param);
+  return c;
+}
+
+// act_type follows lite_api::ActivationType: 1 relu, 2 relu6,
+// 4 leaky_relu, 5 sigmoid, 6 tanh.
+OpCasePtr MakeActivation(const DDim& in, int act_type) {
+  OpCasePtr c(new OpCase);
+  operators::ActivationParam param;
+  param.X = c->Input(in);
+  param.Out = c->Output(in);
+  param.threshold = 6.f;
+  param.Leaky_relu_alpha = 0.1f;
+  c->flops = in.production();
+  switch (act_type) {
+    case 1:
+      c->Init<x86::ReluCompute<float>, paddle::lite::X86Context>(
+          new x86::ReluCompute<float>, param);
+      break;
+    case 2:
+      c->Init<x86::Relu6Compute<float>, paddle::lite::X86Context>(
+          new x86::Relu6Compute<float>, param);
+      break;
+    case 4:
+      c->Init<x86::LeakyReluCompute<float>, paddle::lite::X86Context>(
+          new x86::LeakyReluCompute<float>, param);
+      break;
+    case 5:
+      c->Init<x86::SigmoidCompute<float>, paddle::lite::X86Context>(
+          new x86::SigmoidCompute<float>, param);
+      break;
+    case 6:
+      c->Init<x86::TanhCompute<float>, paddle::lite::X86Context>(
+          new x86::TanhCompute<float>, param);
+      break;
+    default:
+      return nullptr;
+  }
+  return c;
+}
+
+OpCasePtr MakeBatchNorm(const DDim& in, float epsilon, float momentum) {
+  OpCasePtr c(new OpCase);
+  const DDim channel({in[1]});
+  operators::BatchNormParam param;
+  param.x = c->Input(in);
+  param.scale = c->Input(channel);
+  param.bias = c->Input(channel);
+  param.mean = c->Input(channel);
+  param.variance = c->Input(channel);
+  // Keep the variance positive.
+  float* var = param.variance->mutable_data<float>();
+  for (int i = 0; i < in[1]; ++i) var[i] = var[i] * var[i] + 0.5f;
+  param.y = c->Output(in);
+  param.mean_out = c->NewTensor(channel);
+  param.variance_out = c->NewTensor(channel);
+  param.saved_mean = c->NewTensor(channel);
+  param.saved_variance = c->NewTensor(channel);
+  param.is_test = true;
+  param.use_global_stats = true;
+  param.epsilon = epsilon;
+  param.momentum = momentum;
+  c->flops = 2. * in.production();
+  c->Init<x86::BatchNormCompute<float>, paddle::lite::X86Context>(
+      new x86::BatchNormCompute<float>, param);
+  return c;
+}
+
+OpCasePtr MakeSoftmax(const DDim& in, int axis) {
+  OpCasePtr c(new OpCase);
+  operators::SoftmaxParam param;
+  param.x = c->Input(in);
+  param.output = c->Output(in);
+  param.axis = axis;
+  // max, sub, exp, sum and scale.
+  c->flops = 5. * in.production();
+  c->Init<x86::SoftmaxCompute<float>, paddle::lite::X86Context>(
+      new x86::SoftmaxCompute<float>, param);
+  return c;
+}
+
+OpCasePtr MakeLayerNorm(const DDim& in, int begin_norm_axis, float epsilon) {
+  OpCasePtr c(new OpCase);
+  const int64_t left = in.Slice(0, begin_norm_axis).production();
+  const int64_t right = in.production() / left;
+  operators::LayerNormParam param;
+  param.X = c->Input(in);
+  param.Scale = c->Input(DDim({right}));
+  param.Bias = c->Input(DDim({right}));
+  param.Y = c->Output(in);
+  param.Mean = c->NewTensor(DDim({left}));
+  param.Variance = c->NewTensor(DDim({left}));
+  param.begin_norm_axis = begin_norm_axis;
+  param.epsilon = epsilon;
+  // mean, variance, normalize and the affine transform.
+  c->flops = 6. * in.production();
+  c->Init<x86::LayerNormCompute<float>, paddle::lite::X86Context>(
+      new x86::LayerNormCompute<float>, param);
+  return c;
+}
+
+OpCasePtr MakeTranspose(const DDim& in, const std::vector<int>& axis) {
+  OpCasePtr c(new OpCase);
+  std::vector<int64_t> out(axis.size());
+  for (size_t i = 0; i < axis.size(); ++i) out[i] = in[axis[i]];
+  operators::TransposeParam param;
+  param.x = c->Input(in);
+  param.output = c->Output(DDim(out));
+  param.axis = axis;
+  c->Init<x86::TransposeCompute<float>, paddle::lite::X86Context>(
+      new x86::TransposeCompute<float>, param);
+  return c;
+}
+
+// Out = X + Y with Y broadcast from `axis` as the elementwise ops do.
+OpCasePtr MakeElementwiseAdd(const DDim& x, const DDim& y, int axis) {
+  OpCasePtr c(new OpCase);
+  operators::ElementwiseParam param;
+  param.X = c->Input(x);
+  param.Y = c->Input(y);
+  param.Out = c->Output(x);
+  param.axis = axis;
+  c->flops = x.production();
+  c->Init<x86::ElementwiseAddCompute<float>, paddle::lite::X86Context>(
+      new x86::ElementwiseAddCompute<float>, param);
+  return c;
+}
+
+// scores [batch, classes, boxes] of random boxes [batch, boxes, 4].
+OpCasePtr MakeMulticlassNms(const DDim& scores,
+                            int nms_top_k,
+                            int keep_top_k,
+                            float score_threshold,
+                            float nms_threshold) {
+  OpCasePtr c(new OpCase);
+  const int64_t batch = scores[0];
+  const int64_t boxes = scores[2];
+  operators::MulticlassNmsParam param;
+  Tensor* bboxes = c->Input(DDim({batch, boxes, 4}));
+  float* b = bboxes->mutable_data<float>();
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<float> coord(0.f, 0.9f);
+  std::uniform_real_distribution<float> size(0.01f, 0.1f);
+  for (int64_t i = 0; i < batch * boxes; ++i) {
+    b[4 * i] = coord(rng);
+    b[4 * i + 1] = coord(rng);
+    b[4 * i + 2] = b[4 * i] + size(rng);
+    b[4 * i + 3] = b[4 * i + 1] + size(rng);
+  }
+  Tensor* s = c->Input(scores);
+  float* sd = s->mutable_data<float>();
+  for (int64_t i = 0; i < s->numel(); ++i) sd[i] = sd[i] * 0.5f + 0.5f;
+  param.bboxes = bboxes;
+  param.scores = s;
+  // The output size depends on the data, it is resized by the kernel.
+  param.out = c->NewTensor(DDim({keep_top_k, 6}));
+  c->output_dims = param.out->dims();
+  param.background_label = 0;
+  param.score_threshold = score_threshold;
+  param.nms_top_k = nms_top_k;
+  param.nms_threshold = nms_threshold;
+  param.keep_top_k = keep_top_k;
+  typedef host::MulticlassNmsCompute<float, TARGET(kHost), PRECISION(kFloat)>
+      Kernel;
+  c->Init<Kernel, paddle::lite::HostContext>(new Kernel, param);
+  return c;
+}
+
+// The k largest values along the last axis.
+OpCasePtr MakeTopk(const DDim& in, int k) {
+  OpCasePtr c(new OpCase);
+  std::vector<int64_t> out = in.Vectorize();
+  out.back() = k;
+  operators::TopkParam param;
+  param.X = c->Input(in);
+  param.Out = c->Output(DDim(out));
+  param.Indices = c->NewTensor(DDim(out));
+  param.Indices->set_precision(PRECISION(kInt64));
+  param.Indices->mutable_data<int64_t>();
+  param.K = k;
+  c->bytes += param.Indices->numel() * sizeof(int64_t);
+  c->Init<host::TopkCompute, paddle::lite::HostContext>(new host::TopkCompute,
+                                                       param);
+  return c;
+}
+
+void RunCase(benchmark::State& state, OpCase* c) {
+  paddle::lite::x86::SetNumThreads(FLAGS_threads);
+  for (int i = 0; i < 2; ++i) {
+    c->kernel->Launch();
+  }
+  for (auto _ : state) {
+    c->kernel->Launch();
+  }
+  if (c->flops > 0.) {
+    state.counters["FLOPS"] = benchmark::Counter(
+        state.iterations() * c->flops, benchmark::Counter::kIsRate);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * c->bytes));
+}
+
+// Built-in shape sets.
+
+void x86_f32_gemm(const benchmark::State& state_in, const char* net) {
+  // const in parameter is used to pass CI system
+  // because google bench mark must work with a `benchmark::State &`
+  // we do a const cast here
+  benchmark::State& state = const_cast<benchmark::State&>(state_in);
+  auto c = MakeGemm(state.range(0), state.range(1), state.range(2));
+  RunCase(state, c.get());
+}
+
+void x86_f32_conv(const benchmark::State& state_in, const char* net) {
+  benchmark::State& state = const_cast<benchmark::State&>(state_in);
+  // The configs give the total padding of each axis.
+  const int pad_h = state.range(5);
+  const int pad_w = state.range(6);
+  const std::vector<int> pads{
+      pad_h / 2, pad_h - pad_h / 2, pad_w / 2, pad_w - pad_w / 2};
+  const int stride = state.range(7);
+  const int dilation = state.range(8);
+  const int groups = state.range(9);
+  auto c = MakeConv(DDim({state.range(0),
+                          groups * state.range(10),
+                          state.range(1),
+                          state.range(2)}),
+                    groups * state.range(11),
+                    groups,
+                    state.range(3),
+                    state.range(4),
+                    {stride, stride},
+                    pads,
+                    {dilation, dilation},
+                    true,
+                    0);
+  RunCase(state, c.get());
+}
+
+BENCHMARK_GEMM(x86_f32_gemm)
+BENCHMARK_CONVOLUTION(x86_f32_conv)
+
+// Depthwise layers of the MobileNets, with and without the fused relu.
+void DepthwiseArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"C", "H", "K", "S", "Act"});
+  for (int act : {0, 1}) {
+    b->Args({32, 112, 3, 1, act});
+    b->Args({64, 112, 3, 2, act});
+    b->Args({128, 56, 3, 1, act});
+    b->Args({256, 28, 3, 2, act});
+    b->Args({512, 14, 3, 1, act});
+    b->Args({1024, 7, 3, 1, act});
+    b->Args({72, 56, 5, 2, act});
+    b->Args({480, 14, 5, 1, act});
+  }
+}
+
+void x86_f32_depthwise(benchmark::State& state) {
+  const int ch = state.range(0);
+  const int hw = state.range(1);
+  const int kernel = state.range(2);
+  const int pad = kernel / 2;
+  auto c = MakeConv(DDim({1, ch, hw, hw}),
+                    ch,
+                    ch,
+                    kernel,
+                    kernel,
+                    {static_cast<int>(state.range(3)),
+                     static_cast<int>(state.range(3))},
+                    {pad, pad, pad, pad},
+                    {1, 1},
+                    true,
+                    state.range(4));
+  RunCase(state, c.get());
+}
+BENCHMARK(x86_f32_depthwise)->Apply(DepthwiseArguments)->UseRealTime();
+
+// Kernel 0 means global pooling, Avg is 0 for max and 1 for avg.
+void PoolArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"C", "H", "K", "S", "P", "Avg"});
+  b->Args({64, 112, 3, 2, 1, 0});
+  b->Args({64, 112, 2, 2, 0, 0});
+  b->Args({256, 56, 2, 2, 0, 1});
+  b->Args({192, 35, 3, 1, 1, 1});
+  b->Args({1024, 7, 0, 1, 0, 1});
+  b->Args({2048, 7, 0, 1, 0, 1});
+}
+
+void x86_f32_pool(benchmark::State& state) {
+  const int pad = state.range(4);
+  auto c = MakePool(
+      DDim({1, state.range(0), state.range(1), state.range(1)}),
+      state.range(2),
+      state.range(3),
+      {pad, pad, pad, pad},
+      state.range(5) ? "avg" : "max",
+      true,
+      false);
+  RunCase(state, c.get());
+}
+BENCHMARK(x86_f32_pool)->Apply(PoolArguments)->UseRealTime();
+
+// Classifier heads and attention scores [batch * heads * seq, seq].
+void RowArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"M", "N"});
+  b->Args({1, 1000});
+  b->Args({32, 1000});
+  b->Args({1, 21841});
+  b->Args({12 * 128, 128});
+  b->Args({12 * 384, 384});
+}
+
+void x86_f32_softmax(benchmark::State& state) {
+  auto c = MakeSoftmax(DDim({state.range(0), state.range(1)}), -1);
+  RunCase(state, c.get());
+}
+BENCHMARK(x86_f32_softmax)->Apply(RowArguments)->UseRealTime();
+
+// Transformer hidden states [tokens, hidden].
+void LayerNormArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"M", "N"});
+  b->Args({1, 768});
+  b->Args({128, 768});
+  b->Args({384, 1024});
+  b->Args({512, 768});
+}
+
+void x86_f32_layer_norm(benchmark::State& state) {
+  auto c = MakeLayerNorm(DDim({state.range(0), state.range(1)}), 1, 1e-5f);
+  RunCase(state, c.get());
+}
+BENCHMARK(x86_f32_layer_norm)->Apply(LayerNormArguments)->UseRealTime();
+
+// Perm 0 is NCHW to NHWC, perm 1 swaps the two middle axes as the
+// attention heads split does.
+void TransposeArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"N", "C", "H", "W", "Perm"});
+  b->Args({1, 64, 112, 112, 0});
+  b->Args({1, 256, 56, 56, 0});
+  b->Args({1, 128, 12, 64, 1});
+  b->Args({8, 128, 12, 64, 1});
+  b->Args({1, 384, 16, 64, 1});
+}
+
+void x86_f32_transpose(benchmark::State& state) {
+  static const std::vector<int> kPerms[] = {{0, 2, 3, 1}, {0, 2, 1, 3}};
+  auto c = MakeTranspose(DDim({state.range(0),
+                               state.range(1),
+                               state.range(2),
+                               state.range(3)}),
+                         kPerms[state.range(4)]);
+  RunCase(state, c.get());
+}
+BENCHMARK(x86_f32_transpose)->Apply(TransposeArguments)->UseRealTime();
+
+// Same shape and per channel (Y is [C]) additions.
+void ElementwiseArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"C", "H", "Bcast"});
+  for (int bcast : {0, 1}) {
+    b->Args({64, 112, bcast});
+    b->Args({256, 56, bcast});
+    b->Args({1024, 14, bcast});
+  }
+}
+
+void x86_f32_elementwise_add(benchmark::State& state) {
+  const DDim x({1, state.range(0), state.range(1), state.range(1)});
+  auto c = MakeElementwiseAdd(
+      x, state.range(2) ? DDim({state.range(0)}) : x, state.range(2) ? 1 : -1);
+  RunCase(state, c.get());
+}
+BENCHMARK(x86_f32_elementwise_add)
+    ->Apply(ElementwiseArguments)
+    ->UseRealTime();
+
+// Detection heads: SSD, YOLO and Faster R-CNN like class and box counts.
+void NmsArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"N", "Classes", "Boxes"});
+  b->Args({1, 21, 1917});
+  b->Args({1, 81, 1000});
+  b->Args({1, 80, 10647});
+  b->Args({8, 21, 1917});
+}
+
+void host_f32_multiclass_nms(benchmark::State& state) {
+  auto c = MakeMulticlassNms(
+      DDim({state.range(0), state.range(1), state.range(2)}),
+      400,
+      200,
+      0.05f,
+      0.45f);
+  RunCase(state, c.get());
+}
+BENCHMARK(host_f32_multiclass_nms)->Apply(NmsArguments)->UseRealTime();
+
+void TopkArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"M", "N", "K"});
+  b->Args({1, 1000, 5});
+  b->Args({32, 1000, 5});
+  b->Args({1, 30522, 50});
+  b->Args({128, 128, 16});
+}
+
+void host_f32_topk(benchmark::State& state) {
+  auto c = MakeTopk(DDim({state.range(0), state.range(1)}), state.range(2));
+  RunCase(state, c.get());
+}
+BENCHMARK(host_f32_topk)->Apply(TopkArguments)->UseRealTime();
+
+// ops.txt support, see the README of this directory for the format.
+
+std::string Trim(const std::string& s) {
+  const char* ws = " \t\r\n";
+  size_t begin = s.find_first_not_of(ws);
+  if (begin == std::string::npos) return "";
+  return s.substr(begin, s.find_last_not_of(ws) - begin + 1);
+}
+
+// "[1 3 224 224]" to {1, 3, 224, 224}.
+std::vector<int> ParseList(const std::string& s) {
+  std::string body = s;
+  std::replace(body.begin(), body.end(), '[', ' ');
+  std::replace(body.begin(), body.end(), ']', ' ');
+  std::replace(body.begin(), body.end(), 'x', ' ');
+  std::stringstream ss(body);
+  std::vector<int> values;
+  int v;
+  while (ss >> v) values.push_back(v);
+  return values;
+}
+
+// One line of ops.txt, the params keep their order for the output.
+struct OpLine {
+  std::string op;
+  std::string input_dims;
+  std::vector<std::pair<std::string, std::string>> params;
+
+  std::string Get(const std::string& key, const std::string& def) const {
+    for (auto& p : params) {
+      if (p.first == key) return p.second;
+    }
+    return def;
+  }
+  int GetInt(const std::string& key, int def) const {
+    return std::atoi(Get(key, std::to_string(def)).c_str());
+  }
+  float GetFloat(const std::string& key, float def) const {
+    return std::atof(Get(key, std::to_string(def)).c_str());
+  }
+  // A list like "[1 1]" where a single value is repeated to `size`.
+  std::vector<int> GetList(const std::string& key, const std::string& def,
+                           size_t size) const {
+    std::vector<int> v = ParseList(Get(key, def));
+    if (v.size() == 1) v.resize(size, v[0]);
+    return v;
+  }
+};
+
+bool ParseOpLine(const std::string& line, OpLine* op) {
+  std::stringstream ss(line);
+  std::string params;
+  std::getline(ss, op->op, '\t');
+  std::getline(ss, op->input_dims, '\t');
+  std::getline(ss, params);
+  op->op = Trim(op->op);
+  op->input_dims = Trim(op->input_dims);
+  if (op->op.empty() || op->input_dims.empty()) return false;
+  params = Trim(params);
+  if (!params.empty() && params.front() == '(') params.erase(0, 1);
+  if (!params.empty() && params.back() == ')') params.pop_back();
+  std::stringstream ps(params);
+  std::string item;
+  while (std::getline(ps, item, ',')) {
+    auto eq = item.find('=');
+    if (eq == std::string::npos) continue;
+    op->params.emplace_back(Trim(item.substr(0, eq)),
+                            Trim(item.substr(eq + 1)));
+  }
+  return true;
+}
+
+const std::map<std::string, int> kActTypes = {{"relu", 1},
+                                              {"relu6", 2},
+                                              {"leaky_relu", 4},
+                                              {"sigmoid", 5},
+                                              {"tanh", 6}};
+
+OpCasePtr MakeOpCase(const OpLine& op) {
+  std::vector<int> in = ParseList(op.input_dims);
+  DDim dims(std::vector<int64_t>(in.begin(), in.end()));
+  if (op.Get("dtype", "float") != "float") return nullptr;
+  if (op.op == "conv" && in.size() == 4) {
+    std::vector<int> kernel = ParseList(op.Get("kernel", "3x3"));
+    if (kernel.size() == 1) kernel.push_back(kernel[0]);
+    return MakeConv(dims,
+                    op.GetInt("ch_out", 1),
+                    op.GetInt("group", 1),
+                    kernel[0],
+                    kernel[1],
+                    op.GetList("stride", "[1 1]", 2),
+                    op.GetList("pad", "[0 0 0 0]", 4),
+                    op.GetList("dilation", "[1 1]", 2),
+                    op.GetInt("flag_bias", 1),
+                    op.GetInt("flag_act", 0));
+  } else if (op.op == "pooling" && in.size() == 4) {
+    const int kernel = op.GetInt("flag_global", 0)
+                           ? 0
+                           : ParseList(op.Get("kernel", "2x2"))[0];
+    return MakePool(dims,
+                    kernel,
+                    op.GetList("stride", "2", 2)[0],
+                    op.GetList("pad", "0", 4),
+                    op.Get("pooling_type", "max"),
+                    op.GetInt("exclusive", 1),
+                    op.GetInt("ceil_mode", 0));
+  } else if (op.op == "fc" && in.size() == 2) {
+    std::vector<int> kn = ParseList(op.Get("param_dim", "1x1"));
+    return MakeFc(in[0], kn[1], in[1], op.GetInt("flag_bias", 1));
+  } else if (op.op == "gemm" && in.size() == 2) {
+    std::vector<int> kn = ParseList(op.Get("param_dim", "1x1"));
+    return MakeGemm(in[0], kn[1], in[1]);
+  } else if (op.op == "activation") {
+    auto act = kActTypes.find(op.Get("act_type", "relu"));
+    if (act == kActTypes.end()) return nullptr;
+    return MakeActivation(dims, act->second);
+  } else if (op.op == "batchnorm" && in.size() == 4) {
+    return MakeBatchNorm(
+        dims, op.GetFloat("epsilon", 1e-4f), op.GetFloat("momentum", 0.9f));
+  } else if (op.op == "softmax") {
+    return MakeSoftmax(dims, op.GetInt("axis", -1));
+  } else if (op.op == "layer_norm") {
+    return MakeLayerNorm(dims,
+                         op.GetInt("begin_norm_axis", 1),
+                         op.GetFloat("epsilon", 1e-5f));
+  } else if (op.op == "transpose") {
+    return MakeTranspose(dims, ParseList(op.Get("axis", "[0 2 3 1]")));
+  } else if (op.op == "elementwise_add") {
+    std::vector<int> y = ParseList(op.Get("y_dims", op.input_dims));
+    return MakeElementwiseAdd(dims,
+                              DDim(std::vector<int64_t>(y.begin(), y.end())),
+                              op.GetInt("axis", -1));
+  } else if (op.op == "multiclass_nms" && in.size() == 3) {
+    return MakeMulticlassNms(dims,
+                             op.GetInt("nms_top_k", 400),
+                             op.GetInt("keep_top_k", 200),
+                             op.GetFloat("score_threshold", 0.05f),
+                             op.GetFloat("nms_threshold", 0.45f));
+  } else if (op.op == "topk") {
+    return MakeTopk(dims, op.GetInt("k", 1));
+  }
+  return nullptr;
+}
+
+std::string DimsString(const DDim& dims) {
+  std::stringstream ss;
+  ss << "[";
+  for (size_t i = 0; i < dims.size(); ++i) {
+    ss << (i ? " " : "") << dims[i];
+  }
+  ss << "]";
+  return ss.str();
+}
+
+std::string CpuModelName() {
+  std::ifstream fs("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(fs, line)) {
+    if (line.compare(0, 10, "model name") == 0) {
+      return Trim(line.substr(line.find(':') + 1));
+    }
+  }
+  return "unknown";
+}
+
+std::string Column(const std::string& s, size_t width) {
+  return s.size() < width ? s + std::string(width - s.size(), ' ') : s;
+}
+
+template <typename T>
+std::string Column(T v, size_t width) {
+  std::stringstream ss;
+  ss << v;
+  return Column(ss.str(), width);
+}
+
+int WriteLatencyLookupTable() {
+  std::ifstream ops(FLAGS_ops_path);
+  if (!ops.is_open()) {
+    std::cerr << "Open ops file " << FLAGS_ops_path << " error." << std::endl;
+    return 1;
+  }
+  std::ofstream table(FLAGS_latency_lookup_table_path);
+  table << Column("dev_info", 30) << "\t" << Column("arch", 10) << "\t"
+        << Column("core_num", 10) << "\t" << Column("thread_num", 10) << "\n";
+  table << Column(CpuModelName(), 30) << "\t" << Column("x86", 10) << "\t"
+        << Column(std::thread::hardware_concurrency(), 10) << "\t"
+        << Column(FLAGS_threads, 10) << "\n";
+  table << Column("op_name", 10) << "\t" << Column("input_dims", 10) << "\t"
+        << Column("output_dims", 10) << "\t" << Column("param_info", 80)
+        << "\t" << Column("min_latency(ms)", 10) << "\t"
+        << Column("max_latency(ms)", 10) << "\t"
+        << Column("avg_latency(ms)", 10) << "\n";
+
+  paddle::lite::x86::SetNumThreads(FLAGS_threads);
+  std::string line;
+  while (std::getline(ops, line)) {
+    OpLine op;
+    if (!ParseOpLine(line, &op)) continue;
+    auto c = MakeOpCase(op);
+    if (!c) {
+      std::cerr << "Skip unsupported op: " << line << std::endl;
+      continue;
+    }
+    for (int i = 0; i < FLAGS_warmup_times; ++i) {
+      c->kernel->Launch();
+    }
+    paddle::lite::profile::Timer timer;
+    for (int i = 0; i < FLAGS_repeats_times; ++i) {
+      timer.Start();
+      c->kernel->Launch();
+      timer.Stop();
+    }
+    std::string param_info;
+    for (auto& p : op.params) {
+      param_info += (param_info.empty() ? "" : ",") + p.first + "=" + p.second;
+    }
+    table << Column(op.op, 10) << "\t" << Column(op.input_dims, 10) << "\t"
+          << Column(DimsString(c->output_dims), 10) << "\t"
+          << Column("(" + param_info + ")", 80) << "\t"
+          << Column(timer.LapTimes().Min(), 10) << "\t"
+          << Column(timer.LapTimes().Max(), 10) << "\t"
+          << Column(timer.LapTimes().Avg(), 10) << "\n";
+  }
+  std::cout << "Latency lookup table is saved to "
+            << FLAGS_latency_lookup_table_path << std::endl;
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  if (!FLAGS_ops_path.empty()) {
+    return WriteLatencyLookupTable();
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,341 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "lite/api/paddle_use_kernels.h"
+#include "lite/api/paddle_use_ops.h"
+#include "lite/core/test/arena/framework.h"
+#include "lite/tests/utils/fill_data.h"
+
+namespace paddle {
+namespace lite {
+
+// out = pool(relu(relu(conv(x) + bias) + residual)), the residual and the
+// pooling are optional.
+class ConvBlockComputeTest : public arena::TestCase {
+ protected:
+  std::string op_type_ = "fusion_conv2d_block";
+  DDim x_dims_{{1, 4, 16, 16}};
+  int out_channel_ = 8;
+  int ksize_ = 3;
+  int stride_ = 1;
+  int pad_ = 1;
+  bool residual_ = true;
+  // The conv output dims when empty.
+  std::vector<int64_t> residual_dims_;
+  int residual_axis_ = -1;
+  std::string pool_type_;
+  int pool_ksize_ = 3;
+  int pool_stride_ = 2;
+  int pool_pad_ = 1;
+  bool pool_global_ = false;
+  bool pool_exclusive_ = true;
+
+ public:
+  ConvBlockComputeTest(const Place& place,
+                       const std::string& alias,
+                       const DDim& x_dims,
+                       int out_channel,
+                       int ksize,
+                       int stride,
+                       bool residual,
+                       const std::string& pool_type,
+                       bool pool_global,
+                       bool pool_exclusive = true)
+      : TestCase(place, alias),
+        x_dims_(x_dims),
+        out_channel_(out_channel),
+        ksize_(ksize),
+        stride_(stride),
+        pad_(ksize / 2),
+        residual_(residual),
+        pool_type_(pool_type),
+        pool_global_(pool_global),
+        pool_exclusive_(pool_exclusive) {}
+
+  int ConvOutSize(int size) const {
+    return (size + 2 * pad_ - ksize_) / stride_ + 1;
+  }
+
+  // A residual broadcast to the conv output as elementwise_add does.
+  void SetResidualDims(const std::vector<int64_t>& dims, int axis) {
+    residual_dims_ = dims;
+    residual_axis_ = axis;
+  }
+
+  DDim ResidualDims() const {
+    if (!residual_dims_.empty()) return DDim(residual_dims_);
+    return DDim({x_dims_[0],
+                 out_channel_,
+                 ConvOutSize(x_dims_[2]),
+                 ConvOutSize(x_dims_[3])});
+  }
+
+  void RunBaseline(Scope* scope) override {
+    auto* x = scope->FindTensor("x")->data<float>();
+    auto* filter = scope->FindTensor("filter")->data<float>();
+    auto* bias = scope->FindTensor("bias")->data<float>();
+    const int n = x_dims_[0], c = x_dims_[1], h = x_dims_[2], w = x_dims_[3];
+    const int oc = out_channel_;
+    const int oh = ConvOutSize(h), ow = ConvOutSize(w);
+    std::vector<float> conv(n * oc * oh * ow);
+    for (int b = 0; b < n; b++) {
+      for (int o = 0; o < oc; o++) {
+        for (int y = 0; y < oh; y++) {
+          for (int xx = 0; xx < ow; xx++) {
+            float sum = bias[o];
+            for (int i = 0; i < c; i++) {
+              for (int ky = 0; ky < ksize_; ky++) {
+                for (int kx = 0; kx < ksize_; kx++) {
+                  int iy = y * stride_ - pad_ + ky;
+                  int ix = xx * stride_ - pad_ + kx;
+                  if (iy < 0 || iy >= h || ix < 0 || ix >= w) continue;
+                  sum += x[((b * c + i) * h + iy) * w + ix] *
+                         filter[((o * c + i) * ksize_ + ky) * ksize_ + kx];
+                }
+              }
+            }
+            conv[((b * oc + o) * oh + y) * ow + xx] = std::max(sum, 0.f);
+          }
+        }
+      }
+    }
+    if (residual_) {
+      auto* residual = scope->FindTensor("residual")->data<float>();
+      // The residual dims padded to the conv output rank.
+      auto res_dims = ResidualDims();
+      const int rank = res_dims.size();
+      const int start =
+          residual_axis_ == -1 || rank == 4 ? 4 - rank : residual_axis_;
+      int64_t dims[4] = {1, 1, 1, 1};
+      for (int i = 0; i < rank; i++) dims[start + i] = res_dims[i];
+      const int64_t conv_dims[4] = {n, oc, oh, ow};
+      for (size_t i = 0; i < conv.size(); i++) {
+        int64_t index = 0;
+        int64_t rest = i;
+        int64_t stride = 1;
+        for (int d = 3; d >= 0; d--) {
+          const int64_t coord = rest % conv_dims[d];
+          rest /= conv_dims[d];
+          if (dims[d] != 1) index += coord * stride;
+          stride *= dims[d];
+        }
+        conv[i] = std::max(conv[i] + residual[index], 0.f);
+      }
+    }
+
+    auto* out = scope->NewTensor("out");
+    CHECK(out);
+    if (pool_type_.empty()) {
+      out->Resize({n, oc, oh, ow});
+      std::copy(conv.begin(), conv.end(), out->mutable_data<float>());
+      return;
+    }
+    const int k = pool_global_ ? std::max(oh, ow) : pool_ksize_;
+    const int s = pool_global_ ? 1 : pool_stride_;
+    const int p = pool_global_ ? 0 : pool_pad_;
+    const int ph = pool_global_ ? 1 : (oh + 2 * p - k) / s + 1;
+    const int pw = pool_global_ ? 1 : (ow + 2 * p - k) / s + 1;
+    out->Resize({n, oc, ph, pw});
+    auto* out_data = out->mutable_data<float>();
+    for (int i = 0; i < n * oc; i++) {
+      for (int y = 0; y < ph; y++) {
+        for (int xx = 0; xx < pw; xx++) {
+          float max = std::numeric_limits<float>::lowest();
+          float sum = 0.f;
+          int count = 0;
+          for (int ky = y * s - p; ky < y * s - p + k; ky++) {
+            for (int kx = xx * s - p; kx < xx * s - p + k; kx++) {
+              if (ky < 0 || ky >= oh || kx < 0 || kx >= ow) continue;
+              float v = conv[(i * oh + ky) * ow + kx];
+              max = std::max(max, v);
+              sum += v;
+              count++;
+            }
+          }
+          if (!pool_exclusive_) {
+            // The window clipped to the input plus the leading padding.
+            count = (std::min(y * s - p + k, oh + p) - (y * s - p)) *
+                    (std::min(xx * s - p + k, ow + p) - (xx * s - p));
+          }
+          out_data[(i * ph + y) * pw + xx] =
+              pool_type_ == "max" ? max : sum / count;
+        }
+      }
+    }
+  }
+
+  void PrepareOpDesc(cpp::OpDesc* op_desc) {
+    op_desc->SetType(op_type_);
+    op_desc->SetInput("Input", {"x"});
+    op_desc->SetInput("Filter", {"filter"});
+    op_desc->SetInput("Bias", {"bias"});
+    op_desc->SetOutput("Output", {"out"});
+    op_desc->SetAttr<std::vector<int>>("strides", {stride_, stride_});
+    op_desc->SetAttr<std::vector<int>>("paddings", {pad_, pad_});
+    op_desc->SetAttr<std::vector<int>>("dilations", {1, 1});
+    op_desc->SetAttr("groups", 1);
+    op_desc->SetAttr("with_act", true);
+    op_desc->SetAttr<std::string>("act_type", "relu");
+    if (residual_) {
+      op_desc->SetInput("ResidualData", {"residual"});
+      op_desc->SetAttr("residual_axis", residual_axis_);
+      op_desc->SetAttr("residual_relu", true);
+    }
+    if (!pool_type_.empty()) {
+      op_desc->SetAttr("pool_type", pool_type_);
+      op_desc->SetAttr<std::vector<int>>("pool_ksize",
+                                         {pool_ksize_, pool_ksize_});
+      op_desc->SetAttr<std::vector<int>>("pool_strides",
+                                         {pool_stride_, pool_stride_});
+      op_desc->SetAttr<std::vector<int>>("pool_paddings",
+                                         {pool_pad_, pool_pad_});
+      op_desc->SetAttr("pool_global", pool_global_);
+      op_desc->SetAttr("pool_exclusive", pool_exclusive_);
+    }
+  }
+
+  void PrepareData() override {
+    const int64_t c = x_dims_[1];
+    std::vector<float> x(x_dims_.production());
+    fill_data_rand(x.data(), -1.f, 1.f, x.size());
+    SetCommonTensor("x", x_dims_, x.data());
+    DDim filter_dims({out_channel_, c, ksize_, ksize_});
+    std::vector<float> filter(filter_dims.production());
+    fill_data_rand(filter.data(), -1.f, 1.f, filter.size());
+    SetCommonTensor("filter", filter_dims, filter.data(), {}, true);
+    std::vector<float> bias(out_channel_);
+    fill_data_rand(bias.data(), -1.f, 1.f, bias.size());
+    SetCommonTensor("bias", DDim({out_channel_}), bias.data(), {}, true);
+    if (residual_) {
+      DDim res_dims = ResidualDims();
+      std::vector<float> residual(res_dims.production());
+      fill_data_rand(residual.data(), -1.f, 1.f, residual.size());
+      SetCommonTensor("residual", res_dims, residual.data());
+    }
+  }
+};
+
+TEST(ConvBlock, precision) {
+  LOG(INFO) << "test fusion_conv2d_block op";
+#if defined(LITE_WITH_X86)
+  Place place(TARGET(kX86));
+  float abs_error = 1e-4;
+#else
+  return;
+#endif
+
+  // The large input spans several bands of conv rows.
+  for (auto x_dims : std::vector<std::vector<int64_t>>{{2, 3, 9, 11},
+                                                       {1, 32, 64, 64}}) {
+    for (int ksize : {1, 3}) {
+      for (int stride : {1, 2}) {
+        for (bool residual : {true, false}) {
+          for (std::string pool_type : {"", "max", "avg"}) {
+            for (bool pool_global : {false, true}) {
+              if (!residual && pool_type.empty()) continue;
+              if (pool_type.empty() && pool_global) continue;
+              std::unique_ptr<arena::TestCase> tester(
+                  new ConvBlockComputeTest(place,
+                                           "def",
+                                           DDim(x_dims),
+                                           16,
+                                           ksize,
+                                           stride,
+                                           residual,
+                                           pool_type,
+                                           pool_global));
+              arena::Arena arena(std::move(tester), place, abs_error);
+              arena.TestPrecision();
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(ConvBlock, avg_pool_not_exclusive) {
+  LOG(INFO) << "test fusion_conv2d_block op with non-exclusive avg pooling";
+#if defined(LITE_WITH_X86)
+  Place place(TARGET(kX86));
+  float abs_error = 1e-4;
+#else
+  return;
+#endif
+
+  for (auto x_dims : std::vector<std::vector<int64_t>>{{2, 3, 9, 11},
+                                                       {1, 32, 64, 64}}) {
+    for (int stride : {1, 2}) {
+      std::unique_ptr<arena::TestCase> tester(
+          new ConvBlockComputeTest(place,
+                                   "def",
+                                   DDim(x_dims),
+                                   16,
+                                   3,
+                                   stride,
+                                   true,
+                                   "avg",
+                                   false,
+                                   false));
+      arena::Arena arena(std::move(tester), place, abs_error);
+      arena.TestPrecision();
+    }
+  }
+}
+
+TEST(ConvBlock, broadcast_residual) {
+  LOG(INFO) << "test fusion_conv2d_block op with a broadcast residual";
+#if defined(LITE_WITH_X86)
+  Place place(TARGET(kX86));
+  float abs_error = 1e-4;
+#else
+  return;
+#endif
+
+  // Conv output {2, 16, 9, 11}.
+  const std::vector<std::pair<std::vector<int64_t>, int>> residuals{
+      {{16, 1, 1}, -1},
+      {{1, 16, 1, 1}, -1},
+      {{2, 1, 9, 11}, -1},
+      {{11}, -1},
+      {{9, 1}, -1},
+      {{2, 16}, 0},
+      {{16, 9}, 1}};
+  for (auto& residual : residuals) {
+    for (std::string pool_type : {"", "max"}) {
+      std::unique_ptr<ConvBlockComputeTest> tester(
+          new ConvBlockComputeTest(place,
+                                   "def",
+                                   DDim({2, 3, 9, 11}),
+                                   16,
+                                   3,
+                                   1,
+                                   true,
+                                   pool_type,
+                                   false));
+      tester->SetResidualDims(residual.first, residual.second);
+      arena::Arena arena(std::move(tester), place, abs_error);
+      arena.TestPrecision();
+    }
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,303 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include "lite/api/paddle_use_kernels.h"
+#include "lite/api/paddle_use_ops.h"
+#include "lite/backends/host/math/half_weight.h"
+#include "lite/core/test/arena/framework.h"
+#include "lite/tests/utils/fill_data.h"
+
+namespace paddle {
+namespace lite {
+
+class EmbeddingBagComputeTest : public arena::TestCase {
+ protected:
+  // common attributes for this op.
+  std::string op_type_ = "embedding_bag";
+  std::string ids_ = "ids";
+  std::string w_ = "w";
+  std::string out_ = "out";
+  LoD lod_{{0, 2, 5}};
+  DDim w_dims_{{8, 4}};
+  int64_t padding_idx_ = -1;
+  std::string pool_type_ = "SUM";
+  std::string table_quant_type_ = "none";
+  bool fp16_table_ = false;
+  bool int32_ids_ = false;
+  // "fp16" or "bf16" marks an int16 table written by the half weight pass.
+  std::string half_weight_type_{};
+
+ public:
+  EmbeddingBagComputeTest(const Place& place,
+                          const std::string& alias,
+                          const LoD& lod,
+                          const DDim& w_dims,
+                          int64_t padding_idx,
+                          const std::string& pool_type,
+                          const std::string& table_quant_type,
+                          bool fp16_table = false,
+                          bool int32_ids = false,
+                          const std::string& half_weight_type = "")
+      : TestCase(place, alias),
+        lod_(lod),
+        w_dims_(w_dims),
+        padding_idx_(padding_idx),
+        pool_type_(pool_type),
+        table_quant_type_(table_quant_type),
+        fp16_table_(fp16_table),
+        int32_ids_(int32_ids),
+        half_weight_type_(half_weight_type) {}
+
+  void RunBaseline(Scope* scope) override {
+    auto ids = scope->FindTensor(ids_);
+    auto w = scope->FindTensor(w_);
+    auto out = scope->NewTensor(out_);
+    CHECK(out);
+
+    bool quant = table_quant_type_ == "uint8_minmax";
+    int64_t quant_number = w_dims_[1];
+    int64_t w_cols = quant ? (quant_number - 2) * 4 : w_dims_[1];
+    auto offset = lod_.back();
+    int64_t bag_num = offset.size() - 1;
+    out->Resize({bag_num, w_cols});
+    LoD out_lod;
+    if (lod_.size() == 2) {
+      out_lod.push_back(lod_[0]);
+    } else {
+      std::vector<uint64_t> bags(bag_num + 1);
+      for (int64_t i = 0; i <= bag_num; i++) bags[i] = i;
+      out_lod.push_back(bags);
+    }
+    out->set_lod(out_lod);
+    std::vector<int64_t> ids_data(ids->numel());
+    for (int64_t i = 0; i < ids->numel(); i++) {
+      ids_data[i] = int32_ids_ ? ids->data<int32_t>()[i]
+                               : ids->data<int64_t>()[i];
+    }
+    std::vector<float> w_data(w_dims_.production());
+    for (int64_t i = 0; i < w_dims_.production(); i++) {
+      if (half_weight_type_ == "bf16") {
+        w_data[i] = lite::host::math::bf16_to_float(
+            static_cast<uint16_t>(w->data<int16_t>()[i]));
+      } else if (fp16_table_ || !half_weight_type_.empty()) {
+        w_data[i] = lite::host::math::fp16_to_float(
+            static_cast<uint16_t>(w->data<int16_t>()[i]));
+      } else {
+        w_data[i] = w->data<float>()[i];
+      }
+    }
+    auto out_data = out->mutable_data<float>();
+
+    std::vector<float> row(w_cols);
+    for (int64_t b = 0; b < bag_num; b++) {
+      float* dst = out_data + b * w_cols;
+      int64_t len = offset[b + 1] - offset[b];
+      if (len == 0) {
+        for (int64_t j = 0; j < w_cols; j++) dst[j] = 0.f;
+        continue;
+      }
+      for (int64_t j = 0; j < w_cols; j++) dst[j] = 0.f;
+      for (uint64_t i = offset[b]; i < offset[b + 1]; i++) {
+        auto id = ids_data[i];
+        if (padding_idx_ != -1 && id == padding_idx_) continue;
+        if (quant) {
+          const float* q_row = w_data.data() + id * quant_number;
+          float min = q_row[0];
+          float scale = (q_row[1] - min) / 256.f;
+          const unsigned char* q =
+              reinterpret_cast<const unsigned char*>(q_row + 2);
+          for (int64_t j = 0; j < w_cols; j++) {
+            row[j] = scale * static_cast<int>(q[j]) + min;
+          }
+        } else {
+          for (int64_t j = 0; j < w_cols; j++) row[j] = w_data[id * w_cols + j];
+        }
+        for (int64_t j = 0; j < w_cols; j++) dst[j] += row[j];
+      }
+      float scale = 1.f;
+      if (pool_type_ == "AVERAGE") {
+        scale = 1.f / len;
+      } else if (pool_type_ == "SQRT") {
+        scale = 1.f / std::sqrt(static_cast<float>(len));
+      }
+      for (int64_t j = 0; j < w_cols; j++) dst[j] *= scale;
+    }
+  }
+
+  void PrepareOpDesc(cpp::OpDesc* op_desc) {
+    op_desc->SetType(op_type_);
+    op_desc->SetInput("Ids", {ids_});
+    op_desc->SetInput("W", {w_});
+    op_desc->SetOutput("Out", {out_});
+    op_desc->SetAttr<int64_t>("padding_idx", padding_idx_);
+    op_desc->SetAttr<std::string>("pooltype", pool_type_);
+    op_desc->SetAttr<std::string>("table_quant_type", table_quant_type_);
+    if (!half_weight_type_.empty()) {
+      op_desc->SetAttr<std::string>("half_weight_type", half_weight_type_);
+    }
+  }
+
+  void PrepareData() override {
+    int64_t ids_num = lod_.back().back();
+    std::vector<int64_t> ids(ids_num);
+    fill_data_rand<int64_t>(ids.data(), 0, w_dims_[0] - 1, ids_num);
+    if (int32_ids_) {
+      std::vector<int32_t> ids32(ids.begin(), ids.end());
+      SetCommonTensor(ids_, DDim({ids_num, 1}), ids32.data(), lod_);
+    } else {
+      SetCommonTensor(ids_, DDim({ids_num, 1}), ids.data(), lod_);
+    }
+
+    std::vector<float> w(w_dims_.production());
+    fill_data_rand(w.data(), -1.f, 1.f, w_dims_.production());
+    if (table_quant_type_ == "uint8_minmax") {
+      for (int64_t i = 0; i < w_dims_[0]; i++) {
+        w[i * w_dims_[1]] = -1.f;
+        w[i * w_dims_[1] + 1] = 1.f;
+      }
+    }
+
+    if (fp16_table_) {
+      // The kernel tells a half table apart by the tensor precision.
+      std::vector<int16_t> half(w.size());
+      for (size_t i = 0; i < w.size(); i++) {
+        half[i] = static_cast<int16_t>(lite::host::math::float_to_fp16(w[i]));
+      }
+      SetCommonTensor(w_, w_dims_, half.data(), {}, true);
+      baseline_scope()->FindMutableTensor(w_)->set_precision(PRECISION(kFP16));
+      inst_scope()->FindMutableTensor(w_)->set_precision(PRECISION(kFP16));
+    } else if (!half_weight_type_.empty()) {
+      // The half weight pass keeps the bits in a plain int16 tensor.
+      bool bf16 = half_weight_type_ == "bf16";
+      std::vector<int16_t> half(w.size());
+      for (size_t i = 0; i < w.size(); i++) {
+        half[i] = static_cast<int16_t>(
+            bf16 ? lite::host::math::float_to_bf16(w[i])
+                 : lite::host::math::float_to_fp16(w[i]));
+      }
+      SetCommonTensor(w_, w_dims_, half.data(), {}, true);
+    } else {
+      SetCommonTensor(w_, w_dims_, w.data(), {}, true);
+    }
+  }
+};
+
+TEST(EmbeddingBag, precision) {
+  LOG(INFO) << "test embedding_bag op";
+  float abs_error = 1e-5;
+  Place place;
+#if defined(LITE_WITH_X86)
+  place = TARGET(kX86);
+#else
+  return;
+#endif
+
+  for (auto lod : std::vector<LoD>{{{0, 3, 3, 7}}, {{0, 1, 2}, {0, 4, 9}}}) {
+    for (auto w_dims :
+         std::vector<std::vector<int64_t>>{{6, 8}, {12, 15}, {20, 64}}) {
+      for (auto padding_idx : std::vector<int64_t>{-1, 0}) {
+        for (auto pool_type :
+             std::vector<std::string>{"SUM", "AVERAGE", "SQRT"}) {
+          for (auto quant_type :
+               std::vector<std::string>{"none", "uint8_minmax"}) {
+            std::unique_ptr<arena::TestCase> tester(
+                new EmbeddingBagComputeTest(place,
+                                            "def",
+                                            lod,
+                                            DDim(w_dims),
+                                            padding_idx,
+                                            pool_type,
+                                            quant_type));
+            arena::Arena arena(std::move(tester), place, abs_error);
+            arena.TestPrecision();
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(EmbeddingBag, fp16_table_int32_ids) {
+  LOG(INFO) << "test embedding_bag op with fp16 table and int32 ids";
+  float abs_error = 1e-5;
+  Place place;
+#if defined(LITE_WITH_X86)
+  place = TARGET(kX86);
+#else
+  return;
+#endif
+
+  LoD lod{{0, 3, 3, 7}};
+  for (auto w_dims :
+       std::vector<std::vector<int64_t>>{{6, 8}, {12, 15}, {20, 64}}) {
+    for (auto pool_type :
+         std::vector<std::string>{"SUM", "AVERAGE", "SQRT"}) {
+      for (bool int32_ids : {false, true}) {
+        for (bool fp16_table : {false, true}) {
+          std::unique_ptr<arena::TestCase> tester(
+              new EmbeddingBagComputeTest(place,
+                                          int32_ids ? "int32_ids" : "def",
+                                          lod,
+                                          DDim(w_dims),
+                                          0,
+                                          pool_type,
+                                          "none",
+                                          fp16_table,
+                                          int32_ids));
+          arena::Arena arena(std::move(tester), place, abs_error);
+          arena.TestPrecision();
+        }
+      }
+    }
+  }
+}
+
+TEST(EmbeddingBag, half_weight_type) {
+  LOG(INFO) << "test embedding_bag op with a half weight table";
+  float abs_error = 1e-5;
+  Place place;
+#if defined(LITE_WITH_X86)
+  place = TARGET(kX86);
+#else
+  return;
+#endif
+
+  LoD lod{{0, 3, 3, 7}};
+  for (auto w_dims :
+       std::vector<std::vector<int64_t>>{{6, 8}, {12, 15}, {20, 64}}) {
+    for (auto pool_type :
+         std::vector<std::string>{"SUM", "AVERAGE", "SQRT"}) {
+      for (auto half_weight_type : std::vector<std::string>{"fp16", "bf16"}) {
+        std::unique_ptr<arena::TestCase> tester(
+            new EmbeddingBagComputeTest(place,
+                                        "def",
+                                        lod,
+                                        DDim(w_dims),
+                                        0,
+                                        pool_type,
+                                        "none",
+                                        false,
+                                        false,
+                                        half_weight_type));
+        arena::Arena arena(std::move(tester), place, abs_error);
+        arena.TestPrecision();
+      }
+    }
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
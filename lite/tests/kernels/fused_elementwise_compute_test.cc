@@ -0,0 +1,146 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include "lite/api/paddle_use_kernels.h"
+#include "lite/api/paddle_use_ops.h"
+#include "lite/core/test/arena/framework.h"
+#include "lite/tests/utils/fill_data.h"
+
+namespace paddle {
+namespace lite {
+
+// case 0: out = hard_swish(sigmoid((x + y[C]) * 0.5 + 0.1) * z), x is NCHW
+// case 1: out = max(relu6(y - x[HW]), s[1]) / d[NC], y is NCHW, so the
+//         accumulator is broadcast into the larger operand
+class FusedElementwiseComputeTest : public arena::TestCase {
+ protected:
+  std::string op_type_ = "fused_elementwise";
+  std::string out_ = "out";
+  int case_ = 0;
+  DDim dims_{{2, 3, 4, 5}};
+
+ public:
+  FusedElementwiseComputeTest(const Place& place,
+                              const std::string& alias,
+                              int test_case,
+                              const DDim& dims)
+      : TestCase(place, alias), case_(test_case), dims_(dims) {}
+
+  void RunBaseline(Scope* scope) override {
+    auto out = scope->NewTensor(out_);
+    CHECK(out);
+    out->Resize(dims_);
+    auto* out_data = out->mutable_data<float>();
+    const int64_t C = dims_[1], H = dims_[2], W = dims_[3];
+    if (case_ == 0) {
+      auto* x = scope->FindTensor("x")->data<float>();
+      auto* y = scope->FindTensor("y")->data<float>();
+      auto* z = scope->FindTensor("z")->data<float>();
+      for (int64_t i = 0; i < dims_.production(); i++) {
+        int64_t c = i / (H * W) % C;
+        float v = (x[i] + y[c]) * 0.5f + 0.1f;
+        v = 1.f / (1.f + std::exp(-v)) * z[i];
+        out_data[i] = v * std::min(std::max(v + 3.f, 0.f), 6.f) / 6.f;
+      }
+    } else {
+      auto* x = scope->FindTensor("x")->data<float>();
+      auto* y = scope->FindTensor("y")->data<float>();
+      auto* s = scope->FindTensor("s")->data<float>();
+      auto* d = scope->FindTensor("d")->data<float>();
+      for (int64_t i = 0; i < dims_.production(); i++) {
+        int64_t hw = i % (H * W);
+        int64_t nc = i / (H * W);
+        float v = std::min(std::max(y[i] - x[hw], 0.f), 6.f);
+        out_data[i] = std::max(v, s[0]) / d[nc];
+      }
+    }
+  }
+
+  void PrepareOpDesc(cpp::OpDesc* op_desc) {
+    op_desc->SetType(op_type_);
+    op_desc->SetOutput("Out", {out_});
+    if (case_ == 0) {
+      op_desc->SetInput("X", {"x", "y", "z"});
+      op_desc->SetAttr<std::vector<std::string>>(
+          "fused_op_types", {"add", "scale", "sigmoid", "mul", "hard_swish"});
+      op_desc->SetAttr<std::vector<int>>("fused_op_inputs", {1, -1, -1, 2, -1});
+      op_desc->SetAttr<std::vector<int>>("fused_op_axes", {1, -1, -1, -1, -1});
+      op_desc->SetAttr<std::vector<float>>(
+          "fused_op_params",
+          {0, 0, 0, 0.5f, 0.1f, 0, 0, 0, 0, 0, 0, 0, 6.f, 6.f, 3.f});
+    } else {
+      op_desc->SetInput("X", {"x", "y", "s", "d"});
+      op_desc->SetAttr<std::vector<std::string>>(
+          "fused_op_types", {"rsub", "relu6", "max", "div"});
+      op_desc->SetAttr<std::vector<int>>("fused_op_inputs", {1, -1, 2, 3});
+      op_desc->SetAttr<std::vector<int>>("fused_op_axes", {-1, -1, -1, 0});
+      op_desc->SetAttr<std::vector<float>>(
+          "fused_op_params", {0, 0, 0, 6.f, 0, 0, 0, 0, 0, 0, 0, 0});
+    }
+  }
+
+  void PrepareData() override {
+    const int64_t N = dims_[0], C = dims_[1], H = dims_[2], W = dims_[3];
+    std::vector<float> full(dims_.production());
+    fill_data_rand(full.data(), -8.f, 8.f, dims_.production());
+    if (case_ == 0) {
+      SetCommonTensor("x", dims_, full.data());
+      std::vector<float> y(C);
+      fill_data_rand(y.data(), -2.f, 2.f, C);
+      SetCommonTensor("y", DDim({C}), y.data());
+      fill_data_rand(full.data(), -2.f, 2.f, dims_.production());
+      SetCommonTensor("z", dims_, full.data());
+    } else {
+      std::vector<float> x(H * W);
+      fill_data_rand(x.data(), -2.f, 2.f, H * W);
+      SetCommonTensor("x", DDim({H, W}), x.data());
+      SetCommonTensor("y", dims_, full.data());
+      std::vector<float> s{0.5f};
+      SetCommonTensor("s", DDim({1}), s.data());
+      std::vector<float> d(N * C);
+      fill_data_rand(d.data(), 1.f, 3.f, N * C);
+      SetCommonTensor("d", DDim({N, C}), d.data());
+    }
+  }
+};
+
+TEST(FusedElementwise, precision) {
+  LOG(INFO) << "test fused_elementwise op";
+  float abs_error = 1e-5;
+  Place place;
+#if defined(LITE_WITH_X86)
+  place = TARGET(kX86);
+#elif defined(LITE_WITH_ARM)
+  place = TARGET(kARM);
+  abs_error = 1e-4;
+#else
+  return;
+#endif
+
+  for (int test_case : {0, 1}) {
+    for (auto dims : std::vector<std::vector<int64_t>>{
+             {1, 3, 4, 5}, {2, 16, 7, 9}, {2, 3, 32, 40}}) {
+      std::unique_ptr<arena::TestCase> tester(new FusedElementwiseComputeTest(
+          place, "def", test_case, DDim(dims)));
+      arena::Arena arena(std::move(tester), place, abs_error);
+      arena.TestPrecision();
+    }
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -101,6 +101,8 @@ TEST(PixelShuffle, precision) {
 #elif defined(LITE_WITH_ARM)
   LOG(INFO) << "test pixel_shuffle arm";
   place = TARGET(kARM);
+#elif defined(LITE_WITH_X86)
+  place = TARGET(kX86);
 #else
   return;
 #endif
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include "lite/api/paddle_use_kernels.h"
 #include "lite/api/paddle_use_ops.h"
 #include "lite/core/test/arena/framework.h"
@@ -200,7 +201,13 @@ class PoolComputeTest : public arena::TestCase {
                 if (exclusive_) {
                   res /= pooling_size;
                 } else {
-                  res /= window_h * window_w;
+                  // The window clipped to the input plus the leading
+                  // padding, as x86 Pool2dFunctor counts it.
+                  int h0 = h * stride_h - pad_t;
+                  int w0 = w * stride_w - pad_l;
+                  int h1 = std::min(h0 + window_h, in_h + pad_t);
+                  int w1 = std::min(w0 + window_w, in_w + pad_l);
+                  res /= (h1 - h0) * (w1 - w0);
                 }
               }
               dst_ptr[n * size_out_n + c * size_out_c + h * out_w + w] = res;
@@ -380,6 +387,25 @@ void TestPoolCeilMode(Place place, float abs_error = 2e-5) {
   }
 }
 
+void TestPoolExclusive(Place place, float abs_error = 2e-5) {
+  for (auto exclusive : {true, false}) {
+    for (auto ceil_mode : {false, true}) {
+      for (auto paddings : std::vector<std::vector<int>>{
+               {1, 1}, {1, 0, 1, 0}, {0, 1, 0, 1}, {2, 0, 1, 2}}) {
+        TestPoolHelper(place,
+                       abs_error,
+                       {2, 3, 7, 8},
+                       "avg",
+                       {2, 2},
+                       paddings,
+                       {3, 3},
+                       exclusive,
+                       ceil_mode);
+      }
+    }
+  }
+}
+
 TEST(Pool, precision) {
   LOG(INFO) << "test pool op";
   float abs_error = 2e-5;
@@ -401,6 +427,9 @@ TEST(Pool, precision) {
 #elif defined(LITE_WITH_NPU)
   place = TARGET(kNPU);
   abs_error = 1e-2;  // Using fp16 in NPU
+#elif defined(LITE_WITH_X86)
+  place = TARGET(kX86);
+  TestPoolExclusive(place, abs_error);
 #else
   return;
 #endif
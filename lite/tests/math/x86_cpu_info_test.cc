@@ -0,0 +1,175 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "lite/backends/x86/cpu_info.h"
+#include "lite/utils/log/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+
+TEST(CpuInfo, parse_cpu_list) {
+  EXPECT_EQ(ParseCpuList("0-3,8,10-11"),
+            std::vector<int>({0, 1, 2, 3, 8, 10, 11}));
+  EXPECT_EQ(ParseCpuList("5"), std::vector<int>({5}));
+  EXPECT_EQ(ParseCpuList("0,2"), std::vector<int>({0, 2}));
+  EXPECT_TRUE(ParseCpuList("").empty());
+}
+
+#ifdef __linux__
+// Two sockets of two cores with two SMT threads each, the siblings are
+// numbered next to each other. The raw package and core ids are sparse and
+// sysfs node 1 has memory only. Each line is "<path> <content>".
+static const char* kSysfsFixture =
+    "cpu/online 0-7\n"
+    "cpu/cpu0/topology/physical_package_id 0\n"
+    "cpu/cpu0/topology/core_id 0\n"
+    "cpu/cpu1/topology/physical_package_id 0\n"
+    "cpu/cpu1/topology/core_id 0\n"
+    "cpu/cpu2/topology/physical_package_id 0\n"
+    "cpu/cpu2/topology/core_id 4\n"
+    "cpu/cpu3/topology/physical_package_id 0\n"
+    "cpu/cpu3/topology/core_id 4\n"
+    "cpu/cpu4/topology/physical_package_id 3\n"
+    "cpu/cpu4/topology/core_id 0\n"
+    "cpu/cpu5/topology/physical_package_id 3\n"
+    "cpu/cpu5/topology/core_id 0\n"
+    "cpu/cpu6/topology/physical_package_id 3\n"
+    "cpu/cpu6/topology/core_id 4\n"
+    "cpu/cpu7/topology/physical_package_id 3\n"
+    "cpu/cpu7/topology/core_id 4\n"
+    "cpu/cpu0/cache/index0/level 1\n"
+    "cpu/cpu0/cache/index0/type Data\n"
+    "cpu/cpu0/cache/index0/size 48K\n"
+    "cpu/cpu0/cache/index1/level 1\n"
+    "cpu/cpu0/cache/index1/type Instruction\n"
+    "cpu/cpu0/cache/index1/size 32K\n"
+    "cpu/cpu0/cache/index2/level 2\n"
+    "cpu/cpu0/cache/index2/type Unified\n"
+    "cpu/cpu0/cache/index2/size 1280K\n"
+    "cpu/cpu0/cache/index3/level 3\n"
+    "cpu/cpu0/cache/index3/type Unified\n"
+    "cpu/cpu0/cache/index3/size 48M\n"
+    "node/online 0-2\n"
+    "node/node0/cpulist 0-3\n"
+    "node/node1/cpulist \n"
+    "node/node2/cpulist 4-7\n";
+
+// Writes the fixture under a new temporary directory and returns its path
+// with a trailing slash. The created paths are added to `paths`, the
+// directories before their content.
+static std::string WriteFixture(const std::string& fixture,
+                                std::vector<std::string>* paths) {
+  char root[] = "/tmp/sysfs_XXXXXX";
+  CHECK(mkdtemp(root));
+  paths->push_back(root);
+  std::istringstream lines(fixture);
+  std::string line;
+  while (std::getline(lines, line)) {
+    auto space = line.find(' ');
+    auto path = std::string(root) + "/" + line.substr(0, space);
+    for (size_t slash = path.find('/', strlen(root) + 1);
+         slash != std::string::npos;
+         slash = path.find('/', slash + 1)) {
+      auto dir = path.substr(0, slash);
+      if (mkdir(dir.c_str(), 0755) == 0) paths->push_back(dir);
+    }
+    std::ofstream(path) << line.substr(space + 1) << "\n";
+    paths->push_back(path);
+  }
+  return std::string(root) + "/";
+}
+
+TEST(CpuInfo, detect_cpu_topology) {
+  std::vector<std::string> paths;
+  auto topo = DetectCpuTopology(WriteFixture(kSysfsFixture, &paths));
+  for (auto it = paths.rbegin(); it != paths.rend(); ++it) {
+    remove(it->c_str());
+  }
+
+  EXPECT_EQ(topo.num_cpus, 8);
+  EXPECT_EQ(topo.num_sockets, 2);
+  EXPECT_EQ(topo.num_physical_cores, 4);
+  EXPECT_EQ(topo.cpu_socket, std::vector<int>({0, 0, 0, 0, 1, 1, 1, 1}));
+  EXPECT_EQ(topo.cpu_core, std::vector<int>({0, 0, 1, 1, 2, 2, 3, 3}));
+  // The memory-only node is skipped, sysfs node 2 gets index 1.
+  EXPECT_EQ(topo.num_numa_nodes, 2);
+  EXPECT_EQ(topo.cpu_numa_node, std::vector<int>({0, 0, 0, 0, 1, 1, 1, 1}));
+  ASSERT_EQ(topo.numa_node_cpus.size(), 2u);
+  // The first thread of every core comes first.
+  EXPECT_EQ(topo.numa_node_cpus[0], std::vector<int>({0, 2, 1, 3}));
+  EXPECT_EQ(topo.numa_node_cpus[1], std::vector<int>({4, 6, 5, 7}));
+  EXPECT_EQ(topo.l1d_cache_size, 48u << 10);
+  EXPECT_EQ(topo.l2_cache_size, 1280u << 10);
+  EXPECT_EQ(topo.l3_cache_size, 48u << 20);
+}
+
+TEST(CpuInfo, detect_cpu_topology_without_nodes) {
+  std::vector<std::string> paths;
+  auto topo = DetectCpuTopology(WriteFixture(
+      "cpu/online 0-1\n"
+      "cpu/cpu0/topology/core_id 0\n"
+      "cpu/cpu1/topology/core_id 1\n",
+      &paths));
+  for (auto it = paths.rbegin(); it != paths.rend(); ++it) {
+    remove(it->c_str());
+  }
+
+  EXPECT_EQ(topo.num_cpus, 2);
+  EXPECT_EQ(topo.num_sockets, 1);
+  EXPECT_EQ(topo.num_physical_cores, 2);
+  EXPECT_EQ(topo.num_numa_nodes, 1);
+  ASSERT_EQ(topo.numa_node_cpus.size(), 1u);
+  EXPECT_EQ(topo.numa_node_cpus[0], std::vector<int>({0, 1}));
+  EXPECT_EQ(topo.l2_cache_size, 0u);
+}
+
+// The way a predictor pinned to a node runs on the caller's thread.
+TEST(CpuInfo, numa_node_scope_restores_affinity) {
+  cpu_set_t before;
+  CPU_ZERO(&before);
+  ASSERT_EQ(sched_getaffinity(0, sizeof(before), &before), 0);
+  {
+    NumaNodeScope scope(0);
+    BindWorkerThreadsToNumaNode(0, 2);
+    cpu_set_t pinned;
+    CPU_ZERO(&pinned);
+    ASSERT_EQ(sched_getaffinity(0, sizeof(pinned), &pinned), 0);
+    for (int cpu : GetCpuTopology().numa_node_cpus[0]) {
+      if (CPU_ISSET(cpu, &before)) {
+        EXPECT_TRUE(CPU_ISSET(cpu, &pinned));
+      }
+    }
+  }
+  cpu_set_t after;
+  CPU_ZERO(&after);
+  ASSERT_EQ(sched_getaffinity(0, sizeof(after), &after), 0);
+  EXPECT_TRUE(CPU_EQUAL(&before, &after));
+}
+#endif  // __linux__
+
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
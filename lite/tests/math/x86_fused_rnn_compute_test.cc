@@ -0,0 +1,171 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef LITE_WITH_X86
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "lite/backends/x86/math/fused_rnn.h"
+#include "lite/core/context.h"
+
+namespace math = paddle::lite::x86::math;
+
+static float sigmoid(float x) { return 1.f / (1.f + std::exp(-x)); }
+
+// Step by step reference of the rnn op for one direction, gates in the op
+// order i, f, c, o (LSTM) or r, z, c (GRU).
+static void rnn_ref(bool lstm,
+                    int I,
+                    int H,
+                    const std::vector<float>& w_ih,
+                    const std::vector<float>& w_hh,
+                    const std::vector<float>& b_ih,
+                    const std::vector<float>& b_hh,
+                    const std::vector<float>& x,
+                    int steps,
+                    int batch,
+                    const std::vector<int>& seq_len,
+                    bool reverse,
+                    std::vector<float>* h,
+                    std::vector<float>* c,
+                    std::vector<float>* out) {
+  const int G = lstm ? 4 : 3;
+  out->assign(steps * batch * H, 0.f);
+  for (int b = 0; b < batch; ++b) {
+    for (int t = 0; t < seq_len[b]; ++t) {
+      const int step = reverse ? seq_len[b] - 1 - t : t;
+      std::vector<float> xi(G * H), hh(G * H);
+      for (int g = 0; g < G * H; ++g) {
+        xi[g] = b_ih[g];
+        hh[g] = b_hh[g];
+        for (int k = 0; k < I; ++k) {
+          xi[g] += w_ih[g * I + k] * x[(step * batch + b) * I + k];
+        }
+        for (int k = 0; k < H; ++k) hh[g] += w_hh[g * H + k] * (*h)[b * H + k];
+      }
+      for (int i = 0; i < H; ++i) {
+        float& hv = (*h)[b * H + i];
+        if (lstm) {
+          float ig = sigmoid(xi[i] + hh[i]);
+          float fg = sigmoid(xi[H + i] + hh[H + i]);
+          float cg = std::tanh(xi[2 * H + i] + hh[2 * H + i]);
+          float og = sigmoid(xi[3 * H + i] + hh[3 * H + i]);
+          float& cv = (*c)[b * H + i];
+          cv = fg * cv + ig * cg;
+          xi[i] = og * std::tanh(cv);
+        } else {
+          float r = sigmoid(xi[i] + hh[i]);
+          float z = sigmoid(xi[H + i] + hh[H + i]);
+          float n = std::tanh(xi[2 * H + i] + r * hh[2 * H + i]);
+          xi[i] = (1.f - z) * n + z * hv;
+        }
+      }
+      for (int i = 0; i < H; ++i) {
+        (*h)[b * H + i] = xi[i];
+        (*out)[(step * batch + b) * H + i] = xi[i];
+      }
+    }
+  }
+}
+
+static void check_fused_rnn(bool lstm, int H, bool with_len, bool reverse) {
+  const int I = 5, steps = 6, batch = 4, G = lstm ? 4 : 3;
+  std::vector<float> w_ih(G * H * I), w_hh(G * H * H), b_ih(G * H),
+      b_hh(G * H), x(steps * batch * I), h0(batch * H), c0(batch * H);
+  for (size_t i = 0; i < w_ih.size(); ++i) w_ih[i] = std::sin(i * 0.37f);
+  for (size_t i = 0; i < w_hh.size(); ++i) w_hh[i] = std::cos(i * 0.41f) / H;
+  for (int i = 0; i < G * H; ++i) {
+    b_ih[i] = 0.05f * (i % 7) - 0.1f;
+    b_hh[i] = 0.03f * (i % 5) - 0.05f;
+  }
+  for (size_t i = 0; i < x.size(); ++i) x[i] = std::sin(i * 0.13f);
+  for (int i = 0; i < batch * H; ++i) {
+    h0[i] = 0.1f * std::cos(i * 0.7f);
+    c0[i] = 0.2f * std::sin(i * 0.3f);
+  }
+  std::vector<int> seq_len = {steps, steps, steps, steps};
+  if (with_len) seq_len = {3, 6, 0, 5};
+
+  std::vector<float> ref_h = h0, ref_c = c0, ref_out;
+  rnn_ref(lstm,
+          I,
+          H,
+          w_ih,
+          w_hh,
+          b_ih,
+          b_hh,
+          x,
+          steps,
+          batch,
+          seq_len,
+          reverse,
+          &ref_h,
+          &ref_c,
+          &ref_out);
+
+  math::FusedRnnCell cell;
+  cell.Init(lstm, I, H, w_ih.data(), w_hh.data(), b_ih.data(), b_hh.data());
+  // out rows are twice as wide to check the stride of bidirectional output
+  std::vector<float> out(steps * batch * 2 * H, -1.f), h(batch * H),
+      c(batch * H);
+  std::unique_ptr<paddle::lite::KernelContext> ctx(
+      new paddle::lite::KernelContext);
+  cell.Forward(ctx->As<paddle::lite::X86Context>(),
+               x.data(),
+               steps,
+               batch,
+               with_len ? seq_len.data() : nullptr,
+               reverse,
+               h0.data(),
+               c0.data(),
+               out.data(),
+               2 * H,
+               h.data(),
+               c.data());
+  for (int r = 0; r < steps * batch; ++r) {
+    for (int i = 0; i < H; ++i) {
+      ASSERT_NEAR(out[r * 2 * H + i], ref_out[r * H + i], 1e-4)
+          << "row " << r << " lstm " << lstm << " reverse " << reverse;
+      ASSERT_EQ(out[r * 2 * H + H + i], -1.f);
+    }
+  }
+  for (int i = 0; i < batch * H; ++i) {
+    ASSERT_NEAR(h[i], ref_h[i], 1e-4);
+    if (lstm) {
+      ASSERT_NEAR(c[i], ref_c[i], 1e-4);
+    }
+  }
+}
+
+TEST(TestX86FusedRnn, lstm) {
+  for (int H : {8, 11}) {
+    for (bool with_len : {false, true}) {
+      check_fused_rnn(true, H, with_len, false);
+      check_fused_rnn(true, H, with_len, true);
+    }
+  }
+}
+
+TEST(TestX86FusedRnn, gru) {
+  for (int H : {8, 11}) {
+    for (bool with_len : {false, true}) {
+      check_fused_rnn(false, H, with_len, false);
+      check_fused_rnn(false, H, with_len, true);
+    }
+  }
+}
+
+#endif  // LITE_WITH_X86
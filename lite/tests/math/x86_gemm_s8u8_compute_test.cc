@@ -24,7 +24,10 @@
 #include <gtest/gtest.h>
 #include <string.h>
 #include <algorithm>
+#include <cmath>
+#include <vector>
 #include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/dynamic_quant_gemm.h"
 #include "lite/backends/x86/math/gemm_s8u8_compute.h"
 #include "lite/core/context.h"
 #include "lite/core/profile/timer.h"
@@ -413,4 +416,95 @@ TEST(TestX86LiteGemmInt8f32, gemm_s8u8f32_compute) {
   }
 }
 
+TEST(TestX86LiteGemmInt8Dynamic, dynamic_quant_gemm) {
+  for (int mm : {1, 7, 64}) {
+    for (int nn : {3, 33, 130}) {
+      for (int kk : {5, 97, 301}) {
+        std::vector<float> x(mm * kk), w(kk * nn), bias(nn);
+        std::vector<float> out(mm * nn), ref(mm * nn);
+        for (int i = 0; i < mm * kk; i++) x[i] = std::sin(0.13f * i);
+        for (int i = 0; i < kk * nn; i++) w[i] = 0.1f * std::cos(0.07f * i);
+        for (int i = 0; i < nn; i++) bias[i] = 0.01f * i;
+        std::vector<int8_t> w_int8(kk * nn);
+        std::vector<float> w_scale(nn);
+        paddle::lite::x86::math::dynamic_quant_weight(
+            w.data(), kk, nn, w_int8.data(), w_scale.data());
+        paddle::lite::x86::math::dynamic_quant_gemm(x.data(),
+                                                    mm,
+                                                    kk,
+                                                    w_int8.data(),
+                                                    w_scale.data(),
+                                                    nn,
+                                                    1.f,
+                                                    bias.data(),
+                                                    1,
+                                                    0.f,
+                                                    out.data());
+        std::vector<float> x_max(mm, 0.f), w_max(nn, 0.f);
+        for (int i = 0; i < mm * kk; i++) {
+          x_max[i / kk] = std::max(x_max[i / kk], std::fabs(x[i]));
+        }
+        for (int i = 0; i < kk * nn; i++) {
+          w_max[i % nn] = std::max(w_max[i % nn], std::fabs(w[i]));
+        }
+        for (int i = 0; i < mm; i++) {
+          for (int j = 0; j < nn; j++) {
+            float acc = bias[j];
+            // half a quantization step of 7 bit x and 8 bit w per product
+            float tolerance = 1e-4f;
+            for (int k = 0; k < kk; k++) {
+              float xv = x[i * kk + k];
+              float wv = w[k * nn + j];
+              acc += xv * wv;
+              tolerance += std::fabs(wv) * x_max[i] / 126.f +
+                           std::fabs(xv) * w_max[j] / 254.f;
+            }
+            ref[i * nn + j] = std::max(acc, 0.f);
+            EXPECT_NEAR(out[i * nn + j], ref[i * nn + j], tolerance);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(TestX86LiteGemmInt8Prepacked, gemm_s8u8_compute_prepacked) {
+  for (bool trans_b : {false, true}) {
+    for (int mm : {1, 17}) {
+      for (int nn : {5, 70, 1500}) {
+        for (int kk : {3, 64, 259}) {
+          std::vector<int8_t> a(mm * kk), b(kk * nn);
+          for (int i = 0; i < mm * kk; i++) a[i] = (i * 7) % 255 - 127;
+          for (int i = 0; i < kk * nn; i++) b[i] = (i * 13) % 255 - 127;
+          std::vector<float> scale(mm, 0.01f), bias(mm, 0.5f);
+          std::vector<float> out(mm * nn), ref(mm * nn);
+          paddle::lite::x86::math::generate_gemm_s8u8_x86_kern<float> gemm(
+              false,
+              trans_b,
+              mm,
+              nn,
+              kk,
+              a.data(),
+              nn,
+              scale.data(),
+              1.f,
+              1.f,
+              bias.data(),
+              0,
+              1.f);
+          gemm.compute(a.data(), b.data(), ref.data());
+          std::vector<uint8_t> packed_b(
+              paddle::lite::x86::math::gemm_s8u8_packed_B_size(nn, kk));
+          paddle::lite::x86::math::gemm_s8u8_prepackB(
+              nn, kk, b.data(), packed_b.data(), trans_b);
+          gemm.compute_prepacked(a.data(), packed_b.data(), out.data());
+          for (int i = 0; i < mm * nn; i++) {
+            EXPECT_EQ(out[i], ref[i]);
+          }
+        }
+      }
+    }
+  }
+}
+
 #endif  // LITE_WITH_X86
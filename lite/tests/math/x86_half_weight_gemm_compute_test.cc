@@ -0,0 +1,102 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef LITE_WITH_X86
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "lite/backends/host/math/half_weight.h"
+#include "lite/backends/x86/math/half_weight_gemm.h"
+
+namespace host_math = paddle::lite::host::math;
+namespace math = paddle::lite::x86::math;
+
+TEST(TestX86HalfWeight, convert) {
+  // every finite half survives the round trip
+  for (uint32_t h = 0; h < 65536; ++h) {
+    float f = host_math::fp16_to_float(static_cast<uint16_t>(h));
+    if (std::isnan(f)) continue;
+    ASSERT_EQ(host_math::float_to_fp16(f), h) << "half bits " << h;
+  }
+  EXPECT_EQ(host_math::float_to_fp16(65520.f), 0x7c00);
+  EXPECT_EQ(host_math::float_to_fp16(65519.f), 0x7bff);
+  EXPECT_EQ(host_math::float_to_fp16(3e-8f), 1);
+  // ties round to even
+  EXPECT_EQ(host_math::float_to_fp16(1.f + 1.f / 2048), 0x3c00);
+  EXPECT_EQ(host_math::float_to_fp16(1.f + 3.f / 2048), 0x3c02);
+  EXPECT_EQ(host_math::float_to_bf16(1.f + 1.f / 256), 0x3f80);
+  EXPECT_EQ(host_math::float_to_bf16(1.f + 3.f / 256), 0x3f82);
+  EXPECT_EQ(host_math::bf16_to_float(0x3f82), 1.f + 1.f / 64);
+}
+
+static void check_half_weight_gemm(
+    int M, int N, int K, bool bf16, bool with_bias, bool relu) {
+  std::vector<float> x(M * K), bias(N), y(M * N);
+  std::vector<uint16_t> w(K * N);
+  for (int i = 0; i < M * K; ++i) x[i] = std::sin(i * 0.3f);
+  for (int i = 0; i < N; ++i) bias[i] = 0.1f * i - 1.f;
+  for (int i = 0; i < K * N; ++i) {
+    float v = std::cos(i * 0.7f);
+    w[i] = bf16 ? host_math::float_to_bf16(v) : host_math::float_to_fp16(v);
+  }
+  math::half_weight_gemm(x.data(),
+                         M,
+                         K,
+                         w.data(),
+                         bf16,
+                         N,
+                         0.5f,
+                         with_bias ? bias.data() : nullptr,
+                         relu,
+                         y.data());
+  for (int m = 0; m < M; ++m) {
+    for (int n = 0; n < N; ++n) {
+      double ref = 0;
+      for (int k = 0; k < K; ++k) {
+        uint16_t h = w[k * N + n];
+        ref += x[m * K + k] * (bf16 ? host_math::bf16_to_float(h)
+                                    : host_math::fp16_to_float(h));
+      }
+      ref = ref * 0.5 + (with_bias ? bias[n] : 0.f);
+      if (relu) ref = std::max(ref, 0.0);
+      ASSERT_NEAR(y[m * N + n], ref, 1e-4)
+          << "M " << M << " N " << N << " K " << K << " bf16 " << bf16;
+    }
+  }
+
+  std::vector<float> widened(K * N);
+  math::half_weight_to_float(w.data(), K * N, bf16, widened.data());
+  for (int i = 0; i < K * N; ++i) {
+    ASSERT_EQ(widened[i],
+              bf16 ? host_math::bf16_to_float(w[i])
+                   : host_math::fp16_to_float(w[i]));
+  }
+}
+
+TEST(TestX86HalfWeight, gemm) {
+  // full and tail column blocks, partial row groups
+  for (bool bf16 : {false, true}) {
+    for (int M : {1, 3, 4, 70}) {
+      for (int N : {1, 8, 13, 16, 37}) {
+        check_half_weight_gemm(M, N, 33, bf16, N % 2 == 1, false);
+        check_half_weight_gemm(M, N, 5, bf16, true, true);
+      }
+    }
+  }
+}
+
+#endif  // LITE_WITH_X86
@@ -0,0 +1,75 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifdef LITE_WITH_X86
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <vector>
+#include "lite/backends/x86/math/permute.h"
+
+namespace math = paddle::lite::x86::math;
+
+template <typename T>
+static void check_permute(const std::vector<int64_t>& dims,
+                          const std::vector<int>& axis) {
+  const int rank = static_cast<int>(dims.size());
+  int64_t num = 1;
+  for (auto d : dims) num *= d;
+  std::vector<T> in(num), out(num), ref(num);
+  for (int64_t i = 0; i < num; ++i) in[i] = static_cast<T>(i % 113 - 50);
+
+  std::vector<int64_t> in_strides(rank, 1), out_dims(rank);
+  for (int i = rank - 2; i >= 0; --i) {
+    in_strides[i] = in_strides[i + 1] * dims[i + 1];
+  }
+  for (int i = 0; i < rank; ++i) out_dims[i] = dims[axis[i]];
+  std::vector<int64_t> index(rank, 0);
+  for (int64_t o = 0; o < num; ++o) {
+    int64_t offset = 0;
+    for (int i = 0; i < rank; ++i) offset += index[i] * in_strides[axis[i]];
+    ref[o] = in[offset];
+    for (int i = rank - 1; i >= 0 && ++index[i] == out_dims[i]; --i) {
+      index[i] = 0;
+    }
+  }
+
+  math::permute(in.data(), out.data(), dims, axis);
+  for (int64_t i = 0; i < num; ++i) {
+    ASSERT_EQ(out[i], ref[i]) << "index " << i;
+  }
+}
+
+TEST(TestX86Permute, float) {
+  // copies, merged rows and batched 2D transposes with odd edges
+  check_permute<float>({7, 9}, {0, 1});
+  check_permute<float>({1, 7, 1, 9}, {2, 0, 3, 1});
+  check_permute<float>({2, 37, 4, 16}, {0, 2, 1, 3});
+  check_permute<float>({67, 45}, {1, 0});
+  check_permute<float>({3, 64, 72}, {0, 2, 1});
+  check_permute<float>({2, 5, 33, 17}, {0, 2, 3, 1});
+  check_permute<float>({2, 33, 17, 5}, {0, 3, 1, 2});
+  check_permute<float>({2, 3, 4, 5, 6}, {4, 2, 0, 3, 1});
+  check_permute<float>({2, 3, 2, 2, 7, 9}, {0, 1, 4, 2, 5, 3});
+}
+
+TEST(TestX86Permute, other_types) {
+  check_permute<int8_t>({2, 19, 40}, {0, 2, 1});
+  check_permute<int8_t>({2, 5, 6, 7}, {0, 2, 3, 1});
+  check_permute<int64_t>({9, 41}, {1, 0});
+  check_permute<int64_t>({3, 4, 5}, {1, 0, 2});
+}
+
+#endif  // LITE_WITH_X86
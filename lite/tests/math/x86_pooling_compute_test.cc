@@ -0,0 +1,159 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifdef LITE_WITH_X86
+
+#include <gtest/gtest.h>
+#include <float.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "lite/backends/x86/math/pooling_fast.h"
+
+namespace math = paddle::lite::x86::math;
+
+// Window [start, start + k) of an input of `size` with `pad_end` padding
+// after it, clipped to the input in [*lo, *hi).
+static int ref_window(int start,
+                      int k,
+                      int size,
+                      int pad_end,
+                      bool exclusive,
+                      int* lo,
+                      int* hi) {
+  int end = std::min(start + k, size + pad_end);
+  *lo = std::max(start, 0);
+  *hi = std::min(end, size);
+  return exclusive ? *hi - *lo : end - start;
+}
+
+static std::vector<float> make_input(int nc, int ih, int iw) {
+  std::vector<float> in(nc * ih * iw);
+  for (size_t i = 0; i < in.size(); ++i) {
+    in[i] = static_cast<float>((i * 37) % 101) * 0.1f - 5.f;
+  }
+  return in;
+}
+
+static void check_pool(int nc,
+                       int ih,
+                       int iw,
+                       int k,
+                       int stride,
+                       int pad,
+                       bool max,
+                       bool exclusive) {
+  const int oh = (ih + 2 * pad - k) / stride + 1;
+  const int ow = (iw + 2 * pad - k) / stride + 1;
+  std::vector<float> in = make_input(nc, ih, iw);
+  std::vector<float> out(nc * oh * ow), ref(out.size());
+  for (int p = 0; p < nc; ++p) {
+    for (int i = 0; i < oh; ++i) {
+      for (int j = 0; j < ow; ++j) {
+        int h0, h1, w0, w1;
+        int count =
+            ref_window(i * stride - pad, k, ih, pad, exclusive, &h0, &h1) *
+            ref_window(j * stride - pad, k, iw, pad, exclusive, &w0, &w1);
+        float acc = max ? -FLT_MAX : 0.f;
+        for (int h = h0; h < h1; ++h) {
+          for (int w = w0; w < w1; ++w) {
+            float v = in[(p * ih + h) * iw + w];
+            acc = max ? std::max(acc, v) : acc + v;
+          }
+        }
+        ref[(p * oh + i) * ow + j] = max ? acc : acc / count;
+      }
+    }
+  }
+  math::pool2d_fast(in.data(),
+                    out.data(),
+                    nc,
+                    ih,
+                    iw,
+                    oh,
+                    ow,
+                    k,
+                    k,
+                    stride,
+                    stride,
+                    pad,
+                    pad,
+                    pad,
+                    pad,
+                    max,
+                    exclusive);
+  for (size_t i = 0; i < out.size(); ++i) {
+    ASSERT_NEAR(out[i], ref[i], 1e-5) << "index " << i;
+  }
+}
+
+TEST(TestX86PoolingFast, window) {
+  for (bool max : {true, false}) {
+    for (bool exclusive : {true, false}) {
+      for (int k : {2, 3, 5}) {
+        for (int stride : {1, 2, 3}) {
+          for (int pad : {0, 1}) {
+            if (pad >= k) continue;
+            check_pool(3, 17, 35, k, stride, pad, max, exclusive);
+            check_pool(2, 7, 8, k, stride, pad, max, exclusive);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(TestX86PoolingFast, adaptive_and_global) {
+  const int nc = 5, ih = 13, iw = 19;
+  std::vector<float> in = make_input(nc, ih, iw);
+  for (bool max : {true, false}) {
+    const int oh = 4, ow = 7;
+    std::vector<float> out(nc * oh * ow);
+    math::pool2d_adaptive(in.data(), out.data(), nc, ih, iw, oh, ow, max);
+    for (int p = 0; p < nc; ++p) {
+      for (int i = 0; i < oh; ++i) {
+        for (int j = 0; j < ow; ++j) {
+          int h0 = static_cast<int>(std::floor(1.0 * i * ih / oh));
+          int h1 = static_cast<int>(std::ceil(1.0 * (i + 1) * ih / oh));
+          int w0 = static_cast<int>(std::floor(1.0 * j * iw / ow));
+          int w1 = static_cast<int>(std::ceil(1.0 * (j + 1) * iw / ow));
+          float acc = max ? -FLT_MAX : 0.f;
+          for (int h = h0; h < h1; ++h) {
+            for (int w = w0; w < w1; ++w) {
+              float v = in[(p * ih + h) * iw + w];
+              acc = max ? std::max(acc, v) : acc + v;
+            }
+          }
+          if (!max) acc /= (h1 - h0) * (w1 - w0);
+          ASSERT_NEAR(out[(p * oh + i) * ow + j], acc, 1e-5);
+        }
+      }
+    }
+
+    std::vector<float> global(nc);
+    math::pool2d_global(in.data(), global.data(), nc, ih * iw, max);
+    for (int p = 0; p < nc; ++p) {
+      float acc = max ? -FLT_MAX : 0.f;
+      for (int i = 0; i < ih * iw; ++i) {
+        float v = in[p * ih * iw + i];
+        acc = max ? std::max(acc, v) : acc + v;
+      }
+      if (!max) acc /= ih * iw;
+      ASSERT_NEAR(global[p], acc, 1e-4);
+    }
+  }
+}
+
+#endif  // LITE_WITH_X86
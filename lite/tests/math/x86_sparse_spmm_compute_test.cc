@@ -0,0 +1,138 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef LITE_WITH_X86
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "lite/backends/x86/math/sparse_spmm.h"
+#include "lite/core/optimizer/mir/sparse_conv_detect_pass.h"
+#include "lite/core/tensor.h"
+
+typedef paddle::lite::Tensor Tensor;
+namespace math = paddle::lite::x86::math;
+
+// Fills a [rows x cols] weight whose zeros come either element-wise or in
+// whole blocks of four rows, to exercise both compressed layouts.
+static std::vector<float> make_sparse_weight(int rows,
+                                             int cols,
+                                             float sparsity,
+                                             bool blocked) {
+  std::mt19937 rng(rows * 131 + cols);
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  std::uniform_real_distribution<float> keep(0.f, 1.f);
+  std::vector<float> w(rows * cols, 0.f);
+  for (int r = 0; r < rows; ++r) {
+    for (int c = 0; c < cols; ++c) {
+      bool zero = blocked ? ((r / 4) * 7 + c * 3) % 10 < sparsity * 10
+                          : keep(rng) < sparsity;
+      w[r * cols + c] = zero ? 0.f : dist(rng);
+    }
+  }
+  return w;
+}
+
+static void check_sparse(int rows, int cols, int P, bool blocked, bool gemv) {
+  auto w = make_sparse_weight(rows, cols, 0.8f, blocked);
+  std::vector<float> bias(rows);
+  std::vector<float> in(cols * P);
+  for (int i = 0; i < rows; ++i) bias[i] = 0.1f * (i % 7) - 0.3f;
+  for (int i = 0; i < cols * P; ++i) in[i] = std::sin(0.37f * i);
+
+  // fc keeps its weight as [K x N], the conv as [N x K].
+  std::vector<float> dense = w;
+  if (gemv) {
+    for (int r = 0; r < rows; ++r) {
+      for (int c = 0; c < cols; ++c) dense[c * rows + r] = w[r * cols + c];
+    }
+  }
+  Tensor values, row_ends, col_idx;
+  paddle::lite::mir::SparseConvDetectPass pass;
+  int block_size = pass.ComputeX86SparseWeight(
+      dense.data(), rows, cols, gemv, 1.f, &values, &row_ends, &col_idx);
+  if (blocked && rows % 4 == 0) {
+    EXPECT_EQ(block_size, 4);
+  }
+  math::SparseMatrix sw;
+  sw.values = values.data<float>();
+  sw.row_ends = row_ends.data<int32_t>();
+  sw.col_idx = col_idx.data<int32_t>();
+  sw.rows = rows;
+  sw.cols = cols;
+  sw.block_size = block_size;
+
+  std::vector<float> out(rows * P), ref(rows * P);
+  if (gemv) {
+    // in is [P x cols], out is [P x rows]
+    math::sparse_gemv(sw,
+                      in.data(),
+                      P,
+                      bias.data(),
+                      math::SparseActType::kRelu,
+                      0.f,
+                      out.data());
+    for (int m = 0; m < P; ++m) {
+      for (int n = 0; n < rows; ++n) {
+        float acc = bias[n];
+        for (int k = 0; k < cols; ++k) {
+          acc += w[n * cols + k] * in[m * cols + k];
+        }
+        ref[m * rows + n] = std::max(acc, 0.f);
+      }
+    }
+  } else {
+    math::sparse_spmm(sw,
+                      in.data(),
+                      P,
+                      bias.data(),
+                      math::SparseActType::kRelu6,
+                      6.f,
+                      out.data());
+    for (int n = 0; n < rows; ++n) {
+      for (int p = 0; p < P; ++p) {
+        float acc = bias[n];
+        for (int k = 0; k < cols; ++k) {
+          acc += w[n * cols + k] * in[k * P + p];
+        }
+        ref[n * P + p] = std::min(std::max(acc, 0.f), 6.f);
+      }
+    }
+  }
+  for (int i = 0; i < rows * P; ++i) {
+    EXPECT_NEAR(out[i], ref[i], 1e-4f) << "index " << i;
+  }
+}
+
+TEST(TestX86SparseSpmm, spmm) {
+  for (int rows : {1, 7, 16, 33}) {
+    for (int P : {1, 9, 40, 77}) {
+      check_sparse(rows, 24, P, false, false);
+      check_sparse(rows, 24, P, true, false);
+    }
+  }
+}
+
+TEST(TestX86SparseSpmm, gemv) {
+  for (int rows : {1, 7, 16, 33}) {
+    for (int M : {1, 3, 8}) {
+      check_sparse(rows, 37, M, false, true);
+      check_sparse(rows, 37, M, true, true);
+    }
+  }
+}
+
+#endif  // LITE_WITH_X86
@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #pragma once
+#include <cstdint>
+#include <cstring>
 #include <functional>
 
 namespace paddle {
@@ -25,5 +27,30 @@ inline void CombineHash(const T& from, size_t* to) {
   *to ^= h(from) + 0x9e3779b9 + (*to << 6) + (*to >> 2);
 }
 
+// A fast 64-bit hash of a byte range, eight bytes per step. It is not
+// cryptographic, equal hashes must still be confirmed by comparing bytes.
+inline uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 0) {
+  constexpr uint64_t kMul = 0x9ddfea08eb382d69ULL;
+  auto mix = [](uint64_t k) {
+    k *= kMul;
+    k ^= k >> 47;
+    return k * kMul;
+  };
+  const char* bytes = static_cast<const char*>(data);
+  uint64_t hash = seed ^ (size * kMul);
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    uint64_t k;
+    std::memcpy(&k, bytes + i, sizeof(k));
+    hash = (hash ^ mix(k)) * kMul;
+  }
+  if (i < size) {
+    uint64_t k = 0;
+    std::memcpy(&k, bytes + i, size - i);
+    hash = (hash ^ mix(k)) * kMul;
+  }
+  return mix(hash ^ (hash >> 47));
+}
+
 }  // namespace lite
 }  // namespace paddle